@@ -0,0 +1,138 @@
+#pragma once
+
+// Minimal benchmark harness with the shape of Google Benchmark, so the suite
+// builds without third-party code and ports over by swapping this header:
+//
+//   static void BM_Thing(Bench::State& state) {
+//       Setup setup(state.range(0));          // untimed
+//       for (auto _ : state) {
+//           Bench::doNotOptimize(work());
+//       }
+//       state.setItemsProcessed(state.iterations());
+//   }
+//   BENCHMARK(BM_Thing)->range(1000, 100000, 10)->threadRange(1, 8);
+//
+// A multi-threaded run calls the function once per thread with the same
+// arguments. Every thread enters its timed loop together and leaves it
+// together, so setup done before the loop by thread 0 is visible to all, and
+// teardown after the loop by thread 0 runs once the others are done.
+//
+// Flags: --filter=SUBSTRING --min-time=SECONDS --repetitions=N --json=FILE
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Bench {
+
+class Barrier;
+
+class State {
+public:
+    struct Iterator {
+        State* state;
+        uint64_t remaining;
+        
+        bool operator!=(const Iterator&) {
+            if (remaining != 0) {
+                return true;
+            }
+            state->finishTiming();
+            return false;
+        }
+        Iterator& operator++() {
+            --remaining;
+            return *this;
+        }
+        // Marked so `for (auto _ : state)` does not warn, as in Google Benchmark
+        struct [[maybe_unused]] Value {};
+        Value operator*() const { return Value(); }
+    };
+    
+private:
+    std::vector<int64_t> ranges_;
+    uint64_t iterations_;
+    int threads_;
+    int threadIndex_;
+    Barrier* barrier_;
+    
+    std::chrono::steady_clock::time_point started_;
+    std::chrono::steady_clock::duration elapsed_{};
+    int64_t cpuStartedNs_ = 0;
+    int64_t cpuElapsedNs_ = 0;
+    int64_t itemsProcessed_ = 0;
+    bool paused_ = false;
+    
+    void startTiming();
+    void finishTiming();
+    
+public:
+    State(std::vector<int64_t> ranges, uint64_t iterations, int threads, int threadIndex, Barrier* barrier);
+    
+    Iterator begin();
+    Iterator end() { return Iterator{this, 0}; }
+    
+    int64_t range(size_t index = 0) const { return index < ranges_.size() ? ranges_[index] : 0; }
+    uint64_t iterations() const { return iterations_; }
+    int threads() const { return threads_; }
+    int threadIndex() const { return threadIndex_; }
+    
+    // Bracket untimed work inside the loop
+    void pauseTiming();
+    void resumeTiming();
+    void setItemsProcessed(int64_t items) { itemsProcessed_ = items; }
+    
+    std::chrono::steady_clock::duration getElapsed() const { return elapsed_; }
+    int64_t getCpuElapsedNs() const { return cpuElapsedNs_; }
+    int64_t getItemsProcessed() const { return itemsProcessed_; }
+};
+
+using Function = void (*)(State&);
+
+class Registration {
+private:
+    std::string name_;
+    Function function_;
+    std::vector<std::vector<int64_t>> argumentSets_;
+    std::vector<int> threadCounts_;
+    
+public:
+    Registration(std::string name, Function function);
+    
+    Registration* arg(int64_t value);
+    Registration* args(std::vector<int64_t> values);
+    // lo, lo*multiplier, ... up to and including hi
+    Registration* range(int64_t lo, int64_t hi, int64_t multiplier = 8);
+    Registration* threads(int count);
+    // 1, 2, 4, ... up to and including hi
+    Registration* threadRange(int lo, int hi);
+    
+    const std::string& getName() const { return name_; }
+    Function getFunction() const { return function_; }
+    std::vector<std::vector<int64_t>> getArgumentSets() const;
+    std::vector<int> getThreadCounts() const;
+};
+
+Registration* registerBenchmark(const char* name, Function function);
+int runAll(int argc, char** argv);
+
+// Keeps the compiler from discarding a computed value
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+} // namespace Bench
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+#define BENCHMARK(fn) \
+    static ::Bench::Registration* BENCH_CONCAT(benchRegistration_, __LINE__) = ::Bench::registerBenchmark(#fn, fn)
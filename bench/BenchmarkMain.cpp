@@ -0,0 +1,422 @@
+// Runner for the benchmark suite, see Benchmark.h.
+//
+// Build with optimizations and NDEBUG. Each suite links only its own
+// project, so either can be built alone:
+//   g++ -std=c++20 -O2 -DNDEBUG -pthread bench/BenchmarkMain.cpp bench/ParkingLotBenchmarks.cpp
+//       <parkingLot sources> -o run_parking_benchmarks
+//   g++ -std=c++20 -O2 -DNDEBUG -pthread bench/BenchmarkMain.cpp bench/BookingBenchmarks.cpp
+//       <movieTicketBooking sources> -lmysqlclient -o run_booking_benchmarks
+// The booking suite needs the complete movieTicketBooking build, including
+// the model, exception and logger sources and the MySQL client library.
+// Pin the CPU frequency governor and compare runs from the same host.
+//
+// Results print as a table; --json=FILE also writes them in Google
+// Benchmark's JSON schema so existing comparison tooling can read them.
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace Bench {
+
+// Reusable rendezvous for the threads of one run
+class Barrier {
+private:
+    std::mutex mutex_;
+    std::condition_variable arrived_;
+    int parties_;
+    int waiting_ = 0;
+    uint64_t generation_ = 0;
+    
+public:
+    explicit Barrier(int parties) : parties_(parties) {}
+    
+    void arriveAndWait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        uint64_t generation = generation_;
+        if (++waiting_ == parties_) {
+            waiting_ = 0;
+            ++generation_;
+            arrived_.notify_all();
+            return;
+        }
+        arrived_.wait(lock, [&] { return generation != generation_; });
+    }
+};
+
+namespace {
+
+int64_t threadCpuNs() {
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return int64_t(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+std::vector<std::unique_ptr<Registration>>& registry() {
+    static std::vector<std::unique_ptr<Registration>> registrations;
+    return registrations;
+}
+
+struct Options {
+    std::string filter;
+    double minTimeSeconds = 0.5;
+    int repetitions = 1;
+    std::string jsonPath;
+};
+
+struct RunResult {
+    std::string name;
+    std::string runName;
+    int threads;
+    int repetitionIndex;
+    uint64_t iterations;
+    double realTimeNs;   // per iteration, from the slowest thread
+    double cpuTimeNs;    // per iteration, summed over threads
+    double itemsPerSecond;
+    bool aggregate;
+    std::string aggregateName;
+};
+
+RunResult runOnce(const Registration& registration, const std::vector<int64_t>& arguments,
+                  int threadCount, uint64_t iterations) {
+    Barrier barrier(threadCount);
+    std::vector<std::unique_ptr<State>> states;
+    for (int i = 0; i < threadCount; ++i) {
+        states.push_back(std::make_unique<State>(arguments, iterations, threadCount, i, &barrier));
+    }
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threadCount; ++i) {
+        workers.emplace_back(registration.getFunction(), std::ref(*states[i]));
+    }
+    registration.getFunction()(*states[0]);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    
+    RunResult result{};
+    std::chrono::steady_clock::duration slowest{};
+    int64_t cpuNs = 0;
+    int64_t items = 0;
+    for (const auto& state : states) {
+        slowest = std::max(slowest, state->getElapsed());
+        cpuNs += state->getCpuElapsedNs();
+        items += state->getItemsProcessed();
+    }
+    double seconds = std::chrono::duration<double>(slowest).count();
+    result.threads = threadCount;
+    result.iterations = iterations;
+    result.realTimeNs = seconds * 1e9 / double(iterations);
+    result.cpuTimeNs = double(cpuNs) / double(iterations);
+    result.itemsPerSecond = seconds > 0 ? double(items) / seconds : 0.0;
+    return result;
+}
+
+std::string runNameFor(const Registration& registration, const std::vector<int64_t>& arguments, int threads) {
+    std::string name = registration.getName();
+    for (int64_t argument : arguments) {
+        name += "/" + std::to_string(argument);
+    }
+    // Like Google Benchmark, the thread count is part of every threaded name
+    if (threads > 1 || registration.getThreadCounts().size() > 1) {
+        name += "/threads:" + std::to_string(threads);
+    }
+    return name;
+}
+
+// Grows the iteration count until one run lasts at least the minimum time
+uint64_t calibrate(const Registration& registration, const std::vector<int64_t>& arguments, int threads,
+                   double minTimeSeconds) {
+    uint64_t iterations = 1;
+    while (true) {
+        RunResult trial = runOnce(registration, arguments, threads, iterations);
+        double seconds = trial.realTimeNs * double(iterations) / 1e9;
+        if (seconds >= minTimeSeconds || iterations >= 1000000000) {
+            return iterations;
+        }
+        double scale = seconds > 0 ? minTimeSeconds * 1.4 / seconds : 10.0;
+        iterations = std::max<uint64_t>(iterations + 1,
+                                        static_cast<uint64_t>(double(iterations) * std::min(scale, 10.0)));
+    }
+}
+
+void addAggregates(std::vector<RunResult>& results, size_t first) {
+    size_t count = results.size() - first;
+    if (count < 2) {
+        return;
+    }
+    auto aggregate = [&](const std::string& which, auto pick) {
+        RunResult summary = results[first];
+        summary.aggregate = true;
+        summary.aggregateName = which;
+        summary.name = summary.runName + "_" + which;
+        summary.realTimeNs = pick([](const RunResult& r) { return r.realTimeNs; });
+        summary.cpuTimeNs = pick([](const RunResult& r) { return r.cpuTimeNs; });
+        summary.itemsPerSecond = pick([](const RunResult& r) { return r.itemsPerSecond; });
+        return summary;
+    };
+    auto values = [&](auto field) {
+        std::vector<double> out;
+        for (size_t i = first; i < first + count; ++i) {
+            out.push_back(field(results[i]));
+        }
+        return out;
+    };
+    auto mean = [&](auto field) {
+        std::vector<double> v = values(field);
+        double sum = 0;
+        for (double x : v) sum += x;
+        return sum / double(v.size());
+    };
+    auto median = [&](auto field) {
+        std::vector<double> v = values(field);
+        std::sort(v.begin(), v.end());
+        return v.size() % 2 ? v[v.size() / 2] : (v[v.size() / 2 - 1] + v[v.size() / 2]) / 2;
+    };
+    auto stddev = [&](auto field) {
+        std::vector<double> v = values(field);
+        double m = mean(field);
+        double sum = 0;
+        for (double x : v) sum += (x - m) * (x - m);
+        return std::sqrt(sum / double(v.size() - 1));
+    };
+    RunResult summaries[] = {aggregate("mean", mean), aggregate("median", median), aggregate("stddev", stddev)};
+    for (const RunResult& summary : summaries) {
+        results.push_back(summary);
+    }
+}
+
+void printRow(const RunResult& result) {
+    std::printf("%-60s %14.1f ns %14.1f ns %12llu", result.name.c_str(), result.realTimeNs, result.cpuTimeNs,
+                static_cast<unsigned long long>(result.iterations));
+    if (result.itemsPerSecond > 0) {
+        std::printf(" %12.3fM items/s", result.itemsPerSecond / 1e6);
+    }
+    std::printf("\n");
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+bool writeJson(const std::string& path, const std::vector<RunResult>& results, const Options& options) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    char host[256] = "unknown";
+    gethostname(host, sizeof(host) - 1);
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+    
+    out << "{\n  \"context\": {\n"
+        << "    \"date\": \"" << date << "\",\n"
+        << "    \"host_name\": \"" << jsonEscape(host) << "\",\n"
+        << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+        << "    \"library_build_type\": \"release\",\n"
+#else
+        << "    \"library_build_type\": \"debug\",\n"
+#endif
+        << "    \"min_time\": " << options.minTimeSeconds << ",\n"
+        << "    \"repetitions\": " << options.repetitions << "\n"
+        << "  },\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const RunResult& r = results[i];
+        out << (i ? "," : "") << "\n    {\n"
+            << "      \"name\": \"" << jsonEscape(r.name) << "\",\n"
+            << "      \"run_name\": \"" << jsonEscape(r.runName) << "\",\n"
+            << "      \"run_type\": \"" << (r.aggregate ? "aggregate" : "iteration") << "\",\n"
+            << "      \"repetitions\": " << options.repetitions << ",\n";
+        if (r.aggregate) {
+            out << "      \"aggregate_name\": \"" << r.aggregateName << "\",\n";
+        } else {
+            out << "      \"repetition_index\": " << r.repetitionIndex << ",\n";
+        }
+        out << "      \"threads\": " << r.threads << ",\n"
+            << "      \"iterations\": " << r.iterations << ",\n"
+            << "      \"real_time\": " << r.realTimeNs << ",\n"
+            << "      \"cpu_time\": " << r.cpuTimeNs << ",\n"
+            << "      \"time_unit\": \"ns\"";
+        if (r.itemsPerSecond > 0) {
+            out << ",\n      \"items_per_second\": " << r.itemsPerSecond;
+        }
+        out << "\n    }";
+    }
+    out << "\n  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string flag = argv[i];
+        auto value = [&](const char* prefix) -> const char* {
+            size_t length = std::strlen(prefix);
+            return flag.compare(0, length, prefix) == 0 ? argv[i] + length : nullptr;
+        };
+        if (const char* v = value("--filter=")) {
+            options.filter = v;
+        } else if (const char* v = value("--min-time=")) {
+            options.minTimeSeconds = std::atof(v);
+        } else if (const char* v = value("--repetitions=")) {
+            options.repetitions = std::max(1, std::atoi(v));
+        } else if (const char* v = value("--json=")) {
+            options.jsonPath = v;
+        } else {
+            std::cerr << "unknown flag " << flag
+                      << "\nusage: " << argv[0] << " [--filter=SUBSTRING] [--min-time=SECONDS]"
+                      << " [--repetitions=N] [--json=FILE]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// State
+
+State::State(std::vector<int64_t> ranges, uint64_t iterations, int threads, int threadIndex, Barrier* barrier)
+    : ranges_(std::move(ranges)), iterations_(iterations), threads_(threads), threadIndex_(threadIndex),
+      barrier_(barrier) {}
+
+State::Iterator State::begin() {
+    startTiming();
+    return Iterator{this, iterations_};
+}
+
+void State::startTiming() {
+    barrier_->arriveAndWait();
+    cpuStartedNs_ = threadCpuNs();
+    started_ = std::chrono::steady_clock::now();
+}
+
+void State::finishTiming() {
+    if (!paused_) {
+        elapsed_ += std::chrono::steady_clock::now() - started_;
+        cpuElapsedNs_ += threadCpuNs() - cpuStartedNs_;
+    }
+    barrier_->arriveAndWait();
+}
+
+void State::pauseTiming() {
+    elapsed_ += std::chrono::steady_clock::now() - started_;
+    cpuElapsedNs_ += threadCpuNs() - cpuStartedNs_;
+    paused_ = true;
+}
+
+void State::resumeTiming() {
+    paused_ = false;
+    cpuStartedNs_ = threadCpuNs();
+    started_ = std::chrono::steady_clock::now();
+}
+
+// Registration
+
+Registration::Registration(std::string name, Function function)
+    : name_(std::move(name)), function_(function) {}
+
+Registration* Registration::arg(int64_t value) {
+    argumentSets_.push_back({value});
+    return this;
+}
+
+Registration* Registration::args(std::vector<int64_t> values) {
+    argumentSets_.push_back(std::move(values));
+    return this;
+}
+
+Registration* Registration::range(int64_t lo, int64_t hi, int64_t multiplier) {
+    for (int64_t value = lo; value < hi; value *= std::max<int64_t>(multiplier, 2)) {
+        argumentSets_.push_back({value});
+    }
+    argumentSets_.push_back({hi});
+    return this;
+}
+
+Registration* Registration::threads(int count) {
+    threadCounts_.push_back(std::max(count, 1));
+    return this;
+}
+
+Registration* Registration::threadRange(int lo, int hi) {
+    for (int count = std::max(lo, 1); count < hi; count *= 2) {
+        threadCounts_.push_back(count);
+    }
+    threadCounts_.push_back(hi);
+    return this;
+}
+
+std::vector<std::vector<int64_t>> Registration::getArgumentSets() const {
+    return argumentSets_.empty() ? std::vector<std::vector<int64_t>>{{}} : argumentSets_;
+}
+
+std::vector<int> Registration::getThreadCounts() const {
+    return threadCounts_.empty() ? std::vector<int>{1} : threadCounts_;
+}
+
+Registration* registerBenchmark(const char* name, Function function) {
+    registry().push_back(std::make_unique<Registration>(name, function));
+    return registry().back().get();
+}
+
+int runAll(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 2;
+    }
+    
+    std::printf("%-60s %17s %17s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+    std::vector<RunResult> results;
+    for (const auto& registration : registry()) {
+        for (const auto& arguments : registration->getArgumentSets()) {
+            for (int threads : registration->getThreadCounts()) {
+                std::string runName = runNameFor(*registration, arguments, threads);
+                if (runName.find(options.filter) == std::string::npos) {
+                    continue;
+                }
+                uint64_t iterations = calibrate(*registration, arguments, threads, options.minTimeSeconds);
+                size_t first = results.size();
+                for (int repetition = 0; repetition < options.repetitions; ++repetition) {
+                    RunResult result = runOnce(*registration, arguments, threads, iterations);
+                    result.name = result.runName = runName;
+                    result.repetitionIndex = repetition;
+                    printRow(result);
+                    results.push_back(result);
+                }
+                addAggregates(results, first);
+                for (size_t i = first + options.repetitions; i < results.size(); ++i) {
+                    printRow(results[i]);
+                }
+            }
+        }
+    }
+    
+    if (!options.jsonPath.empty() && !writeJson(options.jsonPath, results, options)) {
+        std::cerr << "cannot write " << options.jsonPath << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace Bench
+
+int main(int argc, char** argv) {
+    return Bench::runAll(argc, argv);
+}
@@ -0,0 +1,257 @@
+// Movie booking hot paths: seat locking under contention, best-available
+// allocation, the show cache hit path, seat layout serialization, router
+// dispatch and async log throughput.
+
+#include "Benchmark.h"
+
+#include "../movieTicketBooking/include/controllers/BookingController.h"
+#include "../movieTicketBooking/include/models/Show.h"
+#include "../movieTicketBooking/include/utils/JsonWriter.h"
+#include "../movieTicketBooking/include/utils/Logger.h"
+#include "../movieTicketBooking/include/utils/ShardedLruCache.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace MovieBooking;
+
+namespace {
+
+const int kSeatsPerShow = 1000;
+
+std::unique_ptr<Models::Show> makeShow(int showId) {
+    auto start = std::chrono::system_clock::now() + std::chrono::hours(24);
+    auto show = std::make_unique<Models::Show>(showId, 1, 1, start, start + std::chrono::hours(3), 12.5);
+    std::vector<Models::ShowSeatRecord> seats;
+    seats.reserve(kSeatsPerShow);
+    for (int seat = 1; seat <= kSeatsPerShow; ++seat) {
+        seats.emplace_back(showId * kSeatsPerShow + seat, showId, seat, Models::ShowSeatStatus::AVAILABLE, 12.5);
+    }
+    show->loadShowSeats(seats);
+    return show;
+}
+
+// Show::lockSeats
+
+std::unique_ptr<Models::Show> sharedShow;
+
+// Every thread locks a random run of `range(0)` adjacent seats and releases
+// them again; more threads means more conflicting attempts on the same seats
+void BM_ShowLockSeats(Bench::State& state) {
+    if (state.threadIndex() == 0) {
+        sharedShow = makeShow(1);
+    }
+    std::mt19937 random(12345 + state.threadIndex()); // fixed seeds for repeatable runs
+    std::uniform_int_distribution<int> firstSeat(1, kSeatsPerShow - static_cast<int>(state.range(0)) + 1);
+    std::vector<int> seatIds(static_cast<size_t>(state.range(0)));
+    int bookingId = state.threadIndex() * 100000000;
+    int64_t locked = 0;
+    
+    for (auto _ : state) {
+        int first = firstSeat(random);
+        for (size_t i = 0; i < seatIds.size(); ++i) {
+            seatIds[i] = first + static_cast<int>(i);
+        }
+        ++bookingId;
+        if (sharedShow->lockSeats(seatIds, bookingId)) {
+            sharedShow->releaseLockedSeats(bookingId);
+            ++locked;
+        }
+    }
+    
+    state.setItemsProcessed(locked);
+    if (state.threadIndex() == 0) {
+        sharedShow.reset();
+    }
+}
+BENCHMARK(BM_ShowLockSeats)->arg(4)->threadRange(1, 64);
+
+// Show::lockBestAvailableSeats on a 25 x 40 screen (seat ids 1..1000, row
+// major), every thread booking blocks of state.range(0) and releasing them
+const int kRows = 25;
+const int kSeatsPerRow = kSeatsPerShow / kRows;
+
+std::unique_ptr<Models::SeatLayout> sharedLayout;
+
+void BM_LockBestAvailable(Bench::State& state) {
+    if (state.threadIndex() == 0) {
+        sharedShow = makeShow(1);
+        std::vector<Models::Seat> seats;
+        seats.reserve(kSeatsPerShow);
+        for (int seat = 1; seat <= kSeatsPerShow; ++seat) {
+            seats.emplace_back(seat, 1, std::string(1, static_cast<char>('A' + (seat - 1) / kSeatsPerRow)),
+                               (seat - 1) % kSeatsPerRow + 1);
+        }
+        sharedLayout = std::make_unique<Models::SeatLayout>(
+            Models::Screen(1, 1, "bench", kSeatsPerShow, kRows, kSeatsPerRow, {Models::SeatType::REGULAR}), seats);
+    }
+    const size_t count = static_cast<size_t>(state.range(0));
+    int bookingId = 1 + static_cast<int>(state.threadIndex()) * 1000000;
+    int64_t locked = 0;
+    for (auto _ : state) {
+        ++bookingId;
+        if (!sharedShow->lockBestAvailableSeats(*sharedLayout, count, bookingId).empty()) {
+            sharedShow->releaseLockedSeats(bookingId);
+            ++locked;
+        }
+    }
+    state.setItemsProcessed(locked);
+    if (state.threadIndex() == 0) {
+        sharedShow.reset();
+        sharedLayout.reset();
+    }
+}
+BENCHMARK(BM_LockBestAvailable)->arg(4)->threadRange(1, 16);
+
+// ShowService cache hit path. ShowService loads misses through the database,
+// so this drives the same cache type and sizing it uses (ShowService::ShowCache:
+// 16 shards, capacity 1000) with every show already cached.
+
+using ShowCache = Utils::ShardedLruCache<int, Models::Show>;
+std::unique_ptr<ShowCache> sharedCache;
+
+void BM_ShowCacheHit(Bench::State& state) {
+    int shows = static_cast<int>(state.range(0));
+    if (state.threadIndex() == 0) {
+        sharedCache = std::make_unique<ShowCache>(1000, std::chrono::minutes(10), 16);
+        for (int showId = 1; showId <= shows; ++showId) {
+            sharedCache->put(showId, std::shared_ptr<const Models::Show>(makeShow(showId)));
+        }
+    }
+    std::mt19937 random(777 + state.threadIndex());
+    std::uniform_int_distribution<int> showIds(1, shows);
+    
+    for (auto _ : state) {
+        Bench::doNotOptimize(sharedCache->get(showIds(random)));
+    }
+    
+    state.setItemsProcessed(state.iterations());
+    if (state.threadIndex() == 0) {
+        sharedCache.reset();
+    }
+}
+BENCHMARK(BM_ShowCacheHit)->arg(1)->arg(1000)->threadRange(1, 16);
+
+// Seat layout serialization into a reused buffer: arg 0 writes every seat as
+// an object, arg 1 the compact one-string-per-row encoding
+void BM_SeatLayoutJson(Bench::State& state) {
+    const auto show = makeShow(1);
+    const bool compact = state.range(0) != 0;
+    std::string buffer;
+    Utils::JsonWriter json(buffer);
+    for (auto _ : state) {
+        json.clear();
+        if (compact) {
+            show->writeCompactLayout(json, 25);
+        } else {
+            show->writeSeatsJson(json);
+        }
+        Bench::doNotOptimize(buffer.data());
+    }
+    state.setItemsProcessed(state.iterations() * kSeatsPerShow);
+}
+BENCHMARK(BM_SeatLayoutJson)->arg(0)->arg(1);
+
+// Router::handleRequest, with the booking API's route shapes and trivial handlers
+
+std::unique_ptr<Controllers::Router> makeRouter() {
+    auto router = std::make_unique<Controllers::Router>();
+    auto ok = [](const HttpRequestView& request) {
+        HttpResponse response;
+        response.body = std::string(request.getPathParam("id"));
+        return response;
+    };
+    auto okOwned = [](const HttpRequest& request) {
+        HttpResponse response;
+        response.body = request.path;
+        return response;
+    };
+    const char* viewRoutes[] = {"/api/bookings/:id", "/api/bookings/:id/payment", "/api/shows/:id",
+                                "/api/shows/:id/seats", "/api/shows/:id/layout", "/health"};
+    for (const char* path : viewRoutes) {
+        router->registerViewRoute("GET", path, ok);
+    }
+    const char* ownedRoutes[] = {"/api/bookings", "/api/bookings/:id/confirm", "/api/bookings/:id/cancel",
+                                 "/api/shows", "/api/bookings/shows/:showId/locks"};
+    for (const char* path : ownedRoutes) {
+        router->registerRoute("POST", path, okOwned);
+    }
+    router->registerRoute("GET", "/api/bookings/stats", okOwned);
+    return router;
+}
+
+// Wire bytes to response: in-place parse plus radix-tree dispatch
+void BM_RouterDispatchView(Bench::State& state) {
+    std::unique_ptr<Controllers::Router> router = makeRouter();
+    const std::string wire = "GET /api/shows/42/seats?date=2024-06-01 HTTP/1.1\r\n"
+                             "Host: booking.local\r\nAccept: application/json\r\n"
+                             "User-Agent: bench\r\n\r\n";
+    HttpRequestView request;
+    
+    for (auto _ : state) {
+        HttpRequestView::parse(wire, request);
+        Bench::doNotOptimize(router->handleRequest(request));
+    }
+    
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RouterDispatchView);
+
+// Owning HttpRequest into a handler that takes one
+void BM_RouterDispatchOwned(Bench::State& state) {
+    std::unique_ptr<Controllers::Router> router = makeRouter();
+    HttpRequest request;
+    request.method = "POST";
+    request.path = "/api/bookings/1234/confirm";
+    request.headers["Content-Type"] = "application/json";
+    request.body = "{\"paymentId\":\"PAY-1\"}";
+    
+    for (auto _ : state) {
+        Bench::doNotOptimize(router->handleRequest(request));
+    }
+    
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RouterDispatchOwned);
+
+// AsyncAppender producer throughput into an appender that only counts
+
+class CountingAppender : public Utils::ILogAppender {
+public:
+    std::atomic<uint64_t> appended{0};
+    
+    void append(const Utils::LogEntry&) override { appended.fetch_add(1, std::memory_order_relaxed); }
+    void flush() override {}
+    bool isReady() const override { return true; }
+    bool acceptsDeferred() const override { return true; }
+};
+
+std::unique_ptr<Utils::AsyncAppender> sharedAppender;
+
+void BM_AsyncAppender(Bench::State& state) {
+    if (state.threadIndex() == 0) {
+        // BLOCK, so the measured rate is what the writer sustains, not drops
+        sharedAppender = std::make_unique<Utils::AsyncAppender>(std::make_unique<CountingAppender>(), 1 << 16,
+                                                                Utils::LogOverflowPolicy::BLOCK);
+        sharedAppender->start();
+    }
+    
+    for (auto _ : state) {
+        sharedAppender->append(Utils::LogEntry(Utils::LogLevel::INFO, "seat lock acquired for booking", "bench",
+                                               __FILE__, __LINE__, __func__));
+    }
+    
+    state.setItemsProcessed(state.iterations());
+    if (state.threadIndex() == 0) {
+        sharedAppender->flush();
+        sharedAppender->stop();
+        sharedAppender.reset();
+    }
+}
+BENCHMARK(BM_AsyncAppender)->threadRange(1, 8);
+
+} // namespace
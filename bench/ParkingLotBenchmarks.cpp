@@ -0,0 +1,93 @@
+// ParkingLot entry and exit at 1k to 100k slots.
+
+#include "Benchmark.h"
+
+#include "../parkingLot/ParkingLot.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Shared by the threads of one run; created by thread 0 before the timed loop
+std::unique_ptr<ParkingLot> sharedLot;
+
+// Mostly cars, as at our gates: 80% car, 10% truck, 10% motorcycle slots
+std::unique_ptr<ParkingLot> makeLot(int64_t slots) {
+    int cars = static_cast<int>(slots * 8 / 10);
+    int trucks = static_cast<int>(slots / 10);
+    int motorcycles = static_cast<int>(slots - cars - trucks);
+    return std::unique_ptr<ParkingLot>(new ParkingLot(cars, trucks, motorcycles, 10.0));
+}
+
+// Steady state at half occupancy: every iteration parks one car and lets it out
+void BM_ParkAndExit(Bench::State& state) {
+    if (state.threadIndex() == 0) {
+        sharedLot = makeLot(state.range(0));
+        for (int64_t i = 0; i < state.range(0) / 2; ++i) {
+            sharedLot->parkVehicle(Vehicle("FILL" + std::to_string(i), VehicleType::CAR));
+        }
+    }
+    Vehicle car("BENCH" + std::to_string(state.threadIndex()), VehicleType::CAR);
+    
+    for (auto _ : state) {
+        std::shared_ptr<ParkingTicket> ticket = sharedLot->parkVehicle(car);
+        Bench::doNotOptimize(sharedLot->exitParking(ticket->getTicketId()));
+    }
+    
+    state.setItemsProcessed(state.iterations() * 2);
+    if (state.threadIndex() == 0) {
+        sharedLot.reset();
+    }
+}
+BENCHMARK(BM_ParkAndExit)->range(1000, 100000, 10)->threadRange(1, 8);
+
+// Empty to full: the cost of a park as the free lists drain
+void BM_ParkUntilFull(Bench::State& state) {
+    int64_t slots = state.range(0);
+    std::vector<Vehicle> cars;
+    for (int64_t i = 0; i < slots; ++i) {
+        cars.emplace_back("CAR" + std::to_string(i), VehicleType::CAR);
+    }
+    
+    for (auto _ : state) {
+        state.pauseTiming();
+        std::unique_ptr<ParkingLot> lot(new ParkingLot(static_cast<int>(slots), 0, 0, 10.0));
+        state.resumeTiming();
+        for (const Vehicle& car : cars) {
+            Bench::doNotOptimize(lot->parkVehicle(car));
+        }
+        state.pauseTiming();
+        lot.reset();
+        state.resumeTiming();
+    }
+    
+    state.setItemsProcessed(state.iterations() * slots);
+}
+BENCHMARK(BM_ParkUntilFull)->range(1000, 100000, 10);
+
+// Exit path alone, with the tickets issued outside the timed region
+void BM_ExitParking(Bench::State& state) {
+    int64_t slots = state.range(0);
+    std::unique_ptr<ParkingLot> lot = makeLot(slots);
+    Vehicle car("EXIT", VehicleType::CAR);
+    std::vector<ParkingId> tickets;
+    
+    for (auto _ : state) {
+        if (tickets.empty()) {
+            state.pauseTiming();
+            while (auto ticket = lot->parkVehicle(car)) {
+                tickets.push_back(ticket->getTicketId());
+            }
+            state.resumeTiming();
+        }
+        Bench::doNotOptimize(lot->exitParking(tickets.back()));
+        tickets.pop_back();
+    }
+    
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ExitParking)->range(1000, 100000, 10);
+
+} // namespace
@@ -1,13 +1,21 @@
 #pragma once
 
+#include <array>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <optional>
 #include <vector>
 #include <future>
 #include <functional>
 
+#include "RouteTree.h"
 #include "../services/BookingService.h"
+#include "../services/SeatChangeFeed.h"
+#include "../services/ShowService.h"
 #include "../payment/PaymentGateway.h"
+#include "../utils/EventStream.h"
+#include "../utils/JsonWriter.h"
 
 // HTTP response structure
 struct HttpResponse {
@@ -15,6 +23,9 @@ struct HttpResponse {
     std::string contentType;
     std::string body;
     std::unordered_map<std::string, std::string> headers;
+    // Streaming response (HttpServer only): `body` goes first, then the
+    // stream's events until either side closes it
+    std::shared_ptr<MovieBooking::Utils::EventStream> stream;
     
     HttpResponse(int code = 200, const std::string& type = "application/json")
         : statusCode(code), contentType(type) {}
@@ -45,10 +56,61 @@ struct HttpRequest {
     }
 };
 
+// Non-owning request parsed in place from a connection's read buffer.
+// Every field views that buffer, so the view is only valid while it is, and
+// parsing or routing one allocates nothing. Query values are left undecoded.
+struct HttpRequestView {
+    static constexpr size_t kMaxHeaders = 64;
+    using Field = std::pair<std::string_view, std::string_view>;
+    
+    std::string_view method;
+    std::string_view target; // path plus query, as sent
+    std::string_view path;
+    std::string_view query;
+    std::string_view version;
+    std::array<Field, kMaxHeaders> headers;
+    size_t headerCount = 0;
+    std::string_view body;
+    MovieBooking::Controllers::RouteParams pathParams; // filled by Router
+    
+    // Header names compare case-insensitively
+    std::string_view getHeader(std::string_view name) const;
+    std::string_view getQueryParam(std::string_view name) const;
+    std::string_view getPathParam(std::string_view name) const { return pathParams.get(name); }
+    // HTTP/1.1 keeps the connection unless "Connection: close"; 1.0 only on "keep-alive"
+    bool wantsKeepAlive() const;
+    
+    // Parse one HTTP/1.x request from the front of `data`. Returns the bytes it
+    // occupies, or 0 if `data` does not hold a complete request yet. Throws
+    // ValidationException on malformed input, repeated Content-Length and
+    // chunked bodies.
+    static size_t parse(std::string_view data, HttpRequestView& request);
+    
+    // Owning copy for handlers that take HttpRequest
+    HttpRequest toRequest() const;
+};
+
 namespace MovieBooking {
 namespace Controllers {
 
-// Booking controller for handling HTTP requests
+// Response whose JSON body `write(Utils::JsonWriter&)` serializes in place,
+// e.g. [&](auto& json) { show.writeCompactLayout(json, screen.getSeatsPerRow()); }
+template<typename WriteFn>
+HttpResponse jsonResponse(WriteFn&& write, int statusCode = 200) {
+    HttpResponse response(statusCode);
+    Utils::JsonWriter writer(response.body);
+    write(writer);
+    return response;
+}
+
+// Response for an expected booking failure, answered without an exception
+inline HttpResponse bookingErrorResponse(const Utils::BookingError& error) {
+    return jsonResponse([&](Utils::JsonWriter& json) { error.writeJson(json); }, error.getHttpStatusCode());
+}
+
+// Booking controller for handling HTTP requests.
+// *Async methods run on the shared Utils::Executors::io() pool; when its queue
+// is full the caller blocks (back-pressure) instead of spawning a thread.
 class BookingController {
 private:
     std::unique_ptr<Services::BookingService> bookingService_;
@@ -126,6 +188,7 @@ private:
     HttpResponse buildSuccessResponse(const std::string& data);
     HttpResponse buildErrorResponse(const std::string& message, int statusCode = 400);
     HttpResponse buildBookingResponse(const Services::BookingResult& result);
+    HttpResponse buildBookingResponse(const Services::InitiatedBooking& booking);
     HttpResponse buildPaymentResponse(const Payment::PaymentResponse& response);
     
     // Validation helpers
@@ -133,15 +196,17 @@ private:
     bool validatePaymentRequest(const HttpRequest& request);
     bool validateUserPermissions(int userId, const HttpRequest& request);
     
-    // Error handling
+    // Error handling. Booking conflicts come back from tryInitiateBooking as
+    // values and go to bookingErrorResponse; handleException is for the rest.
     HttpResponse handleException(const std::exception& e);
     HttpResponse handleValidationError(const std::string& field, const std::string& message);
 };
 
-// Show controller
+// Show controller (async variants as in BookingController)
 class ShowController {
 private:
     std::unique_ptr<Services::ShowService> showService_;
+    std::shared_ptr<Services::SeatChangeFeed> seatChangeFeed_;
     std::function<bool(const HttpRequest&)> authValidator_;
     
 public:
@@ -177,35 +242,83 @@ public:
     std::future<HttpResponse> getAvailableSeatsAsync(const HttpRequest& request);
     HttpResponse getAvailableSeats(const HttpRequest& request);
     
+    // Server-sent seat changes for one show (see Services::SeatChangeFeed);
+    // ?seatsPerRow= shapes the snapshot's layout. 503 without a feed.
+    std::future<HttpResponse> streamSeatChangesAsync(const HttpRequest& request);
+    HttpResponse streamSeatChanges(const HttpRequest& request);
+    
     // Configuration
     void setAuthValidator(std::function<bool(const HttpRequest&)> validator) {
         authValidator_ = validator;
     }
+    
+    void setSeatChangeFeed(std::shared_ptr<Services::SeatChangeFeed> feed) {
+        seatChangeFeed_ = std::move(feed);
+    }
 
 private:
     Services::ShowCreationRequest parseShowCreationRequest(const HttpRequest& request);
     Services::ShowSearchCriteria parseShowSearchCriteria(const HttpRequest& request);
-    HttpResponse buildShowResponse(const std::unique_ptr<Models::Show>& show);
+    HttpResponse buildShowResponse(const Models::Show& show);
     HttpResponse buildShowsResponse(const std::vector<std::unique_ptr<Models::Show>>& shows);
 };
 
-// Router for handling HTTP routing
+// Router for handling HTTP routing.
+// Routes live in one radix tree per method, built by the register*/setup*
+// calls at startup and read-only afterwards, so matching is lock-free.
+// Handlers take either an owning HttpRequest or, to avoid per-request
+// allocation, an HttpRequestView; each entry point converts only when the
+// route's handler wants the other form. Async handlers (the controllers'
+// *Async methods) return a future that dispatch() hands back unwaited.
 class Router {
+public:
+    using Handler = std::function<HttpResponse(const HttpRequest&)>;
+    using ViewHandler = std::function<HttpResponse(const HttpRequestView&)>;
+    using AsyncHandler = std::function<std::future<HttpResponse>(const HttpRequest&)>;
+    
+    struct Route {
+        Handler handler;
+        ViewHandler viewHandler;
+        AsyncHandler asyncHandler;
+    };
+    
+    // Either a finished response or one still being computed; `request` keeps
+    // the owning request alive until `pending` is ready
+    struct Dispatched {
+        std::optional<HttpResponse> response;
+        std::future<HttpResponse> pending;
+        std::shared_ptr<const HttpRequest> request;
+    };
+
 private:
-    std::unordered_map<std::string, std::unordered_map<std::string, std::function<HttpResponse(const HttpRequest&)>>> routes_;
+    // Few methods, so a linear scan beats hashing the method name
+    std::vector<std::pair<std::string, RouteTree<Route>>> routes_;
     std::unordered_map<std::string, std::unique_ptr<BookingController>> bookingControllers_;
     std::unordered_map<std::string, std::unique_ptr<ShowController>> showControllers_;
     
 public:
-    // Route registration
-    void registerRoute(const std::string& method, const std::string& path, 
-                      std::function<HttpResponse(const HttpRequest&)> handler);
+    // Route registration. Paths are patterns such as "/api/bookings/:id";
+    // throws ValidationException on a malformed or duplicate pattern.
+    void registerRoute(const std::string& method, const std::string& path, Handler handler);
+    void registerViewRoute(const std::string& method, const std::string& path, ViewHandler handler);
+    void registerAsyncRoute(const std::string& method, const std::string& path, AsyncHandler handler);
     
     void registerBookingController(const std::string& prefix, std::unique_ptr<BookingController> controller);
     void registerShowController(const std::string& prefix, std::unique_ptr<ShowController> controller);
     
-    // Request handling
+    // Request handling; 404 for an unknown path, 405 for a known path with
+    // another method. `request.pathParams` is filled in for the handler, and
+    // async handlers are waited on.
     HttpResponse handleRequest(const HttpRequest& request);
+    HttpResponse handleRequest(HttpRequestView& request);
+    
+    // As handleRequest, but never waits on an async handler; for event loops
+    Dispatched dispatch(HttpRequestView& request);
+    // Result of a ready future from dispatch(); exceptions become error responses
+    static HttpResponse collect(std::future<HttpResponse>& pending);
+    
+    // Match without dispatching. Allocation-free, for benchmarks and diagnostics.
+    const Route* match(std::string_view method, std::string_view path, RouteParams& params) const;
     
     // Route configuration
     void setupDefaultRoutes();
@@ -213,8 +326,11 @@ public:
     void setupShowRoutes();
 
 private:
-    std::pair<std::string, std::unordered_map<std::string, std::string>> parsePath(const std::string& path);
-    std::function<HttpResponse(const HttpRequest&)> findHandler(const std::string& method, const std::string& path);
+    RouteTree<Route>& treeFor(const std::string& method);
+    const RouteTree<Route>* findTree(std::string_view method) const;
+    // For a missed match: the methods that do serve `path`, for the Allow header
+    std::string allowedMethods(std::string_view path) const;
+    HttpResponse notRouted(std::string_view path) const;
 };
 
 } // namespace Controllers
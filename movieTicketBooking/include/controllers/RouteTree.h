@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../utils/Exceptions.h"
+
+namespace MovieBooking {
+namespace Controllers {
+
+// Path parameters captured by a route match. Names point into the route tree
+// and values into the matched path, so filling them never allocates.
+struct RouteParams {
+    static constexpr size_t kMaxParams = 8;
+
+    std::array<std::pair<std::string_view, std::string_view>, kMaxParams> entries;
+    size_t count = 0;
+
+    std::string_view get(std::string_view name) const {
+        for (size_t i = 0; i < count; ++i) {
+            if (entries[i].first == name) {
+                return entries[i].second;
+            }
+        }
+        return {};
+    }
+
+    void clear() { count = 0; }
+};
+
+// Radix tree of path patterns, built once at startup and matched per request.
+// Patterns are literal text plus ":name" segments, e.g. "/bookings/:id/confirm".
+// A parameter matches one non-empty path segment. Literal edges are compressed
+// and tried before a parameter at the same position, so "/bookings/stats"
+// wins over "/bookings/:id"; a failed branch backtracks.
+template<typename Value>
+class RouteTree {
+private:
+    struct Node {
+        std::string prefix;                          // literal edge label leading here
+        std::vector<std::unique_ptr<Node>> children; // literal children, distinct first chars
+        std::unique_ptr<Node> param;                 // ":name" child
+        std::string paramName;
+        std::optional<Value> value;
+    };
+
+    Node root_;
+    size_t size_ = 0;
+
+public:
+    // Throws ValidationException on a malformed pattern, a duplicate route, or
+    // two parameter names at the same position
+    void insert(const std::string& routePattern, Value value) {
+        std::string_view pattern = routePattern;
+        Node* node = &root_;
+        size_t params = 0;
+        while (!pattern.empty()) {
+            const size_t colon = pattern.find(':');
+            node = &insertLiteral(*node, pattern.substr(0, colon));
+            if (colon == std::string_view::npos) {
+                break;
+            }
+            if (colon > 0 && pattern[colon - 1] != '/') {
+                throw Utils::ValidationException("Route parameter must start a segment: " + routePattern, "path");
+            }
+            pattern.remove_prefix(colon + 1);
+            const std::string_view name = pattern.substr(0, pattern.find('/'));
+            if (name.empty() || ++params > RouteParams::kMaxParams) {
+                throw Utils::ValidationException("Invalid route parameter in " + routePattern, "path");
+            }
+            if (!node->param) {
+                node->param = std::make_unique<Node>();
+                node->paramName = std::string(name);
+            } else if (node->paramName != name) {
+                throw Utils::ValidationException("Conflicting route parameter names in " + routePattern, "path");
+            }
+            node = node->param.get();
+            pattern.remove_prefix(name.size());
+        }
+        if (node->value) {
+            throw Utils::ValidationException("Duplicate route: " + routePattern, "path");
+        }
+        node->value.emplace(std::move(value));
+        ++size_;
+    }
+
+    // Null if nothing matches; `params` holds the captures of the match
+    const Value* match(std::string_view path, RouteParams& params) const {
+        params.clear();
+        return matchNode(root_, path, params);
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    static Node& insertLiteral(Node& from, std::string_view text) {
+        Node* node = &from;
+        while (!text.empty()) {
+            std::unique_ptr<Node>* slot = nullptr;
+            for (auto& child : node->children) {
+                if (child->prefix[0] == text[0]) {
+                    slot = &child;
+                    break;
+                }
+            }
+            if (!slot) {
+                node->children.push_back(std::make_unique<Node>());
+                node->children.back()->prefix = std::string(text);
+                return *node->children.back();
+            }
+            Node& child = **slot;
+            size_t common = 0;
+            while (common < child.prefix.size() && common < text.size() && child.prefix[common] == text[common]) {
+                ++common;
+            }
+            if (common < child.prefix.size()) {
+                // Split the edge: the shared part becomes a new node above the child
+                auto split = std::make_unique<Node>();
+                split->prefix = child.prefix.substr(0, common);
+                (*slot)->prefix.erase(0, common);
+                split->children.push_back(std::move(*slot));
+                *slot = std::move(split);
+            }
+            node = slot->get();
+            text.remove_prefix(common);
+        }
+        return *node;
+    }
+
+    static const Value* matchNode(const Node& node, std::string_view path, RouteParams& params) {
+        if (path.empty()) {
+            return node.value ? &*node.value : nullptr;
+        }
+        for (const auto& child : node.children) {
+            if (child->prefix[0] == path[0]) {
+                if (path.substr(0, child->prefix.size()) == child->prefix) {
+                    if (const Value* found = matchNode(*child, path.substr(child->prefix.size()), params)) {
+                        return found;
+                    }
+                }
+                break;
+            }
+        }
+        if (node.param) {
+            const size_t end = std::min(path.find('/'), path.size());
+            if (end > 0) {
+                params.entries[params.count++] = {node.paramName, path.substr(0, end)};
+                if (const Value* found = matchNode(*node.param, path.substr(end), params)) {
+                    return found;
+                }
+                --params.count;
+            }
+        }
+        return nullptr;
+    }
+};
+
+} // namespace Controllers
+} // namespace MovieBooking
@@ -4,11 +4,29 @@
 #include <memory>
 #include <vector>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <variant>
 #include <mysql/mysql.h>
 
+#include "PreparedStatementCache.h"
+#include "ResultCursor.h"
+#include "../utils/LatencyHistogram.h"
+#include "../utils/Metrics.h"
+#include "../utils/Task.h"
+
 namespace MovieBooking {
 namespace Database {
 
+// Typed prepared-statement parameter; bound directly, never escaped or formatted
+using StatementParam = std::variant<std::nullptr_t, int, int64_t, double, std::string,
+                                    std::chrono::system_clock::time_point>;
+
 class DatabaseConnection {
 private:
     MYSQL* connection_;
@@ -19,11 +37,12 @@ private:
     int port_;
     bool isConnected_;
     mutable std::mutex mutex_;
+    PreparedStatementCache statementCache_;
 
 public:
     DatabaseConnection(const std::string& host, const std::string& username,
                       const std::string& password, const std::string& database,
-                      int port = 3306);
+                      int port = 3306, size_t statementCacheCapacity = 64);
     
     ~DatabaseConnection();
 
@@ -35,11 +54,18 @@ public:
     
     // Query execution
     bool executeQuery(const std::string& query);
+    // As above, reporting the rows the statement affected
+    bool executeQuery(const std::string& query, uint64_t* affectedRows);
     std::vector<std::vector<std::string>> fetchResults(const std::string& query);
     std::vector<std::string> fetchRow(const std::string& query);
     std::string fetchSingleValue(const std::string& query);
     int getLastInsertId();
     
+    // Streaming reads: rows are decoded in place from the MySQL buffer
+    ResultCursor openCursor(const std::string& query);
+    template<typename RowFn>
+    size_t forEachRow(const std::string& query, RowFn&& onRow);
+    
     // Transaction management
     bool beginTransaction();
     bool commit();
@@ -50,6 +76,20 @@ public:
     bool executePreparedStatement(MYSQL_STMT* stmt);
     void closeStatement(MYSQL_STMT* stmt);
     
+    // Cached prepared statements: `sqlTemplate` uses '?' placeholders and is
+    // prepared once per connection, then re-executed with freshly bound params
+    bool executeCached(const std::string& sqlTemplate, const std::vector<StatementParam>& params,
+                       uint64_t* affectedRows = nullptr);
+    void setStatementCacheCapacity(size_t capacity);
+    
+    // Coroutine variants: the blocking C API call runs on Utils::Executors::io()
+    // and the awaiting coroutine is resumed there when it returns
+    Utils::Task<bool> executeQueryTask(std::string query);
+    Utils::Task<std::vector<std::vector<std::string>>> fetchResultsTask(std::string query);
+    Utils::Task<bool> executeCachedTask(std::string sqlTemplate, std::vector<StatementParam> params,
+                                        uint64_t* affectedRows = nullptr);
+    PreparedStatementCache::Stats getStatementCacheStats() const;
+    
     // Utility methods
     std::string escapeString(const std::string& input);
     bool ping();
@@ -58,53 +98,375 @@ public:
 private:
     void cleanup();
     bool checkConnection();
+    PreparedStatementCache::Statement getOrPrepareStatement(const std::string& sqlTemplate);
+    bool bindAndExecute(MYSQL_STMT* stmt, const std::vector<StatementParam>& params, uint64_t* affectedRows);
 };
 
-// Connection pool for better performance
-class ConnectionPool {
+class ConnectionPool;
+
+// RAII lease of a pooled connection. Returned to the pool on destruction;
+// hold it for one operation (or one Transaction), not for an object's lifetime.
+// The pool is held weakly: a lease that outlives it just closes its connection.
+class PooledConnection {
 private:
-    std::vector<std::unique_ptr<DatabaseConnection>> connections_;
-    std::string host_;
-    std::string username_;
-    std::string password_;
-    std::string database_;
-    int port_;
-    int maxConnections_;
+    std::weak_ptr<ConnectionPool> pool_;
+    std::unique_ptr<DatabaseConnection> connection_;
+    std::chrono::steady_clock::time_point leasedAt_;
+    // A routed write lease stamps its affinity's last write when released
+    std::shared_ptr<std::atomic<int64_t>> lastWriteMicros_;
+
+    friend class ConnectionRouter;
+
+public:
+    PooledConnection() = default;
+    PooledConnection(std::weak_ptr<ConnectionPool> pool, std::unique_ptr<DatabaseConnection> connection)
+        : pool_(std::move(pool)), connection_(std::move(connection)), leasedAt_(std::chrono::steady_clock::now()) {}
+    
+    ~PooledConnection() { release(); }
+
+    PooledConnection(PooledConnection&& other) noexcept = default;
+    PooledConnection& operator=(PooledConnection&& other) noexcept {
+        if (this != &other) {
+            release();
+            pool_ = std::move(other.pool_);
+            connection_ = std::move(other.connection_);
+            leasedAt_ = other.leasedAt_;
+            lastWriteMicros_ = std::move(other.lastWriteMicros_);
+        }
+        return *this;
+    }
+    PooledConnection(const PooledConnection&) = delete;
+    PooledConnection& operator=(const PooledConnection&) = delete;
+
+    DatabaseConnection* get() const { return connection_.get(); }
+    DatabaseConnection* operator->() const { return connection_.get(); }
+    DatabaseConnection& operator*() const { return *connection_; }
+    explicit operator bool() const { return connection_ != nullptr; }
+
+    // Return the connection early
+    void release();
+};
+
+// Connection pool configuration
+struct ConnectionPoolConfig {
+    std::string host;
+    std::string username;
+    std::string password;
+    std::string database;
+    int port = 3306;
+    int minConnections = 2;
+    int maxConnections = 10;
+    std::chrono::milliseconds acquireTimeout{500};
+    std::chrono::seconds healthCheckInterval{30};
+};
+
+// Bounded connection pool.
+// Opens minConnections eagerly on warmUp(), grows on demand up to
+// maxConnections, and validates idle connections with ping() from a
+// background thread. acquire() blocks for at most acquireTimeout and then
+// throws Utils::LockTimeoutException. Own pools through std::shared_ptr
+// (std::make_shared): leases find their way back through a weak_ptr.
+class ConnectionPool : public std::enable_shared_from_this<ConnectionPool> {
+public:
+    struct Stats {
+        int idleConnections;
+        int openConnections;
+        int maxConnections;
+        uint64_t acquireTimeouts;
+        uint64_t failedHealthChecks;
+        Utils::LatencyHistogram::Snapshot waitTime;  // microseconds spent in acquire()
+        Utils::LatencyHistogram::Snapshot leaseTime; // microseconds a lease was held
+    };
+
+private:
+    ConnectionPoolConfig config_;
+    std::vector<std::unique_ptr<DatabaseConnection>> idle_; // LIFO keeps hot connections hot
+    int openConnections_;
+    bool closed_; // set by shutdown(); released connections are then dropped
     mutable std::mutex mutex_;
     std::condition_variable condition_;
+    
+    // Health checking
+    std::atomic<bool> running_;
+    std::thread healthThread_;
+    std::mutex healthMutex_;
+    std::condition_variable healthCondition_;
+    
+    // Metrics
+    Utils::LatencyHistogram waitTime_;
+    Utils::LatencyHistogram leaseTime_;
+    std::atomic<uint64_t> acquireTimeouts_;
+    std::atomic<uint64_t> failedHealthChecks_;
+    Utils::ScopedCollector metricsCollector_; // exports getStats() on scrape
+
+    friend class PooledConnection;
 
 public:
+    explicit ConnectionPool(const ConnectionPoolConfig& config);
     ConnectionPool(const std::string& host, const std::string& username,
                   const std::string& password, const std::string& database,
                   int port = 3306, int maxConnections = 10);
     
     ~ConnectionPool();
 
-    std::unique_ptr<DatabaseConnection> getConnection();
-    void returnConnection(std::unique_ptr<DatabaseConnection> connection);
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // Open minConnections up front and start the health checker
+    bool warmUp();
+    void shutdown();
+
+    PooledConnection acquire();
+    PooledConnection acquire(std::chrono::milliseconds timeout);
+    // An idle connection, or a new one if the pool may still grow; an empty
+    // lease instead of waiting when neither is possible
+    PooledConnection tryAcquire();
+    
+    // Waits for a free connection on Utils::Executors::io(), not on the caller
+    Utils::Task<PooledConnection> acquireTask();
     
     int getAvailableConnections() const;
-    int getTotalConnections() const { return maxConnections_; }
+    int getOpenConnections() const;
+    int getTotalConnections() const { return config_.maxConnections; }
+    const ConnectionPoolConfig& getConfig() const { return config_; }
+    Stats getStats() const;
+
+private:
+    std::unique_ptr<DatabaseConnection> openConnection();
+    void release(std::unique_ptr<DatabaseConnection> connection,
+                 std::chrono::steady_clock::time_point leasedAt);
+    void healthWorker();
+    void validateIdleConnections();
+    void collectMetrics(Utils::MetricsWriter& out) const;
+};
+
+template<typename RowFn>
+size_t DatabaseConnection::forEachRow(const std::string& query, RowFn&& onRow) {
+    ResultCursor cursor = openCursor(query);
+    size_t rows = 0;
+    while (cursor.next()) {
+        onRow(cursor.row());
+        ++rows;
+    }
+    return rows;
+}
+
+inline void PooledConnection::release() {
+    if (connection_) {
+        if (std::shared_ptr<ConnectionPool> pool = pool_.lock()) {
+            pool->release(std::move(connection_), leasedAt_);
+        }
+        connection_.reset();
+    }
+    pool_.reset();
+    if (const std::shared_ptr<std::atomic<int64_t>> lastWrite = std::move(lastWriteMicros_)) {
+        // What the lease wrote only starts reaching the replicas now
+        lastWrite->store(std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::steady_clock::now().time_since_epoch()).count(),
+                         std::memory_order_release);
+    }
+}
+
+// How an operation uses its lease
+enum class QueryIntent {
+    Read,  // may be served by a replica within the lag bound
+    Write  // always the primary
+};
+
+// One primary and any number of read replicas
+struct ReplicatedPoolConfig {
+    ConnectionPoolConfig primary;
+    std::vector<ConnectionPoolConfig> replicas;
+    std::chrono::milliseconds maxReplicationLag{1000};
+    std::chrono::milliseconds lagCheckInterval{250};
+    // Run on each replica; returns its lag in seconds, NULL while the applier
+    // is stopped. Replace it with a heartbeat-table query where
+    // performance_schema is unavailable.
+    std::string lagQuery =
+        "SELECT IF(SUM(SERVICE_STATE <> 'ON') > 0, NULL, "
+        "COALESCE(MAX(IF(APPLYING_TRANSACTION <> '', TIMESTAMPDIFF(MICROSECOND, "
+        "APPLYING_TRANSACTION_ORIGINAL_COMMIT_TIMESTAMP, NOW(6)), 0)), 0) / 1000000) "
+        "FROM performance_schema.replication_applier_status_by_worker";
+};
+
+// Routes leases between the primary pool and replica pools.
+// Writes always lease from the primary. Reads go round robin to a replica
+// whose lag is within the bound, and fall back to the primary when none
+// qualifies or every qualifying replica's pool is exhausted. A background
+// thread probes each replica every lagCheckInterval; a replica counts as
+// lagging by its last measured lag plus the age of that measurement, so a
+// replica whose probes stall or fail drops out on its own.
+//
+// Read-your-writes follows an affinity state: while a PrimaryAffinity on it
+// is held (every routed Transaction and batch write takes one), and for
+// maxReplicationLag after one or a write lease is released, reads
+// under that state stay on the primary. Each thread has its own state. A
+// coroutine resumes on whichever io() thread is free, so a task that reads
+// its own writes across co_await carries a Session and enters it with a
+// SessionScope around each step; a PrimaryAffinity always releases the state
+// it pinned, whichever thread drops it.
+class ConnectionRouter {
+public:
+    struct ReplicaStats {
+        std::string name;                // host:port
+        bool eligible;
+        std::chrono::microseconds lag;   // -1 if unknown
+        ConnectionPool::Stats pool;
+    };
+
+    struct Stats {
+        uint64_t writes;
+        uint64_t replicaReads;
+        uint64_t primaryReadsPinned;     // read-your-writes
+        uint64_t primaryReadsLagging;    // no replica within the bound
+        uint64_t primaryReadsExhausted;  // replicas within the bound had no free connection
+        std::vector<ReplicaStats> replicas;
+    };
+
+    // Read-your-writes state: open affinities and the last write, in
+    // steady_clock microseconds. Atomic, as a Session may be entered on two
+    // threads at once.
+    struct AffinityState {
+        std::atomic<int> depth{0};
+        std::atomic<int64_t> lastWriteMicros{std::numeric_limits<int64_t>::min()};
+    };
+
+    // Read-your-writes context not tied to a thread, e.g. one per request
+    using Session = std::shared_ptr<AffinityState>;
+    static Session newSession() { return std::make_shared<AffinityState>(); }
+
+    // Makes `session` the calling thread's state until destroyed. Synchronous:
+    // construct and destroy it on one thread, never across a co_await.
+    class SessionScope {
+    private:
+        Session session_;
+        const Session* previous_;
+
+    public:
+        explicit SessionScope(Session session);
+        ~SessionScope();
+
+        SessionScope(const SessionScope&) = delete;
+        SessionScope& operator=(const SessionScope&) = delete;
+    };
+
+    // Keeps reads under the state it pinned on the primary until released
+    class PrimaryAffinity {
+    private:
+        std::shared_ptr<AffinityState> state_;
+
+    public:
+        PrimaryAffinity() = default;
+        ~PrimaryAffinity() { release(); }
+
+        PrimaryAffinity(PrimaryAffinity&& other) noexcept : state_(std::move(other.state_)) {}
+        PrimaryAffinity& operator=(PrimaryAffinity&& other) noexcept {
+            if (this != &other) {
+                release();
+                state_ = std::move(other.state_);
+            }
+            return *this;
+        }
+        PrimaryAffinity(const PrimaryAffinity&) = delete;
+        PrimaryAffinity& operator=(const PrimaryAffinity&) = delete;
+
+        void release();
+
+    private:
+        friend class ConnectionRouter;
+        explicit PrimaryAffinity(std::shared_ptr<AffinityState> state) : state_(std::move(state)) {}
+    };
 
 private:
-    void initializePool();
+    struct Replica {
+        std::shared_ptr<ConnectionPool> pool;
+        std::string name;
+        std::atomic<int64_t> lagMicros{-1};   // last measurement; -1 if the probe failed
+        std::atomic<int64_t> measuredAt{0};   // steady_clock ticks of that measurement
+    };
+
+    ReplicatedPoolConfig config_;
+    std::shared_ptr<ConnectionPool> primary_;
+    std::vector<std::unique_ptr<Replica>> replicas_;
+    std::atomic<size_t> nextReplica_;
+    
+    // Lag monitor
+    std::atomic<bool> running_;
+    std::thread lagThread_;
+    std::mutex lagMutex_;
+    std::condition_variable lagCondition_;
+    
+    // Metrics
+    std::atomic<uint64_t> writes_;
+    std::atomic<uint64_t> replicaReads_;
+    std::atomic<uint64_t> primaryReadsPinned_;
+    std::atomic<uint64_t> primaryReadsLagging_;
+    std::atomic<uint64_t> primaryReadsExhausted_;
+    Utils::ScopedCollector metricsCollector_;
+
+public:
+    explicit ConnectionRouter(const ReplicatedPoolConfig& config);
+    ~ConnectionRouter();
+
+    ConnectionRouter(const ConnectionRouter&) = delete;
+    ConnectionRouter& operator=(const ConnectionRouter&) = delete;
+
+    // Warms every pool, measures every replica once, then starts the lag
+    // monitor. False if the primary could not open its minimum; replicas that
+    // fail to warm up are simply skipped by reads until they recover.
+    bool warmUp();
+    void shutdown();
+
+    PooledConnection acquire(QueryIntent intent);
+    // A read with its own bound, tighter or looser than maxReplicationLag
+    PooledConnection acquireRead(std::chrono::milliseconds maxLag);
+    
+    // Pins the calling thread's state, or the entered Session's
+    PrimaryAffinity pinToPrimary();
+
+    const std::shared_ptr<ConnectionPool>& getPrimary() const { return primary_; }
+    size_t getReplicaCount() const { return replicas_.size(); }
+    Stats getStats() const;
+
+private:
+    bool isEligible(const Replica& replica, std::chrono::microseconds maxLag,
+                    std::chrono::steady_clock::time_point now) const;
+    void measureLag(Replica& replica);
+    void lagWorker();
+    void collectMetrics(Utils::MetricsWriter& out) const;
 };
 
 // Singleton for database connection pool
 class DatabaseManager {
 private:
-    static std::unique_ptr<ConnectionPool> pool_;
+    static std::shared_ptr<ConnectionPool> pool_;
+    static std::shared_ptr<ConnectionRouter> router_;
     static std::mutex mutex_;
 
 public:
+    // Creates the pool and warms it up before publishing it; a pool or
+    // router set up earlier is then shut down
+    static bool initialize(const ConnectionPoolConfig& config);
     static bool initialize(const std::string& host, const std::string& username,
                          const std::string& password, const std::string& database,
-                         int port = 3306, int maxConnections = 10);
+                         int port = 3306, int maxConnections = 10, int minConnections = 2);
+    
+    // Primary plus read replicas; getPool() is then the primary's pool.
+    // Published and replaced the same way
+    static bool initialize(const ReplicatedPoolConfig& config);
     
-    static std::unique_ptr<DatabaseConnection> getConnection();
+    static PooledConnection getConnection();
+    // Routed through the replicas when initialized with them, else the pool
+    static PooledConnection getConnection(QueryIntent intent);
+    static std::shared_ptr<ConnectionPool> getPool();
+    static std::shared_ptr<ConnectionRouter> getRouter();
     static void shutdown();
     
     static bool isInitialized();
+
+private:
+    // Publish `pool` and `router`, then shut down the ones they replace
+    static void install(std::shared_ptr<ConnectionPool> pool, std::shared_ptr<ConnectionRouter> router);
 };
 
 } // namespace Database
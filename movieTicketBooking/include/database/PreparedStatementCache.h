@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <mysql/mysql.h>
+
+namespace MovieBooking {
+namespace Utils {
+class LatencyHistogram;
+}
+namespace Database {
+
+// Per-connection LRU cache of server-side prepared statements, keyed by SQL
+// template. Not synchronized: the owning DatabaseConnection's mutex guards it.
+// Evicted statements are closed through the supplied closer.
+class PreparedStatementCache {
+public:
+    // A statement handle and its template's latency histogram, resolved once
+    // when the statement is prepared
+    struct Statement {
+        MYSQL_STMT* handle = nullptr;
+        Utils::LatencyHistogram* latency = nullptr;
+    };
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        size_t size;
+    };
+
+private:
+    using Entry = std::pair<std::string, Statement>;
+
+    std::list<Entry> entries_; // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    size_t capacity_;
+    std::function<void(MYSQL_STMT*)> closer_;
+    uint64_t hits_;
+    uint64_t misses_;
+    uint64_t evictions_;
+
+public:
+    PreparedStatementCache(size_t capacity, std::function<void(MYSQL_STMT*)> closer)
+        : capacity_(capacity), closer_(std::move(closer)), hits_(0), misses_(0), evictions_(0) {}
+
+    ~PreparedStatementCache() { clear(); }
+
+    PreparedStatementCache(const PreparedStatementCache&) = delete;
+    PreparedStatementCache& operator=(const PreparedStatementCache&) = delete;
+
+    // Cached statement for `sqlTemplate`, or nullptr (counted as a miss)
+    const Statement* find(const std::string& sqlTemplate) {
+        auto it = index_.find(sqlTemplate);
+        if (it == index_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+        entries_.splice(entries_.begin(), entries_, it->second);
+        ++hits_;
+        return &it->second->second;
+    }
+
+    void insert(const std::string& sqlTemplate, Statement stmt) {
+        auto it = index_.find(sqlTemplate);
+        if (it != index_.end()) {
+            if (it->second->second.handle != stmt.handle) {
+                closer_(it->second->second.handle);
+            }
+            it->second->second = stmt;
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+        entries_.emplace_front(sqlTemplate, stmt);
+        index_.emplace(sqlTemplate, entries_.begin());
+        while (entries_.size() > capacity_) {
+            closer_(entries_.back().second.handle);
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+            ++evictions_;
+        }
+    }
+
+    // Drop and close one statement, e.g. after the server invalidated it
+    void erase(const std::string& sqlTemplate) {
+        auto it = index_.find(sqlTemplate);
+        if (it == index_.end()) {
+            return;
+        }
+        closer_(it->second->second.handle);
+        entries_.erase(it->second);
+        index_.erase(it);
+    }
+
+    // Close everything; required after a reconnect, since statements are server-side
+    void clear() {
+        for (auto& entry : entries_) {
+            closer_(entry.second.handle);
+        }
+        entries_.clear();
+        index_.clear();
+    }
+
+    void setCapacity(size_t capacity) {
+        capacity_ = capacity;
+        while (entries_.size() > capacity_) {
+            closer_(entries_.back().second.handle);
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+            ++evictions_;
+        }
+    }
+
+    Stats getStats() const { return {hits_, misses_, evictions_, entries_.size()}; }
+};
+
+} // namespace Database
+} // namespace MovieBooking
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <mysql/mysql.h>
+
+namespace MovieBooking {
+namespace Database {
+
+// Typed, non-owning view of the current row of a ResultCursor.
+// Accessors parse straight out of the MySQL row buffer; nothing is copied
+// into std::string. String views are only valid until the cursor advances.
+class RowView {
+private:
+    MYSQL_ROW row_;
+    unsigned long* lengths_;
+    unsigned columnCount_;
+
+public:
+    RowView() : row_(nullptr), lengths_(nullptr), columnCount_(0) {}
+    RowView(MYSQL_ROW row, unsigned long* lengths, unsigned columnCount)
+        : row_(row), lengths_(lengths), columnCount_(columnCount) {}
+
+    unsigned size() const { return columnCount_; }
+    bool isNull(unsigned column) const { return row_[column] == nullptr; }
+
+    std::string_view getStringView(unsigned column) const {
+        return isNull(column) ? std::string_view() : std::string_view(row_[column], lengths_[column]);
+    }
+
+    std::string getString(unsigned column) const { return std::string(getStringView(column)); }
+
+    int getInt(unsigned column, int defaultValue = 0) const { return parse(column, defaultValue); }
+    int64_t getInt64(unsigned column, int64_t defaultValue = 0) const { return parse(column, defaultValue); }
+    double getDouble(unsigned column, double defaultValue = 0.0) const { return parse(column, defaultValue); }
+
+    bool getBool(unsigned column, bool defaultValue = false) const {
+        return isNull(column) ? defaultValue : getInt(column) != 0;
+    }
+
+    // DATETIME / TIMESTAMP columns ("YYYY-MM-DD HH:MM:SS[.ffffff]"), in local time
+    std::chrono::system_clock::time_point getTimePoint(unsigned column) const {
+        const std::string_view text = getStringView(column);
+        if (text.size() < 19) {
+            return {};
+        }
+        std::tm tm{};
+        tm.tm_year = digits(text, 0, 4) - 1900;
+        tm.tm_mon = digits(text, 5, 2) - 1;
+        tm.tm_mday = digits(text, 8, 2);
+        tm.tm_hour = digits(text, 11, 2);
+        tm.tm_min = digits(text, 14, 2);
+        tm.tm_sec = digits(text, 17, 2);
+        tm.tm_isdst = -1;
+        return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+    }
+
+private:
+    template<typename N>
+    N parse(unsigned column, N defaultValue) const {
+        if (isNull(column)) {
+            return defaultValue;
+        }
+        N value{};
+        const char* begin = row_[column];
+        const auto result = std::from_chars(begin, begin + lengths_[column], value);
+        return result.ec == std::errc() ? value : defaultValue;
+    }
+
+    static int digits(std::string_view text, size_t offset, size_t count) {
+        int value = 0;
+        std::from_chars(text.data() + offset, text.data() + offset + count, value);
+        return value;
+    }
+};
+
+// Forward-only streaming cursor over a query result (mysql_use_result).
+// Rows are pulled from the server one at a time. The cursor holds the
+// connection's lock until it is destroyed, because no other statement may
+// run on a connection while a streamed result is open.
+class ResultCursor {
+private:
+    std::unique_lock<std::mutex> lock_;
+    MYSQL_RES* result_;
+    unsigned columnCount_;
+    RowView current_;
+
+public:
+    ResultCursor() : result_(nullptr), columnCount_(0) {}
+    ResultCursor(std::unique_lock<std::mutex> lock, MYSQL_RES* result)
+        : lock_(std::move(lock)), result_(result),
+          columnCount_(result ? mysql_num_fields(result) : 0) {}
+
+    ~ResultCursor() {
+        if (result_) {
+            mysql_free_result(result_); // drains any unread rows
+        }
+    }
+
+    ResultCursor(ResultCursor&& other) noexcept
+        : lock_(std::move(other.lock_)), result_(other.result_),
+          columnCount_(other.columnCount_), current_(other.current_) {
+        other.result_ = nullptr;
+    }
+    ResultCursor& operator=(ResultCursor&&) = delete;
+    ResultCursor(const ResultCursor&) = delete;
+    ResultCursor& operator=(const ResultCursor&) = delete;
+
+    bool isValid() const { return result_ != nullptr; }
+    unsigned getColumnCount() const { return columnCount_; }
+
+    // Advance to the next row; false at end of result
+    bool next() {
+        if (!result_) {
+            return false;
+        }
+        MYSQL_ROW row = mysql_fetch_row(result_);
+        if (!row) {
+            return false;
+        }
+        current_ = RowView(row, mysql_fetch_lengths(result_), columnCount_);
+        return true;
+    }
+
+    const RowView& row() const { return current_; }
+};
+
+} // namespace Database
+} // namespace MovieBooking
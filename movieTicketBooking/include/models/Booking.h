@@ -8,6 +8,13 @@
 #include <atomic>
 
 namespace MovieBooking {
+namespace Database {
+class RowView;
+}
+namespace Utils {
+class JsonWriter;
+}
+
 namespace Models {
 
 enum class BookingStatus {
@@ -43,6 +50,7 @@ public:
 
     // Serialization
     std::string toJson() const;
+    void writeJson(Utils::JsonWriter& writer) const;
 };
 
 class Booking {
@@ -104,9 +112,11 @@ public:
 
     // Serialization
     std::string toJson() const;
+    void writeJson(Utils::JsonWriter& writer) const;
     
     // Factory methods
     static std::unique_ptr<Booking> createFromDbRow(const std::vector<std::string>& row);
+    static std::unique_ptr<Booking> createFromDbRow(const Database::RowView& row);
     static std::unique_ptr<Booking> createPending(int userId, int showId, 
                                                   const std::vector<int>& showSeatIds,
                                                   double totalAmount, int lockDurationMinutes = 15);
@@ -6,6 +6,13 @@
 #include <vector>
 
 namespace MovieBooking {
+namespace Database {
+class RowView;
+}
+namespace Utils {
+class JsonWriter;
+}
+
 namespace Models {
 
 enum class MovieStatus {
@@ -66,10 +73,12 @@ public:
 
     // Serialization
     std::string toJson() const;
+    void writeJson(Utils::JsonWriter& writer) const;
     
     // Factory methods
     static std::unique_ptr<Movie> createFromJson(const std::string& json);
     static std::unique_ptr<Movie> createFromDbRow(const std::vector<std::string>& row);
+    static std::unique_ptr<Movie> createFromDbRow(const Database::RowView& row);
 };
 
 } // namespace Models
@@ -6,6 +6,13 @@
 #include <chrono>
 
 namespace MovieBooking {
+namespace Database {
+class RowView;
+}
+namespace Utils {
+class JsonWriter;
+}
+
 namespace Models {
 
 enum class SeatType {
@@ -50,6 +57,7 @@ public:
 
     // Serialization
     std::string toJson() const;
+    void writeJson(Utils::JsonWriter& writer) const;
 };
 
 class Screen {
@@ -84,9 +92,11 @@ public:
 
     // Serialization
     std::string toJson() const;
+    void writeJson(Utils::JsonWriter& writer) const;
     
     // Factory methods
     static std::unique_ptr<Screen> createFromDbRow(const std::vector<std::string>& row);
+    static std::unique_ptr<Screen> createFromDbRow(const Database::RowView& row);
 };
 
 } // namespace Models
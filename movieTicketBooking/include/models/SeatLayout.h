@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Screen.h"
+
+namespace MovieBooking {
+namespace Models {
+
+// Ranking for best-available allocation. Lower scores win:
+//   centerWeight * dx^2 + rowWeight * dy^2
+// with dx the block centre's distance from the row centre and dy the row's
+// distance from idealRowFraction (0 = front row, 1 = back row), each
+// normalized to [0, 1].
+struct BestSeatPreferences {
+    std::optional<SeatType> seatType; // every seat of the block must be this type
+    double idealRowFraction = 0.6;
+    double rowWeight = 1.0;
+    double centerWeight = 1.0;
+};
+
+// Physical seat grid of one screen, built once from the screen's seats and
+// shared by every show on it. Row 0 is nearest the screen; a position is a
+// seat number minus one, so positions without a usable seat are gaps
+// (aisles, removed or unavailable seats) that no block may span.
+//
+// Per row, which positions hold a seat, and which hold each seat type, are
+// kept as bitmasks (bit i = position i) so an allocation is a few mask ANDs
+// and run scans per row.
+class SeatLayout {
+public:
+    static constexpr int kNoSeat = -1;
+    static constexpr size_t kSeatTypeCount = 4;
+    static constexpr size_t kBitsPerWord = 64;
+
+    struct Row {
+        std::string label;
+        std::vector<int> seatIds;                                   // by position; kNoSeat for gaps
+        std::vector<uint64_t> seatMask;                             // positions holding a usable seat
+        std::array<std::vector<uint64_t>, kSeatTypeCount> typeMask; // ... of each SeatType
+    };
+
+private:
+    std::vector<Row> rows_;
+    size_t width_; // positions per row
+
+public:
+    // The width starts from Screen::getSeatsPerRow() and grows to the highest
+    // seat number; rows are the distinct row labels, ordered "A" < "B" < ... <
+    // "Z" < "AA". Seats of other screens are ignored.
+    SeatLayout(const Screen& screen, const std::vector<Seat>& seats);
+
+    const std::vector<Row>& getRows() const { return rows_; }
+    size_t getRowCount() const { return rows_.size(); }
+    size_t getWidth() const { return width_; }
+    size_t getWordsPerRow() const { return (width_ + kBitsPerWord - 1) / kBitsPerWord; }
+};
+
+} // namespace Models
+} // namespace MovieBooking
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace MovieBooking {
+namespace Models {
+
+enum class ShowSeatStatus : uint8_t {
+    AVAILABLE = 0,
+    LOCKED = 1,
+    BOOKED = 2,
+    MAINTENANCE = 3
+};
+
+// Packed seat status store for a single show.
+// Each seat takes 2 bits, so one 64-bit word holds 32 seats and a 400-seat
+// screen fits in 13 words. Seats are addressed by ordinal (their position in
+// the show's seat list), not by database id.
+class SeatStateMap {
+public:
+    static constexpr size_t kBitsPerSeat = 2;
+    static constexpr size_t kSeatsPerWord = 64 / kBitsPerSeat;
+
+private:
+    static constexpr uint64_t kLowBits = 0x5555555555555555ULL;
+    static constexpr uint64_t kSeatMask = 0x3ULL;
+
+    size_t seatCount_;
+    size_t wordCount_;
+    std::unique_ptr<std::atomic<uint64_t>[]> words_;
+
+public:
+    explicit SeatStateMap(size_t seatCount = 0, ShowSeatStatus initial = ShowSeatStatus::AVAILABLE)
+        : seatCount_(seatCount),
+          wordCount_((seatCount + kSeatsPerWord - 1) / kSeatsPerWord),
+          words_(new std::atomic<uint64_t>[wordCount_]) {
+        const uint64_t fill = kLowBits * static_cast<uint64_t>(initial);
+        for (size_t i = 0; i < wordCount_; ++i) {
+            words_[i].store(fill, std::memory_order_relaxed);
+        }
+    }
+
+    SeatStateMap(SeatStateMap&&) noexcept = default;
+    SeatStateMap& operator=(SeatStateMap&&) noexcept = default;
+
+    size_t size() const { return seatCount_; }
+    size_t wordCount() const { return wordCount_; }
+
+    // Raw word access, for callers that scan whole words (e.g. row scans)
+    uint64_t loadWord(size_t wordIndex) const {
+        return words_[wordIndex].load(std::memory_order_acquire);
+    }
+
+    ShowSeatStatus get(size_t ordinal) const {
+        const uint64_t word = loadWord(ordinal / kSeatsPerWord);
+        return static_cast<ShowSeatStatus>((word >> shiftOf(ordinal)) & kSeatMask);
+    }
+
+    void set(size_t ordinal, ShowSeatStatus status) {
+        std::atomic<uint64_t>& word = words_[ordinal / kSeatsPerWord];
+        const unsigned shift = shiftOf(ordinal);
+        uint64_t current = word.load(std::memory_order_relaxed);
+        uint64_t desired;
+        do {
+            desired = (current & ~(kSeatMask << shift)) |
+                      (static_cast<uint64_t>(status) << shift);
+        } while (!word.compare_exchange_weak(current, desired, std::memory_order_acq_rel,
+                                             std::memory_order_relaxed));
+    }
+
+    // Moves one seat from `expected` to `desired`. Fails only if the seat is not
+    // in `expected`; concurrent changes to neighbouring seats in the same word
+    // are retried transparently.
+    bool compareExchange(size_t ordinal, ShowSeatStatus expected, ShowSeatStatus desired) {
+        std::atomic<uint64_t>& word = words_[ordinal / kSeatsPerWord];
+        const unsigned shift = shiftOf(ordinal);
+        uint64_t current = word.load(std::memory_order_acquire);
+        for (;;) {
+            if (((current >> shift) & kSeatMask) != static_cast<uint64_t>(expected)) {
+                return false;
+            }
+            const uint64_t next = (current & ~(kSeatMask << shift)) |
+                                  (static_cast<uint64_t>(desired) << shift);
+            if (word.compare_exchange_weak(current, next, std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+                return true;
+            }
+        }
+    }
+
+    // All-or-nothing transition of a set of seats from `from` to `to`.
+    // Seats sharing a word are claimed with a single compare-and-swap, so callers
+    // with disjoint seat sets never wait on each other. If any seat is not in
+    // `from`, the words this call already claimed are rolled back, the ordinals
+    // that were not in `from` are appended to `conflicts`, and false is returned.
+    // `ordinals` must be sorted and free of duplicates.
+    bool tryTransitionAll(const std::vector<size_t>& ordinals, ShowSeatStatus from, ShowSeatStatus to,
+                          std::vector<size_t>& conflicts) {
+        std::vector<std::pair<size_t, uint64_t>> claimed; // word index, seat mask
+        size_t begin = 0;
+        while (begin < ordinals.size()) {
+            const size_t wordIndex = ordinals[begin] / kSeatsPerWord;
+            size_t end = begin;
+            uint64_t seatMask = 0;
+            while (end < ordinals.size() && ordinals[end] / kSeatsPerWord == wordIndex) {
+                seatMask |= kSeatMask << shiftOf(ordinals[end]);
+                ++end;
+            }
+
+            const uint64_t conflictMask = claimWord(wordIndex, seatMask, from, to);
+            if (conflictMask != 0) {
+                appendOrdinals(wordIndex, conflictMask, conflicts, conflicts.size() + kSeatsPerWord);
+                collectConflicts(ordinals, end, from, conflicts);
+                for (const auto& [claimedWord, claimedMask] : claimed) {
+                    restoreWord(claimedWord, claimedMask, to, from);
+                }
+                return false;
+            }
+            claimed.emplace_back(wordIndex, seatMask);
+            begin = end;
+        }
+        return true;
+    }
+
+    // Number of seats in `status`. One popcount per 32 seats.
+    size_t count(ShowSeatStatus status) const {
+        size_t total = 0;
+        for (size_t i = 0; i < wordCount_; ++i) {
+            total += static_cast<size_t>(std::popcount(matchMask(i, status)));
+        }
+        return total;
+    }
+
+    // Ordinals of every seat in `status`, in ascending order
+    std::vector<size_t> ordinalsWithStatus(ShowSeatStatus status) const {
+        std::vector<size_t> ordinals;
+        ordinals.reserve(count(status));
+        for (size_t i = 0; i < wordCount_; ++i) {
+            appendOrdinals(i, matchMask(i, status), ordinals, seatCount_);
+        }
+        return ordinals;
+    }
+
+    // First `n` available ordinals, or fewer if the show does not have `n` free seats.
+    // Whole words with no free seat are skipped with a single test.
+    std::vector<size_t> findAvailable(size_t n) const {
+        std::vector<size_t> ordinals;
+        ordinals.reserve(n);
+        for (size_t i = 0; i < wordCount_ && ordinals.size() < n; ++i) {
+            appendOrdinals(i, matchMask(i, ShowSeatStatus::AVAILABLE), ordinals, n);
+        }
+        return ordinals;
+    }
+
+    // One bit (at the low bit of each 2-bit pair) per seat of word `wordIndex`
+    // whose status equals `status`. Padding seats past size() never match.
+    uint64_t matchMask(size_t wordIndex, ShowSeatStatus status) const {
+        const uint64_t diff = loadWord(wordIndex) ^ (kLowBits * static_cast<uint64_t>(status));
+        return ~(diff | (diff >> 1)) & kLowBits & validMask(wordIndex);
+    }
+
+private:
+    static unsigned shiftOf(size_t ordinal) {
+        return static_cast<unsigned>((ordinal % kSeatsPerWord) * kBitsPerSeat);
+    }
+
+    uint64_t validMask(size_t wordIndex) const {
+        const size_t seatsInWord = seatCount_ - wordIndex * kSeatsPerWord;
+        if (seatsInWord >= kSeatsPerWord) {
+            return ~0ULL;
+        }
+        return (1ULL << (seatsInWord * kBitsPerSeat)) - 1;
+    }
+
+    // CAS every seat selected by `seatMask` in one word from `from` to `to`.
+    // Returns 0 on success. Otherwise nothing is written and the result marks
+    // (one low bit per seat) the selected seats that were not in `from`.
+    uint64_t claimWord(size_t wordIndex, uint64_t seatMask, ShowSeatStatus from, ShowSeatStatus to) {
+        std::atomic<uint64_t>& word = words_[wordIndex];
+        const uint64_t fromBits = (kLowBits * static_cast<uint64_t>(from)) & seatMask;
+        const uint64_t toBits = (kLowBits * static_cast<uint64_t>(to)) & seatMask;
+        uint64_t current = word.load(std::memory_order_acquire);
+        for (;;) {
+            const uint64_t diff = (current ^ fromBits) & seatMask;
+            if (diff != 0) {
+                return (diff | (diff >> 1)) & kLowBits;
+            }
+            if (word.compare_exchange_weak(current, (current & ~seatMask) | toBits,
+                                           std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return 0;
+            }
+        }
+    }
+
+    // Undo a successful claimWord. Only seats still in `to` are restored, so a
+    // seat another actor has moved on since (e.g. an expiry sweep) is left alone.
+    void restoreWord(size_t wordIndex, uint64_t seatMask, ShowSeatStatus to, ShowSeatStatus from) {
+        for (uint64_t mask = seatMask & kLowBits; mask != 0; mask &= mask - 1) {
+            const size_t bit = static_cast<size_t>(std::countr_zero(mask));
+            compareExchange(wordIndex * kSeatsPerWord + bit / kBitsPerSeat, to, from);
+        }
+    }
+
+    void collectConflicts(const std::vector<size_t>& ordinals, size_t begin, ShowSeatStatus from,
+                          std::vector<size_t>& conflicts) const {
+        for (size_t i = begin; i < ordinals.size(); ++i) {
+            if (get(ordinals[i]) != from) {
+                conflicts.push_back(ordinals[i]);
+            }
+        }
+    }
+
+    static void appendOrdinals(size_t wordIndex, uint64_t mask, std::vector<size_t>& out, size_t limit) {
+        while (mask != 0 && out.size() < limit) {
+            const unsigned bit = static_cast<unsigned>(std::countr_zero(mask));
+            out.push_back(wordIndex * kSeatsPerWord + bit / kBitsPerSeat);
+            mask &= mask - 1;
+        }
+    }
+};
+
+} // namespace Models
+} // namespace MovieBooking
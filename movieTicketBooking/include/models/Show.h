@@ -5,11 +5,27 @@
 #include <memory>
 #include <chrono>
 #include <mutex>
+#include <shared_mutex>
 #include <atomic>
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
 
 #include "Screen.h"
+#include "SeatLayout.h"
+#include "SeatStateMap.h"
+#include "../utils/BookingError.h"
+#include "../utils/EventBus.h"
+#include "../utils/Metrics.h"
 
 namespace MovieBooking {
+namespace Database {
+class RowView;
+}
+namespace Utils {
+class JsonWriter;
+}
+
 namespace Models {
 
 enum class ShowStatus {
@@ -19,56 +35,102 @@ enum class ShowStatus {
     IN_PROGRESS
 };
 
-enum class ShowSeatStatus {
-    AVAILABLE,
-    LOCKED,
-    BOOKED,
-    MAINTENANCE
+class Show;
+
+// Show seat row as loaded from the database, before it is packed into a Show
+struct ShowSeatRecord {
+    int id;
+    int showId;
+    int seatId;
+    ShowSeatStatus status;
+    double price;
+    int bookingId;
+    std::chrono::system_clock::time_point lockedUntil;
+
+    ShowSeatRecord(int id, int showId, int seatId, ShowSeatStatus status = ShowSeatStatus::AVAILABLE,
+                   double price = 0.0, int bookingId = -1,
+                   const std::chrono::system_clock::time_point& lockedUntil = {})
+        : id(id), showId(showId), seatId(seatId), status(status), price(price),
+          bookingId(bookingId), lockedUntil(lockedUntil) {}
+
+    // Factory methods
+    static ShowSeatRecord createFromDbRow(const std::vector<std::string>& row);
+    static ShowSeatRecord createFromDbRow(const Database::RowView& row);
 };
 
+// State of one seat as carried by a SeatDelta
+struct SeatChange {
+    int seatId;
+    ShowSeatStatus status;
+    int bookingId;
+    std::chrono::system_clock::time_point lockedUntil;
+};
+
+// Seats changed by one successful lockSeats, bookSeats or releaseLockedSeats,
+// published on Show::seatEvents(). Each seat carries its state as read when
+// the delta was published, and a show's deltas are published one at a time
+// in version order, so applying them in order converges on the show's state.
+struct SeatDelta {
+    int showId;
+    uint64_t version;   // +1 per delta of this show id, whichever instance published it
+    const Show* source; // the publishing show; only valid inside a handler
+    std::vector<SeatChange> seats;
+
+    // {"showId":..,"version":..,"seats":[[seatId,"L"],...]} with the codes of
+    // Show::writeCompactLayout
+    void writeJson(Utils::JsonWriter& writer) const;
+};
+
+// Seat versions of every show in the process, one counter per show id, so
+// instances loaded for the same show number their deltas from one sequence.
+// A show's deltas are numbered and published under its stripe's lock, which
+// keeps them in version order across instances.
+class SeatVersionSequence {
+private:
+    struct alignas(64) Stripe {
+        std::mutex mutex;
+        std::unordered_map<int, uint64_t> versions;
+    };
+    static constexpr size_t kStripeCount = 64;
+    Stripe stripes_[kStripeCount];
+
+    Stripe& stripeFor(int showId) { return stripes_[static_cast<uint32_t>(showId) % kStripeCount]; }
+
+public:
+    // Held while numbering and publishing one delta of `showId`
+    std::unique_lock<std::mutex> lock(int showId) { return std::unique_lock<std::mutex>(stripeFor(showId).mutex); }
+    // Next version of `showId`; the caller holds lock(showId)
+    uint64_t next(int showId) { return ++stripeFor(showId).versions[showId]; }
+};
+
+// Lightweight view of one seat inside a Show's packed seat store.
+// Cheap to copy; only valid while the owning Show is alive.
 class ShowSeat {
 private:
-    int id_;
-    int showId_;
-    int seatId_;
-    std::atomic<ShowSeatStatus> status_;
-    std::chrono::system_clock::time_point lockedUntil_;
-    int bookingId_;
-    double price_;
-    mutable std::mutex mutex_;
+    const Show* show_;
+    size_t ordinal_;
 
 public:
-    ShowSeat(int id, int showId, int seatId, ShowSeatStatus status = ShowSeatStatus::AVAILABLE,
-             double price = 0.0);
+    ShowSeat(const Show* show, size_t ordinal) : show_(show), ordinal_(ordinal) {}
 
     // Thread-safe getters
-    int getId() const { return id_; }
-    int getShowId() const { return showId_; }
-    int getSeatId() const { return seatId_; }
-    ShowSeatStatus getStatus() const { return status_.load(); }
-    std::chrono::system_clock::time_point getLockedUntil() const { 
-        std::lock_guard<std::mutex> lock(mutex_);
-        return lockedUntil_; 
-    }
-    int getBookingId() const { 
-        std::lock_guard<std::mutex> lock(mutex_);
-        return bookingId_; 
-    }
-    double getPrice() const { return price_; }
+    int getId() const;
+    int getShowId() const;
+    int getSeatId() const;
+    ShowSeatStatus getStatus() const;
+    std::chrono::system_clock::time_point getLockedUntil() const;
+    int getBookingId() const; // -1 if none; -2 while the seat is being booked or released
+    double getPrice() const;
+    size_t getOrdinal() const { return ordinal_; }
 
-    // Thread-safe operations
-    bool isAvailable() const;
+    // Thread-safe queries
+    bool isAvailable() const { return getStatus() == ShowSeatStatus::AVAILABLE; }
     bool canBeLocked(int lockDurationMinutes = 15) const;
-    bool lockSeat(int bookingId, int lockDurationMinutes = 15);
-    bool releaseLock();
-    bool bookSeat(int bookingId);
     
     // Utility methods
     std::string getStatusString() const;
     std::string toJson() const;
-
-    // Factory methods
-    static std::unique_ptr<ShowSeat> createFromDbRow(const std::vector<std::string>& row);
+    void writeJson(Utils::JsonWriter& writer) const;
 };
 
 class Show {
@@ -80,11 +142,51 @@ private:
     std::chrono::system_clock::time_point endTime_;
     double basePrice_;
     std::atomic<ShowStatus> status_;
-    std::vector<std::unique_ptr<ShowSeat>> showSeats_;
     std::chrono::system_clock::time_point createdAt_;
     std::chrono::system_clock::time_point updatedAt_;
     mutable std::shared_mutex mutex_;
 
+    // Seat storage, indexed by seat ordinal. Status is packed 2 bits per seat;
+    // the remaining per-seat fields live in one contiguous array.
+    //
+    // bookingId is the lock holder, and a seat leaves LOCKED only through
+    // whoever swaps it from the holder to kSeatClaimed: bookSeats for the
+    // holder, or releaseLockedSeats. A lock that expired and was taken by
+    // another booking therefore no longer matches the old holder, whatever the
+    // status bits went through in between.
+    static constexpr int kNoBooking = -1;
+    static constexpr int kSeatClaimed = -2;
+    struct SeatSlot {
+        int showSeatId = 0;
+        int seatId = 0;
+        double price = 0.0;
+        std::atomic<int> bookingId{-1};
+        std::atomic<std::chrono::system_clock::rep> lockedUntil{0};
+    };
+    SeatStateMap seatStates_;
+    std::unique_ptr<SeatSlot[]> seatSlots_;
+    std::unordered_map<int, size_t> seatOrdinals_; // seatId -> ordinal
+
+    // Ordinal of each layout position, rows one after another; kNoOrdinal
+    // where the layout has no seat of this show. Built on the first
+    // allocation over a layout and reused while the layout and seats stay.
+    static constexpr size_t kNoOrdinal = static_cast<size_t>(-1);
+    struct LayoutOrdinals {
+        const SeatLayout* layout = nullptr;
+        const SeatSlot* seats = nullptr;
+        std::vector<size_t> ordinals;
+    };
+    mutable std::mutex layoutOrdinalsMutex_;
+    mutable std::shared_ptr<const LayoutOrdinals> layoutOrdinals_;
+    
+    // Seat deltas are built and published under the show id's lock in
+    // seatVersions(), and only while the bus has subscribers, so reservations
+    // stay lock-free otherwise. seatVersion_ is the last version this
+    // instance published or applied.
+    std::atomic<uint64_t> seatVersion_{0};
+
+    friend class ShowSeat;
+
 public:
     Show(int id, int movieId, int screenId,
          const std::chrono::system_clock::time_point& startTime,
@@ -106,31 +208,301 @@ public:
     void setStatus(ShowStatus status) { status_.store(status); }
 
     // Seat management (thread-safe)
-    void addShowSeat(std::unique_ptr<ShowSeat> showSeat);
-    std::vector<ShowSeat*> getAvailableSeats() const;
-    std::vector<ShowSeat*> getLockedSeats() const;
-    std::vector<ShowSeat*> getBookedSeats() const;
-    ShowSeat* getShowSeatById(int seatId) const;
+    void loadShowSeats(const std::vector<ShowSeatRecord>& seats);
+    std::vector<ShowSeat> getAvailableSeats() const;
+    std::vector<ShowSeat> getLockedSeats() const;
+    std::vector<ShowSeat> getBookedSeats() const;
+    std::vector<ShowSeat> findAvailableSeats(size_t count) const;
+    std::optional<ShowSeat> getShowSeatById(int seatId) const;
+    size_t getSeatCount() const { return seatStates_.size(); }
+    const SeatStateMap& getSeatStates() const { return seatStates_; }
     
-    // Booking operations (thread-safe)
+    // Booking operations (thread-safe, lock-free once seats are loaded).
+    // tryLockSeats is all-or-nothing: on conflict no seat stays locked and the
+    // error names the seats that were taken, or unknown. On success it returns
+    // the locks' lockedUntil. lockSeats is the same call reporting a bool.
+    Utils::Expected<std::chrono::system_clock::time_point, Utils::BookingError>
+    tryLockSeats(const std::vector<int>& seatIds, int bookingId, int lockDurationMinutes = 15);
+    bool lockSeats(const std::vector<int>& seatIds, int bookingId, int lockDurationMinutes,
+                   std::vector<int>& conflictingSeatIds);
     bool lockSeats(const std::vector<int>& seatIds, int bookingId, int lockDurationMinutes = 15);
     bool releaseLockedSeats(int bookingId);
     bool bookSeats(const std::vector<int>& seatIds, int bookingId);
     
+    // Seat change events of every show in the process. Handlers run on the
+    // reserving thread while the show's next delta waits, so keep them short.
+    static Utils::EventBus<SeatDelta>& seatEvents() {
+        static Utils::EventBus<SeatDelta> bus;
+        return bus;
+    }
+    static SeatVersionSequence& seatVersions() {
+        static SeatVersionSequence versions;
+        return versions;
+    }
+    // Version of the last delta this show published or applied; 0 if none
+    uint64_t getSeatVersion() const { return seatVersion_.load(std::memory_order_acquire); }
+    // Mirror another instance's delta onto this one, e.g. a cached snapshot of
+    // the same show. States are stored outright, bypassing the CAS paths, so
+    // this is only for copies that nobody reserves seats on or reads yet.
+    void applySeatDelta(const SeatDelta& delta);
+    // Private copy of this show and its seats, for copy-on-write updates of a
+    // shared snapshot. Seats are read one by one, so a concurrent reservation
+    // may be seen half done; copy snapshots, not live shows.
+    std::unique_ptr<Show> snapshot() const;
+    
+    // Best-available allocation over `layout` (this show's screen).
+    // findBestAvailableSeats returns the seat ids, left to right, of the best
+    // `count` adjacent available seats in one row, or nothing if no row has
+    // such a block. lockBestAvailableSeats also locks them; if another booking
+    // takes a seat first it rescans, up to maxAttempts times.
+    std::vector<int> findBestAvailableSeats(const SeatLayout& layout, size_t count,
+                                            const BestSeatPreferences& preferences = {}) const;
+    std::vector<int> lockBestAvailableSeats(const SeatLayout& layout, size_t count, int bookingId,
+                                            int lockDurationMinutes = 15,
+                                            const BestSeatPreferences& preferences = {}, int maxAttempts = 3);
+    
     // Utility methods
     std::string getStatusString() const;
     std::string getStartTimeString() const;
     std::string getEndTimeString() const;
-    int getAvailableSeatCount() const;
-    int getBookedSeatCount() const;
+    int getAvailableSeatCount() const { return static_cast<int>(seatStates_.count(ShowSeatStatus::AVAILABLE)); }
+    int getLockedSeatCount() const { return static_cast<int>(seatStates_.count(ShowSeatStatus::LOCKED)); }
+    int getBookedSeatCount() const { return static_cast<int>(seatStates_.count(ShowSeatStatus::BOOKED)); }
     double calculateTotalRevenue() const;
 
-    // Serialization
+    // Serialization. writeSeatsJson writes every seat as a ShowSeat object
+    // without materializing ShowSeat views. writeCompactLayout writes the seat
+    // map as one status string per row, seats in ordinal order, seatsPerRow at
+    // a time: 'A' available, 'L' locked, 'B' booked, 'M' maintenance.
     std::string toJson() const;
+    void writeJson(Utils::JsonWriter& writer) const;
+    void writeSeatsJson(Utils::JsonWriter& writer) const;
+    void writeCompactLayout(Utils::JsonWriter& writer, size_t seatsPerRow) const;
     
     // Factory methods
     static std::unique_ptr<Show> createFromDbRow(const std::vector<std::string>& row);
+    static std::unique_ptr<Show> createFromDbRow(const Database::RowView& row);
+
+private:
+    std::vector<ShowSeat> viewsOf(const std::vector<size_t>& ordinals) const;
+    std::shared_ptr<const LayoutOrdinals> ordinalsOf(const SeatLayout& layout) const;
+    bool resolveOrdinals(const std::vector<int>& seatIds, std::vector<size_t>& ordinals,
+                         std::vector<int>& unknownSeatIds) const;
+    void publishSeatChanges(const std::vector<size_t>& ordinals);
 };
 
+// ShowSeat view accessors
+inline int ShowSeat::getId() const { return show_->seatSlots_[ordinal_].showSeatId; }
+inline int ShowSeat::getShowId() const { return show_->getId(); }
+inline int ShowSeat::getSeatId() const { return show_->seatSlots_[ordinal_].seatId; }
+inline ShowSeatStatus ShowSeat::getStatus() const { return show_->seatStates_.get(ordinal_); }
+inline double ShowSeat::getPrice() const { return show_->seatSlots_[ordinal_].price; }
+
+inline int ShowSeat::getBookingId() const {
+    return show_->seatSlots_[ordinal_].bookingId.load(std::memory_order_acquire);
+}
+
+inline std::chrono::system_clock::time_point ShowSeat::getLockedUntil() const {
+    return std::chrono::system_clock::time_point(std::chrono::system_clock::duration(
+        show_->seatSlots_[ordinal_].lockedUntil.load(std::memory_order_acquire)));
+}
+
+// Seat reservation. Seat ordinals are fixed once loadShowSeats has run, so
+// these paths rely only on the packed status words and never take mutex_.
+inline bool Show::resolveOrdinals(const std::vector<int>& seatIds, std::vector<size_t>& ordinals,
+                                  std::vector<int>& unknownSeatIds) const {
+    ordinals.clear();
+    ordinals.reserve(seatIds.size());
+    for (int seatId : seatIds) {
+        auto it = seatOrdinals_.find(seatId);
+        if (it == seatOrdinals_.end()) {
+            unknownSeatIds.push_back(seatId);
+        } else {
+            ordinals.push_back(it->second);
+        }
+    }
+    std::sort(ordinals.begin(), ordinals.end());
+    ordinals.erase(std::unique(ordinals.begin(), ordinals.end()), ordinals.end());
+    return unknownSeatIds.empty();
+}
+
+inline Utils::Expected<std::chrono::system_clock::time_point, Utils::BookingError>
+Show::tryLockSeats(const std::vector<int>& seatIds, int bookingId, int lockDurationMinutes) {
+    static Utils::Counter& lockAttempts = Utils::MetricsRegistry::global().counter(
+        "booking_seat_lock_attempts_total", "All-or-nothing seat lock attempts");
+    static Utils::Counter& lockConflicts = Utils::MetricsRegistry::global().counter(
+        "booking_seat_lock_conflicts_total", "Seat lock attempts rejected for a taken or unknown seat");
+
+    if (seatIds.empty()) {
+        return Utils::makeUnexpected(Utils::BookingError::seats(Utils::BookingErrorCode::NO_SEATS, id_, {}));
+    }
+    lockAttempts.increment();
+    std::vector<size_t> ordinals;
+    std::vector<int> unknownSeatIds;
+    if (!resolveOrdinals(seatIds, ordinals, unknownSeatIds)) {
+        lockConflicts.increment();
+        return Utils::makeUnexpected(
+            Utils::BookingError::seats(Utils::BookingErrorCode::UNKNOWN_SEATS, id_, std::move(unknownSeatIds)));
+    }
+
+    std::vector<size_t> conflicts;
+    if (!seatStates_.tryTransitionAll(ordinals, ShowSeatStatus::AVAILABLE, ShowSeatStatus::LOCKED, conflicts)) {
+        lockConflicts.increment();
+        std::vector<int> takenSeatIds;
+        takenSeatIds.reserve(conflicts.size());
+        for (size_t ordinal : conflicts) {
+            takenSeatIds.push_back(seatSlots_[ordinal].seatId);
+        }
+        return Utils::makeUnexpected(
+            Utils::BookingError::seats(Utils::BookingErrorCode::SEATS_UNAVAILABLE, id_, std::move(takenSeatIds)));
+    }
+
+    const auto lockedUntil = std::chrono::system_clock::now() + std::chrono::minutes(lockDurationMinutes);
+    for (size_t ordinal : ordinals) {
+        SeatSlot& slot = seatSlots_[ordinal];
+        slot.lockedUntil.store(lockedUntil.time_since_epoch().count(), std::memory_order_relaxed);
+        slot.bookingId.store(bookingId, std::memory_order_release);
+    }
+    publishSeatChanges(ordinals);
+    return lockedUntil;
+}
+
+inline bool Show::lockSeats(const std::vector<int>& seatIds, int bookingId, int lockDurationMinutes,
+                            std::vector<int>& conflictingSeatIds) {
+    auto locked = tryLockSeats(seatIds, bookingId, lockDurationMinutes);
+    if (!locked) {
+        const auto& failed = locked.error().seatIds;
+        conflictingSeatIds.insert(conflictingSeatIds.end(), failed.begin(), failed.end());
+    }
+    return locked.has_value();
+}
+
+inline bool Show::lockSeats(const std::vector<int>& seatIds, int bookingId, int lockDurationMinutes) {
+    return tryLockSeats(seatIds, bookingId, lockDurationMinutes).has_value();
+}
+
+inline bool Show::releaseLockedSeats(int bookingId) {
+    if (bookingId < 0) {
+        return false;
+    }
+    std::vector<size_t> released;
+    for (size_t ordinal : seatStates_.ordinalsWithStatus(ShowSeatStatus::LOCKED)) {
+        SeatSlot& slot = seatSlots_[ordinal];
+        int holder = bookingId;
+        if (!slot.bookingId.compare_exchange_strong(holder, kSeatClaimed, std::memory_order_acq_rel)) {
+            continue; // another booking's lock, or being booked
+        }
+        // Claimed: nobody else moves the seat or writes its fields until the
+        // claim is dropped. lockedUntil is cleared first, as a new lock
+        // writes its own as soon as the seat is AVAILABLE.
+        slot.lockedUntil.store(0, std::memory_order_relaxed);
+        if (!seatStates_.compareExchange(ordinal, ShowSeatStatus::LOCKED, ShowSeatStatus::AVAILABLE)) {
+            slot.bookingId.store(bookingId, std::memory_order_release);
+            continue;
+        }
+        // A new lock may already hold the seat and have written its own id
+        int claimed = kSeatClaimed;
+        slot.bookingId.compare_exchange_strong(claimed, kNoBooking, std::memory_order_acq_rel);
+        released.push_back(ordinal);
+    }
+    publishSeatChanges(released);
+    return !released.empty();
+}
+
+inline bool Show::bookSeats(const std::vector<int>& seatIds, int bookingId) {
+    std::vector<size_t> ordinals;
+    std::vector<int> unknownSeatIds;
+    if (seatIds.empty() || bookingId < 0 || !resolveOrdinals(seatIds, ordinals, unknownSeatIds)) {
+        return false;
+    }
+    // Claim every seat from its holder, so an expiry can neither release it
+    // nor hand it to another booking while it is being booked
+    const auto dropClaims = [this, &ordinals, bookingId](size_t claimedCount) {
+        for (size_t i = 0; i < claimedCount; ++i) {
+            seatSlots_[ordinals[i]].bookingId.store(bookingId, std::memory_order_release);
+        }
+    };
+    for (size_t i = 0; i < ordinals.size(); ++i) {
+        int holder = bookingId;
+        if (!seatSlots_[ordinals[i]].bookingId.compare_exchange_strong(holder, kSeatClaimed,
+                                                                       std::memory_order_acq_rel)) {
+            dropClaims(i);
+            return false;
+        }
+    }
+
+    std::vector<size_t> conflicts;
+    if (!seatStates_.tryTransitionAll(ordinals, ShowSeatStatus::LOCKED, ShowSeatStatus::BOOKED, conflicts)) {
+        dropClaims(ordinals.size());
+        return false;
+    }
+    for (size_t ordinal : ordinals) {
+        SeatSlot& slot = seatSlots_[ordinal];
+        slot.lockedUntil.store(0, std::memory_order_relaxed);
+        slot.bookingId.store(bookingId, std::memory_order_release);
+    }
+    publishSeatChanges(ordinals);
+    return true;
+}
+
+// Seat change events
+
+inline void Show::publishSeatChanges(const std::vector<size_t>& ordinals) {
+    if (ordinals.empty() || !seatEvents().hasSubscribers()) {
+        return;
+    }
+    // States are read under the lock, so a later version never carries an
+    // older state of a seat than an earlier one
+    SeatVersionSequence& versions = seatVersions();
+    const auto lock = versions.lock(id_);
+    SeatDelta delta{id_, versions.next(id_), this, {}};
+    delta.seats.reserve(ordinals.size());
+    for (size_t ordinal : ordinals) {
+        const SeatSlot& slot = seatSlots_[ordinal];
+        delta.seats.push_back(SeatChange{
+            slot.seatId, seatStates_.get(ordinal), slot.bookingId.load(std::memory_order_acquire),
+            std::chrono::system_clock::time_point(std::chrono::system_clock::duration(
+                slot.lockedUntil.load(std::memory_order_acquire)))});
+    }
+    seatVersion_.store(delta.version, std::memory_order_release);
+    seatEvents().publish(delta);
+}
+
+inline std::unique_ptr<Show> Show::snapshot() const {
+    auto copy = std::make_unique<Show>(id_, movieId_, screenId_, startTime_, endTime_, basePrice_, getStatus());
+    copy->createdAt_ = createdAt_;
+    copy->updatedAt_ = updatedAt_;
+    const size_t seatCount = seatStates_.size();
+    copy->seatStates_ = SeatStateMap(seatCount);
+    copy->seatSlots_ = std::make_unique<SeatSlot[]>(seatCount);
+    for (size_t ordinal = 0; ordinal < seatCount; ++ordinal) {
+        const SeatSlot& from = seatSlots_[ordinal];
+        SeatSlot& to = copy->seatSlots_[ordinal];
+        to.showSeatId = from.showSeatId;
+        to.seatId = from.seatId;
+        to.price = from.price;
+        to.bookingId.store(from.bookingId.load(std::memory_order_acquire), std::memory_order_relaxed);
+        to.lockedUntil.store(from.lockedUntil.load(std::memory_order_acquire), std::memory_order_relaxed);
+        copy->seatStates_.set(ordinal, seatStates_.get(ordinal));
+    }
+    copy->seatOrdinals_ = seatOrdinals_;
+    copy->seatVersion_.store(getSeatVersion(), std::memory_order_relaxed);
+    return copy;
+}
+
+inline void Show::applySeatDelta(const SeatDelta& delta) {
+    for (const SeatChange& change : delta.seats) {
+        auto it = seatOrdinals_.find(change.seatId);
+        if (it == seatOrdinals_.end()) {
+            continue;
+        }
+        SeatSlot& slot = seatSlots_[it->second];
+        slot.bookingId.store(change.bookingId, std::memory_order_relaxed);
+        slot.lockedUntil.store(change.lockedUntil.time_since_epoch().count(), std::memory_order_relaxed);
+        seatStates_.set(it->second, change.status);
+    }
+    seatVersion_.store(delta.version, std::memory_order_release);
+}
+
 } // namespace Models
 } // namespace MovieBooking
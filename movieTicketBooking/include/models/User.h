@@ -5,6 +5,13 @@
 #include <memory>
 
 namespace MovieBooking {
+namespace Database {
+class RowView;
+}
+namespace Utils {
+class JsonWriter;
+}
+
 namespace Models {
 
 class User {
@@ -54,9 +61,11 @@ public:
 
     // Serialization
     std::string toJson() const;
+    void writeJson(Utils::JsonWriter& writer) const;
     
     // Factory methods
     static std::unique_ptr<User> createFromDbRow(const std::vector<std::string>& row);
+    static std::unique_ptr<User> createFromDbRow(const Database::RowView& row);
     static std::unique_ptr<User> createNew(const std::string& username, const std::string& email,
                                            const std::string& password, const std::string& firstName = "",
                                            const std::string& lastName = "", const std::string& phone = "");
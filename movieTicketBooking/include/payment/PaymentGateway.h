@@ -5,11 +5,25 @@
 #include <vector>
 #include <future>
 #include <mutex>
+#include <atomic>
 #include <unordered_map>
 #include <chrono>
 #include <functional>
+#include <optional>
+
+#include "../utils/CircuitBreaker.h"
+#include "../utils/ConcurrencyLimiter.h"
+#include "../utils/Exceptions.h"
+#include "../utils/Metrics.h"
+#include "../utils/ShardedLruCache.h"
+#include "../utils/Task.h"
+#include "../utils/TimerScheduler.h"
 
 namespace MovieBooking {
+namespace Repositories {
+class BookingRepository;
+}
+
 namespace Payment {
 
 // Payment method types
@@ -42,6 +56,10 @@ struct PaymentRequest {
     std::string returnUrl;
     std::string cancelUrl;
     std::chrono::system_clock::time_point timestamp;
+    // Names one charge across every attempt to make it: a gateway that has
+    // already settled a key answers with that settlement instead of charging
+    // again. PaymentService fills it in when it is empty.
+    std::string idempotencyKey;
     
     PaymentRequest(const std::string& bookingId, double amount, PaymentMethod method)
         : bookingId(bookingId), amount(amount), method(method), currency("USD"), 
@@ -58,10 +76,13 @@ struct PaymentResponse {
     std::string gatewayResponse;
     std::chrono::system_clock::time_point processedAt;
     std::unordered_map<std::string, std::string> additionalData;
+    // Set when the gateway itself failed (transport error, 5xx, timeout) and
+    // the call may be retried; an unsuccessful response without it is a decline
+    bool gatewayError;
     
-    PaymentResponse(bool success, const std::string& message = "")
+    PaymentResponse(bool success, const std::string& message = "", bool gatewayError = false)
         : success(success), status(PaymentStatus::FAILED), message(message),
-          processedAt(std::chrono::system_clock::now()) {}
+          processedAt(std::chrono::system_clock::now()), gatewayError(gatewayError) {}
 };
 
 // Refund request structure
@@ -86,10 +107,11 @@ struct RefundResponse {
     std::string status;
     std::string message;
     std::chrono::system_clock::time_point processedAt;
+    bool gatewayError; // as for PaymentResponse
     
-    RefundResponse(bool success, const std::string& message = "")
+    RefundResponse(bool success, const std::string& message = "", bool gatewayError = false)
         : success(success), refundedAmount(0.0), status("failed"), message(message),
-          processedAt(std::chrono::system_clock::now()) {}
+          processedAt(std::chrono::system_clock::now()), gatewayError(gatewayError) {}
 };
 
 // Abstract payment gateway interface
@@ -109,6 +131,52 @@ public:
     virtual std::future<PaymentStatus> checkPaymentStatusAsync(const std::string& transactionId) = 0;
     virtual PaymentStatus checkPaymentStatus(const std::string& transactionId) = 0;
     
+    // Coroutine variants. The defaults run the blocking call on
+    // Utils::Executors::io(); gateways with a non-blocking client override them.
+    virtual Utils::Task<PaymentResponse> processPaymentTask(PaymentRequest request) {
+        co_return co_await Utils::offload(Utils::Executors::io(), [this, &request] { return processPayment(request); });
+    }
+    virtual Utils::Task<RefundResponse> processRefundTask(RefundRequest request) {
+        co_return co_await Utils::offload(Utils::Executors::io(), [this, &request] { return processRefund(request); });
+    }
+    virtual Utils::Task<PaymentStatus> checkPaymentStatusTask(std::string transactionId) {
+        co_return co_await Utils::offload(Utils::Executors::io(),
+                                          [this, &transactionId] { return checkPaymentStatus(transactionId); });
+    }
+    
+    // The charge made under `idempotencyKey`, nullopt if the gateway never
+    // took one. Settles an attempt whose outcome was lost (a timeout or a
+    // transport error) before the payment may go to another gateway; the
+    // default throws, so payments never fail over from such a gateway.
+    virtual std::optional<PaymentResponse> findPayment(const std::string& idempotencyKey) {
+        (void)idempotencyKey;
+        throw Utils::PaymentGatewayException(getGatewayName(), "lookup by idempotency key is not supported");
+    }
+    virtual Utils::Task<std::optional<PaymentResponse>> findPaymentTask(std::string idempotencyKey) {
+        co_return co_await Utils::offload(Utils::Executors::io(),
+                                          [this, &idempotencyKey] { return findPayment(idempotencyKey); });
+    }
+    
+    // Bulk status lookup, one status per id in input order. A lookup that
+    // fails reads as PENDING so it is simply retried on the next pass.
+    // The defaults pipeline single lookups, at most getStatusLookupConcurrency()
+    // in flight; gateways with a bulk endpoint override the Task variant and
+    // getMaxStatusBatchSize().
+    virtual Utils::Task<std::vector<PaymentStatus>> checkPaymentStatusBatchTask(std::vector<std::string> transactionIds) {
+        std::vector<Utils::Task<PaymentStatus>> lookups;
+        lookups.reserve(transactionIds.size());
+        for (auto& transactionId : transactionIds) {
+            lookups.push_back(checkPaymentStatusOrPending(std::move(transactionId)));
+        }
+        co_return co_await Utils::whenAllBounded(std::move(lookups), getStatusLookupConcurrency());
+    }
+    virtual std::vector<PaymentStatus> checkPaymentStatusBatch(const std::vector<std::string>& transactionIds) {
+        return Utils::syncWait(checkPaymentStatusBatchTask(transactionIds));
+    }
+    // Largest id list one checkPaymentStatusBatch call should be given
+    virtual size_t getMaxStatusBatchSize() const { return 100; }
+    virtual size_t getStatusLookupConcurrency() const { return 8; }
+    
     // Gateway information
     virtual std::string getGatewayName() const = 0;
     virtual std::vector<PaymentMethod> getSupportedMethods() const = 0;
@@ -117,18 +185,52 @@ public:
     // Validation
     virtual bool validatePaymentDetails(const PaymentRequest& request) = 0;
     virtual bool validateRefundDetails(const RefundRequest& request) = 0;
+
+protected:
+    Utils::Task<PaymentStatus> checkPaymentStatusOrPending(std::string transactionId) {
+        try {
+            co_return co_await checkPaymentStatusTask(std::move(transactionId));
+        } catch (const std::exception&) {
+            co_return PaymentStatus::PENDING;
+        }
+    }
 };
 
-// Mock payment gateway for testing
+// Response-time model for MockPaymentGateway: a log-normal body fitted to
+// p50/p99, plus rare spikes added on top to reproduce a gateway's long tail
+struct LatencyProfile {
+    std::chrono::milliseconds p50{1000};
+    std::chrono::milliseconds p99{1000};
+    double spikeProbability = 0.0;
+    std::chrono::milliseconds spikeLatency{0};
+    
+    static LatencyProfile fixed(std::chrono::milliseconds delay) { return {delay, delay, 0.0, {}}; }
+};
+
+// Mock payment gateway for testing and load tests.
+// Transactions live in a sharded LRU store bounded by count and retention
+// time, so concurrent calls only contend per shard and memory stays flat over
+// long runs; a transaction evicted from it reads as unknown. The *Task
+// variants wait out the sampled latency on the shared TimerScheduler, so
+// thousands of in-flight calls do not need thousands of threads.
 class MockPaymentGateway : public IPaymentGateway {
 private:
-    std::unordered_map<std::string, PaymentResponse> transactions_;
-    mutable std::mutex transactionsMutex_;
-    double successRate_;
-    std::chrono::milliseconds processingDelay_;
+    Utils::ShardedLruCache<std::string, PaymentResponse> transactions_;
+    // First settlement per idempotency key, retained like transactions_
+    Utils::ShardedLruCache<std::string, PaymentResponse> paymentsByKey_;
+    std::atomic<double> successRate_;
+    // LatencyProfile in sampling form: log-normal mu/sigma and the spike
+    std::atomic<double> latencyMu_;
+    std::atomic<double> latencySigma_;
+    std::atomic<double> spikeProbability_;
+    std::atomic<int64_t> spikeLatencyMs_;
+    std::atomic<uint64_t> nextId_;
     
 public:
-    explicit MockPaymentGateway(double successRate = 0.95, std::chrono::milliseconds processingDelay = std::chrono::milliseconds(1000));
+    explicit MockPaymentGateway(double successRate = 0.95,
+                                std::chrono::milliseconds processingDelay = std::chrono::milliseconds(1000),
+                                size_t maxRetainedTransactions = 100000,
+                                std::chrono::minutes retention = std::chrono::minutes(60));
     
     std::future<PaymentResponse> processPaymentAsync(const PaymentRequest& request) override;
     PaymentResponse processPayment(const PaymentRequest& request) override;
@@ -139,6 +241,13 @@ public:
     std::future<PaymentStatus> checkPaymentStatusAsync(const std::string& transactionId) override;
     PaymentStatus checkPaymentStatus(const std::string& transactionId) override;
     
+    Utils::Task<PaymentResponse> processPaymentTask(PaymentRequest request) override;
+    Utils::Task<RefundResponse> processRefundTask(RefundRequest request) override;
+    Utils::Task<PaymentStatus> checkPaymentStatusTask(std::string transactionId) override;
+    
+    std::optional<PaymentResponse> findPayment(const std::string& idempotencyKey) override;
+    Utils::Task<std::optional<PaymentResponse>> findPaymentTask(std::string idempotencyKey) override;
+    
     std::string getGatewayName() const override { return "MockGateway"; }
     std::vector<PaymentMethod> getSupportedMethods() const override;
     bool isMethodSupported(PaymentMethod method) const override;
@@ -148,9 +257,19 @@ public:
     
     // Mock configuration
     void setSuccessRate(double rate) { successRate_ = rate; }
-    void setProcessingDelay(std::chrono::milliseconds delay) { processingDelay_ = delay; }
+    void setProcessingDelay(std::chrono::milliseconds delay) { setLatencyProfile(LatencyProfile::fixed(delay)); }
+    void setLatencyProfile(const LatencyProfile& profile);
+    void setRetention(size_t maxTransactions, std::chrono::minutes retention);
+    size_t getRetainedTransactionCount() const { return transactions_.size(); }
 
 private:
+    std::chrono::microseconds sampleLatency();
+    // The gateway's work once the simulated latency has elapsed
+    PaymentResponse settlePayment(const PaymentRequest& request);
+    RefundResponse settleRefund(const RefundRequest& request);
+    PaymentStatus lookupStatus(const std::string& transactionId);
+    std::optional<PaymentResponse> lookupPayment(const std::string& idempotencyKey);
+    
     std::string generateTransactionId();
     std::string generateRefundId();
     bool shouldSucceed();
@@ -209,16 +328,65 @@ public:
     static std::unique_ptr<IPaymentGateway> createStripeGateway(const std::string& apiKey);
 };
 
-// Payment service for managing multiple gateways
+// Per-gateway admission policy for PaymentService
+struct GatewayPolicy {
+    Utils::AdaptiveConcurrencyLimit::Config concurrency;
+    int breakerFailureThreshold = 5;
+    std::chrono::seconds breakerOpenDuration{30};
+};
+
+// Point-in-time view of one gateway
+struct GatewayStats {
+    std::string name;
+    int concurrencyLimit;
+    int inFlight;
+    uint64_t rejected;
+    Utils::CircuitBreaker::State breakerState;
+    uint64_t breakerOpened;
+};
+
+// Outcome of one PaymentService::reconcilePayments pass
+struct ReconciliationResult {
+    size_t checked = 0;    // bookings whose transaction was looked up
+    size_t updated = 0;    // bookings whose payment status changed and was written back
+    size_t unresolved = 0; // still PENDING: unsettled, refused or failed lookups
+    bool writeFailed = false;
+};
+
+// Payment service for managing multiple gateways.
+// *Task methods suspend while the gateway call is in flight; the *Async
+// methods are std::future adapters over them.
+//
+// Every gateway is guarded by an adaptive concurrency limit and a circuit
+// breaker. A payment goes to the requested (or default) gateway and fails over,
+// in registration order, to the next one whose breaker is closed and that has
+// spare capacity. Only gateway failures (a throw or a gatewayError response)
+// count against the breaker and are retried; a decline is returned as is.
+// Every attempt carries the request's idempotency key. A failed attempt may
+// still have charged, so retries stay on that gateway until findPayment
+// reports it holds no charge under the key, and a charge it does hold is
+// returned instead.
+// Retries wait on the shared TimerScheduler with exponential backoff and
+// jitter, so no thread sleeps between attempts.
 class PaymentService {
 private:
-    std::unordered_map<std::string, std::unique_ptr<IPaymentGateway>> gateways_;
+    struct GatewayEntry {
+        std::unique_ptr<IPaymentGateway> gateway;
+        std::unique_ptr<Utils::AdaptiveConcurrencyLimit> limiter;
+        std::unique_ptr<Utils::CircuitBreaker> breaker;
+        Utils::LatencyHistogram* latency; // registry-owned, per gateway name
+        Utils::Counter* failures;
+    };
+    
+    std::unordered_map<std::string, GatewayEntry> gateways_;
+    std::vector<std::string> gatewayOrder_; // failover order
     std::string defaultGateway_;
     mutable std::mutex gatewaysMutex_;
     
     // Payment retry configuration
     int maxRetries_;
-    std::chrono::seconds retryDelay_;
+    std::chrono::milliseconds retryDelay_;    // backoff base
+    std::chrono::milliseconds maxRetryDelay_; // backoff cap
     
     // Transaction logging
     bool enableLogging_;
@@ -226,44 +394,93 @@ private:
     
 public:
     PaymentService(const std::string& defaultGateway = "mock", int maxRetries = 3,
-                  std::chrono::seconds retryDelay = std::chrono::seconds(2));
+                  std::chrono::milliseconds retryDelay = std::chrono::seconds(2));
     
     // Gateway management
-    void addGateway(const std::string& name, std::unique_ptr<IPaymentGateway> gateway);
+    void addGateway(const std::string& name, std::unique_ptr<IPaymentGateway> gateway,
+                    const GatewayPolicy& policy = GatewayPolicy());
     void setDefaultGateway(const std::string& name);
     std::string getDefaultGateway() const { return defaultGateway_; }
     
     // Payment operations with retry logic
+    Utils::Task<PaymentResponse> processPaymentTask(PaymentRequest request, std::string gatewayName = "");
     std::future<PaymentResponse> processPaymentAsync(const PaymentRequest& request, 
-                                                     const std::string& gatewayName = "");
+                                                     const std::string& gatewayName = "") {
+        return Utils::toFuture(processPaymentTask(request, gatewayName));
+    }
     PaymentResponse processPayment(const PaymentRequest& request, 
                                  const std::string& gatewayName = "");
     
+    // Refunds retry on the named gateway only; they never fail over
+    Utils::Task<RefundResponse> processRefundTask(RefundRequest request, std::string gatewayName = "");
     std::future<RefundResponse> processRefundAsync(const RefundRequest& request,
-                                                   const std::string& gatewayName = "");
+                                                   const std::string& gatewayName = "") {
+        return Utils::toFuture(processRefundTask(request, gatewayName));
+    }
     RefundResponse processRefund(const RefundRequest& request,
                                 const std::string& gatewayName = "");
     
     // Payment status
+    Utils::Task<PaymentStatus> checkPaymentStatusTask(std::string transactionId, std::string gatewayName = "");
     std::future<PaymentStatus> checkPaymentStatusAsync(const std::string& transactionId,
-                                                       const std::string& gatewayName = "");
+                                                       const std::string& gatewayName = "") {
+        return Utils::toFuture(checkPaymentStatusTask(transactionId, gatewayName));
+    }
     PaymentStatus checkPaymentStatus(const std::string& transactionId,
                                     const std::string& gatewayName = "");
     
+    // Bulk status lookup, one status per id in input order. Ids are split into
+    // chunks of the gateway's getMaxStatusBatchSize(), with at most
+    // `maxParallelChunks` chunks in flight, each admitted through the gateway's
+    // limiter and breaker; a refused or failed chunk reads as PENDING.
+    Utils::Task<std::vector<PaymentStatus>> checkPaymentStatusBatchTask(std::vector<std::string> transactionIds,
+                                                                        std::string gatewayName = "",
+                                                                        size_t maxParallelChunks = 4);
+    std::vector<PaymentStatus> checkPaymentStatusBatch(const std::vector<std::string>& transactionIds,
+                                                       const std::string& gatewayName = "",
+                                                       size_t maxParallelChunks = 4) {
+        return Utils::syncWait(checkPaymentStatusBatchTask(transactionIds, gatewayName, maxParallelChunks));
+    }
+    
+    // Nightly job: re-check every booking with a failed payment and write the
+    // changed statuses back with one updatePaymentStatusBatch per status
+    Utils::Task<ReconciliationResult> reconcilePaymentsTask(Repositories::BookingRepository& repository,
+                                                            std::string gatewayName = "",
+                                                            size_t maxParallelChunks = 4);
+    ReconciliationResult reconcilePayments(Repositories::BookingRepository& repository,
+                                           const std::string& gatewayName = "",
+                                           size_t maxParallelChunks = 4) {
+        return Utils::syncWait(reconcilePaymentsTask(repository, gatewayName, maxParallelChunks));
+    }
+    
     // Configuration
     void setMaxRetries(int retries) { maxRetries_ = retries; }
-    void setRetryDelay(std::chrono::seconds delay) { retryDelay_ = delay; }
+    void setRetryDelay(std::chrono::milliseconds delay) { retryDelay_ = delay; }
+    void setMaxRetryDelay(std::chrono::milliseconds delay) { maxRetryDelay_ = delay; }
     void enableLogging(bool enable) { enableLogging_ = enable; }
     void setPaymentLogger(std::function<void(const PaymentRequest&, const PaymentResponse&)> logger);
     
     // Gateway information
     std::vector<std::string> getAvailableGateways() const;
     std::vector<PaymentMethod> getSupportedMethods(const std::string& gatewayName = "") const;
+    std::vector<GatewayStats> getGatewayStats() const;
 
 private:
-    IPaymentGateway* getGateway(const std::string& name) const;
-    PaymentResponse processPaymentWithRetry(const PaymentRequest& request, IPaymentGateway* gateway);
-    RefundResponse processRefundWithRetry(const RefundRequest& request, IPaymentGateway* gateway);
+    GatewayEntry* getGateway(const std::string& name);
+    const GatewayEntry* getGateway(const std::string& name) const;
+    // `preferred` first, then the others in failover order
+    std::vector<std::pair<std::string, GatewayEntry*>> failoverCandidates(const std::string& preferred);
+    // Admit through the breaker and the limiter; false if either refuses
+    static bool tryAdmit(GatewayEntry& entry);
+    static void complete(GatewayEntry& entry, bool success, std::chrono::steady_clock::time_point start);
+    std::chrono::milliseconds backoffDelay(int attempt) const;
+    
+    Utils::Task<PaymentResponse> processPaymentWithRetryTask(PaymentRequest request, std::string preferredGateway);
+    Utils::Task<bool> findPaymentOn(const std::string& gatewayName, std::string idempotencyKey,
+                                    std::optional<PaymentResponse>& charge);
+    static std::string newIdempotencyKey(const PaymentRequest& request);
+    Utils::Task<RefundResponse> processRefundWithRetryTask(RefundRequest request, std::string gatewayName);
+    Utils::Task<std::vector<PaymentStatus>> checkStatusChunkTask(GatewayEntry& entry, std::vector<std::string> transactionIds);
     void logPayment(const PaymentRequest& request, const PaymentResponse& response);
 };
 
@@ -8,9 +8,14 @@ namespace Repositories {
 
 class BookingRepository : public Repository<Models::Booking> {
 public:
-    explicit BookingRepository(std::unique_ptr<DatabaseConnection> connection);
+    explicit BookingRepository(std::shared_ptr<Database::ConnectionPool> pool);
+    // Reads are served by the router's replicas where the tags below allow
+    explicit BookingRepository(std::shared_ptr<Database::ConnectionRouter> router)
+        : BookingRepository(router->getPrimary()) {
+        setConnectionRouter(std::move(router));
+    }
     
-    // Custom queries for bookings
+    // Custom queries for bookings (Read)
     std::vector<std::unique_ptr<Models::Booking>> findByUserId(int userId);
     std::vector<std::unique_ptr<Models::Booking>> findByShowId(int showId);
     std::vector<std::unique_ptr<Models::Booking>> findByStatus(Models::BookingStatus status);
@@ -18,7 +23,7 @@ public:
     std::vector<std::unique_ptr<Models::Booking>> findExpiredBookings();
     std::vector<std::unique_ptr<Models::Booking>> findPendingBookingsOlderThan(int minutes);
     
-    // Booking statistics
+    // Booking statistics (Read)
     int countByUserId(int userId);
     int countByShowId(int showId);
     int countByStatus(Models::BookingStatus status);
@@ -26,17 +31,17 @@ public:
     double totalRevenueByUserId(int userId);
     double totalRevenueByDateRange(const std::string& startDate, const std::string& endDate);
     
-    // Batch operations
+    // Batch operations (Write)
     bool updateStatusBatch(const std::vector<int>& bookingIds, Models::BookingStatus status);
     bool updatePaymentStatusBatch(const std::vector<int>& bookingIds, Models::PaymentStatus status);
     bool cancelExpiredBookings();
     
-    // Concurrent booking operations
+    // Concurrent booking operations (Write)
     bool lockSeatsForBooking(int bookingId, const std::vector<int>& showSeatIds);
     bool releaseSeatsForBooking(int bookingId);
     bool confirmSeatsForBooking(int bookingId);
     
-    // Payment operations
+    // Payment operations (updatePaymentId Write, findBookingsWithFailedPayments Read)
     bool updatePaymentId(int bookingId, const std::string& paymentId);
     std::vector<std::unique_ptr<Models::Booking>> findBookingsWithFailedPayments();
 
@@ -47,6 +52,13 @@ protected:
     std::string getUpdateSetClause(const Models::Booking& entity) const override;
 
 private:
+    // Prepared statement templates for the batch updates, completed by
+    // executeForIdChunks with the id list (see ShowRepository)
+    static constexpr const char* kUpdateStatusBatchSql =
+        "UPDATE bookings SET booking_status = ?, updated_at = NOW() WHERE id IN ";
+    static constexpr const char* kUpdatePaymentStatusBatchSql =
+        "UPDATE bookings SET payment_status = ?, updated_at = NOW() WHERE id IN ";
+    
     // Helper methods for complex queries
     std::string buildBookingSeatsJoinQuery() const;
     std::string buildShowSeatsJoinQuery() const;
@@ -4,8 +4,11 @@
 #include <vector>
 #include <functional>
 #include <future>
+#include <algorithm>
+#include <string>
 
-#include "DatabaseConnection.h"
+#include "../database/DatabaseConnection.h"
+#include "../utils/Task.h"
 
 namespace MovieBooking {
 namespace Repositories {
@@ -29,23 +32,57 @@ public:
     virtual int count() = 0;
 };
 
+// Per-row outcome of a batched write
+struct BatchWriteResult {
+    std::vector<bool> rowSucceeded;   // same order as the input
+    std::vector<int> insertedIds;     // saveBatch only; -1 for rows that failed
+    size_t succeeded = 0;
+    size_t failed = 0;
+    
+    bool allSucceeded() const { return failed == 0; }
+};
+
+class Transaction;
+
 // Generic repository implementation
 template<typename T>
 class Repository : public IRepository<T> {
 protected:
-    std::unique_ptr<DatabaseConnection> connection_;
+    // Connections are leased per operation, never held by the repository
+    std::shared_ptr<Database::ConnectionPool> pool_;
+    // When set, leases are routed by intent between the primary and replicas
+    std::shared_ptr<Database::ConnectionRouter> router_;
     std::string tableName_;
     std::function<std::unique_ptr<T>(const std::vector<std::string>&)> rowMapper_;
+    // Preferred over rowMapper_ when set: decodes typed columns via a ResultCursor
+    std::function<std::unique_ptr<T>(const Database::RowView&)> rowViewMapper_;
     std::function<std::string(const T&)> entitySerializer_;
+    size_t batchChunkSize_ = 500;
 
 public:
-    Repository(std::unique_ptr<DatabaseConnection> connection,
+    Repository(std::shared_ptr<Database::ConnectionPool> pool,
                const std::string& tableName,
                std::function<std::unique_ptr<T>(const std::vector<std::string>&)> rowMapper,
                std::function<std::string(const T&)> entitySerializer);
     
+    Repository(std::shared_ptr<Database::ConnectionPool> pool,
+               const std::string& tableName,
+               std::function<std::unique_ptr<T>(const Database::RowView&)> rowViewMapper,
+               std::function<std::string(const T&)> entitySerializer);
+    
     virtual ~Repository() = default;
+    
+    void setRowViewMapper(std::function<std::unique_ptr<T>(const Database::RowView&)> mapper) {
+        rowViewMapper_ = std::move(mapper);
+    }
+    
+    void setConnectionRouter(std::shared_ptr<Database::ConnectionRouter> router) {
+        router_ = std::move(router);
+    }
 
+    // Finders, existsById and count lease with QueryIntent::Read; everything
+    // that modifies rows leases with QueryIntent::Write
+    
     // CRUD operations
     std::unique_ptr<T> findById(int id) override;
     std::vector<std::unique_ptr<T>> findAll() override;
@@ -58,41 +95,111 @@ public:
     bool existsById(int id) override;
     int count() override;
     
-    // Batch operations
-    std::vector<std::unique_ptr<T>> saveBatch(const std::vector<T>& entities);
-    bool updateBatch(const std::vector<T>& entities);
-    bool deleteBatch(const std::vector<int>& ids);
+    // Batch operations: one multi-row statement and one transaction per chunk.
+    // If a chunk fails, or affects fewer rows than it has items, it is rolled
+    // back and retried row by row, so the result pinpoints the failing rows
+    // while the rest are still written. A row succeeds only if its statement
+    // affected a row; connections must be opened with CLIENT_FOUND_ROWS so an
+    // update that leaves a row's values unchanged still counts it.
+    // updateBatch only updates, on both paths: an entity whose id has no row
+    // is not inserted, as with update(), and is reported as failed. Its chunk
+    // statement joins a VALUES ROW table, which needs MySQL 8.0.19 or later.
+    BatchWriteResult saveBatch(const std::vector<T>& entities);
+    BatchWriteResult updateBatch(const std::vector<T>& entities);
+    BatchWriteResult deleteBatch(const std::vector<int>& ids);
+    
+    void setBatchChunkSize(size_t size) { batchChunkSize_ = size > 0 ? size : 1; }
+    size_t getBatchChunkSize() const { return batchChunkSize_; }
     
-    // Async operations
+    // Coroutine operations: the query runs on Utils::Executors::io() while the
+    // awaiting coroutine is suspended. Entities are passed by shared_ptr (the
+    // models are not copyable), so the task keeps the one it writes alive.
+    Utils::Task<std::unique_ptr<T>> findByIdTask(int id);
+    Utils::Task<std::vector<std::unique_ptr<T>>> findAllTask();
+    Utils::Task<std::unique_ptr<T>> saveTask(std::shared_ptr<const T> entity);
+    Utils::Task<bool> updateTask(std::shared_ptr<const T> entity);
+    Utils::Task<bool> deleteByIdTask(int id);
+    
+    // Async operations (std::future adapters over the tasks)
     std::future<std::unique_ptr<T>> findByIdAsync(int id);
     std::future<std::vector<std::unique_ptr<T>>> findAllAsync();
-    std::future<std::unique_ptr<T>> saveAsync(const T& entity);
-    std::future<bool> updateAsync(const T& entity);
+    std::future<std::unique_ptr<T>> saveAsync(std::shared_ptr<const T> entity);
+    std::future<bool> updateAsync(std::shared_ptr<const T> entity);
     std::future<bool> deleteByIdAsync(int id);
 
 protected:
+    // Lease a connection for the duration of one operation. Untagged leases
+    // are writes, so only operations known to be reads reach a replica.
+    Database::PooledConnection lease(Database::QueryIntent intent = Database::QueryIntent::Write) const {
+        return router_ ? router_->acquire(intent) : pool_->acquire();
+    }
+    
+    // Keeps this thread's reads on the primary across a multi-statement write
+    Database::ConnectionRouter::PrimaryAffinity pinToPrimary() const {
+        return router_ ? router_->pinToPrimary() : Database::ConnectionRouter::PrimaryAffinity();
+    }
+    
+    // Transaction on a primary connection; reads on this thread keep to the
+    // primary until it ends
+    Transaction beginTransaction() const;
+    
+    // Run a SELECT and map every row, streaming through rowViewMapper_ when set
+    std::vector<std::unique_ptr<T>> fetchEntities(const std::string& query);
+    
     // Helper methods
     std::string buildSelectQuery(const std::string& condition = "") const;
     std::string buildInsertQuery(const T& entity) const;
     std::string buildUpdateQuery(const T& entity) const;
     std::string buildDeleteQuery(int id) const;
     
+    // Multi-row statements over entities[begin, end)
+    std::string buildMultiRowInsertQuery(const std::vector<T>& entities, size_t begin, size_t end) const;
+    std::string buildMultiRowUpdateQuery(const std::vector<T>& entities, size_t begin, size_t end) const;
+    
+    // Run `prefix (?, ..., ?) suffix` through executeCached once per
+    // batchChunkSize_ ids, binding `leading`, the chunk's ids, then `trailing`.
+    // A short chunk is padded with its last id to the next power of two (or
+    // the chunk size), so any number of ids reuses a few prepared statements,
+    // and IN keeps the primary-key lookup. Every chunk runs in `transaction`,
+    // so the ids are written together: the first failing chunk rolls it back
+    // and returns false. Otherwise the caller commits, after checking
+    // affectedRows (summed over the chunks) if it needs every id to match.
+    bool executeForIdChunks(Transaction& transaction, const std::string& prefix,
+                            const std::vector<Database::StatementParam>& leading, const std::vector<int>& ids,
+                            const std::string& suffix = "",
+                            const std::vector<Database::StatementParam>& trailing = {},
+                            uint64_t* affectedRows = nullptr) const;
+    
     virtual std::string getSelectColumns() const = 0;
     virtual std::string getInsertColumns() const = 0;
     virtual std::string getInsertValues(const T& entity) const = 0;
     virtual std::string getUpdateSetClause(const T& entity) const = 0;
     virtual std::string getWhereClause(int id) const { return "id = " + std::to_string(id); }
+    
+    // SET clause of updateBatch's chunk statement, assigning the target `t`
+    // from the joined values `v`; defaults to every insert column
+    virtual std::string getBatchUpdateAssignments() const;
+
+private:
+    template<typename Item, typename ChunkQuery, typename RowQuery>
+    BatchWriteResult runChunked(const std::vector<Item>& items, ChunkQuery chunkQuery, RowQuery rowQuery,
+                                std::vector<int>* insertedIds);
 };
 
 // Transaction support
 class Transaction {
 private:
-    std::unique_ptr<DatabaseConnection> connection_;
+    Database::ConnectionRouter::PrimaryAffinity affinity_; // outlives the connection
+    Database::PooledConnection connection_; // held until commit/rollback
     bool isActive_;
     bool isCommitted_;
 
 public:
-    explicit Transaction(std::unique_ptr<DatabaseConnection> connection);
+    explicit Transaction(Database::PooledConnection connection);
+    Transaction(Database::PooledConnection connection, Database::ConnectionRouter::PrimaryAffinity affinity)
+        : Transaction(std::move(connection)) {
+        affinity_ = std::move(affinity);
+    }
     ~Transaction();
     
     bool commit();
@@ -100,7 +207,7 @@ public:
     bool isActive() const { return isActive_ && !isCommitted_; }
     
     // Get connection for operations within transaction
-    DatabaseConnection* getConnection() const { return connection_.get(); }
+    Database::DatabaseConnection* getConnection() const { return connection_.get(); }
 
 private:
     void cleanup();
@@ -111,10 +218,264 @@ template<typename T>
 class RepositoryFactory {
 public:
     static std::unique_ptr<Repository<T>> create(
+        std::shared_ptr<Database::ConnectionPool> pool,
         const std::string& tableName,
         std::function<std::unique_ptr<T>(const std::vector<std::string>&)> rowMapper,
         std::function<std::string(const T&)> entitySerializer);
 };
 
+template<typename T>
+Transaction Repository<T>::beginTransaction() const {
+    if (!router_) {
+        return Transaction(pool_->acquire());
+    }
+    auto affinity = router_->pinToPrimary();
+    return Transaction(router_->acquire(Database::QueryIntent::Write), std::move(affinity));
+}
+
+// Batch write implementation
+
+template<typename T>
+std::string Repository<T>::buildMultiRowInsertQuery(const std::vector<T>& entities, size_t begin, size_t end) const {
+    std::string query = "INSERT INTO " + tableName_ + " (" + getInsertColumns() + ") VALUES ";
+    for (size_t i = begin; i < end; ++i) {
+        if (i != begin) {
+            query += ", ";
+        }
+        query += "(";
+        query += getInsertValues(entities[i]);
+        query += ")";
+    }
+    return query;
+}
+
+// UPDATE t JOIN (VALUES ROW(id, ...), ...) AS v (id, ...) ON t.id = v.id SET ...:
+// one statement that only touches rows that exist
+template<typename T>
+std::string Repository<T>::buildMultiRowUpdateQuery(const std::vector<T>& entities, size_t begin, size_t end) const {
+    std::string query = "UPDATE " + tableName_ + " AS t JOIN (VALUES ";
+    for (size_t i = begin; i < end; ++i) {
+        if (i != begin) {
+            query += ", ";
+        }
+        query += "ROW(" + std::to_string(entities[i].getId()) + ", ";
+        query += getInsertValues(entities[i]);
+        query += ")";
+    }
+    query += ") AS v (id, " + getInsertColumns() + ") ON t.id = v.id SET " + getBatchUpdateAssignments();
+    return query;
+}
+
+template<typename T>
+std::string Repository<T>::getBatchUpdateAssignments() const {
+    const std::string columns = getInsertColumns();
+    std::string clause;
+    size_t start = 0;
+    while (start < columns.size()) {
+        size_t comma = columns.find(',', start);
+        if (comma == std::string::npos) {
+            comma = columns.size();
+        }
+        size_t first = columns.find_first_not_of(' ', start);
+        size_t last = columns.find_last_not_of(' ', comma - 1);
+        if (first != std::string::npos && first < comma) {
+            const std::string column = columns.substr(first, last - first + 1);
+            if (!clause.empty()) {
+                clause += ", ";
+            }
+            clause += "t." + column + " = v." + column;
+        }
+        start = comma + 1;
+    }
+    return clause;
+}
+
+template<typename T>
+template<typename Item, typename ChunkQuery, typename RowQuery>
+BatchWriteResult Repository<T>::runChunked(const std::vector<Item>& items, ChunkQuery chunkQuery,
+                                           RowQuery rowQuery, std::vector<int>* insertedIds) {
+    BatchWriteResult result;
+    result.rowSucceeded.assign(items.size(), false);
+    const auto affinity = pinToPrimary();
+    if (insertedIds) {
+        insertedIds->assign(items.size(), -1);
+    }
+
+    for (size_t begin = 0; begin < items.size(); begin += batchChunkSize_) {
+        const size_t end = std::min(items.size(), begin + batchChunkSize_);
+        Database::PooledConnection connection = lease(Database::QueryIntent::Write);
+
+        uint64_t affected = 0;
+        bool chunkOk = connection->beginTransaction() && connection->executeQuery(chunkQuery(begin, end), &affected);
+        int firstId = chunkOk && insertedIds ? connection->getLastInsertId() : -1;
+        // Fewer rows than items: some matched nothing, so find them row by row
+        chunkOk = chunkOk && affected == end - begin && connection->commit();
+        if (chunkOk) {
+            for (size_t i = begin; i < end; ++i) {
+                result.rowSucceeded[i] = true;
+                // A single multi-row INSERT is assigned consecutive auto-increment ids
+                if (insertedIds) {
+                    (*insertedIds)[i] = firstId + static_cast<int>(i - begin);
+                }
+            }
+            continue;
+        }
+
+        // Isolate the failing rows
+        connection->rollback();
+        for (size_t i = begin; i < end; ++i) {
+            uint64_t rowAffected = 0;
+            result.rowSucceeded[i] = connection->executeQuery(rowQuery(i), &rowAffected) && rowAffected > 0;
+            if (result.rowSucceeded[i] && insertedIds) {
+                (*insertedIds)[i] = connection->getLastInsertId();
+            }
+        }
+    }
+
+    for (bool ok : result.rowSucceeded) {
+        ok ? ++result.succeeded : ++result.failed;
+    }
+    return result;
+}
+
+template<typename T>
+BatchWriteResult Repository<T>::saveBatch(const std::vector<T>& entities) {
+    std::vector<int> insertedIds;
+    BatchWriteResult result = runChunked(
+        entities,
+        [&](size_t begin, size_t end) { return buildMultiRowInsertQuery(entities, begin, end); },
+        [&](size_t i) { return buildInsertQuery(entities[i]); },
+        &insertedIds);
+    result.insertedIds = std::move(insertedIds);
+    return result;
+}
+
+template<typename T>
+BatchWriteResult Repository<T>::updateBatch(const std::vector<T>& entities) {
+    return runChunked(
+        entities,
+        [&](size_t begin, size_t end) { return buildMultiRowUpdateQuery(entities, begin, end); },
+        [&](size_t i) { return buildUpdateQuery(entities[i]); },
+        nullptr);
+}
+
+template<typename T>
+BatchWriteResult Repository<T>::deleteBatch(const std::vector<int>& ids) {
+    return runChunked(
+        ids,
+        [&](size_t begin, size_t end) {
+            std::string query = "DELETE FROM " + tableName_ + " WHERE id IN (";
+            for (size_t i = begin; i < end; ++i) {
+                if (i != begin) {
+                    query += ", ";
+                }
+                query += std::to_string(ids[i]);
+            }
+            return query + ")";
+        },
+        [&](size_t i) { return buildDeleteQuery(ids[i]); },
+        nullptr);
+}
+
+template<typename T>
+bool Repository<T>::executeForIdChunks(Transaction& transaction, const std::string& prefix,
+                                       const std::vector<Database::StatementParam>& leading,
+                                       const std::vector<int>& ids, const std::string& suffix,
+                                       const std::vector<Database::StatementParam>& trailing,
+                                       uint64_t* affectedRows) const {
+    if (affectedRows) {
+        *affectedRows = 0;
+    }
+    Database::DatabaseConnection* connection = transaction.getConnection();
+    if (!transaction.isActive() || !connection) {
+        return false;
+    }
+    for (size_t begin = 0; begin < ids.size(); begin += batchChunkSize_) {
+        const size_t count = std::min(ids.size() - begin, batchChunkSize_);
+        size_t slots = 1;
+        while (slots < count) {
+            slots *= 2;
+        }
+        slots = std::min(slots, batchChunkSize_);
+
+        std::string sqlTemplate = prefix;
+        sqlTemplate += "(";
+        std::vector<Database::StatementParam> params(leading);
+        params.reserve(leading.size() + slots + trailing.size());
+        for (size_t i = 0; i < slots; ++i) {
+            sqlTemplate += i == 0 ? "?" : ", ?";
+            params.emplace_back(ids[begin + std::min(i, count - 1)]);
+        }
+        sqlTemplate += ")";
+        sqlTemplate += suffix;
+        params.insert(params.end(), trailing.begin(), trailing.end());
+
+        uint64_t affected = 0;
+        if (!connection->executeCached(sqlTemplate, params, &affected)) {
+            transaction.rollback();
+            return false;
+        }
+        if (affectedRows) {
+            *affectedRows += affected;
+        }
+    }
+    return true;
+}
+
+// Coroutine operations
+
+template<typename T>
+Utils::Task<std::unique_ptr<T>> Repository<T>::findByIdTask(int id) {
+    co_return co_await Utils::offload(Utils::Executors::io(), [this, id] { return findById(id); });
+}
+
+template<typename T>
+Utils::Task<std::vector<std::unique_ptr<T>>> Repository<T>::findAllTask() {
+    co_return co_await Utils::offload(Utils::Executors::io(), [this] { return findAll(); });
+}
+
+// `entity` lives in the coroutine frame, which outlives the offloaded call
+template<typename T>
+Utils::Task<std::unique_ptr<T>> Repository<T>::saveTask(std::shared_ptr<const T> entity) {
+    co_return co_await Utils::offload(Utils::Executors::io(), [this, &entity] { return save(*entity); });
+}
+
+template<typename T>
+Utils::Task<bool> Repository<T>::updateTask(std::shared_ptr<const T> entity) {
+    co_return co_await Utils::offload(Utils::Executors::io(), [this, &entity] { return update(*entity); });
+}
+
+template<typename T>
+Utils::Task<bool> Repository<T>::deleteByIdTask(int id) {
+    co_return co_await Utils::offload(Utils::Executors::io(), [this, id] { return deleteById(id); });
+}
+
+// Async operations
+
+template<typename T>
+std::future<std::unique_ptr<T>> Repository<T>::findByIdAsync(int id) {
+    return Utils::toFuture(findByIdTask(id));
+}
+
+template<typename T>
+std::future<std::vector<std::unique_ptr<T>>> Repository<T>::findAllAsync() {
+    return Utils::toFuture(findAllTask());
+}
+
+template<typename T>
+std::future<std::unique_ptr<T>> Repository<T>::saveAsync(std::shared_ptr<const T> entity) {
+    return Utils::toFuture(saveTask(std::move(entity)));
+}
+
+template<typename T>
+std::future<bool> Repository<T>::updateAsync(std::shared_ptr<const T> entity) {
+    return Utils::toFuture(updateTask(std::move(entity)));
+}
+
+template<typename T>
+std::future<bool> Repository<T>::deleteByIdAsync(int id) {
+    return Utils::toFuture(deleteByIdTask(id));
+}
+
 } // namespace Repositories
 } // namespace MovieBooking
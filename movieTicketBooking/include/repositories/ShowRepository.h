@@ -8,9 +8,14 @@ namespace Repositories {
 
 class ShowRepository : public Repository<Models::Show> {
 public:
-    explicit ShowRepository(std::unique_ptr<DatabaseConnection> connection);
+    explicit ShowRepository(std::shared_ptr<Database::ConnectionPool> pool);
+    // Reads are served by the router's replicas where the tags below allow
+    explicit ShowRepository(std::shared_ptr<Database::ConnectionRouter> router)
+        : ShowRepository(router->getPrimary()) {
+        setConnectionRouter(std::move(router));
+    }
     
-    // Custom queries for shows
+    // Custom queries for shows (Read)
     std::vector<std::unique_ptr<Models::Show>> findByMovieId(int movieId);
     std::vector<std::unique_ptr<Models::Show>> findByScreenId(int screenId);
     std::vector<std::unique_ptr<Models::Show>> findByStatus(Models::ShowStatus status);
@@ -19,31 +24,33 @@ public:
     std::vector<std::unique_ptr<Models::Show>> findOngoingShows();
     std::vector<std::unique_ptr<Models::Show>> findShowsWithAvailableSeats();
     
-    // Show seat operations
+    // Show seat operations (createShowSeats Write, the getters Read)
     bool createShowSeats(int showId, int screenId, double basePrice);
-    std::vector<std::unique_ptr<Models::ShowSeat>> getShowSeats(int showId);
-    std::vector<std::unique_ptr<Models::ShowSeat>> getAvailableShowSeats(int showId);
-    std::vector<std::unique_ptr<Models::ShowSeat>> getLockedShowSeats(int showId);
-    std::vector<std::unique_ptr<Models::ShowSeat>> getBookedShowSeats(int showId);
+    std::vector<Models::ShowSeatRecord> getShowSeats(int showId);
+    std::vector<Models::ShowSeatRecord> getAvailableShowSeats(int showId);
+    std::vector<Models::ShowSeatRecord> getLockedShowSeats(int showId);
+    std::vector<Models::ShowSeatRecord> getBookedShowSeats(int showId);
     
-    // Seat locking operations (thread-safe)
+    // Seat locking operations (thread-safe; Write)
     bool lockShowSeats(int showId, const std::vector<int>& seatIds, int bookingId, int lockDurationMinutes = 15);
     bool releaseShowSeats(int showId, const std::vector<int>& seatIds, int bookingId);
     bool bookShowSeats(int showId, const std::vector<int>& seatIds, int bookingId);
     bool releaseExpiredLocks(int showId);
+    bool releaseExpiredLocksForBookings(const std::vector<int>& bookingIds);
     
-    // Show statistics
+    // Show statistics (Read)
     int getAvailableSeatCount(int showId);
     int getBookedSeatCount(int showId);
     int getLockedSeatCount(int showId);
     double calculateShowRevenue(int showId);
     double calculateOccupancyRate(int showId);
     
-    // Batch operations
+    // Batch operations (Write)
     bool updateShowStatusBatch(const std::vector<int>& showIds, Models::ShowStatus status);
     bool cancelShowsOlderThanDate(const std::string& date);
     
-    // Conflict detection
+    // Conflict detection (Write: a replica may not have a show created moments
+    // ago, and the answer decides whether the next one is inserted)
     bool hasTimeConflict(int screenId, const std::chrono::system_clock::time_point& startTime,
                         const std::chrono::system_clock::time_point& endTime, int excludeShowId = -1);
     std::vector<std::unique_ptr<Models::Show>> findConflictingShows(int screenId,
@@ -57,13 +64,39 @@ protected:
     std::string getUpdateSetClause(const Models::Show& entity) const override;
 
 private:
+    // Prepared statement templates for the hot seat paths. Id lists are
+    // completed by executeForIdChunks: the statement is `Sql (?, ..., ?)
+    // Suffix`, binding the prefix's params, the ids, then the suffix's. An IN
+    // list keeps the (show_id, seat_id) index, which FIND_IN_SET could not use,
+    // and padding keeps it to a few prepared statements per connection.
+    // Callers compare the affected row count with the number of seats requested.
+    static constexpr const char* kLockShowSeatsSql =
+        "UPDATE show_seats SET status = 'LOCKED', booking_id = ?, locked_until = ? "
+        "WHERE show_id = ? AND seat_id IN ";
+    static constexpr const char* kLockShowSeatsSuffix = " AND status = 'AVAILABLE'";
+    // createShowSeats: one INSERT ... SELECT materializes every seat of the screen
+    static constexpr const char* kCreateShowSeatsSql =
+        "INSERT INTO show_seats (show_id, seat_id, status, price) "
+        "SELECT ?, id, 'AVAILABLE', ? * price_multiplier FROM seats WHERE screen_id = ?";
+    static constexpr const char* kBookShowSeatsSql =
+        "UPDATE show_seats SET status = 'BOOKED', locked_until = NULL WHERE show_id = ? AND seat_id IN ";
+    static constexpr const char* kBookShowSeatsSuffix = " AND status = 'LOCKED' AND booking_id = ?";
+    // releaseExpiredLocksForBookings: binds the current time, then the booking ids
+    static constexpr const char* kReleaseExpiredLocksForBookingsSql =
+        "UPDATE show_seats AS s JOIN bookings AS b ON b.id = s.booking_id "
+        "SET s.status = 'AVAILABLE', s.booking_id = NULL, s.locked_until = NULL "
+        "WHERE s.status = 'LOCKED' AND s.locked_until <= ? AND b.booking_status = 'PENDING' "
+        "AND s.booking_id IN ";
+    
     // Helper methods
+    static std::string joinIds(const std::vector<int>& ids);
     std::string buildShowSeatsQuery() const;
     std::string buildSeatLockQuery() const;
     std::string buildTimeConflictQuery() const;
     
     // Row mappers
-    std::unique_ptr<Models::ShowSeat> mapShowSeat(const std::vector<std::string>& row);
+    Models::ShowSeatRecord mapShowSeat(const std::vector<std::string>& row);
+    Models::ShowSeatRecord mapShowSeat(const Database::RowView& row);
     std::unique_ptr<Models::Show> mapShowWithSeats(const std::vector<std::string>& row);
     
     // Seat management helpers
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../controllers/BookingController.h"
+
+namespace MovieBooking {
+namespace Server {
+
+struct HttpServerConfig {
+    std::string host = "0.0.0.0";
+    uint16_t port = 8080;                  // 0 picks a free port, see getPort()
+    size_t threads = 0;                    // event loops; 0 = one per core
+    int backlog = 1024;
+    size_t maxRequestBytes = 1024 * 1024;  // header block plus body
+    size_t maxPipelinedRequests = 64;      // unanswered requests per connection
+    size_t maxPendingOutputBytes = 1024 * 1024; // unsent response bytes before parsing pauses
+    std::chrono::seconds idleTimeout{60};
+};
+
+struct HttpServerStats {
+    uint64_t connectionsAccepted;
+    uint64_t requestsServed;
+    uint64_t protocolErrors;
+    size_t openConnections;
+    size_t openStreams;     // connections carrying an event stream
+};
+
+// Embedded HTTP/1.1 front end for Router.
+//
+// Each event loop thread owns an epoll instance and its own SO_REUSEPORT
+// listener on the shared port, so the kernel spreads connections across loops
+// and a connection never leaves the loop that accepted it. Requests are parsed
+// in place (HttpRequestView) and dispatched straight to Router::dispatch.
+// Keep-alive and pipelining are supported: responses go out in request order,
+// and parsing pauses once maxPipelinedRequests are unanswered or, for a
+// client that stops reading, once maxPendingOutputBytes are waiting to be
+// sent; it resumes as the socket drains.
+//
+// Async routes return a std::future, which offers no completion callback.
+// Rather than block on it, a loop with outstanding futures polls their
+// readiness every millisecond and sends each response once it is ready.
+//
+// A response with a `stream` (server-sent events) takes over its connection:
+// producers wake the loop through its eventfd whenever events are queued, and
+// the connection closes when either the stream or the client does.
+class HttpServer {
+public:
+    class EventLoop;
+
+private:
+    Controllers::Router& router_;
+    HttpServerConfig config_;
+    std::vector<std::unique_ptr<EventLoop>> loops_;
+    std::atomic<uint16_t> boundPort_;
+    std::atomic<bool> running_;
+
+public:
+    explicit HttpServer(Controllers::Router& router, HttpServerConfig config = HttpServerConfig());
+    ~HttpServer();
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    // Bind every loop's listener and start the loops. Throws
+    // ConfigurationException if the address cannot be bound.
+    void start();
+    // Close listeners and connections, then join the loops. Idempotent.
+    void stop();
+
+    bool isRunning() const { return running_.load(); }
+    uint16_t getPort() const { return boundPort_.load(); }
+    HttpServerStats getStats() const;
+};
+
+} // namespace Server
+} // namespace MovieBooking
@@ -14,6 +14,11 @@
 #include "../models/Show.h"
 #include "../repositories/BookingRepository.h"
 #include "../repositories/ShowRepository.h"
+#include "../utils/BookingError.h"
+#include "../utils/Metrics.h"
+#include "../utils/StripedLockTable.h"
+#include "../utils/TimerWheel.h"
+#include "../utils/Task.h"
 
 namespace MovieBooking {
 namespace Services {
@@ -27,8 +32,17 @@ struct BookingResult {
     
     BookingResult(bool success, const std::string& message = "")
         : success(success), message(message) {}
+    
+    static BookingResult fromError(const Utils::BookingError& error) {
+        BookingResult result(false, error.getMessage());
+        result.failedSeatIds = error.seatIds;
+        return result;
+    }
 };
 
+// Pending booking, or the expected reason there is none
+using InitiatedBooking = Utils::Expected<std::unique_ptr<Models::Booking>, Utils::BookingError>;
+
 // Seat selection request
 struct SeatSelectionRequest {
     int showId;
@@ -40,22 +54,41 @@ struct SeatSelectionRequest {
         : showId(showId), seatIds(seatIds), userId(userId) {}
 };
 
-// Booking service with thread safety and concurrency control
+// Seat lock scheduled for release when its lockedUntil deadline passes
+struct SeatLockExpiry {
+    int showId;
+    int bookingId;
+};
+
+// Booking service with thread safety and concurrency control.
+// *Task methods are coroutines that suspend across MySQL and gateway calls, so
+// no thread is parked per in-flight booking; the booking workflow *Async
+// methods are std::future adapters over them. The remaining *Async methods
+// run on the shared Utils::Executors::io() pool.
 class BookingService {
 private:
     std::unique_ptr<Repositories::BookingRepository> bookingRepository_;
     std::unique_ptr<Repositories::ShowRepository> showRepository_;
     
-    // Thread safety for seat locking
-    std::unordered_map<int, std::unique_ptr<std::mutex>> showMutexes_;
-    std::mutex showMutexesMutex_;
+    // Thread safety for seat locking, striped by showId
+    Utils::StripedLockTable showLocks_;
     
-    // Background cleanup thread
+    // Background cleanup thread (periodic safety-net sweep)
     std::atomic<bool> running_;
     std::thread cleanupThread_;
     std::condition_variable cleanupCondition_;
     std::mutex cleanupMutex_;
     
+    // Deadline-driven lock expiry: attemptSeatLocking schedules every seat lock
+    // on the wheel at its lockedUntil time. expiryThread_, run by start(),
+    // advances the wheel each tick and releases what expired in chunks of
+    // expiryBatchSize_ bookings, one statement per chunk. Firing is idempotent
+    // (only still-LOCKED seats of a still-PENDING booking are released), so
+    // confirmed bookings are never cancelled off the wheel.
+    Utils::TimerWheel<SeatLockExpiry> lockExpiryWheel_;
+    std::thread expiryThread_;
+    size_t expiryBatchSize_;
+    
     // Configuration
     int defaultLockDurationMinutes_;
     int cleanupIntervalMinutes_;
@@ -66,27 +99,51 @@ public:
                    std::unique_ptr<Repositories::ShowRepository> showRepository,
                    int defaultLockDurationMinutes = 15,
                    int cleanupIntervalMinutes = 5,
-                   int maxBookingRetries = 3);
+                   int maxBookingRetries = 3,
+                   size_t showLockStripes = 64);
     
     ~BookingService();
 
-    // Core booking operations
-    std::future<BookingResult> initiateBookingAsync(const SeatSelectionRequest& request);
+    // Core booking operations.
+    // tryInitiateBooking* return seat conflicts and the other BookingError
+    // outcomes as values, so a contended sale never throws; exceptions are
+    // left to database and other infrastructure failures. initiateBooking*
+    // wrap them with BookingResult::fromError.
+    Utils::Task<InitiatedBooking> tryInitiateBookingTask(SeatSelectionRequest request);
+    std::future<InitiatedBooking> tryInitiateBookingAsync(const SeatSelectionRequest& request) {
+        return Utils::toFuture(tryInitiateBookingTask(request));
+    }
+    InitiatedBooking tryInitiateBooking(const SeatSelectionRequest& request);
+    
+    Utils::Task<BookingResult> initiateBookingTask(SeatSelectionRequest request);
+    std::future<BookingResult> initiateBookingAsync(const SeatSelectionRequest& request) {
+        return Utils::toFuture(initiateBookingTask(request));
+    }
     BookingResult initiateBooking(const SeatSelectionRequest& request);
     
-    std::future<BookingResult> confirmBookingAsync(int bookingId, const std::string& paymentId);
+    Utils::Task<BookingResult> confirmBookingTask(int bookingId, std::string paymentId);
+    std::future<BookingResult> confirmBookingAsync(int bookingId, const std::string& paymentId) {
+        return Utils::toFuture(confirmBookingTask(bookingId, paymentId));
+    }
     BookingResult confirmBooking(int bookingId, const std::string& paymentId);
     
-    std::future<bool> cancelBookingAsync(int bookingId, int userId);
+    Utils::Task<bool> cancelBookingTask(int bookingId, int userId);
+    std::future<bool> cancelBookingAsync(int bookingId, int userId) {
+        return Utils::toFuture(cancelBookingTask(bookingId, userId));
+    }
     bool cancelBooking(int bookingId, int userId);
     
-    std::future<bool> releaseExpiredBookingAsync(int bookingId);
+    Utils::Task<bool> releaseExpiredBookingTask(int bookingId);
+    std::future<bool> releaseExpiredBookingAsync(int bookingId) {
+        return Utils::toFuture(releaseExpiredBookingTask(bookingId));
+    }
     bool releaseExpiredBooking(int bookingId);
     
     // Seat availability and selection
-    std::future<std::vector<Models::ShowSeat*>> getAvailableSeatsAsync(int showId);
-    std::vector<Models::ShowSeat*> getAvailableSeats(int showId);
+    std::future<std::vector<Models::ShowSeat>> getAvailableSeatsAsync(int showId);
+    std::vector<Models::ShowSeat> getAvailableSeats(int showId);
     
+    // All-or-nothing; returns the seat ids that could not be locked (empty on success)
     std::future<std::vector<int>> lockSeatsAsync(int showId, const std::vector<int>& seatIds, int bookingId);
     std::vector<int> lockSeats(int showId, const std::vector<int>& seatIds, int bookingId);
     
@@ -114,8 +171,28 @@ public:
     // Configuration
     void setDefaultLockDuration(int minutes) { defaultLockDurationMinutes_ = minutes; }
     void setCleanupInterval(int minutes) { cleanupIntervalMinutes_ = minutes; }
+    void setExpiryBatchSize(size_t size) { expiryBatchSize_ = size; }
     void setMaxBookingRetries(int retries) { maxBookingRetries_ = retries; }
     
+    // Show lock table sizing
+    size_t getShowLockStripeCount() const { return showLocks_.getStripeCount(); }
+    std::vector<Utils::StripedLockTable::StripeStats> getShowLockStats() const { return showLocks_.getStripeStats(); }
+    
+    // Show lock contention for a registry collector:
+    //   registry.addCollector([&service](auto& out) { service.collectMetrics(out); })
+    void collectMetrics(Utils::MetricsWriter& out) const {
+        uint64_t acquisitions = 0;
+        uint64_t contended = 0;
+        for (const auto& stripe : showLocks_.getStripeStats()) {
+            acquisitions += stripe.acquisitions;
+            contended += stripe.contended;
+        }
+        out.counter("booking_show_lock_acquisitions_total", "Show lock acquisitions", {}, acquisitions);
+        out.counter("booking_show_lock_contended_total", "Show lock acquisitions that had to wait", {}, contended);
+        out.summary("booking_show_lock_wait_seconds", "Time blocked on a contended show lock", {},
+                    showLocks_.getContendedWaitTime());
+    }
+    
     // Service lifecycle
     void start();
     void stop();
@@ -123,17 +200,20 @@ public:
 
 private:
     // Thread safety helpers
-    std::mutex& getShowMutex(int showId);
-    void cleanupShowMutex(int showId);
+    std::unique_lock<std::mutex> lockShow(int showId) { return showLocks_.lock(showId); }
     
     // Core booking logic
     BookingResult processBookingRequest(const SeatSelectionRequest& request);
-    bool validateSeatSelection(const SeatSelectionRequest& request);
-    double calculateTotalPrice(const std::vector<Models::ShowSeat*>& seats);
+    Utils::Task<BookingResult> processBookingRequestTask(SeatSelectionRequest request);
+    Utils::Expected<void, Utils::BookingError> validateSeatSelection(const SeatSelectionRequest& request);
+    double calculateTotalPrice(const std::vector<Models::ShowSeat>& seats);
     std::unique_ptr<Models::Booking> createPendingBooking(const SeatSelectionRequest& request, double totalPrice);
+    Utils::Task<std::unique_ptr<Models::Booking>> createPendingBookingTask(SeatSelectionRequest request, double totalPrice);
     
-    // Seat management
-    bool attemptSeatLocking(int showId, const std::vector<int>& seatIds, int bookingId);
+    // Seat management (attemptSeatLocking: ShowRepository::lockShowSeats under
+    // the show lock; schedules the lock's expiry)
+    Utils::Expected<std::chrono::system_clock::time_point, Utils::BookingError>
+    attemptSeatLocking(int showId, const std::vector<int>& seatIds, int bookingId);
     void releaseSeatLocks(int showId, const std::vector<int>& seatIds, int bookingId);
     bool confirmSeatBooking(int showId, const std::vector<int>& seatIds, int bookingId);
     
@@ -142,6 +222,11 @@ private:
     void processExpiredBookings();
     void processExpiredLocks();
     
+    // Timer-wheel lock expiry
+    void scheduleLockExpiry(int showId, int bookingId, std::chrono::system_clock::time_point lockedUntil);
+    void expiryWorker();
+    void releaseExpiredLockBatch(const std::vector<SeatLockExpiry>& expired);
+    
     // Error handling and logging
     void logBookingAttempt(const SeatSelectionRequest& request, const BookingResult& result);
     void logError(const std::string& operation, const std::string& error);
@@ -152,7 +237,7 @@ private:
     std::string generateBookingReference();
 };
 
-// Booking manager for high-level operations
+// Booking manager for high-level operations (async variants as in BookingService)
 class BookingManager {
 private:
     std::unique_ptr<BookingService> bookingService_;
@@ -161,11 +246,17 @@ public:
     explicit BookingManager(std::unique_ptr<BookingService> bookingService);
     
     // High-level booking workflow
-    std::future<BookingResult> bookTicketsAsync(int userId, int showId, const std::vector<int>& seatIds);
+    Utils::Task<BookingResult> bookTicketsTask(int userId, int showId, std::vector<int> seatIds);
+    std::future<BookingResult> bookTicketsAsync(int userId, int showId, const std::vector<int>& seatIds) {
+        return Utils::toFuture(bookTicketsTask(userId, showId, seatIds));
+    }
     BookingResult bookTickets(int userId, int showId, const std::vector<int>& seatIds);
     
     // Payment workflow
-    std::future<BookingResult> processPaymentAsync(int bookingId, const std::string& paymentMethod);
+    Utils::Task<BookingResult> processPaymentTask(int bookingId, std::string paymentMethod);
+    std::future<BookingResult> processPaymentAsync(int bookingId, const std::string& paymentMethod) {
+        return Utils::toFuture(processPaymentTask(bookingId, paymentMethod));
+    }
     BookingResult processPayment(int bookingId, const std::string& paymentMethod);
     
     // User operations
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "../models/Show.h"
+#include "../utils/EventStream.h"
+#include "../utils/Metrics.h"
+
+namespace MovieBooking {
+namespace Services {
+
+// Pushes seat deltas to watching clients as server-sent events, so seat maps
+// stay live without polling getAvailableSeats.
+//
+// A watch starts with a "snapshot" event, {"version":N,"layout":{...}} with
+// the layout of Show::writeCompactLayout. Every later change to that show
+// follows as a "seats" event (SeatDelta::writeJson) whose SSE id is its
+// version. Clients skip deltas at or below the snapshot's version and
+// reconnect when a version is missing; a snapshot version of 0 means the
+// first delta sets the baseline. Each delta is serialized once, however many
+// clients watch its show.
+class SeatChangeFeed {
+public:
+    struct Stats {
+        size_t watchers;
+        size_t watchedShows;
+        uint64_t eventsSent;
+        uint64_t watchersDropped; // disconnected, or too far behind
+    };
+
+private:
+    struct Watchers {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<Utils::EventStream>> streams;
+        bool retired = false; // removed from byShow_; watch() must not join it
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<int, std::shared_ptr<Watchers>> byShow_;
+    size_t maxPendingBytes_;
+    std::atomic<uint64_t> eventsSent_{0};
+    std::atomic<uint64_t> watchersDropped_{0};
+    Utils::ScopedCollector metricsCollector_;
+    Utils::EventBus<Models::SeatDelta>::Subscription subscription_;
+
+public:
+    // A watcher more than maxPendingBytes behind is disconnected
+    explicit SeatChangeFeed(size_t maxPendingBytes = 256 * 1024);
+    // Closes every stream, which ends its connection
+    ~SeatChangeFeed();
+
+    SeatChangeFeed(const SeatChangeFeed&) = delete;
+    SeatChangeFeed& operator=(const SeatChangeFeed&) = delete;
+
+    // Stream of `show`'s seat changes, primed with its snapshot
+    std::shared_ptr<Utils::EventStream> watch(const Models::Show& show, size_t seatsPerRow = 0);
+    Stats getStats() const;
+
+private:
+    void onDelta(const Models::SeatDelta& delta);
+    void collectMetrics(Utils::MetricsWriter& out) const;
+};
+
+} // namespace Services
+} // namespace MovieBooking
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace MovieBooking {
+namespace Services {
+
+// Time slot on one screen, as proposed by a show creation request
+struct ScheduleSlot {
+    int screenId;
+    std::chrono::system_clock::time_point startTime;
+    std::chrono::system_clock::time_point endTime;
+};
+
+// First conflict found for one slot of a batch: either an indexed show
+// (showId) or an earlier-starting slot of the same batch (otherSlot)
+struct ScheduleConflict {
+    static constexpr size_t kNoSlot = static_cast<size_t>(-1);
+
+    size_t slot;                 // index into the validated batch
+    int showId = -1;             // conflicting show, or -1
+    size_t otherSlot = kNoSlot;  // conflicting batch slot, or kNoSlot
+};
+
+// In-memory index of scheduled shows per screen, for conflict checks that
+// never reach MySQL.
+//
+// Each screen keeps its shows ordered by start time together with the longest
+// duration seen on it. A show overlapping [start, end) must start after
+// start - longestDuration and before end, so a check is one ordered-map seek
+// plus a scan of that window: O(log n) for non-overlapping schedules, and
+// still exact if legacy data holds overlapping shows. Intervals are half-open,
+// so back-to-back shows do not conflict.
+//
+// Readers lock only the screen they check, shared. Writers are serialized on
+// locationsMutex_ and lock the screens they touch exclusively.
+class ShowScheduleIndex {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+private:
+    struct Entry {
+        int showId;
+        TimePoint endTime;
+    };
+
+    struct Screen {
+        mutable std::shared_mutex mutex;
+        std::multimap<TimePoint, Entry> byStart;
+        TimePoint::duration longestDuration{0}; // never shrinks, which only widens the scan
+    };
+
+    struct Location {
+        int screenId;
+        TimePoint startTime;
+    };
+
+    mutable std::shared_mutex screensMutex_;
+    std::unordered_map<int, std::unique_ptr<Screen>> screens_;
+
+    // showId -> where it is indexed, for updates and removals
+    mutable std::mutex locationsMutex_;
+    std::unordered_map<int, Location> locations_;
+
+public:
+    ShowScheduleIndex() = default;
+    ShowScheduleIndex(const ShowScheduleIndex&) = delete;
+    ShowScheduleIndex& operator=(const ShowScheduleIndex&) = delete;
+
+    // Index a show, replacing any earlier slot for the same showId
+    void add(int showId, const ScheduleSlot& slot);
+    // Check and add under the screen lock, so two creators cannot both take a
+    // slot; false (nothing added) if it conflicts with another show
+    bool tryAdd(int showId, const ScheduleSlot& slot);
+    bool remove(int showId);
+    void clear();
+
+    bool hasConflict(const ScheduleSlot& slot, int excludeShowId = -1) const;
+    // Ids of every indexed show overlapping the slot, in start time order
+    std::vector<int> findConflicts(const ScheduleSlot& slot, int excludeShowId = -1) const;
+
+    // Validate a whole batch in one pass: slots are grouped by screen and swept
+    // in start order, each screen locked once. Reports the first conflict of
+    // every conflicting slot, against the index or an earlier slot of the
+    // batch, ordered by slot index.
+    std::vector<ScheduleConflict> validateBatch(const std::vector<ScheduleSlot>& slots) const;
+
+    size_t size() const;
+    size_t getScreenCount() const;
+
+private:
+    Screen* findScreen(int screenId) const;
+    Screen& screenFor(int screenId);
+
+    // Caller holds screen.mutex (shared or exclusive). Calls fn(showId) for
+    // each overlap until fn returns false.
+    template<typename Fn>
+    static void forEachOverlap(const Screen& screen, TimePoint start, TimePoint end, int excludeShowId, Fn&& fn);
+    // Caller holds screen.mutex exclusively
+    static void eraseEntry(Screen& screen, int showId, TimePoint start);
+    static void insertEntry(Screen& screen, int showId, const ScheduleSlot& slot);
+};
+
+} // namespace Services
+} // namespace MovieBooking
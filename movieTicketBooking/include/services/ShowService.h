@@ -6,11 +6,17 @@
 #include <mutex>
 #include <unordered_map>
 #include <chrono>
+#include <atomic>
 
 #include "../models/Show.h"
 #include "../models/Movie.h"
 #include "../models/Screen.h"
 #include "../repositories/ShowRepository.h"
+#include "ShowScheduleIndex.h"
+#include "../utils/Metrics.h"
+#include "../utils/ShardedLruCache.h"
+#include "../utils/SingleFlight.h"
+#include "../utils/ThreadPool.h"
 
 namespace MovieBooking {
 namespace Services {
@@ -45,31 +51,55 @@ struct ShowSearchCriteria {
     }
 };
 
-// Show service with caching and optimization
+// Seat views together with the show snapshot that owns them, so the views
+// stay valid after the snapshot is evicted from the cache
+struct ShowSeatsSnapshot {
+    std::shared_ptr<const Models::Show> show;
+    std::vector<Models::ShowSeat> seats;
+};
+
+// Show service with caching and optimization.
+// *Async methods run on the shared Utils::Executors::io() pool; when its queue
+// is full the caller blocks (back-pressure) instead of spawning a thread.
 class ShowService {
 private:
     std::unique_ptr<Repositories::ShowRepository> showRepository_;
     
-    // Caching
-    std::unordered_map<int, std::unique_ptr<Models::Show>> showCache_;
-    std::mutex cacheMutex_;
+    // Caching: immutable Show snapshots in a sharded LRU with inline TTL
+    using ShowCache = Utils::ShardedLruCache<int, Models::Show>;
+    ShowCache showCache_;
     std::chrono::seconds cacheExpiry_;
-    std::unordered_map<int, std::chrono::system_clock::time_point> cacheTimestamps_;
+    
+    // Concurrent cache misses for one showId share a single repository load
+    Utils::SingleFlight<int, std::shared_ptr<const Models::Show>> showLoads_;
+    
+    // Scheduled and in-progress shows per screen. Until loadScheduleIndex()
+    // succeeds, conflict checks go to the repository.
+    ShowScheduleIndex scheduleIndex_;
+    std::atomic<bool> scheduleIndexLoaded_{false};
     
     // Configuration
     int maxCacheSize_;
     bool enableCaching_;
     
+    // Seat deltas from Show::seatEvents() swap in updated copies of cached
+    // snapshots, so reservations no longer evict shows. Declared last, so it is set up after
+    // the cache and dropped before it.
+    std::atomic<uint64_t> seatDeltasApplied_{0};
+    Utils::EventBus<Models::SeatDelta>::Subscription seatEventSubscription_ =
+        Models::Show::seatEvents().subscribe([this](const Models::SeatDelta& delta) { applySeatDelta(delta); });
+    
 public:
     explicit ShowService(std::unique_ptr<Repositories::ShowRepository> showRepository,
-                         int maxCacheSize = 1000, bool enableCaching = true);
+                         int maxCacheSize = 1000, bool enableCaching = true,
+                         size_t cacheShards = 16);
     
     // Show CRUD operations
     std::future<std::unique_ptr<Models::Show>> createShowAsync(const ShowCreationRequest& request);
     std::unique_ptr<Models::Show> createShow(const ShowCreationRequest& request);
     
-    std::future<std::unique_ptr<Models::Show>> getShowAsync(int showId);
-    std::unique_ptr<Models::Show> getShow(int showId);
+    std::future<std::shared_ptr<const Models::Show>> getShowAsync(int showId);
+    std::shared_ptr<const Models::Show> getShow(int showId);
     
     std::future<bool> updateShowAsync(const Models::Show& show);
     bool updateShow(const Models::Show& show);
@@ -94,11 +124,11 @@ public:
     std::vector<std::unique_ptr<Models::Show>> getOngoingShows();
     
     // Show seat operations
-    std::future<std::vector<Models::ShowSeat*>> getAvailableSeatsAsync(int showId);
-    std::vector<Models::ShowSeat*> getAvailableSeats(int showId);
+    std::future<ShowSeatsSnapshot> getAvailableSeatsAsync(int showId);
+    ShowSeatsSnapshot getAvailableSeats(int showId);
     
-    std::future<std::vector<Models::ShowSeat*>> getShowSeatingLayoutAsync(int showId);
-    std::vector<Models::ShowSeat*> getShowSeatingLayout(int showId);
+    std::future<ShowSeatsSnapshot> getShowSeatingLayoutAsync(int showId);
+    ShowSeatsSnapshot getShowSeatingLayout(int showId);
     
     std::future<std::vector<int>> lockSeatsAsync(int showId, const std::vector<int>& seatIds, int bookingId);
     std::vector<int> lockSeats(int showId, const std::vector<int>& seatIds, int bookingId);
@@ -116,13 +146,26 @@ public:
     std::future<double> getExpectedRevenueAsync(int showId);
     double getExpectedRevenue(int showId);
     
-    // Conflict detection and validation
+    // Conflict detection and validation. Once the schedule index is loaded,
+    // hasTimeConflict never queries MySQL, and findConflictingShows only does
+    // so to load the shows the index found.
     std::future<bool> hasTimeConflictAsync(const ShowCreationRequest& request, int excludeShowId = -1);
     bool hasTimeConflict(const ShowCreationRequest& request, int excludeShowId = -1);
     
     std::future<std::vector<std::unique_ptr<Models::Show>>> findConflictingShowsAsync(const ShowCreationRequest& request);
     std::vector<std::unique_ptr<Models::Show>> findConflictingShows(const ShowCreationRequest& request);
     
+    // Check a generated schedule in one pass, against existing shows and
+    // within the batch itself; ScheduleConflict::slot indexes `requests`.
+    // Without a loaded index, each screen in the batch is read once instead.
+    std::vector<ScheduleConflict> validateShowBatch(const std::vector<ShowCreationRequest>& requests);
+    
+    // (Re)build the schedule index from the repository's scheduled and
+    // in-progress shows
+    bool loadScheduleIndex();
+    bool isScheduleIndexLoaded() const { return scheduleIndexLoaded_.load(std::memory_order_acquire); }
+    const ShowScheduleIndex& getScheduleIndex() const { return scheduleIndex_; }
+    
     // Batch operations
     std::future<bool> updateShowStatusBatchAsync(const std::vector<int>& showIds, Models::ShowStatus status);
     bool updateShowStatusBatch(const std::vector<int>& showIds, Models::ShowStatus status);
@@ -130,20 +173,73 @@ public:
     std::future<bool> cancelOldShowsAsync(const std::chrono::system_clock::time_point& beforeDate);
     bool cancelOldShows(const std::chrono::system_clock::time_point& beforeDate);
     
-    // Cache management
+    // Cache management. Seat reservations reach the cache as deltas, so
+    // invalidateCache is only needed for other changes to a show.
     void clearCache();
     void invalidateCache(int showId);
-    void setCacheExpiry(std::chrono::seconds expiry) { cacheExpiry_ = expiry; }
-    void setMaxCacheSize(int size) { maxCacheSize_ = size; }
+    void setCacheExpiry(std::chrono::seconds expiry) { cacheExpiry_ = expiry; showCache_.setTtl(expiry); }
+    void setMaxCacheSize(int size) { maxCacheSize_ = size; showCache_.setCapacity(static_cast<size_t>(size)); }
     void enableCaching(bool enable) { enableCaching_ = enable; }
+    std::vector<ShowCache::ShardStats> getCacheStats() const { return showCache_.getShardStats(); }
+    double getLoadCoalescingRate() const { return showLoads_.getCoalescingRate(); }
+    Utils::SingleFlight<int, std::shared_ptr<const Models::Show>>::Stats getLoadCoalescingStats() const {
+        return showLoads_.getStats();
+    }
+    
+    // Show cache effectiveness for a registry collector, summed over shards
+    void collectMetrics(Utils::MetricsWriter& out) const {
+        ShowCache::ShardStats total{0, 0, 0, 0, 0};
+        for (const auto& shard : showCache_.getShardStats()) {
+            total.hits += shard.hits;
+            total.misses += shard.misses;
+            total.evictions += shard.evictions;
+            total.expirations += shard.expirations;
+            total.size += shard.size;
+        }
+        out.counter("show_cache_hits_total", "Show cache hits", {}, total.hits);
+        out.counter("show_cache_misses_total", "Show cache misses", {}, total.misses);
+        out.counter("show_cache_evictions_total", "Show cache entries evicted for capacity", {}, total.evictions);
+        out.counter("show_cache_expirations_total", "Show cache entries dropped after their TTL", {},
+                    total.expirations);
+        out.gauge("show_cache_entries", "Shows currently cached", {}, static_cast<double>(total.size));
+        out.counter("show_cache_seat_deltas_applied_total", "Seat deltas applied to cached shows", {},
+                    seatDeltasApplied_.load(std::memory_order_relaxed));
+        const auto loads = showLoads_.getStats();
+        out.counter("show_loads_total", "Cache-miss show loads requested", {}, loads.calls);
+        out.counter("show_loads_coalesced_total", "Show loads served by an in-flight load", {}, loads.coalesced);
+    }
 
 private:
     // Cache management
-    void updateCache(int showId, std::unique_ptr<Models::Show> show);
-    std::unique_ptr<Models::Show> getFromCache(int showId);
-    bool isCacheValid(int showId);
+    void updateCache(int showId, std::shared_ptr<const Models::Show> show);
+    
+    // Cached snapshots are shared with readers and never written: a delta is
+    // applied to a private copy, which then replaces the entry under the
+    // shard lock. The publishing show itself may be the cached one, which is
+    // already current, and a delta no newer than the snapshot is dropped.
+    void applySeatDelta(const Models::SeatDelta& delta) {
+        if (!enableCaching_) {
+            return;
+        }
+        bool applied = false;
+        showCache_.update(delta.showId, [&delta, &applied](const Models::Show& show) {
+            if (&show == delta.source || delta.version <= show.getSeatVersion()) {
+                return std::shared_ptr<const Models::Show>();
+            }
+            std::shared_ptr<Models::Show> next = show.snapshot();
+            next->applySeatDelta(delta);
+            applied = true;
+            return std::shared_ptr<const Models::Show>(std::move(next));
+        });
+        if (applied) {
+            seatDeltasApplied_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    std::shared_ptr<const Models::Show> getFromCache(int showId);
     void cleanupExpiredCache();
-    void evictOldestEntries();
+    
+    // Cache-miss path: findById + getShowSeats, coalesced per showId through showLoads_
+    std::shared_ptr<const Models::Show> loadShow(int showId);
     
     // Validation helpers
     bool validateShowRequest(const ShowCreationRequest& request);
@@ -152,6 +248,14 @@ private:
     bool isValidScreen(int screenId);
     bool isValidMovie(int movieId);
     
+    // Schedule index maintenance, for every path that creates, moves or
+    // changes the status of a show
+    void indexShow(const Models::Show& show);
+    void unindexShow(int showId) { scheduleIndex_.remove(showId); }
+    static ScheduleSlot slotOf(const ShowCreationRequest& request) {
+        return ScheduleSlot{request.screenId, request.startTime, request.endTime};
+    }
+    
     // Show creation helpers
     std::unique_ptr<Models::Show> buildShowFromRequest(const ShowCreationRequest& request);
     bool createShowSeats(int showId, int screenId, double basePrice);
@@ -168,7 +272,7 @@ private:
     void logError(const std::string& operation, const std::string& error);
 };
 
-// Show manager for high-level operations
+// Show manager for high-level operations (async variants as in ShowService)
 class ShowManager {
 private:
     std::unique_ptr<ShowService> showService_;
@@ -186,7 +290,7 @@ public:
     std::vector<std::unique_ptr<Models::Show>> findAvailableShows(
         int movieId, const std::chrono::system_clock::time_point& date);
     
-    // Show analytics
+    // Show analytics (repository reads only, so replicas serve them when routed)
     std::future<std::vector<std::unique_ptr<Models::Show>>> getPopularShowsAsync(int limit = 10);
     std::vector<std::unique_ptr<Models::Show>> getPopularShows(int limit = 10);
     
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Logger.h"
+
+namespace MovieBooking {
+namespace Utils {
+
+// Compact binary log encoding, decoded offline by tools/log_decoder.
+//
+// A file is kFileMagic followed by records, each starting with a type byte:
+//   BLOCK_START  resets the string table (every FileAppender block begins with one)
+//   STRING       u16 id, u16 length, bytes
+//   ENTRY        u8 level, u8 flags, u32 line, i64 timestamp (us since epoch),
+//                u64 thread hash, u16 file id, u16 function id, u8 category length,
+//                u32 payload length, category bytes, payload
+// The payload is the message, or for a deferred entry (flags & kDeferred) a
+// u16 format-string id followed by LogFormat-encoded arguments, so nothing is
+// formatted at runtime. File, function and format strings are static and are
+// interned per block as STRING records. Integers use host byte order.
+namespace BinaryLog {
+
+constexpr std::string_view kFileMagic{"MBLOG\x01\r\n", 8};
+
+enum class RecordType : uint8_t {
+    BLOCK_START = 1,
+    STRING = 2,
+    ENTRY = 3
+};
+
+constexpr uint8_t kDeferred = 0x01;
+
+template<typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool get(const char*& cursor, const char* end, T& value) {
+    if (static_cast<size_t>(end - cursor) < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+} // namespace BinaryLog
+
+// Formatter for FileAppender that writes the binary encoding above
+class BinaryLogFormatter : public ILogFormatter {
+private:
+    std::unordered_map<const char*, uint16_t> stringIds_; // per block
+
+public:
+    // Not used by FileAppender; returns one self-contained block
+    std::string format(const LogEntry& entry) override {
+        std::string out;
+        beginBlock(out);
+        formatTo(entry, out);
+        return out;
+    }
+
+    std::string_view fileHeader() const override { return BinaryLog::kFileMagic; }
+    bool acceptsDeferred() const override { return true; }
+
+    void beginBlock(std::string& out) override {
+        stringIds_.clear();
+        out += static_cast<char>(BinaryLog::RecordType::BLOCK_START);
+    }
+
+    void formatTo(const LogEntry& entry, std::string& out) override {
+        using namespace BinaryLog;
+        if (stringIds_.size() + 3 > 0xFFFF) {
+            beginBlock(out);
+        }
+        const uint16_t fileId = intern(entry.file, out);
+        const uint16_t functionId = intern(entry.function, out);
+        const uint16_t formatId = entry.isDeferred() ? intern(entry.getFormat(), out) : 0;
+
+        const std::string_view category = entry.getCategory();
+        const std::string_view payload = entry.isDeferred() ? entry.getEncodedArgs() : entry.getMessage();
+        const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+            entry.timestamp.time_since_epoch()).count();
+
+        out += static_cast<char>(RecordType::ENTRY);
+        put<uint8_t>(out, static_cast<uint8_t>(entry.level));
+        put<uint8_t>(out, entry.isDeferred() ? kDeferred : 0);
+        put<uint32_t>(out, static_cast<uint32_t>(entry.line));
+        put<int64_t>(out, static_cast<int64_t>(micros));
+        put<uint64_t>(out, static_cast<uint64_t>(std::hash<std::thread::id>{}(entry.threadId)));
+        put<uint16_t>(out, fileId);
+        put<uint16_t>(out, functionId);
+        put<uint8_t>(out, static_cast<uint8_t>(category.size()));
+        put<uint32_t>(out, static_cast<uint32_t>(payload.size() + (entry.isDeferred() ? 2 : 0)));
+        out.append(category);
+        if (entry.isDeferred()) {
+            put<uint16_t>(out, formatId);
+        }
+        out.append(payload);
+    }
+
+private:
+    uint16_t intern(const char* text, std::string& out) {
+        auto it = stringIds_.find(text);
+        if (it != stringIds_.end()) {
+            return it->second;
+        }
+        const auto id = static_cast<uint16_t>(stringIds_.size());
+        const std::string_view view(text ? text : "");
+        const auto length = static_cast<uint16_t>(std::min<size_t>(view.size(), 0xFFFF));
+        out += static_cast<char>(BinaryLog::RecordType::STRING);
+        BinaryLog::put<uint16_t>(out, id);
+        BinaryLog::put<uint16_t>(out, length);
+        out.append(view.data(), length);
+        stringIds_.emplace(text, id);
+        return id;
+    }
+};
+
+// One decoded ENTRY record
+struct DecodedLogRecord {
+    LogLevel level = LogLevel::INFO;
+    std::chrono::system_clock::time_point timestamp;
+    uint64_t threadHash = 0;
+    std::string file;
+    int line = 0;
+    std::string function;
+    std::string category;
+    std::string message; // deferred entries are rendered here
+
+    std::string toText() const {
+        static constexpr const char* kLevels[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+        const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+            timestamp.time_since_epoch()).count();
+        const std::time_t seconds = static_cast<std::time_t>(micros / 1000000);
+        std::tm tm{};
+        gmtime_r(&seconds, &tm);
+        char time[40];
+        const size_t length = std::strftime(time, sizeof(time), "%Y-%m-%d %H:%M:%S", &tm);
+        std::snprintf(time + length, sizeof(time) - length, ".%06lldZ", static_cast<long long>(micros % 1000000));
+
+        const auto levelIndex = static_cast<size_t>(level);
+        std::string text = time;
+        text += " [";
+        text += levelIndex < 6 ? kLevels[levelIndex] : "?";
+        text += "] [";
+        text += std::to_string(threadHash);
+        text += "] ";
+        if (!category.empty()) {
+            text += "[" + category + "] ";
+        }
+        text += message;
+        text += " (" + file + ":" + std::to_string(line) + " " + function + ")";
+        return text;
+    }
+};
+
+// Streaming decoder over the bytes of one binary log file
+class BinaryLogReader {
+private:
+    const char* cursor_;
+    const char* end_;
+    std::vector<std::string> strings_;
+    bool valid_;
+
+public:
+    BinaryLogReader(const char* data, size_t size) : cursor_(data), end_(data + size), valid_(false) {
+        if (size >= BinaryLog::kFileMagic.size() &&
+            std::string_view(data, BinaryLog::kFileMagic.size()) == BinaryLog::kFileMagic) {
+            cursor_ += BinaryLog::kFileMagic.size();
+            valid_ = true;
+        }
+    }
+
+    // False on a missing magic header
+    bool isValid() const { return valid_; }
+    // Bytes left undecoded, non-zero after a truncated or corrupt record
+    size_t remaining() const { return static_cast<size_t>(end_ - cursor_); }
+
+    // Decode the next ENTRY; false at end of data or on a malformed record
+    bool next(DecodedLogRecord& record) {
+        using namespace BinaryLog;
+        while (valid_ && cursor_ < end_) {
+            const char* start = cursor_;
+            uint8_t type;
+            get(cursor_, end_, type);
+            switch (static_cast<RecordType>(type)) {
+            case RecordType::BLOCK_START:
+                strings_.clear();
+                break;
+            case RecordType::STRING: {
+                uint16_t id;
+                uint16_t length;
+                if (!get(cursor_, end_, id) || !get(cursor_, end_, length) ||
+                    static_cast<size_t>(end_ - cursor_) < length) {
+                    return fail(start);
+                }
+                if (strings_.size() <= id) {
+                    strings_.resize(id + 1);
+                }
+                strings_[id].assign(cursor_, length);
+                cursor_ += length;
+                break;
+            }
+            case RecordType::ENTRY: {
+                if (!readEntry(record)) {
+                    return fail(start);
+                }
+                return true;
+            }
+            default:
+                return fail(start);
+            }
+        }
+        return false;
+    }
+
+private:
+    bool fail(const char* at) {
+        cursor_ = at;
+        valid_ = false;
+        return false;
+    }
+
+    const std::string& lookup(uint16_t id) const {
+        static const std::string unknown = "?";
+        return id < strings_.size() ? strings_[id] : unknown;
+    }
+
+    bool readEntry(DecodedLogRecord& record) {
+        using namespace BinaryLog;
+        uint8_t level, flags, categoryLength;
+        uint32_t line, payloadLength;
+        int64_t micros;
+        uint64_t threadHash;
+        uint16_t fileId, functionId;
+        if (!get(cursor_, end_, level) || !get(cursor_, end_, flags) || !get(cursor_, end_, line) ||
+            !get(cursor_, end_, micros) || !get(cursor_, end_, threadHash) || !get(cursor_, end_, fileId) ||
+            !get(cursor_, end_, functionId) || !get(cursor_, end_, categoryLength) ||
+            !get(cursor_, end_, payloadLength) ||
+            static_cast<size_t>(end_ - cursor_) < size_t{categoryLength} + payloadLength) {
+            return false;
+        }
+        record.level = static_cast<LogLevel>(level);
+        record.line = static_cast<int>(line);
+        record.timestamp = std::chrono::system_clock::time_point(std::chrono::microseconds(micros));
+        record.threadHash = threadHash;
+        record.file = lookup(fileId);
+        record.function = lookup(functionId);
+        record.category.assign(cursor_, categoryLength);
+        cursor_ += categoryLength;
+
+        const char* payload = cursor_;
+        cursor_ += payloadLength;
+        record.message.clear();
+        if (flags & kDeferred) {
+            uint16_t formatId;
+            if (payloadLength < 2 || !get(payload, cursor_, formatId)) {
+                return false;
+            }
+            LogFormat::render(lookup(formatId), payload, static_cast<size_t>(cursor_ - payload), record.message);
+        } else {
+            record.message.assign(payload, payloadLength);
+        }
+        return true;
+    }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
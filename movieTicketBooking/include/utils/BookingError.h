@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Expected.h"
+
+namespace MovieBooking {
+namespace Utils {
+
+class JsonWriter;
+
+// Expected booking outcomes: the failures a sale produces by the thousand
+enum class BookingErrorCode : uint8_t {
+    SEATS_UNAVAILABLE,  // taken by another booking
+    UNKNOWN_SEATS,      // not seats of the show
+    NO_SEATS,           // empty selection
+    INSUFFICIENT_SEATS, // fewer seats free than requested
+    NOT_LOCK_HOLDER,    // the seats are not locked by this booking
+    LOCK_TIMEOUT,       // show lock still contended at its timeout
+    BOOKING_EXPIRED
+};
+
+// Error half of Expected<T, BookingError>, returned where the matching
+// exception in Exceptions.h would otherwise be thrown. Building one costs no
+// more than the seat list; the message is only formatted when a response is.
+// Database, payment and configuration failures stay exceptions.
+struct BookingError {
+    BookingErrorCode code;
+    int showId = 0;
+    int bookingId = 0;
+    std::vector<int> seatIds; // the seats at fault, for the seat codes
+    int requested = 0;        // INSUFFICIENT_SEATS only
+    int available = 0;
+
+    static BookingError seats(BookingErrorCode code, int showId, std::vector<int> seatIds) {
+        return BookingError{code, showId, 0, std::move(seatIds)};
+    }
+
+    // The code's name; statuses are those of the matching exceptions
+    const char* getErrorCode() const;
+    int getHttpStatusCode() const;
+    std::string getMessage() const;
+
+    // {"error":"..","code":"..","seatIds":[..]}
+    void writeJson(JsonWriter& writer) const;
+    // For callers that still report through exceptions
+    [[noreturn]] void raise() const;
+};
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace MovieBooking {
+namespace Utils {
+
+// Consecutive-failure circuit breaker.
+// CLOSED lets everything through. failureThreshold consecutive failures open
+// it; while OPEN every call is refused until openDuration has passed. It then
+// goes HALF_OPEN and admits a single probe: success closes it, failure
+// re-opens it for another openDuration.
+class CircuitBreaker {
+public:
+    enum class State {
+        CLOSED,
+        OPEN,
+        HALF_OPEN
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+private:
+    int failureThreshold_;
+    Clock::duration openDuration_;
+    State state_;
+    int consecutiveFailures_;
+    bool probeInFlight_;
+    Clock::time_point openedAt_;
+    uint64_t timesOpened_;
+    mutable std::mutex mutex_;
+
+public:
+    explicit CircuitBreaker(int failureThreshold = 5,
+                            Clock::duration openDuration = std::chrono::seconds(30))
+        : failureThreshold_(failureThreshold > 0 ? failureThreshold : 1), openDuration_(openDuration),
+          state_(State::CLOSED), consecutiveFailures_(0), probeInFlight_(false), timesOpened_(0) {}
+
+    // Ask to make a call. Every true must be followed by recordSuccess/recordFailure.
+    bool allowRequest(Clock::time_point now = Clock::now()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        switch (state_) {
+        case State::CLOSED:
+            return true;
+        case State::OPEN:
+            if (now - openedAt_ < openDuration_) {
+                return false;
+            }
+            state_ = State::HALF_OPEN;
+            probeInFlight_ = true;
+            return true;
+        case State::HALF_OPEN:
+            if (probeInFlight_) {
+                return false;
+            }
+            probeInFlight_ = true;
+            return true;
+        }
+        return false;
+    }
+
+    void recordSuccess() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        consecutiveFailures_ = 0;
+        probeInFlight_ = false;
+        state_ = State::CLOSED;
+    }
+
+    void recordFailure(Clock::time_point now = Clock::now()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        probeInFlight_ = false;
+        if (state_ == State::HALF_OPEN || ++consecutiveFailures_ >= failureThreshold_) {
+            if (state_ != State::OPEN) {
+                ++timesOpened_;
+            }
+            state_ = State::OPEN;
+            openedAt_ = now;
+            consecutiveFailures_ = 0;
+        }
+    }
+
+    State getState() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return state_;
+    }
+
+    uint64_t getTimesOpened() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return timesOpened_;
+    }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
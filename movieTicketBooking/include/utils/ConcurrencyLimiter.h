@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace MovieBooking {
+namespace Utils {
+
+// Adaptive (AIMD) concurrency limit for calls to one downstream.
+// tryAcquire() never waits: it refuses once inFlight reaches the current limit,
+// so callers can fail over instead of queueing. Each success under
+// latencyTarget grows the limit by about one per limit's worth of calls
+// (additive increase); a failure or a call slower than latencyTarget cuts it
+// by backoffRatio (multiplicative decrease).
+class AdaptiveConcurrencyLimit {
+public:
+    struct Config {
+        double initialLimit = 16;
+        double minLimit = 1;
+        double maxLimit = 256;
+        double backoffRatio = 0.5;
+        std::chrono::milliseconds latencyTarget{2000};
+    };
+
+    struct Stats {
+        int limit;
+        int inFlight;
+        uint64_t rejected;
+    };
+
+private:
+    Config config_;
+    double limit_;
+    int inFlight_;
+    uint64_t rejected_;
+    mutable std::mutex mutex_;
+
+public:
+    AdaptiveConcurrencyLimit() : AdaptiveConcurrencyLimit(Config{}) {}
+    explicit AdaptiveConcurrencyLimit(const Config& config)
+        : config_(config), limit_(std::clamp(config.initialLimit, config.minLimit, config.maxLimit)),
+          inFlight_(0), rejected_(0) {}
+
+    bool tryAcquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (inFlight_ >= static_cast<int>(limit_)) {
+            ++rejected_;
+            return false;
+        }
+        ++inFlight_;
+        return true;
+    }
+
+    // Complete a call admitted by tryAcquire()
+    void release(bool success, std::chrono::steady_clock::duration latency) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --inFlight_;
+        if (success && latency <= config_.latencyTarget) {
+            limit_ = std::min(config_.maxLimit, limit_ + 1.0 / limit_);
+        } else {
+            limit_ = std::max(config_.minLimit, limit_ * config_.backoffRatio);
+        }
+    }
+
+    // Give back a slot that was acquired but never used; the limit is unchanged
+    void releaseUnused() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --inFlight_;
+    }
+
+    Stats getStats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return {static_cast<int>(limit_), inFlight_, rejected_};
+    }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
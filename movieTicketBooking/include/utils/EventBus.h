@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+namespace MovieBooking {
+namespace Utils {
+
+// In-process publish/subscribe for one event type.
+// publish() runs every handler on the publishing thread under a shared lock:
+// handlers must be quick, must not block, and must not publish, subscribe or
+// unsubscribe themselves. Unsubscribing waits for publishes in flight, so no
+// handler runs once its Subscription is gone. Publishers check
+// hasSubscribers() before building an event, which makes an idle bus cost
+// one relaxed load.
+template<typename Event>
+class EventBus {
+public:
+    using Handler = std::function<void(const Event&)>;
+
+    // Registration that is undone on destruction
+    class Subscription {
+    private:
+        EventBus* bus_ = nullptr;
+        uint64_t id_ = 0;
+
+    public:
+        Subscription() = default;
+        Subscription(EventBus& bus, Handler handler) : bus_(&bus), id_(bus.add(std::move(handler))) {}
+        ~Subscription() { reset(); }
+
+        Subscription(Subscription&& other) noexcept : bus_(other.bus_), id_(other.id_) {
+            other.bus_ = nullptr;
+        }
+        Subscription& operator=(Subscription&& other) noexcept {
+            if (this != &other) {
+                reset();
+                bus_ = other.bus_;
+                id_ = other.id_;
+                other.bus_ = nullptr;
+            }
+            return *this;
+        }
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+
+        void reset() {
+            if (bus_) {
+                bus_->remove(id_);
+                bus_ = nullptr;
+            }
+        }
+    };
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::vector<std::pair<uint64_t, Handler>> handlers_;
+    uint64_t nextId_ = 1;
+    std::atomic<size_t> subscriberCount_{0};
+
+public:
+    EventBus() = default;
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    Subscription subscribe(Handler handler) { return Subscription(*this, std::move(handler)); }
+
+    bool hasSubscribers() const { return subscriberCount_.load(std::memory_order_relaxed) > 0; }
+    size_t getSubscriberCount() const { return subscriberCount_.load(std::memory_order_relaxed); }
+
+    // A throwing handler is skipped: the publisher's change has already happened
+    void publish(const Event& event) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        for (const auto& [id, handler] : handlers_) {
+            try {
+                handler(event);
+            } catch (...) {
+            }
+        }
+    }
+
+private:
+    uint64_t add(Handler handler) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        const uint64_t id = nextId_++;
+        handlers_.emplace_back(id, std::move(handler));
+        subscriberCount_.store(handlers_.size(), std::memory_order_relaxed);
+        return id;
+    }
+
+    void remove(uint64_t id) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        for (auto it = handlers_.begin(); it != handlers_.end(); ++it) {
+            if (it->first == id) {
+                handlers_.erase(it);
+                break;
+            }
+        }
+        subscriberCount_.store(handlers_.size(), std::memory_order_relaxed);
+    }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace MovieBooking {
+namespace Utils {
+
+// Body of a streaming server-sent-events response.
+// Producers on any thread queue events with send(); the HTTP server loop that
+// owns the connection drains them to the socket. A client more than
+// maxPendingBytes behind is cut off instead of buffered without bound: the
+// stream closes, and EventSource clients reconnect and start from a fresh
+// snapshot. Either side may close(); producers drop a stream once !isOpen().
+class EventStream {
+private:
+    mutable std::mutex mutex_;
+    std::string pending_;
+    size_t maxPendingBytes_;
+    bool open_ = true;
+    // Set by the server; called under mutex_ when pending_ stops being empty
+    // and on close, so it must only schedule a drain
+    std::function<void()> onReadable_;
+
+public:
+    explicit EventStream(size_t maxPendingBytes = 256 * 1024) : maxPendingBytes_(maxPendingBytes) {}
+
+    EventStream(const EventStream&) = delete;
+    EventStream& operator=(const EventStream&) = delete;
+
+    // Queue one event; multi-line data is split over several data: lines.
+    // False once the stream is closed, including by this call overflowing it.
+    bool send(std::string_view event, std::string_view data, std::string_view id = {}) {
+        std::string text;
+        text.reserve(event.size() + data.size() + id.size() + 24);
+        if (!id.empty()) {
+            text.append("id: ").append(id).append("\n");
+        }
+        if (!event.empty()) {
+            text.append("event: ").append(event).append("\n");
+        }
+        size_t start = 0;
+        do {
+            const size_t end = std::min(data.find('\n', start), data.size());
+            text.append("data: ").append(data.substr(start, end - start)).append("\n");
+            start = end + 1;
+        } while (start <= data.size());
+        text += '\n';
+        return append(text);
+    }
+
+    // Comment line, ignored by clients; keeps idle connections from timing out
+    bool comment(std::string_view text) {
+        std::string line;
+        line.append(": ").append(text).append("\n\n");
+        return append(line);
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (open_) {
+            open_ = false;
+            if (onReadable_) {
+                onReadable_();
+            }
+        }
+    }
+
+    bool isOpen() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return open_;
+    }
+
+    // Server side. The callback fires at once if events are already queued.
+    void setReadableCallback(std::function<void()> callback) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        onReadable_ = std::move(callback);
+        if (onReadable_ && (!pending_.empty() || !open_)) {
+            onReadable_();
+        }
+    }
+
+    // Move queued bytes onto `out`; false once the stream is closed, after
+    // which the connection ends when `out` has been written
+    bool drain(std::string& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out += pending_;
+        pending_.clear();
+        return open_;
+    }
+
+private:
+    bool append(std::string_view text) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!open_) {
+            return false;
+        }
+        if (pending_.size() + text.size() > maxPendingBytes_) {
+            pending_.clear();
+            open_ = false;
+        } else {
+            const bool wasEmpty = pending_.empty();
+            pending_ += text;
+            if (!wasEmpty) {
+                return true;
+            }
+        }
+        if (onReadable_) {
+            onReadable_();
+        }
+        return open_;
+    }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <exception>
+#include <memory>
 #include <stdexcept>
 
 namespace MovieBooking {
@@ -77,6 +78,9 @@ public:
         : MovieBookingException(message, "CONFLICT_ERROR", 409), conflictType_(conflictType) {}
     
     const std::string& getConflictType() const { return conflictType_; }
+    
+private:
+    std::string conflictType_;
 };
 
 class SeatAlreadyBookedException : public ConflictException {
@@ -100,6 +104,9 @@ public:
         : MovieBookingException(message, "BUSINESS_RULE_VIOLATION", 422), rule_(rule) {}
     
     const std::string& getRule() const { return rule_; }
+    
+private:
+    std::string rule_;
 };
 
 class BookingExpiredException : public BusinessRuleException {
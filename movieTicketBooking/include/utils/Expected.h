@@ -0,0 +1,109 @@
+#pragma once
+
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace MovieBooking {
+namespace Utils {
+
+// Error half of an Expected, as in makeUnexpected(error)
+template<typename E>
+struct Unexpected {
+    E error;
+};
+
+template<typename E>
+Unexpected<std::decay_t<E>> makeUnexpected(E&& error) {
+    return {std::forward<E>(error)};
+}
+
+// Thrown by Expected::value() when it holds an error, which it carries
+template<typename E>
+class BadExpectedAccess : public std::exception {
+private:
+    E error_;
+
+public:
+    explicit BadExpectedAccess(E error) : error_(std::move(error)) {}
+    const char* what() const noexcept override { return "bad Expected access"; }
+    const E& error() const noexcept { return error_; }
+};
+
+// Value or error, for outcomes a caller is expected to handle, where
+// throwing would put unwinding on a hot path. A subset of C++23
+// std::expected under the same member names, so call sites move over to it
+// unchanged. value() throws BadExpectedAccess on an error; operator*,
+// operator-> and error() do not check, as there: test has_value() first.
+template<typename T, typename E>
+class Expected {
+private:
+    std::variant<T, E> storage_;
+
+public:
+    template<typename U = T, typename = std::enable_if_t<std::is_constructible_v<T, U&&>>>
+    Expected(U&& value) : storage_(std::in_place_index<0>, std::forward<U>(value)) {}
+    template<typename G>
+    Expected(Unexpected<G> error) : storage_(std::in_place_index<1>, std::move(error.error)) {}
+
+    bool has_value() const { return storage_.index() == 0; }
+    explicit operator bool() const { return has_value(); }
+
+    T& value() & {
+        checkValue();
+        return **this;
+    }
+    const T& value() const& {
+        checkValue();
+        return **this;
+    }
+    T&& value() && {
+        checkValue();
+        return std::move(**this);
+    }
+    T& operator*() & { return *std::get_if<0>(&storage_); }
+    const T& operator*() const& { return *std::get_if<0>(&storage_); }
+    T&& operator*() && { return std::move(*std::get_if<0>(&storage_)); }
+    T* operator->() { return std::get_if<0>(&storage_); }
+    const T* operator->() const { return std::get_if<0>(&storage_); }
+
+    E& error() & { return *std::get_if<1>(&storage_); }
+    const E& error() const& { return *std::get_if<1>(&storage_); }
+    E&& error() && { return std::move(*std::get_if<1>(&storage_)); }
+
+private:
+    void checkValue() const {
+        if (!has_value()) {
+            throw BadExpectedAccess<E>(error());
+        }
+    }
+};
+
+// Success without a value
+template<typename E>
+class Expected<void, E> {
+private:
+    std::variant<std::monostate, E> storage_;
+
+public:
+    Expected() = default;
+    template<typename G>
+    Expected(Unexpected<G> error) : storage_(std::in_place_index<1>, std::move(error.error)) {}
+
+    bool has_value() const { return storage_.index() == 0; }
+    explicit operator bool() const { return has_value(); }
+
+    void value() const {
+        if (!has_value()) {
+            throw BadExpectedAccess<E>(error());
+        }
+    }
+
+    E& error() & { return *std::get_if<1>(&storage_); }
+    const E& error() const& { return *std::get_if<1>(&storage_); }
+    E&& error() && { return std::move(*std::get_if<1>(&storage_)); }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace MovieBooking {
+namespace Utils {
+
+// Streaming JSON serializer that appends to a caller-owned buffer.
+// Nothing is built per value: numbers go through std::to_chars and strings are
+// escaped straight into the buffer, so serializing a whole response costs the
+// buffer's growth and nothing else. Reuse one buffer (e.g. clear() a
+// thread_local string, or write into HttpResponse::body) to skip even that.
+//
+// Commas are placed automatically; the caller is responsible for balancing
+// begin/end calls and for calling key() before each value inside an object.
+//
+//   JsonWriter json(response.body);
+//   json.beginObject();
+//   json.field("id", show.getId());
+//   json.key("seats");
+//   json.beginArray();
+//   ...
+class JsonWriter {
+private:
+    std::string& out_;
+    bool needComma_ = false;
+
+public:
+    explicit JsonWriter(std::string& out) : out_(out) {}
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    std::string& buffer() { return out_; }
+    const std::string& str() const { return out_; }
+
+    // Drop the output but keep the buffer's capacity
+    void clear() {
+        out_.clear();
+        needComma_ = false;
+    }
+
+    void beginObject() { open('{'); }
+    void endObject() { close('}'); }
+    void beginArray() { open('['); }
+    void endArray() { close(']'); }
+
+    void key(std::string_view name) {
+        separate();
+        appendString(name);
+        out_ += ':';
+        needComma_ = false;
+    }
+
+    void value(std::string_view text) {
+        separate();
+        appendString(text);
+    }
+    void value(const char* text) { value(std::string_view(text)); }
+    void value(const std::string& text) { value(std::string_view(text)); }
+
+    void value(bool flag) {
+        separate();
+        out_ += flag ? "true" : "false";
+    }
+
+    void value(int number) { integer(number); }
+    void value(long number) { integer(number); }
+    void value(long long number) { integer(number); }
+    void value(unsigned number) { integer(number); }
+    void value(unsigned long number) { integer(number); }
+    void value(unsigned long long number) { integer(number); }
+
+    // Shortest round-trip form; NaN and infinities, which JSON cannot hold, become null
+    void value(double number) {
+        separate();
+        if (!std::isfinite(number)) {
+            out_ += "null";
+            return;
+        }
+        char buffer[32];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), number);
+        out_.append(buffer, result.ptr);
+    }
+
+    // ISO 8601 in UTC with second precision, e.g. "2024-05-01T18:30:00Z"
+    void value(std::chrono::system_clock::time_point time) {
+        separate();
+        const auto seconds = std::chrono::floor<std::chrono::seconds>(time);
+        const auto days = std::chrono::floor<std::chrono::days>(seconds);
+        const std::chrono::year_month_day date(days);
+        const std::chrono::hh_mm_ss<std::chrono::seconds> clock(seconds - days);
+
+        char buffer[24];
+        char* p = buffer;
+        *p++ = '"';
+        p = digits(p, static_cast<int>(date.year()), 4);
+        *p++ = '-';
+        p = digits(p, static_cast<int>(static_cast<unsigned>(date.month())), 2);
+        *p++ = '-';
+        p = digits(p, static_cast<int>(static_cast<unsigned>(date.day())), 2);
+        *p++ = 'T';
+        p = digits(p, static_cast<int>(clock.hours().count()), 2);
+        *p++ = ':';
+        p = digits(p, static_cast<int>(clock.minutes().count()), 2);
+        *p++ = ':';
+        p = digits(p, static_cast<int>(clock.seconds().count()), 2);
+        *p++ = 'Z';
+        *p++ = '"';
+        out_.append(buffer, p);
+    }
+
+    void null() {
+        separate();
+        out_ += "null";
+    }
+
+    // Already-serialized JSON, e.g. the output of a legacy toJson()
+    void raw(std::string_view json) {
+        separate();
+        out_ += json;
+    }
+
+    template<typename T>
+    void field(std::string_view name, const T& fieldValue) {
+        key(name);
+        value(fieldValue);
+    }
+
+private:
+    void separate() {
+        if (needComma_) {
+            out_ += ',';
+        }
+        needComma_ = true;
+    }
+
+    void open(char bracket) {
+        separate();
+        out_ += bracket;
+        needComma_ = false;
+    }
+
+    void close(char bracket) {
+        out_ += bracket;
+        needComma_ = true;
+    }
+
+    template<typename Integer>
+    void integer(Integer number) {
+        separate();
+        char buffer[24];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), number);
+        out_.append(buffer, result.ptr);
+    }
+
+    // Zero-padded to `width`; values are non-negative and fit the width
+    static char* digits(char* p, int number, int width) {
+        for (int i = width - 1; i >= 0; --i) {
+            p[i] = static_cast<char>('0' + number % 10);
+            number /= 10;
+        }
+        return p + width;
+    }
+
+    // Quoted and escaped; unescaped runs are appended in one go
+    void appendString(std::string_view text) {
+        static constexpr char kHex[] = "0123456789abcdef";
+        out_ += '"';
+        size_t runStart = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            const unsigned char c = static_cast<unsigned char>(text[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            out_.append(text.data() + runStart, i - runStart);
+            runStart = i + 1;
+            switch (c) {
+                case '"': out_ += "\\\""; break;
+                case '\\': out_ += "\\\\"; break;
+                case '\n': out_ += "\\n"; break;
+                case '\r': out_ += "\\r"; break;
+                case '\t': out_ += "\\t"; break;
+                case '\b': out_ += "\\b"; break;
+                case '\f': out_ += "\\f"; break;
+                default: {
+                    const char escape[] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF]};
+                    out_.append(escape, sizeof(escape));
+                }
+            }
+        }
+        out_.append(text.data() + runStart, text.size() - runStart);
+        out_ += '"';
+    }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MovieBooking {
+namespace Utils {
+
+// Lock-free log-linear latency histogram (HDR style).
+// Values are bucketed by power of two, each split into 8 linear sub-buckets,
+// which bounds the relative error to 12.5% over the full 64-bit range.
+// record() is a handful of relaxed atomic adds and never allocates.
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 3;
+    static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+    static constexpr size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    struct Snapshot {
+        std::vector<uint64_t> counts; // indexed like the histogram buckets
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+
+        // Upper bound of the bucket holding the q-th quantile (0 <= q <= 1)
+        uint64_t percentile(double q) const {
+            if (count == 0) {
+                return 0;
+            }
+            const uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < counts.size(); ++i) {
+                seen += counts[i];
+                if (seen >= rank) {
+                    return bucketUpperBound(i) < max ? bucketUpperBound(i) : max;
+                }
+            }
+            return max;
+        }
+
+        double mean() const { return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count); }
+    };
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+
+public:
+    void record(uint64_t value) {
+        buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        uint64_t currentMax = max_.load(std::memory_order_relaxed);
+        while (value > currentMax &&
+               !max_.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Durations are recorded in microseconds
+    template<typename Rep, typename Period>
+    void record(std::chrono::duration<Rep, Period> duration) {
+        const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        record(micros > 0 ? static_cast<uint64_t>(micros) : 0);
+    }
+
+    Snapshot snapshot() const {
+        Snapshot snap;
+        snap.counts.resize(kBucketCount);
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            snap.counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        }
+        snap.count = count_.load(std::memory_order_relaxed);
+        snap.sum = sum_.load(std::memory_order_relaxed);
+        snap.max = max_.load(std::memory_order_relaxed);
+        return snap;
+    }
+
+    void reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    static size_t bucketIndex(uint64_t value) {
+        if (value < kSubBuckets) {
+            return static_cast<size_t>(value);
+        }
+        const unsigned exponent = 63 - static_cast<unsigned>(std::countl_zero(value));
+        const size_t subBucket = static_cast<size_t>(value >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+        return (exponent - kSubBucketBits + 1) * kSubBuckets + subBucket;
+    }
+
+    // Largest value that maps to bucket `index`
+    static uint64_t bucketUpperBound(size_t index) {
+        if (index < kSubBuckets) {
+            return index;
+        }
+        const unsigned exponent = static_cast<unsigned>(index / kSubBuckets) + kSubBucketBits - 1;
+        const uint64_t subBucket = index % kSubBuckets;
+        const uint64_t lower = (uint64_t{1} << exponent) | (subBucket << (exponent - kSubBucketBits));
+        return lower + (uint64_t{1} << (exponent - kSubBucketBits)) - 1;
+    }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace MovieBooking {
+namespace Utils {
+
+// fmt-style ("{}" placeholders, "{{" / "}}" escapes) formatting for log
+// messages. Arguments are encoded into a compact byte buffer so formatting can
+// be deferred to the writer thread: the caller only copies scalars and string
+// bytes. Placeholders without an argument are kept verbatim; surplus
+// arguments are ignored.
+namespace LogFormat {
+
+enum class ArgType : uint8_t {
+    BOOL,
+    CHAR,
+    INT64,
+    UINT64,
+    DOUBLE,
+    STRING
+};
+
+// Longer string arguments are truncated
+constexpr size_t kMaxStringArg = 0xFFFF;
+
+template<typename T>
+std::string_view asStringView(const T& value) {
+    if constexpr (std::is_array_v<T>) {
+        return std::string_view(value); // an array is never null
+    } else if constexpr (std::is_pointer_v<T>) {
+        return value ? std::string_view(value) : std::string_view("(null)");
+    } else {
+        return std::string_view(value);
+    }
+}
+
+template<typename T>
+size_t encodedSize(const T& value) {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, bool> || std::is_same_v<U, char>) {
+        return 2;
+    } else if constexpr (std::is_arithmetic_v<U> || std::is_enum_v<U>) {
+        return 1 + 8;
+    } else {
+        static_assert(std::is_convertible_v<const T&, std::string_view>,
+                      "log arguments must be arithmetic, enums, or string-like");
+        return 3 + std::min(asStringView(value).size(), kMaxStringArg);
+    }
+}
+
+template<typename T>
+char* encode(char* out, const T& value) {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, bool>) {
+        *out++ = static_cast<char>(ArgType::BOOL);
+        *out++ = value ? 1 : 0;
+    } else if constexpr (std::is_same_v<U, char>) {
+        *out++ = static_cast<char>(ArgType::CHAR);
+        *out++ = value;
+    } else if constexpr (std::is_floating_point_v<U>) {
+        const double number = static_cast<double>(value);
+        *out++ = static_cast<char>(ArgType::DOUBLE);
+        std::memcpy(out, &number, 8);
+        out += 8;
+    } else if constexpr (std::is_enum_v<U>) {
+        return encode(out, static_cast<std::underlying_type_t<U>>(value));
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+        const int64_t number = value;
+        *out++ = static_cast<char>(ArgType::INT64);
+        std::memcpy(out, &number, 8);
+        out += 8;
+    } else if constexpr (std::is_integral_v<U>) {
+        const uint64_t number = value;
+        *out++ = static_cast<char>(ArgType::UINT64);
+        std::memcpy(out, &number, 8);
+        out += 8;
+    } else {
+        const std::string_view text = asStringView(value);
+        const auto length = static_cast<uint16_t>(std::min(text.size(), kMaxStringArg));
+        *out++ = static_cast<char>(ArgType::STRING);
+        std::memcpy(out, &length, 2);
+        std::memcpy(out + 2, text.data(), length);
+        out += 2 + length;
+    }
+    return out;
+}
+
+template<typename... Args>
+size_t encodedSizeAll(const Args&... args) {
+    return (size_t{0} + ... + encodedSize(args));
+}
+
+template<typename... Args>
+void encodeAll(char* out, const Args&... args) {
+    ((out = encode(out, args)), ...);
+}
+
+// Append one encoded argument to `out`; returns the next argument, or `end`
+// if the argument is truncated (encoded buffers may come from disk)
+inline const char* renderArg(const char* arg, const char* end, std::string& out) {
+    char digits[32];
+    const auto type = static_cast<ArgType>(*arg++);
+    const auto available = static_cast<size_t>(end - arg);
+    const size_t needed = type == ArgType::BOOL || type == ArgType::CHAR ? 1 : type == ArgType::STRING ? 2 : 8;
+    if (available < needed) {
+        return end;
+    }
+    switch (type) {
+    case ArgType::BOOL:
+        out += *arg ? "true" : "false";
+        return arg + 1;
+    case ArgType::CHAR:
+        out += *arg;
+        return arg + 1;
+    case ArgType::INT64: {
+        int64_t number;
+        std::memcpy(&number, arg, 8);
+        out.append(digits, std::to_chars(digits, digits + sizeof(digits), number).ptr);
+        return arg + 8;
+    }
+    case ArgType::UINT64: {
+        uint64_t number;
+        std::memcpy(&number, arg, 8);
+        out.append(digits, std::to_chars(digits, digits + sizeof(digits), number).ptr);
+        return arg + 8;
+    }
+    case ArgType::DOUBLE: {
+        double number;
+        std::memcpy(&number, arg, 8);
+        out.append(digits, std::to_chars(digits, digits + sizeof(digits), number).ptr);
+        return arg + 8;
+    }
+    case ArgType::STRING: {
+        uint16_t length;
+        std::memcpy(&length, arg, 2);
+        if (available < size_t{2} + length) {
+            return end;
+        }
+        out.append(arg + 2, length);
+        return arg + 2 + length;
+    }
+    }
+    return end;
+}
+
+// Append `format` with the encoded arguments substituted to `out`
+inline void render(std::string_view format, const char* args, size_t argsLength, std::string& out) {
+    const char* cursor = args;
+    const char* const end = args + argsLength;
+    for (size_t i = 0; i < format.size(); ++i) {
+        const char c = format[i];
+        if (i + 1 < format.size()) {
+            const char next = format[i + 1];
+            if ((c == '{' && next == '{') || (c == '}' && next == '}')) {
+                out += c;
+                ++i;
+                continue;
+            }
+            if (c == '{' && next == '}' && cursor < end) {
+                cursor = renderArg(cursor, end, out);
+                ++i;
+                continue;
+            }
+        }
+        out += c;
+    }
+}
+
+// Eager formatting, for when arguments cannot be deferred
+template<typename... Args>
+std::string format(std::string_view format, const Args&... args) {
+    std::string encoded(encodedSizeAll(args...), '\0');
+    encodeAll(encoded.data(), args...);
+    std::string out;
+    out.reserve(format.size() + encoded.size());
+    render(format, encoded.data(), encoded.size(), out);
+    return out;
+}
+
+} // namespace LogFormat
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -1,17 +1,25 @@
 #pragma once
 
 #include <string>
-#include <fstream>
 #include <memory>
 #include <mutex>
 #include <chrono>
 #include <sstream>
 #include <iomanip>
 #include <thread>
-#include <queue>
 #include <condition_variable>
 #include <atomic>
 #include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "LogFormat.h"
+#include "MpscRingBuffer.h"
 
 namespace MovieBooking {
 namespace Utils {
@@ -26,21 +34,104 @@ enum class LogLevel {
     FATAL = 5
 };
 
-// Log entry structure
+// Log entry structure.
+// Fixed-size so AsyncAppender can preallocate its slots: messages up to
+// kInlineMessageSize bytes and categories up to kCategorySize bytes are stored
+// inline (longer categories are truncated, longer messages spill to the heap).
+// `file` and `function` must point at static storage (__FILE__, __FUNCTION__).
+// A deferred entry holds a format string plus encoded arguments in the inline
+// buffer instead of a message; materialize() renders it.
 struct LogEntry {
+    static constexpr size_t kInlineMessageSize = 160;
+    static constexpr size_t kCategorySize = 32;
+    
     LogLevel level;
-    std::string message;
-    std::string category;
     std::chrono::system_clock::time_point timestamp;
     std::thread::id threadId;
-    std::string file;
+    const char* file;
     int line;
-    std::string function;
-    
-    LogEntry(LogLevel lvl, const std::string& msg, const std::string& cat = "",
-             const std::string& file = "", int line = 0, const std::string& function = "")
-        : level(lvl), message(msg), category(cat), timestamp(std::chrono::system_clock::now()),
-          threadId(std::this_thread::get_id()), file(file), line(line), function(function) {}
+    const char* function;
+    
+    LogEntry() : level(LogLevel::INFO), file(""), line(0), function("") {}
+    
+    LogEntry(LogLevel lvl, std::string_view msg, std::string_view cat = {},
+             const char* file = "", int line = 0, const char* function = "")
+        : level(lvl), timestamp(std::chrono::system_clock::now()), threadId(std::this_thread::get_id()),
+          file(file ? file : ""), line(line), function(function ? function : "") {
+        setMessage(msg);
+        setCategory(cat);
+    }
+    
+    // For a deferred entry this is the raw format string until materialize()
+    std::string_view getMessage() const {
+        if (format_) {
+            return format_;
+        }
+        return overflow_.empty() ? std::string_view(message_, messageLength_) : std::string_view(overflow_);
+    }
+    std::string_view getCategory() const { return std::string_view(category_, categoryLength_); }
+    
+    void setMessage(std::string_view msg) {
+        format_ = nullptr;
+        if (msg.size() <= kInlineMessageSize) {
+            if (!msg.empty()) {
+                std::memcpy(message_, msg.data(), msg.size());
+            }
+            messageLength_ = static_cast<uint32_t>(msg.size());
+            overflow_.clear();
+        } else {
+            overflow_.assign(msg);
+            messageLength_ = 0;
+        }
+    }
+    
+    void setCategory(std::string_view cat) {
+        categoryLength_ = static_cast<uint8_t>(std::min(cat.size(), kCategorySize));
+        if (categoryLength_ > 0) {
+            std::memcpy(category_, cat.data(), categoryLength_);
+        }
+    }
+    
+    // Capture `format` (static storage) and its arguments for later rendering.
+    // False, with the entry unchanged, if the encoded arguments do not fit inline.
+    template<typename... Args>
+    bool setDeferred(const char* format, const Args&... args) {
+        const size_t size = LogFormat::encodedSizeAll(args...);
+        if (size > kInlineMessageSize) {
+            return false;
+        }
+        LogFormat::encodeAll(message_, args...);
+        messageLength_ = static_cast<uint32_t>(size);
+        overflow_.clear();
+        format_ = format;
+        return true;
+    }
+    
+    bool isDeferred() const { return format_ != nullptr; }
+    // Raw deferred form, for encoders that keep formatting off-line
+    const char* getFormat() const { return format_; }
+    std::string_view getEncodedArgs() const {
+        return format_ ? std::string_view(message_, messageLength_) : std::string_view();
+    }
+    
+    // Render a deferred entry into its message; no-op otherwise
+    void materialize() {
+        if (!format_) {
+            return;
+        }
+        thread_local std::string buffer;
+        buffer.clear();
+        LogFormat::render(format_, message_, messageLength_, buffer);
+        setMessage(buffer);
+    }
+
+private:
+    const char* format_ = nullptr;
+    uint32_t messageLength_ = 0;
+    uint8_t categoryLength_ = 0;
+    char category_[kCategorySize];
+    char message_[kInlineMessageSize];
+    std::string overflow_; // only used past kInlineMessageSize; reuses its capacity
 };
 
 // Log formatter interface
@@ -48,6 +139,19 @@ class ILogFormatter {
 public:
     virtual ~ILogFormatter() = default;
     virtual std::string format(const LogEntry& entry) = 0;
+    
+    // Append one formatted record to a write buffer; text formatters emit a line
+    virtual void formatTo(const LogEntry& entry, std::string& out) {
+        out += format(entry);
+        out += '\n';
+    }
+    
+    // Written once at the start of every file
+    virtual std::string_view fileHeader() const { return {}; }
+    // Called before the first record of every write block
+    virtual void beginBlock(std::string& out) { (void)out; }
+    // True if deferred entries can be encoded without materialize()
+    virtual bool acceptsDeferred() const { return false; }
 };
 
 // Default log formatter
@@ -70,7 +174,7 @@ public:
 private:
     std::string levelToString(LogLevel level) const;
     std::string formatTimestamp(const std::chrono::system_clock::time_point& timestamp) const;
-    std::string extractFileName(const std::string& path) const;
+    std::string_view extractFileName(std::string_view path) const;
 };
 
 // JSON log formatter
@@ -79,7 +183,7 @@ public:
     std::string format(const LogEntry& entry) override;
 
 private:
-    std::string escapeJsonString(const std::string& str) const;
+    std::string escapeJsonString(std::string_view str) const;
     std::string levelToString(LogLevel level) const;
 };
 
@@ -90,6 +194,8 @@ public:
     virtual void append(const LogEntry& entry) = 0;
     virtual void flush() = 0;
     virtual bool isReady() const = 0;
+    // AsyncAppender skips materialize() for appenders that return true
+    virtual bool acceptsDeferred() const { return false; }
 };
 
 // Console appender
@@ -106,71 +212,133 @@ public:
     bool isReady() const override { return true; }
 };
 
-// File appender
+// File appender.
+// append() only formats into an in-memory block under mutex_. Full blocks, or
+// the partial block once flushInterval has passed, are handed to a writer
+// thread that writes them with one writev() on an O_APPEND descriptor and
+// performs size-based rotation, so no caller ever waits on the disk.
 class FileAppender : public ILogAppender {
 private:
     std::string filename_;
     std::unique_ptr<ILogFormatter> formatter_;
-    std::ofstream fileStream_;
-    size_t maxFileSize_;
-    int maxBackupFiles_;
+    std::atomic<int> fd_;     // written by the writer thread only, after construction
+    size_t fileSize_;         // writer thread only
+    std::atomic<size_t> maxFileSize_;
+    std::atomic<int> maxBackupFiles_;
+    size_t blockSize_;
+    std::chrono::milliseconds flushInterval_;
+    
     mutable std::mutex mutex_;
+    std::string activeBlock_;
+    std::vector<std::string> fullBlocks_;
+    std::vector<std::string> freeBlocks_; // recycled capacity
+    std::condition_variable writerCondition_;
+    std::condition_variable flushedCondition_;
+    uint64_t flushRequested_;
+    uint64_t flushCompleted_;
+    bool running_;
+    std::thread writerThread_;
+    
+    std::atomic<uint64_t> bytesWritten_;
+    std::atomic<uint64_t> writeCalls_;
+    std::atomic<uint64_t> rotations_;
     
 public:
     explicit FileAppender(const std::string& filename,
                          std::unique_ptr<ILogFormatter> formatter = nullptr,
                          size_t maxFileSize = 10 * 1024 * 1024, // 10MB
-                         int maxBackupFiles = 5);
+                         int maxBackupFiles = 5,
+                         size_t blockSize = 256 * 1024,
+                         std::chrono::milliseconds flushInterval = std::chrono::milliseconds(200));
     
     ~FileAppender();
     
     void append(const LogEntry& entry) override;
+    // Blocks until everything appended so far has been written
     void flush() override;
     bool isReady() const override;
+    bool acceptsDeferred() const override { return formatter_->acceptsDeferred(); }
     
     // Configuration
-    void setMaxFileSize(size_t size) { maxFileSize_ = size; }
-    void setMaxBackupFiles(int count) { maxBackupFiles_ = count; }
+    void setMaxFileSize(size_t size) { maxFileSize_.store(size, std::memory_order_relaxed); }
+    void setMaxBackupFiles(int count) { maxBackupFiles_.store(count, std::memory_order_relaxed); }
+    
+    // Write statistics
+    uint64_t getBytesWritten() const { return bytesWritten_.load(std::memory_order_relaxed); }
+    uint64_t getWriteCalls() const { return writeCalls_.load(std::memory_order_relaxed); }
+    uint64_t getRotations() const { return rotations_.load(std::memory_order_relaxed); }
 
 private:
     void openFile();
     void rotateFile();
     std::string generateBackupFilename(int backupNumber) const;
+    void writerFunction();
+    void writeBlocks(std::vector<std::string>& blocks);
 };
 
-// Async appender for non-blocking logging
+// What AsyncAppender::append does when the ring is full
+enum class LogOverflowPolicy {
+    DROP,   // discard the entry and count it
+    BLOCK   // spin until the writer frees a slot
+};
+
+// Async appender for non-blocking logging.
+// Producers copy the entry into a preallocated slot of a lock-free MPSC ring
+// (no allocation, no mutex); one writer thread drains it into the underlying
+// appender, rendering deferred entries first. The writer is only signalled
+// when it has gone to sleep.
 class AsyncAppender : public ILogAppender {
 private:
     std::unique_ptr<ILogAppender> underlyingAppender_;
-    std::queue<LogEntry> logQueue_;
-    std::mutex queueMutex_;
-    std::condition_variable queueCondition_;
+    MpscRingBuffer<LogEntry> ring_;
+    std::atomic<LogOverflowPolicy> overflowPolicy_;
     std::atomic<bool> running_;
     std::thread workerThread_;
-    size_t maxQueueSize_;
+    
+    // Writer wake-up; only touched when writerSleeping_ is set
+    std::atomic<bool> writerSleeping_;
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+    
+    std::atomic<uint64_t> enqueued_;
+    std::atomic<uint64_t> written_;
+    std::atomic<uint64_t> dropped_;
     
 public:
-    explicit AsyncAppender(std::unique_ptr<ILogAppender> appender, size_t maxQueueSize = 10000);
+    explicit AsyncAppender(std::unique_ptr<ILogAppender> appender, size_t maxQueueSize = 10000,
+                           LogOverflowPolicy overflowPolicy = LogOverflowPolicy::DROP);
     ~AsyncAppender();
     
     void append(const LogEntry& entry) override;
+    // Wait until everything appended so far is written, then flush downstream
     void flush() override;
     bool isReady() const override;
+    bool acceptsDeferred() const override { return true; } // rendered on the writer thread
     
     void start();
     void stop();
+    
+    void setOverflowPolicy(LogOverflowPolicy policy) { overflowPolicy_.store(policy, std::memory_order_relaxed); }
+    LogOverflowPolicy getOverflowPolicy() const { return overflowPolicy_.load(std::memory_order_relaxed); }
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    size_t getQueueDepth() const { return ring_.size(); }
+    size_t getCapacity() const { return ring_.capacity(); }
 
 private:
     void workerFunction();
+    size_t drain();
+    void wakeWriter();
 };
 
 // Logger class
 class Logger {
 private:
     std::string name_;
-    LogLevel minLevel_;
+    std::atomic<LogLevel> minLevel_;
     std::vector<std::unique_ptr<ILogAppender>> appenders_;
     mutable std::shared_mutex appendersMutex_;
+    // When set, addAppender wraps each appender in an AsyncAppender, so the
+    // LOG_* macros only copy into a ring slot on the calling thread
     bool asyncMode_;
     
 public:
@@ -180,8 +348,9 @@ public:
     ~Logger();
     
     // Configuration
-    void setMinLevel(LogLevel level) { minLevel_ = level; }
-    LogLevel getMinLevel() const { return minLevel_; }
+    // On the root logger this also moves the LOG_* macros' gate
+    void setMinLevel(LogLevel level);
+    LogLevel getMinLevel() const { return minLevel_.load(std::memory_order_relaxed); }
     void setAsyncMode(bool async) { asyncMode_ = async; }
     
     // Appender management
@@ -191,30 +360,45 @@ public:
     size_t getAppenderCount() const;
     
     // Logging methods
-    void log(LogLevel level, const std::string& message, const std::string& category = "",
-             const std::string& file = "", int line = 0, const std::string& function = "");
-    
-    void trace(const std::string& message, const std::string& category = "",
-               const std::string& file = "", int line = 0, const std::string& function = "");
-    
-    void debug(const std::string& message, const std::string& category = "",
-               const std::string& file = "", int line = 0, const std::string& function = "");
-    
-    void info(const std::string& message, const std::string& category = "",
-              const std::string& file = "", int line = 0, const std::string& function = "");
-    
-    void warn(const std::string& message, const std::string& category = "",
-              const std::string& file = "", int line = 0, const std::string& function = "");
-    
-    void error(const std::string& message, const std::string& category = "",
-               const std::string& file = "", int line = 0, const std::string& function = "");
-    
-    void fatal(const std::string& message, const std::string& category = "",
-               const std::string& file = "", int line = 0, const std::string& function = "");
+    void log(LogLevel level, std::string_view message, std::string_view category = {},
+             const char* file = "", int line = 0, const char* function = "");
+    
+    void trace(std::string_view message, std::string_view category = {},
+               const char* file = "", int line = 0, const char* function = "");
+    
+    void debug(std::string_view message, std::string_view category = {},
+               const char* file = "", int line = 0, const char* function = "");
+    
+    void info(std::string_view message, std::string_view category = {},
+              const char* file = "", int line = 0, const char* function = "");
+    
+    void warn(std::string_view message, std::string_view category = {},
+              const char* file = "", int line = 0, const char* function = "");
+    
+    void error(std::string_view message, std::string_view category = {},
+               const char* file = "", int line = 0, const char* function = "");
+    
+    void fatal(std::string_view message, std::string_view category = {},
+               const char* file = "", int line = 0, const char* function = "");
+    
+    // fmt-style "{}" formatting. In async mode the arguments are captured by
+    // value and the message is rendered on the AsyncAppender writer thread.
+    template<typename... Args>
+    void logf(LogLevel level, std::string_view category, const char* file, int line, const char* function,
+              const char* format, const Args&... args) {
+        if (!isLevelEnabled(level)) {
+            return;
+        }
+        LogEntry entry(level, {}, category, file, line, function);
+        if (!asyncMode_ || !entry.setDeferred(format, args...)) {
+            entry.setMessage(LogFormat::format(format, args...));
+        }
+        writeToAppenders(entry);
+    }
     
     // Utility methods
     void flush();
-    bool isLevelEnabled(LogLevel level) const { return level >= minLevel_; }
+    bool isLevelEnabled(LogLevel level) const { return level >= minLevel_.load(std::memory_order_relaxed); }
 
 private:
     void writeToAppenders(const LogEntry& entry);
@@ -231,9 +415,17 @@ private:
     LogLevel globalMinLevel_;
     bool asyncMode_;
     
+    // The root logger's level, which the LOG_* macros log through, for their
+    // lock-free gate; set by setGlobalMinLevel and the root's setMinLevel
+    static inline std::atomic<LogLevel> enabledLevel_{LogLevel::INFO};
+    
     LoggerManager();
     
+    friend class Logger;
+    
 public:
+    static constexpr const char* kRootLoggerName = "root";
+    
     ~LoggerManager();
     
     static LoggerManager& getInstance();
@@ -245,52 +437,120 @@ public:
     void removeAllLoggers();
     
     // Global configuration
-    void setGlobalMinLevel(LogLevel level);
+    void setGlobalMinLevel(LogLevel level) {
+        std::unique_lock<std::shared_mutex> lock(loggersMutex_);
+        globalMinLevel_ = level;
+        for (auto& entry : loggers_) {
+            entry.second->setMinLevel(level);
+        }
+        enabledLevel_.store(level, std::memory_order_relaxed);
+    }
+    
+    // One relaxed load; checked by the LOG_* macros before getInstance() and
+    // before any argument is evaluated
+    static bool isEnabled(LogLevel level) { return level >= enabledLevel_.load(std::memory_order_relaxed); }
     void setAsyncMode(bool async);
     
     // Convenience methods for root logger
-    void log(LogLevel level, const std::string& message, const std::string& category = "",
-             const std::string& file = "", int line = 0, const std::string& function = "");
+    void log(LogLevel level, std::string_view message, std::string_view category = {},
+             const char* file = "", int line = 0, const char* function = "");
     
-    void trace(const std::string& message, const std::string& category = "",
-               const std::string& file = "", int line = 0, const std::string& function = "");
+    void trace(std::string_view message, std::string_view category = {},
+               const char* file = "", int line = 0, const char* function = "");
     
-    void debug(const std::string& message, const std::string& category = "",
-               const std::string& file = "", int line = 0, const std::string& function = "");
+    void debug(std::string_view message, std::string_view category = {},
+               const char* file = "", int line = 0, const char* function = "");
     
-    void info(const std::string& message, const std::string& category = "",
-              const std::string& file = "", int line = 0, const std::string& function = "");
+    void info(std::string_view message, std::string_view category = {},
+              const char* file = "", int line = 0, const char* function = "");
     
-    void warn(const std::string& message, const std::string& category = "",
-              const std::string& file = "", int line = 0, const std::string& function = "");
+    void warn(std::string_view message, std::string_view category = {},
+              const char* file = "", int line = 0, const char* function = "");
     
-    void error(const std::string& message, const std::string& category = "",
-               const std::string& file = "", int line = 0, const std::string& function = "");
+    void error(std::string_view message, std::string_view category = {},
+               const char* file = "", int line = 0, const char* function = "");
     
-    void fatal(const std::string& message, const std::string& category = "",
-               const std::string& file = "", int line = 0, const std::string& function = "");
+    void fatal(std::string_view message, std::string_view category = {},
+               const char* file = "", int line = 0, const char* function = "");
+    
+    template<typename... Args>
+    void logf(LogLevel level, std::string_view category, const char* file, int line, const char* function,
+              const char* format, const Args&... args) {
+        getRootLogger().logf(level, category, file, line, function, format, args...);
+    }
     
     void flushAll();
+    
+    Logger& getRootLogger() { return getOrCreateLogger(kRootLoggerName); }
 
 private:
     Logger& getOrCreateLogger(const std::string& name);
     void configureDefaultLogger();
 };
 
+inline void Logger::setMinLevel(LogLevel level) {
+    minLevel_.store(level, std::memory_order_relaxed);
+    if (name_ == LoggerManager::kRootLoggerName) {
+        LoggerManager::enabledLevel_.store(level, std::memory_order_relaxed);
+    }
+}
+
+// Compile-time floor for the LOG_* macros, as a LogLevel value. Calls below it
+// compile to nothing and their arguments are never evaluated, e.g. build with
+// -DMOVIEBOOKING_LOG_MIN_LEVEL=2 to strip TRACE and DEBUG from release builds.
+#ifndef MOVIEBOOKING_LOG_MIN_LEVEL
+#define MOVIEBOOKING_LOG_MIN_LEVEL 0
+#endif
+
+#define MOVIEBOOKING_LOG_AT(lvl, cat, msg)                                                              \
+    do {                                                                                                \
+        if constexpr (static_cast<int>(lvl) >= MOVIEBOOKING_LOG_MIN_LEVEL) {                           \
+            if (MovieBooking::Utils::LoggerManager::isEnabled(lvl)) {                                  \
+                MovieBooking::Utils::LoggerManager::getInstance().log(lvl, msg, cat, __FILE__, __LINE__, \
+                                                                      __FUNCTION__);                    \
+            }                                                                                           \
+        }                                                                                               \
+    } while (0)
+
+#define MOVIEBOOKING_LOGF_AT(lvl, cat, ...)                                                             \
+    do {                                                                                                \
+        if constexpr (static_cast<int>(lvl) >= MOVIEBOOKING_LOG_MIN_LEVEL) {                           \
+            if (MovieBooking::Utils::LoggerManager::isEnabled(lvl)) {                                  \
+                MovieBooking::Utils::LoggerManager::getInstance().logf(lvl, cat, __FILE__, __LINE__,    \
+                                                                       __FUNCTION__, __VA_ARGS__);      \
+            }                                                                                           \
+        }                                                                                               \
+    } while (0)
+
 // Convenience macros for logging
-#define LOG_TRACE(msg) MovieBooking::Utils::LoggerManager::getInstance().trace(msg, "", __FILE__, __LINE__, __FUNCTION__)
-#define LOG_DEBUG(msg) MovieBooking::Utils::LoggerManager::getInstance().debug(msg, "", __FILE__, __LINE__, __FUNCTION__)
-#define LOG_INFO(msg) MovieBooking::Utils::LoggerManager::getInstance().info(msg, "", __FILE__, __LINE__, __FUNCTION__)
-#define LOG_WARN(msg) MovieBooking::Utils::LoggerManager::getInstance().warn(msg, "", __FILE__, __LINE__, __FUNCTION__)
-#define LOG_ERROR(msg) MovieBooking::Utils::LoggerManager::getInstance().error(msg, "", __FILE__, __LINE__, __FUNCTION__)
-#define LOG_FATAL(msg) MovieBooking::Utils::LoggerManager::getInstance().fatal(msg, "", __FILE__, __LINE__, __FUNCTION__)
-
-#define LOG_TRACE_CAT(cat, msg) MovieBooking::Utils::LoggerManager::getInstance().trace(msg, cat, __FILE__, __LINE__, __FUNCTION__)
-#define LOG_DEBUG_CAT(cat, msg) MovieBooking::Utils::LoggerManager::getInstance().debug(msg, cat, __FILE__, __LINE__, __FUNCTION__)
-#define LOG_INFO_CAT(cat, msg) MovieBooking::Utils::LoggerManager::getInstance().info(msg, cat, __FILE__, __LINE__, __FUNCTION__)
-#define LOG_WARN_CAT(cat, msg) MovieBooking::Utils::LoggerManager::getInstance().warn(msg, cat, __FILE__, __LINE__, __FUNCTION__)
-#define LOG_ERROR_CAT(cat, msg) MovieBooking::Utils::LoggerManager::getInstance().error(msg, cat, __FILE__, __LINE__, __FUNCTION__)
-#define LOG_FATAL_CAT(cat, msg) MovieBooking::Utils::LoggerManager::getInstance().fatal(msg, cat, __FILE__, __LINE__, __FUNCTION__)
+#define LOG_TRACE(msg) MOVIEBOOKING_LOG_AT(MovieBooking::Utils::LogLevel::TRACE, "", msg)
+#define LOG_DEBUG(msg) MOVIEBOOKING_LOG_AT(MovieBooking::Utils::LogLevel::DEBUG, "", msg)
+#define LOG_INFO(msg) MOVIEBOOKING_LOG_AT(MovieBooking::Utils::LogLevel::INFO, "", msg)
+#define LOG_WARN(msg) MOVIEBOOKING_LOG_AT(MovieBooking::Utils::LogLevel::WARN, "", msg)
+#define LOG_ERROR(msg) MOVIEBOOKING_LOG_AT(MovieBooking::Utils::LogLevel::ERROR, "", msg)
+#define LOG_FATAL(msg) MOVIEBOOKING_LOG_AT(MovieBooking::Utils::LogLevel::FATAL, "", msg)
+
+#define LOG_TRACE_CAT(cat, msg) MOVIEBOOKING_LOG_AT(MovieBooking::Utils::LogLevel::TRACE, cat, msg)
+#define LOG_DEBUG_CAT(cat, msg) MOVIEBOOKING_LOG_AT(MovieBooking::Utils::LogLevel::DEBUG, cat, msg)
+#define LOG_INFO_CAT(cat, msg) MOVIEBOOKING_LOG_AT(MovieBooking::Utils::LogLevel::INFO, cat, msg)
+#define LOG_WARN_CAT(cat, msg) MOVIEBOOKING_LOG_AT(MovieBooking::Utils::LogLevel::WARN, cat, msg)
+#define LOG_ERROR_CAT(cat, msg) MOVIEBOOKING_LOG_AT(MovieBooking::Utils::LogLevel::ERROR, cat, msg)
+#define LOG_FATAL_CAT(cat, msg) MOVIEBOOKING_LOG_AT(MovieBooking::Utils::LogLevel::FATAL, cat, msg)
+
+// fmt-style variants, e.g. LOG_DEBUGF("booking {} locked {} seats", bookingId, seatIds.size())
+#define LOG_TRACEF(...) MOVIEBOOKING_LOGF_AT(MovieBooking::Utils::LogLevel::TRACE, "", __VA_ARGS__)
+#define LOG_DEBUGF(...) MOVIEBOOKING_LOGF_AT(MovieBooking::Utils::LogLevel::DEBUG, "", __VA_ARGS__)
+#define LOG_INFOF(...) MOVIEBOOKING_LOGF_AT(MovieBooking::Utils::LogLevel::INFO, "", __VA_ARGS__)
+#define LOG_WARNF(...) MOVIEBOOKING_LOGF_AT(MovieBooking::Utils::LogLevel::WARN, "", __VA_ARGS__)
+#define LOG_ERRORF(...) MOVIEBOOKING_LOGF_AT(MovieBooking::Utils::LogLevel::ERROR, "", __VA_ARGS__)
+#define LOG_FATALF(...) MOVIEBOOKING_LOGF_AT(MovieBooking::Utils::LogLevel::FATAL, "", __VA_ARGS__)
+
+#define LOG_TRACEF_CAT(cat, ...) MOVIEBOOKING_LOGF_AT(MovieBooking::Utils::LogLevel::TRACE, cat, __VA_ARGS__)
+#define LOG_DEBUGF_CAT(cat, ...) MOVIEBOOKING_LOGF_AT(MovieBooking::Utils::LogLevel::DEBUG, cat, __VA_ARGS__)
+#define LOG_INFOF_CAT(cat, ...) MOVIEBOOKING_LOGF_AT(MovieBooking::Utils::LogLevel::INFO, cat, __VA_ARGS__)
+#define LOG_WARNF_CAT(cat, ...) MOVIEBOOKING_LOGF_AT(MovieBooking::Utils::LogLevel::WARN, cat, __VA_ARGS__)
+#define LOG_ERRORF_CAT(cat, ...) MOVIEBOOKING_LOGF_AT(MovieBooking::Utils::LogLevel::ERROR, cat, __VA_ARGS__)
+#define LOG_FATALF_CAT(cat, ...) MOVIEBOOKING_LOGF_AT(MovieBooking::Utils::LogLevel::FATAL, cat, __VA_ARGS__)
 
 // Scoped logger for specific categories
 class ScopedLogger {
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "LatencyHistogram.h"
+
+namespace MovieBooking {
+namespace Utils {
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+// Monotonic counter sharded across cache lines. Each thread increments the
+// shard it was assigned on first use, so concurrent writers never contend on
+// one line; value() sums the shards and is meant for scrapes, not hot paths.
+class Counter {
+public:
+    static constexpr size_t kShards = 16;
+    static constexpr size_t kCacheLineSize = 64;
+
+private:
+    struct alignas(kCacheLineSize) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+
+    std::array<Shard, kShards> shards_;
+
+public:
+    void increment(uint64_t amount = 1) {
+        shards_[threadShard()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const {
+        uint64_t total = 0;
+        for (const auto& shard : shards_) {
+            total += shard.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    static size_t threadShard() {
+        static std::atomic<size_t> nextShard{0};
+        thread_local const size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % kShards;
+        return shard;
+    }
+};
+
+// Point-in-time value such as a queue depth or an open connection count
+class Gauge {
+private:
+    std::atomic<int64_t> value_{0};
+
+public:
+    void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+    void add(int64_t delta) { value_.fetch_add(delta, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+};
+
+// Builds a Prometheus text exposition (format 0.0.4). Samples are grouped by
+// metric family in first-seen order, so several sources may report the same
+// family under different labels. Histograms are written as summaries; their
+// microsecond values are scaled by `scale` (1e-6 gives seconds).
+class MetricsWriter {
+private:
+    struct Family {
+        std::string name;
+        std::string help;
+        const char* type;
+        std::string samples;
+    };
+
+    std::vector<Family> families_;
+    std::unordered_map<std::string, size_t> index_;
+
+public:
+    void counter(const std::string& name, const std::string& help, const MetricLabels& labels, uint64_t value);
+    void gauge(const std::string& name, const std::string& help, const MetricLabels& labels, double value);
+    void summary(const std::string& name, const std::string& help, const MetricLabels& labels,
+                 const LatencyHistogram::Snapshot& snapshot, double scale = 1e-6);
+
+    std::string str() const;
+
+private:
+    std::string& samplesFor(const std::string& name, const std::string& help, const char* type);
+};
+
+// Process-wide registry of named metrics.
+// counter()/gauge()/histogram() return the same object for the same name and
+// labels, and the reference stays valid for the life of the process: look it
+// up once (a function-local static or a member) and update it lock-free.
+// Components that already keep their own statistics register a collector
+// instead, which runs only when the registry is scraped.
+class MetricsRegistry {
+public:
+    using Collector = std::function<void(MetricsWriter&)>;
+
+private:
+    enum class Kind { COUNTER, GAUGE, HISTOGRAM };
+
+    struct Metric {
+        Kind kind;
+        std::string name;
+        std::string help;
+        MetricLabels labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<LatencyHistogram> histogram;
+    };
+
+    mutable std::mutex metricsMutex_;
+    std::vector<std::unique_ptr<Metric>> metrics_; // registration order
+    std::unordered_map<std::string, Metric*> index_;
+
+    // Held while collectors run, so removeCollector() waits out a scrape
+    mutable std::mutex collectorsMutex_;
+    std::vector<std::pair<uint64_t, Collector>> collectors_;
+    uint64_t nextCollectorId_ = 1;
+
+public:
+    static MetricsRegistry& global();
+
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    // Throws ConfigurationException if `name` is already registered as another kind
+    Counter& counter(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+    Gauge& gauge(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+    // Records microseconds; exported in seconds
+    LatencyHistogram& histogram(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    // Returns an id for removeCollector(). A collector must not register
+    // collectors itself.
+    uint64_t addCollector(Collector collector);
+    void removeCollector(uint64_t id);
+
+    std::string renderPrometheus() const;
+
+private:
+    Metric& findOrCreate(Kind kind, const std::string& name, const std::string& help, const MetricLabels& labels);
+};
+
+// Collector registration that is undone on destruction, for components with
+// a shorter lifetime than the registry
+class ScopedCollector {
+private:
+    MetricsRegistry* registry_ = nullptr;
+    uint64_t id_ = 0;
+
+public:
+    ScopedCollector() = default;
+    ScopedCollector(MetricsRegistry& registry, MetricsRegistry::Collector collector)
+        : registry_(&registry), id_(registry.addCollector(std::move(collector))) {}
+    ~ScopedCollector() { reset(); }
+
+    ScopedCollector(ScopedCollector&& other) noexcept : registry_(other.registry_), id_(other.id_) {
+        other.registry_ = nullptr;
+    }
+    ScopedCollector& operator=(ScopedCollector&& other) noexcept {
+        if (this != &other) {
+            reset();
+            registry_ = other.registry_;
+            id_ = other.id_;
+            other.registry_ = nullptr;
+        }
+        return *this;
+    }
+
+    void reset() {
+        if (registry_) {
+            registry_->removeCollector(id_);
+            registry_ = nullptr;
+        }
+    }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
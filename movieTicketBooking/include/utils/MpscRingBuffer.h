@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace MovieBooking {
+namespace Utils {
+
+// Bounded lock-free multi-producer / single-consumer ring.
+// Slots are preallocated once and reused; producers claim a slot with one CAS
+// on the tail and publish it through the slot's sequence number, so neither
+// side allocates or takes a lock. Capacity is rounded up to a power of two.
+template<typename T>
+class MpscRingBuffer {
+private:
+    struct alignas(64) Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> tail_{0}; // next position producers claim
+    alignas(64) std::atomic<size_t> head_{0}; // next position the consumer reads; written by it alone
+
+public:
+    explicit MpscRingBuffer(size_t capacity)
+        : slots_(std::make_unique<Slot[]>(std::bit_ceil(capacity < 2 ? size_t{2} : capacity))),
+          mask_(std::bit_ceil(capacity < 2 ? size_t{2} : capacity) - 1) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // Approximate; exact only when producers and the consumer are quiescent
+    size_t size() const {
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        const size_t head = head_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    // Claim a slot and fill it in place with fill(T&). False when full.
+    template<typename Fill>
+    bool tryPush(Fill&& fill) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    fill(slot.value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer only: hand the oldest element to consume(T&) in place, then
+    // recycle its slot. False when empty.
+    template<typename Consume>
+    bool tryConsume(Consume&& consume) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[head & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        consume(slot.value);
+        slot.sequence.store(head + mask_ + 1, std::memory_order_release);
+        head_.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace MovieBooking {
+namespace Utils {
+
+// N-way sharded LRU cache of immutable values.
+// Each shard has its own mutex, recency list and index, so lookups for keys in
+// different shards never contend. Hits hand out shared_ptr<const V> snapshots,
+// and eviction is O(1) from the tail of the shard's list. TTL is stored inline
+// with each entry.
+template<typename K, typename V, typename Hash = std::hash<K>>
+class ShardedLruCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    using ValuePtr = std::shared_ptr<const V>;
+
+    struct ShardStats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        uint64_t expirations;
+        size_t size;
+    };
+
+private:
+    struct Entry {
+        K key;
+        ValuePtr value;
+        Clock::time_point expiresAt;
+    };
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::list<Entry> entries; // most recently used first
+        std::unordered_map<K, typename std::list<Entry>::iterator, Hash> index;
+        size_t capacity = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t expirations = 0;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<Clock::rep> ttlTicks_; // default TTL; setTtl may race with put
+    Hash hash_;
+
+public:
+    ShardedLruCache(size_t capacity, Clock::duration ttl, size_t shardCount = 16)
+        : ttlTicks_(ttl.count()) {
+        if (shardCount == 0) {
+            shardCount = 1;
+        }
+        shards_.reserve(shardCount);
+        for (size_t i = 0; i < shardCount; ++i) {
+            shards_.push_back(std::make_unique<Shard>());
+        }
+        setCapacity(capacity);
+    }
+
+    ShardedLruCache(const ShardedLruCache&) = delete;
+    ShardedLruCache& operator=(const ShardedLruCache&) = delete;
+
+    // Returns nullptr on miss or if the entry has expired
+    ValuePtr get(const K& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            ++shard.misses;
+            return nullptr;
+        }
+        if (Clock::now() >= it->second->expiresAt) {
+            shard.entries.erase(it->second);
+            shard.index.erase(it);
+            ++shard.expirations;
+            ++shard.misses;
+            return nullptr;
+        }
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        ++shard.hits;
+        return it->second->value;
+    }
+
+    void put(const K& key, ValuePtr value) { put(key, std::move(value), getTtl()); }
+
+    void put(const K& key, ValuePtr value, Clock::duration ttl) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto expiresAt = Clock::now() + ttl;
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            it->second->value = std::move(value);
+            it->second->expiresAt = expiresAt;
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            return;
+        }
+        shard.entries.push_front(Entry{key, std::move(value), expiresAt});
+        shard.index.emplace(key, shard.entries.begin());
+        evictOverCapacity(shard);
+    }
+
+    ValuePtr putIfAbsent(const K& key, ValuePtr value) { return putIfAbsent(key, std::move(value), getTtl()); }
+
+    // Stores `value` unless a live entry exists; returns the entry now stored
+    ValuePtr putIfAbsent(const K& key, ValuePtr value, Clock::duration ttl) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto now = Clock::now();
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            if (now < it->second->expiresAt) {
+                shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+                return it->second->value;
+            }
+            it->second->value = std::move(value);
+            it->second->expiresAt = now + ttl;
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            ++shard.expirations;
+            return it->second->value;
+        }
+        shard.entries.push_front(Entry{key, std::move(value), now + ttl});
+        shard.index.emplace(key, shard.entries.begin());
+        ValuePtr stored = shard.entries.front().value;
+        evictOverCapacity(shard);
+        return stored;
+    }
+
+    // Atomically replace a live entry with fn(current value), keeping its TTL.
+    // A null result from fn leaves the entry as it was. False on miss.
+    template<typename Fn>
+    bool update(const K& key, Fn&& fn) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end() || Clock::now() >= it->second->expiresAt) {
+            return false;
+        }
+        ValuePtr replacement = fn(*it->second->value);
+        if (replacement) {
+            it->second->value = std::move(replacement);
+        }
+        return true;
+    }
+
+    bool erase(const K& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            return false;
+        }
+        shard.entries.erase(it->second);
+        shard.index.erase(it);
+        return true;
+    }
+
+    void clear() {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->entries.clear();
+            shard->index.clear();
+        }
+    }
+
+    // Drop every expired entry. Not needed for correctness (get() checks TTL);
+    // only frees memory held by entries nobody asks for any more.
+    size_t purgeExpired() {
+        size_t purged = 0;
+        const auto now = Clock::now();
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            for (auto it = shard->entries.begin(); it != shard->entries.end();) {
+                if (now >= it->expiresAt) {
+                    shard->index.erase(it->key);
+                    it = shard->entries.erase(it);
+                    ++shard->expirations;
+                    ++purged;
+                } else {
+                    ++it;
+                }
+            }
+        }
+        return purged;
+    }
+
+    // Total capacity, split evenly across shards
+    void setCapacity(size_t capacity) {
+        const size_t perShard = (capacity + shards_.size() - 1) / shards_.size();
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->capacity = perShard;
+            evictOverCapacity(*shard);
+        }
+    }
+
+    // Applies to later puts; entries keep the expiry they were stored with
+    void setTtl(Clock::duration ttl) { ttlTicks_.store(ttl.count(), std::memory_order_relaxed); }
+    Clock::duration getTtl() const { return Clock::duration(ttlTicks_.load(std::memory_order_relaxed)); }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            total += shard->index.size();
+        }
+        return total;
+    }
+
+    size_t getShardCount() const { return shards_.size(); }
+
+    std::vector<ShardStats> getShardStats() const {
+        std::vector<ShardStats> stats;
+        stats.reserve(shards_.size());
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            stats.push_back({shard->hits, shard->misses, shard->evictions, shard->expirations,
+                             shard->index.size()});
+        }
+        return stats;
+    }
+
+private:
+    Shard& shardFor(const K& key) const {
+        return *shards_[hash_(key) % shards_.size()];
+    }
+
+    static void evictOverCapacity(Shard& shard) {
+        while (shard.index.size() > shard.capacity && !shard.entries.empty()) {
+            shard.index.erase(shard.entries.back().key);
+            shard.entries.pop_back();
+            ++shard.evictions;
+        }
+    }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace MovieBooking {
+namespace Utils {
+
+// Request coalescing: concurrent calls for the same key share one execution.
+// The first caller (the leader) runs the loader; callers that arrive while it
+// is in flight wait on the same shared_future instead of loading again.
+// Exceptions from the loader propagate to every waiter.
+template<typename K, typename V, typename Hash = std::hash<K>>
+class SingleFlight {
+public:
+    struct Stats {
+        uint64_t calls;
+        uint64_t coalesced;
+    };
+
+private:
+    std::unordered_map<K, std::shared_future<V>, Hash> inFlight_;
+    std::mutex mutex_;
+    std::atomic<uint64_t> calls_{0};
+    std::atomic<uint64_t> coalesced_{0};
+
+public:
+    template<typename Loader>
+    V run(const K& key, Loader&& loader) {
+        calls_.fetch_add(1, std::memory_order_relaxed);
+
+        std::promise<V> promise;
+        std::shared_future<V> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = inFlight_.find(key);
+            if (it != inFlight_.end()) {
+                pending = it->second;
+            } else {
+                inFlight_.emplace(key, promise.get_future().share());
+            }
+        }
+        if (pending.valid()) {
+            coalesced_.fetch_add(1, std::memory_order_relaxed);
+            return pending.get();
+        }
+
+        try {
+            V value = loader();
+            promise.set_value(value);
+            forget(key);
+            return value;
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+            forget(key);
+            throw;
+        }
+    }
+
+    Stats getStats() const {
+        return {calls_.load(std::memory_order_relaxed), coalesced_.load(std::memory_order_relaxed)};
+    }
+
+    // Fraction of calls served by another caller's in-flight load
+    double getCoalescingRate() const {
+        const Stats stats = getStats();
+        return stats.calls == 0 ? 0.0 : static_cast<double>(stats.coalesced) / static_cast<double>(stats.calls);
+    }
+
+private:
+    void forget(const K& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        inFlight_.erase(key);
+    }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "LatencyHistogram.h"
+
+namespace MovieBooking {
+namespace Utils {
+
+// Fixed-size table of mutexes selected by hashing a key.
+// All stripes are allocated up front, so taking a lock costs one hash and
+// involves no allocation or global lock. Two keys can share a stripe; size
+// the table from the contention counters.
+class StripedLockTable {
+public:
+    static constexpr size_t kCacheLineSize = 64;
+
+    struct StripeStats {
+        uint64_t acquisitions;
+        uint64_t contended;
+    };
+
+private:
+    // One stripe per cache line so neighbouring stripes do not false-share
+    struct alignas(kCacheLineSize) Stripe {
+        std::mutex mutex;
+        std::atomic<uint64_t> acquisitions{0};
+        std::atomic<uint64_t> contended{0};
+    };
+
+    size_t mask_;
+    std::unique_ptr<Stripe[]> stripes_;
+    LatencyHistogram contendedWait_; // microseconds blocked, contended acquisitions only
+
+public:
+    // stripeCount is rounded up to a power of two
+    explicit StripedLockTable(size_t stripeCount = 64)
+        : mask_(roundUpToPowerOfTwo(stripeCount) - 1),
+          stripes_(new Stripe[mask_ + 1]) {}
+
+    StripedLockTable(const StripedLockTable&) = delete;
+    StripedLockTable& operator=(const StripedLockTable&) = delete;
+
+    size_t getStripeCount() const { return mask_ + 1; }
+    size_t stripeIndex(int key) const { return mix(static_cast<uint32_t>(key)) & mask_; }
+
+    std::mutex& mutexFor(int key) { return stripes_[stripeIndex(key)].mutex; }
+
+    // Lock the stripe for `key`, recording whether and how long the caller had
+    // to wait. The uncontended path reads no clock.
+    std::unique_lock<std::mutex> lock(int key) {
+        Stripe& stripe = stripes_[stripeIndex(key)];
+        stripe.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        std::unique_lock<std::mutex> guard(stripe.mutex, std::try_to_lock);
+        if (!guard.owns_lock()) {
+            stripe.contended.fetch_add(1, std::memory_order_relaxed);
+            const auto start = std::chrono::steady_clock::now();
+            guard.lock();
+            contendedWait_.record(std::chrono::steady_clock::now() - start);
+        }
+        return guard;
+    }
+
+    std::vector<StripeStats> getStripeStats() const {
+        std::vector<StripeStats> stats;
+        stats.reserve(getStripeCount());
+        for (size_t i = 0; i <= mask_; ++i) {
+            stats.push_back({stripes_[i].acquisitions.load(std::memory_order_relaxed),
+                             stripes_[i].contended.load(std::memory_order_relaxed)});
+        }
+        return stats;
+    }
+
+    LatencyHistogram::Snapshot getContendedWaitTime() const { return contendedWait_.snapshot(); }
+
+    void resetStats() {
+        for (size_t i = 0; i <= mask_; ++i) {
+            stripes_[i].acquisitions.store(0, std::memory_order_relaxed);
+            stripes_[i].contended.store(0, std::memory_order_relaxed);
+        }
+        contendedWait_.reset();
+    }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t n) {
+        size_t size = 1;
+        while (size < n) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    // Sequential ids (show 1, 2, 3...) must not land on adjacent stripes in lockstep
+    static size_t mix(uint32_t key) {
+        key ^= key >> 16;
+        key *= 0x7feb352dU;
+        key ^= key >> 15;
+        key *= 0x846ca68bU;
+        key ^= key >> 16;
+        return key;
+    }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
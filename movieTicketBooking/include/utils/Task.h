@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ThreadPool.h"
+
+namespace MovieBooking {
+namespace Utils {
+
+template<typename T = void>
+class Task;
+
+namespace detail {
+
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr exception;
+
+    // On completion, transfer straight to whoever awaited us (no stack growth)
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+            return handle.promise().continuation;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+};
+
+template<typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object() noexcept;
+
+    template<typename U>
+    void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+
+    T result() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return std::move(*value);
+    }
+};
+
+template<>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object() noexcept;
+    void return_void() const noexcept {}
+
+    void result() const {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
+} // namespace detail
+
+// Lazily started, move-only coroutine returning T.
+// Nothing runs until the task is co_awaited (or handed to toFuture); the
+// awaiting coroutine is resumed by symmetric transfer when it finishes.
+// Exceptions propagate to the awaiter.
+template<typename T>
+class Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+
+public:
+    Task() noexcept = default;
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    bool isValid() const { return static_cast<bool>(handle_); }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+            T await_resume() { return handle.promise().result(); }
+        };
+        return Awaiter{handle_};
+    }
+};
+
+namespace detail {
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+// Fire-and-forget driver; its frame frees itself on completion
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+template<typename T>
+DetachedTask fulfil(Task<T> task, std::promise<T> promise) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await std::move(task);
+            promise.set_value();
+        } else {
+            promise.set_value(co_await std::move(task));
+        }
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+}
+
+} // namespace detail
+
+// Suspend and resume on a worker of `pool`. Submission follows the pool's
+// back-pressure policy, so a rejected resume surfaces as RateLimitException.
+inline auto resumeOn(ThreadPool& pool) {
+    struct Awaiter {
+        ThreadPool& pool;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) const { pool.submit([handle] { handle.resume(); }); }
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{pool};
+}
+
+// Run a blocking call on `pool` without holding the awaiting thread; the
+// awaiter continues on that pool's worker once the call returns
+template<typename Fn>
+Task<std::invoke_result_t<Fn&>> offload(ThreadPool& pool, Fn fn) {
+    co_await resumeOn(pool);
+    co_return fn();
+}
+
+namespace detail {
+
+template<typename T>
+struct WhenAllState {
+    explicit WhenAllState(size_t count) : remaining(count + 1), results(count) {}
+
+    std::atomic<size_t> remaining; // one per task plus one for the awaiter itself
+    std::coroutine_handle<> continuation;
+    std::vector<std::optional<T>> results;
+    std::mutex errorMutex;
+    std::exception_ptr error;
+};
+
+template<typename T>
+DetachedTask runWhenAllItem(Task<T> task, std::shared_ptr<WhenAllState<T>> state, size_t index) {
+    try {
+        state->results[index].emplace(co_await std::move(task));
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(state->errorMutex);
+        if (!state->error) {
+            state->error = std::current_exception();
+        }
+    }
+    if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        state->continuation.resume();
+    }
+}
+
+} // namespace detail
+
+// Run all `tasks` concurrently and collect their results in input order.
+// If any task throws, the first exception is rethrown once all have finished.
+template<typename T>
+Task<std::vector<T>> whenAll(std::vector<Task<T>> tasks) {
+    std::vector<T> results;
+    if (tasks.empty()) {
+        co_return results;
+    }
+    auto state = std::make_shared<detail::WhenAllState<T>>(tasks.size());
+
+    struct Awaiter {
+        std::shared_ptr<detail::WhenAllState<T>>& state;
+        std::vector<Task<T>>& tasks;
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle) {
+            state->continuation = handle;
+            for (size_t i = 0; i < tasks.size(); ++i) {
+                detail::runWhenAllItem(std::move(tasks[i]), state, i);
+            }
+            // Stay suspended unless every task already finished synchronously
+            return state->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+        }
+        void await_resume() const noexcept {}
+    };
+    co_await Awaiter{state, tasks};
+
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+    results.reserve(state->results.size());
+    for (auto& result : state->results) {
+        results.push_back(std::move(*result));
+    }
+    co_return results;
+}
+
+// whenAll with at most `maxConcurrent` tasks in flight, run in consecutive windows
+template<typename T>
+Task<std::vector<T>> whenAllBounded(std::vector<Task<T>> tasks, size_t maxConcurrent) {
+    const size_t window = maxConcurrent > 0 ? maxConcurrent : 1;
+    std::vector<T> results;
+    results.reserve(tasks.size());
+    for (size_t begin = 0; begin < tasks.size(); begin += window) {
+        const size_t end = std::min(tasks.size(), begin + window);
+        std::vector<Task<T>> batch(std::make_move_iterator(tasks.begin() + begin),
+                                   std::make_move_iterator(tasks.begin() + end));
+        for (auto& result : co_await whenAll(std::move(batch))) {
+            results.push_back(std::move(result));
+        }
+    }
+    co_return results;
+}
+
+// Start `task` now and expose its result as a std::future.
+// Runs on the calling thread up to the task's first suspension.
+template<typename T>
+std::future<T> toFuture(Task<T> task) {
+    std::promise<T> promise;
+    std::future<T> future = promise.get_future();
+    detail::fulfil(std::move(task), std::move(promise));
+    return future;
+}
+
+// Block the calling thread until `task` completes. Never call from a pool worker.
+template<typename T>
+T syncWait(Task<T> task) {
+    return toFuture(std::move(task)).get();
+}
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Exceptions.h"
+#include "LatencyHistogram.h"
+
+namespace MovieBooking {
+namespace Utils {
+
+// Queue-full behaviour for ThreadPool::submit
+enum class BackPressurePolicy {
+    BLOCK,         // wait until there is room
+    REJECT,        // throw RateLimitException
+    CALLER_RUNS    // run the task on the submitting thread
+};
+
+// Bounded work-stealing thread pool.
+// Every worker owns a deque: it pops its own work LIFO (cache-warm) and steals
+// FIFO from the others when idle. External submissions are spread round-robin.
+// The total number of queued tasks is capped at maxQueuedTasks.
+class ThreadPool {
+public:
+    struct Stats {
+        std::string name;
+        size_t threads;
+        size_t queueDepth;
+        uint64_t submitted;
+        uint64_t completed;
+        uint64_t steals;
+        uint64_t rejected;
+        LatencyHistogram::Snapshot queueLatency; // microseconds from submit to start
+        LatencyHistogram::Snapshot runLatency;   // microseconds spent running
+    };
+
+private:
+    struct Task {
+        std::function<void()> fn;
+        std::chrono::steady_clock::time_point enqueuedAt;
+    };
+
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::string name_;
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    size_t maxQueuedTasks_;
+    BackPressurePolicy policy_;
+
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> nextQueue_{0};
+    std::atomic<bool> running_{true};
+    std::mutex sleepMutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable spaceAvailable_;
+
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> steals_{0};
+    std::atomic<uint64_t> rejected_{0};
+    LatencyHistogram queueLatency_;
+    LatencyHistogram runLatency_;
+
+    static thread_local ThreadPool* currentPool_;
+    static thread_local size_t currentIndex_;
+
+public:
+    ThreadPool(const std::string& name, size_t threads, size_t maxQueuedTasks = 10000,
+               BackPressurePolicy policy = BackPressurePolicy::BLOCK)
+        : name_(name), maxQueuedTasks_(std::max<size_t>(1, maxQueuedTasks)), policy_(policy) {
+        threads = std::max<size_t>(1, threads);
+        for (size_t i = 0; i < threads; ++i) {
+            queues_.push_back(std::make_unique<WorkerQueue>());
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+        }
+    }
+
+    ~ThreadPool() { shutdown(); }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue `fn` and return its future. Applies the back-pressure policy when full.
+    template<typename Fn>
+    auto submit(Fn&& fn) -> std::future<std::invoke_result_t<std::decay_t<Fn>>> {
+        using Result = std::invoke_result_t<std::decay_t<Fn>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+        std::future<Result> future = task->get_future();
+
+        if (!running_.load()) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            throw RateLimitException("Thread pool '" + name_ + "' is shut down", 1);
+        }
+        if (!reserveSlot()) {
+            // Workers of this pool also run inline rather than deadlock on a full queue
+            if (policy_ == BackPressurePolicy::CALLER_RUNS || currentPool_ == this) {
+                (*task)();
+                return future;
+            }
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            throw RateLimitException("Thread pool '" + name_ + "' queue is full", 1);
+        }
+        enqueue(Task{[task] { (*task)(); }, std::chrono::steady_clock::now()});
+        return future;
+    }
+
+    // Stop accepting work, finish what is queued, and join the workers
+    void shutdown() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+        }
+        workAvailable_.notify_all();
+        spaceAvailable_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    const std::string& getName() const { return name_; }
+    size_t getThreadCount() const { return workers_.size(); }
+    size_t getQueueDepth() const { return queued_.load(std::memory_order_relaxed); }
+
+    Stats getStats() const {
+        return {name_,
+                workers_.size(),
+                queued_.load(std::memory_order_relaxed),
+                submitted_.load(std::memory_order_relaxed),
+                completed_.load(std::memory_order_relaxed),
+                steals_.load(std::memory_order_relaxed),
+                rejected_.load(std::memory_order_relaxed),
+                queueLatency_.snapshot(),
+                runLatency_.snapshot()};
+    }
+
+private:
+    bool reserveSlot() {
+        for (;;) {
+            size_t depth = queued_.load(std::memory_order_relaxed);
+            while (depth < maxQueuedTasks_) {
+                if (queued_.compare_exchange_weak(depth, depth + 1, std::memory_order_acq_rel)) {
+                    return true;
+                }
+            }
+            // A worker of this pool must never block on its own queue
+            if (policy_ != BackPressurePolicy::BLOCK || !running_.load() || currentPool_ == this) {
+                return false;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            spaceAvailable_.wait_for(lock, std::chrono::milliseconds(10), [this] {
+                return !running_.load() || queued_.load(std::memory_order_relaxed) < maxQueuedTasks_;
+            });
+        }
+    }
+
+    void enqueue(Task task) {
+        // Workers push onto their own deque; everyone else spreads round-robin
+        const size_t index = currentPool_ == this
+            ? currentIndex_
+            : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        {
+            std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+            queues_[index]->tasks.push_back(std::move(task));
+        }
+        submitted_.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+        }
+        workAvailable_.notify_one();
+    }
+
+    bool popLocal(size_t index, Task& task) {
+        WorkerQueue& queue = *queues_[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t thief, Task& task) {
+        for (size_t offset = 1; offset < queues_.size(); ++offset) {
+            WorkerQueue& victim = *queues_[(thief + offset) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(Task& task) {
+        queued_.fetch_sub(1, std::memory_order_acq_rel);
+        spaceAvailable_.notify_one();
+        const auto start = std::chrono::steady_clock::now();
+        queueLatency_.record(start - task.enqueuedAt);
+        task.fn();
+        runLatency_.record(std::chrono::steady_clock::now() - start);
+        completed_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void workerLoop(size_t index) {
+        currentPool_ = this;
+        currentIndex_ = index;
+        Task task;
+        for (;;) {
+            if (popLocal(index, task) || steal(index, task)) {
+                run(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            if (!running_.load() && queued_.load() == 0) {
+                break;
+            }
+            workAvailable_.wait_for(lock, std::chrono::milliseconds(50), [this] {
+                return !running_.load() || queued_.load(std::memory_order_relaxed) > 0;
+            });
+        }
+        currentPool_ = nullptr;
+    }
+};
+
+inline thread_local ThreadPool* ThreadPool::currentPool_ = nullptr;
+inline thread_local size_t ThreadPool::currentIndex_ = 0;
+
+// Process-wide executors behind the *Async APIs.
+// CPU-bound work (serialization, seat scans) and blocking DB / gateway I/O run
+// on separate pools so slow I/O cannot starve compute.
+class Executors {
+public:
+    static ThreadPool& cpu() {
+        static ThreadPool pool("cpu", std::max(1u, std::thread::hardware_concurrency()), 10000,
+                               BackPressurePolicy::CALLER_RUNS);
+        return pool;
+    }
+
+    static ThreadPool& io() {
+        static ThreadPool pool("io", std::max(4u, 4 * std::thread::hardware_concurrency()), 20000,
+                               BackPressurePolicy::BLOCK);
+        return pool;
+    }
+
+    static std::vector<ThreadPool::Stats> getStats() { return {cpu().getStats(), io().getStats()}; }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "ThreadPool.h"
+#include "TimerWheel.h"
+
+namespace MovieBooking {
+namespace Utils {
+
+// Runs callbacks after a delay without parking a thread per timer.
+// One ticker thread advances a TimerWheel with a fine tick and hands expired
+// callbacks to an executor. Only a callback the executor refuses runs on the
+// ticker itself, so that a suspended sleepFor is still resumed.
+class TimerScheduler {
+public:
+    using TimerId = TimerWheel<std::function<void()>>::TimerId;
+
+private:
+    TimerWheel<std::function<void()>> wheel_;
+    ThreadPool& executor_;
+    std::atomic<bool> running_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::thread ticker_;
+
+public:
+    explicit TimerScheduler(ThreadPool& executor,
+                            std::chrono::milliseconds tick = std::chrono::milliseconds(10))
+        : wheel_(tick), executor_(executor), running_(true) {
+        ticker_ = std::thread(&TimerScheduler::tickerLoop, this);
+    }
+
+    ~TimerScheduler() { shutdown(); }
+
+    TimerScheduler(const TimerScheduler&) = delete;
+    TimerScheduler& operator=(const TimerScheduler&) = delete;
+
+    // Fires within one tick after `delay`
+    template<typename Rep, typename Period>
+    TimerId schedule(std::chrono::duration<Rep, Period> delay, std::function<void()> callback) {
+        const auto deadline = std::chrono::system_clock::now() +
+                              std::chrono::duration_cast<std::chrono::system_clock::duration>(delay);
+        return wheel_.schedule(deadline, std::move(callback));
+    }
+
+    bool cancel(TimerId id) { return wheel_.cancel(id); }
+    size_t getPendingCount() const { return wheel_.size(); }
+
+    // co_await scheduler.sleepFor(d): suspend, then resume on the executor
+    template<typename Rep, typename Period>
+    auto sleepFor(std::chrono::duration<Rep, Period> delay) {
+        struct Awaiter {
+            TimerScheduler& scheduler;
+            std::chrono::duration<Rep, Period> delay;
+
+            bool await_ready() const noexcept { return delay <= delay.zero(); }
+            void await_suspend(std::coroutine_handle<> handle) {
+                scheduler.schedule(delay, [handle] { handle.resume(); });
+            }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this, delay};
+    }
+
+    void shutdown() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+        }
+        condition_.notify_all();
+        if (ticker_.joinable()) {
+            ticker_.join();
+        }
+    }
+
+    // Process-wide scheduler; callbacks run on Executors::io()
+    static TimerScheduler& shared() {
+        static TimerScheduler scheduler(Executors::io());
+        return scheduler;
+    }
+
+private:
+    void tickerLoop() {
+        const auto tick = wheel_.getTick();
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (running_.load()) {
+            condition_.wait_for(lock, tick, [this] { return !running_.load(); });
+            lock.unlock();
+            for (auto& callback : wheel_.advance()) {
+                // Submitted by copy: a refused submit has already consumed what it was given
+                try {
+                    executor_.submit(callback);
+                    continue;
+                } catch (const std::exception&) {
+                    // Executor shut down or saturated under REJECT
+                }
+                try {
+                    callback();
+                } catch (...) {
+                    // Keep ticking; the executor would have dropped it into a future nobody reads
+                }
+            }
+            lock.lock();
+        }
+    }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace MovieBooking {
+namespace Utils {
+
+// Hierarchical timer wheel.
+// Five levels of 64 slots; level 0 advances one slot per tick (1 second by
+// default) and each higher level covers 64 times the span of the one below,
+// so a 1s wheel reaches ~34 years. Scheduling and cancelling are O(1); a timer
+// is moved down at most once per level before it fires.
+template<typename T>
+class TimerWheel {
+public:
+    using Clock = std::chrono::system_clock;
+    using TimerId = uint64_t;
+
+private:
+    static constexpr unsigned kSlotBits = 6;
+    static constexpr size_t kSlots = size_t{1} << kSlotBits;
+    static constexpr size_t kSlotMask = kSlots - 1;
+    static constexpr size_t kLevels = 5;
+    static constexpr uint64_t kMaxSpan = (uint64_t{1} << (kSlotBits * kLevels)) - 1;
+
+    struct Timer {
+        TimerId id;
+        uint64_t expiryTick;
+        T payload;
+    };
+
+    Clock::duration tick_;
+    Clock::time_point origin_;
+    uint64_t currentTick_;
+    TimerId nextId_;
+    std::array<std::array<std::vector<Timer>, kSlots>, kLevels> wheels_;
+    std::unordered_set<TimerId> pending_;
+    mutable std::mutex mutex_;
+
+public:
+    explicit TimerWheel(Clock::duration tick = std::chrono::seconds(1),
+                        Clock::time_point origin = Clock::now())
+        : tick_(tick), origin_(origin), currentTick_(0), nextId_(1) {}
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Schedule `payload` to fire at the first tick at or after `deadline`.
+    // Deadlines already in the past fire on the next advance().
+    TimerId schedule(Clock::time_point deadline, T payload) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const TimerId id = nextId_++;
+        uint64_t expiryTick = tickAtOrAfter(deadline);
+        if (expiryTick < currentTick_) {
+            expiryTick = currentTick_;
+        }
+        place(Timer{id, expiryTick, std::move(payload)});
+        pending_.insert(id);
+        return id;
+    }
+
+    // Cancelled timers are dropped lazily when their slot comes up
+    bool cancel(TimerId id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pending_.erase(id) > 0;
+    }
+
+    // Run every tick up to `now` and return the payloads that expired, oldest first
+    std::vector<T> advance(Clock::time_point now = Clock::now()) {
+        std::vector<T> expired;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (now < origin_) {
+            return expired;
+        }
+        const uint64_t targetTick = static_cast<uint64_t>((now - origin_) / tick_);
+        while (currentTick_ <= targetTick) {
+            if ((currentTick_ & kSlotMask) == 0) {
+                for (size_t level = 1; level < kLevels && cascade(level) == 0; ++level) {
+                }
+            }
+            fireSlot(wheels_[0][currentTick_ & kSlotMask], expired);
+            ++currentTick_;
+        }
+        return expired;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pending_.size();
+    }
+
+    Clock::duration getTick() const { return tick_; }
+
+private:
+    uint64_t tickAtOrAfter(Clock::time_point deadline) const {
+        if (deadline <= origin_) {
+            return 0;
+        }
+        const auto elapsed = deadline - origin_;
+        return static_cast<uint64_t>((elapsed + tick_ - Clock::duration(1)) / tick_);
+    }
+
+    void place(Timer timer) {
+        uint64_t delta = timer.expiryTick - currentTick_;
+        uint64_t slotTick = timer.expiryTick;
+        if (delta > kMaxSpan) {
+            // Park in the farthest slot; it is re-placed on cascade
+            delta = kMaxSpan;
+            slotTick = currentTick_ + kMaxSpan;
+        }
+        size_t level = 0;
+        while (level + 1 < kLevels && delta >= (uint64_t{1} << (kSlotBits * (level + 1)))) {
+            ++level;
+        }
+        const size_t slot = static_cast<size_t>(slotTick >> (kSlotBits * level)) & kSlotMask;
+        wheels_[level][slot].push_back(std::move(timer));
+    }
+
+    // Redistribute the current slot of `level` into the levels below.
+    // Returns that slot's index so the caller knows whether to cascade further up.
+    size_t cascade(size_t level) {
+        const size_t slot = static_cast<size_t>(currentTick_ >> (kSlotBits * level)) & kSlotMask;
+        std::vector<Timer> timers;
+        timers.swap(wheels_[level][slot]);
+        for (auto& timer : timers) {
+            if (pending_.count(timer.id) != 0) {
+                place(std::move(timer));
+            }
+        }
+        return slot;
+    }
+
+    void fireSlot(std::vector<Timer>& slot, std::vector<T>& expired) {
+        for (auto& timer : slot) {
+            if (pending_.erase(timer.id) != 0) {
+                expired.push_back(std::move(timer.payload));
+            }
+        }
+        slot.clear();
+    }
+};
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -0,0 +1,22 @@
+#include "../../include/controllers/BookingController.h"
+
+namespace MovieBooking {
+namespace Controllers {
+
+HttpResponse BookingController::buildBookingResponse(const Services::InitiatedBooking& booking) {
+    if (!booking) {
+        return bookingErrorResponse(booking.error());
+    }
+    return jsonResponse(
+        [&](Utils::JsonWriter& json) {
+            if (*booking) {
+                (*booking)->writeJson(json);
+            } else {
+                json.null();
+            }
+        },
+        201);
+}
+
+} // namespace Controllers
+} // namespace MovieBooking
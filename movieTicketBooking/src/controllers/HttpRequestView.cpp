@@ -0,0 +1,173 @@
+#include "../../include/controllers/BookingController.h"
+
+#include <charconv>
+
+namespace {
+
+// Header blocks larger than this are rejected rather than buffered forever
+constexpr size_t kMaxHeaderBytes = 64 * 1024;
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        const char x = a[i] >= 'A' && a[i] <= 'Z' ? a[i] + ('a' - 'A') : a[i];
+        const char y = b[i] >= 'A' && b[i] <= 'Z' ? b[i] + ('a' - 'A') : b[i];
+        if (x != y) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Calls fn(key, value) for each "key=value" pair of a query string
+template<typename Fn>
+void forEachQueryParam(std::string_view query, Fn&& fn) {
+    while (!query.empty()) {
+        const size_t amp = query.find('&');
+        const std::string_view pair = query.substr(0, amp);
+        const size_t eq = pair.find('=');
+        if (!pair.empty() && !fn(pair.substr(0, eq), eq == std::string_view::npos ? std::string_view() : pair.substr(eq + 1))) {
+            return;
+        }
+        query = amp == std::string_view::npos ? std::string_view() : query.substr(amp + 1);
+    }
+}
+
+} // namespace
+
+std::string_view HttpRequestView::getHeader(std::string_view name) const {
+    for (size_t i = 0; i < headerCount; ++i) {
+        if (equalsIgnoreCase(headers[i].first, name)) {
+            return headers[i].second;
+        }
+    }
+    return {};
+}
+
+std::string_view HttpRequestView::getQueryParam(std::string_view name) const {
+    std::string_view found;
+    forEachQueryParam(query, [&](std::string_view key, std::string_view value) {
+        if (key == name) {
+            found = value;
+            return false;
+        }
+        return true;
+    });
+    return found;
+}
+
+bool HttpRequestView::wantsKeepAlive() const {
+    const std::string_view connection = getHeader("connection");
+    if (version == "HTTP/1.0") {
+        return equalsIgnoreCase(connection, "keep-alive");
+    }
+    return !equalsIgnoreCase(connection, "close");
+}
+
+size_t HttpRequestView::parse(std::string_view data, HttpRequestView& request) {
+    using MovieBooking::Utils::ValidationException;
+
+    const size_t headerEnd = data.find("\r\n\r\n");
+    if (headerEnd == std::string_view::npos) {
+        if (data.size() > kMaxHeaderBytes) {
+            throw ValidationException("Request header too large");
+        }
+        return 0;
+    }
+    std::string_view head = data.substr(0, headerEnd + 2);
+
+    // Request line: METHOD SP target SP HTTP/1.x
+    const size_t lineEnd = head.find("\r\n");
+    const std::string_view requestLine = head.substr(0, lineEnd);
+    const size_t firstSpace = requestLine.find(' ');
+    const size_t lastSpace = requestLine.rfind(' ');
+    if (firstSpace == std::string_view::npos || firstSpace == lastSpace || firstSpace == 0) {
+        throw ValidationException("Malformed request line");
+    }
+    request.method = requestLine.substr(0, firstSpace);
+    request.target = requestLine.substr(firstSpace + 1, lastSpace - firstSpace - 1);
+    request.version = requestLine.substr(lastSpace + 1);
+    if (request.target.empty() || request.version.substr(0, 7) != "HTTP/1.") {
+        throw ValidationException("Malformed request line");
+    }
+    const size_t question = request.target.find('?');
+    request.path = request.target.substr(0, question);
+    request.query = question == std::string_view::npos ? std::string_view() : request.target.substr(question + 1);
+
+    // Header fields
+    request.headerCount = 0;
+    request.pathParams.clear();
+    size_t contentLength = 0;
+    bool sawContentLength = false;
+    head.remove_prefix(lineEnd + 2);
+    while (!head.empty()) {
+        const size_t end = head.find("\r\n");
+        const std::string_view line = head.substr(0, end);
+        head.remove_prefix(end + 2);
+        const size_t colon = line.find(':');
+        // Whitespace in a field name, before the colon or as obs-fold, is
+        // where request smuggling hides: reject it rather than guess (RFC 9112 5.1)
+        if (colon == std::string_view::npos || colon == 0 ||
+            line.substr(0, colon).find_first_of(" \t") != std::string_view::npos) {
+            throw ValidationException("Malformed header field");
+        }
+        if (request.headerCount == kMaxHeaders) {
+            throw ValidationException("Too many header fields");
+        }
+        const Field field{line.substr(0, colon), trim(line.substr(colon + 1))};
+        request.headers[request.headerCount++] = field;
+
+        if (equalsIgnoreCase(field.first, "content-length")) {
+            // A second Content-Length, equal or not, leaves the body length to
+            // whichever hop reads which one
+            if (sawContentLength) {
+                throw ValidationException("Duplicate Content-Length", "Content-Length");
+            }
+            sawContentLength = true;
+            const auto result = std::from_chars(field.second.data(), field.second.data() + field.second.size(),
+                                                contentLength);
+            if (result.ec != std::errc() || result.ptr != field.second.data() + field.second.size()) {
+                throw ValidationException("Invalid Content-Length", "Content-Length");
+            }
+        } else if (equalsIgnoreCase(field.first, "transfer-encoding") && !equalsIgnoreCase(field.second, "identity")) {
+            throw ValidationException("Chunked request bodies are not supported", "Transfer-Encoding");
+        }
+    }
+
+    const size_t bodyStart = headerEnd + 4;
+    if (data.size() - bodyStart < contentLength) {
+        return 0;
+    }
+    request.body = data.substr(bodyStart, contentLength);
+    return bodyStart + contentLength;
+}
+
+HttpRequest HttpRequestView::toRequest() const {
+    HttpRequest request;
+    request.method = std::string(method);
+    request.path = std::string(path);
+    request.body = std::string(body);
+    for (size_t i = 0; i < headerCount; ++i) {
+        request.headers.emplace(std::string(headers[i].first), std::string(headers[i].second));
+    }
+    forEachQueryParam(query, [&request](std::string_view key, std::string_view value) {
+        request.queryParams.emplace(std::string(key), std::string(value));
+        return true;
+    });
+    for (size_t i = 0; i < pathParams.count; ++i) {
+        request.pathParams.emplace(std::string(pathParams.entries[i].first), std::string(pathParams.entries[i].second));
+    }
+    return request;
+}
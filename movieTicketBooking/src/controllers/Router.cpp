@@ -0,0 +1,257 @@
+#include "../../include/controllers/BookingController.h"
+#include "../../include/utils/Metrics.h"
+
+namespace MovieBooking {
+namespace Controllers {
+
+namespace {
+
+HttpResponse errorResponse(int statusCode, const std::string& message) {
+    HttpResponse response(statusCode);
+    response.body = "{\"error\":\"" + message + "\"}";
+    return response;
+}
+
+template<typename Fn>
+HttpResponse invokeHandler(Fn&& fn) {
+    try {
+        return fn();
+    } catch (const Utils::MovieBookingException& e) {
+        HttpResponse response(e.getHttpStatusCode());
+        response.body = e.toJson();
+        return response;
+    } catch (const std::exception&) {
+        return errorResponse(500, "Internal server error");
+    }
+}
+
+// Responses by status class; one label lookup per process, not per request
+HttpResponse counted(HttpResponse response) {
+    static const std::array<Utils::Counter*, 5> responses = [] {
+        std::array<Utils::Counter*, 5> counters{};
+        for (size_t i = 0; i < counters.size(); ++i) {
+            counters[i] = &Utils::MetricsRegistry::global().counter(
+                "http_responses_total", "Responses sent by the router",
+                {{"code", std::to_string(i + 1) + "xx"}});
+        }
+        return counters;
+    }();
+    const int statusClass = response.statusCode / 100;
+    if (statusClass >= 1 && statusClass <= 5) {
+        responses[static_cast<size_t>(statusClass - 1)]->increment();
+    }
+    return response;
+}
+
+} // namespace
+
+// Route registration
+
+void Router::registerRoute(const std::string& method, const std::string& path, Handler handler) {
+    treeFor(method).insert(path, Route{std::move(handler), nullptr, nullptr});
+}
+
+void Router::registerViewRoute(const std::string& method, const std::string& path, ViewHandler handler) {
+    treeFor(method).insert(path, Route{nullptr, std::move(handler), nullptr});
+}
+
+void Router::registerAsyncRoute(const std::string& method, const std::string& path, AsyncHandler handler) {
+    treeFor(method).insert(path, Route{nullptr, nullptr, std::move(handler)});
+}
+
+void Router::registerBookingController(const std::string& prefix, std::unique_ptr<BookingController> controller) {
+    bookingControllers_[prefix] = std::move(controller);
+}
+
+void Router::registerShowController(const std::string& prefix, std::unique_ptr<ShowController> controller) {
+    showControllers_[prefix] = std::move(controller);
+}
+
+// Request handling
+
+const Router::Route* Router::match(std::string_view method, std::string_view path, RouteParams& params) const {
+    const RouteTree<Route>* tree = findTree(method);
+    return tree ? tree->match(path, params) : nullptr;
+}
+
+HttpResponse Router::handleRequest(const HttpRequest& request) {
+    const std::string_view path = std::string_view(request.path).substr(0, request.path.find('?'));
+    RouteParams params;
+    const Route* route = match(request.method, path, params);
+    if (!route) {
+        return counted(notRouted(path));
+    }
+
+    if (!route->viewHandler) {
+        HttpRequest routed = request;
+        routed.pathParams.clear();
+        for (size_t i = 0; i < params.count; ++i) {
+            routed.pathParams.emplace(std::string(params.entries[i].first), std::string(params.entries[i].second));
+        }
+        if (route->asyncHandler) {
+            std::future<HttpResponse> pending;
+            HttpResponse failed = invokeHandler([&] {
+                pending = route->asyncHandler(routed);
+                return HttpResponse();
+            });
+            return pending.valid() ? collect(pending) : counted(std::move(failed));
+        }
+        return counted(invokeHandler([&] { return route->handler(routed); }));
+    }
+
+    // View handler behind an owning request: view its strings in place
+    HttpRequestView view;
+    view.method = request.method;
+    view.path = path;
+    view.target = request.path;
+    view.version = "HTTP/1.1";
+    view.body = request.body;
+    for (const auto& [name, value] : request.headers) {
+        if (view.headerCount == HttpRequestView::kMaxHeaders) {
+            break;
+        }
+        view.headers[view.headerCount++] = {name, value};
+    }
+    std::string query;
+    for (const auto& [name, value] : request.queryParams) {
+        query += (query.empty() ? "" : "&") + name + "=" + value;
+    }
+    view.query = query;
+    view.pathParams = params;
+    return counted(invokeHandler([&] { return route->viewHandler(view); }));
+}
+
+HttpResponse Router::handleRequest(HttpRequestView& request) {
+    Dispatched dispatched = dispatch(request);
+    return dispatched.response ? std::move(*dispatched.response) : collect(dispatched.pending);
+}
+
+Router::Dispatched Router::dispatch(HttpRequestView& request) {
+    Dispatched dispatched;
+    const Route* route = match(request.method, request.path, request.pathParams);
+    if (!route) {
+        dispatched.response = notRouted(request.path);
+    } else if (route->viewHandler) {
+        dispatched.response = invokeHandler([&] { return route->viewHandler(request); });
+    } else if (route->handler) {
+        dispatched.response = invokeHandler([&] { return route->handler(request.toRequest()); });
+    } else {
+        dispatched.request = std::make_shared<const HttpRequest>(request.toRequest());
+        HttpResponse failed = invokeHandler([&] {
+            dispatched.pending = route->asyncHandler(*dispatched.request);
+            return HttpResponse();
+        });
+        if (!dispatched.pending.valid()) {
+            dispatched.response = std::move(failed);
+        }
+    }
+    if (dispatched.response) {
+        dispatched.response = counted(std::move(*dispatched.response));
+    }
+    return dispatched;
+}
+
+HttpResponse Router::collect(std::future<HttpResponse>& pending) {
+    return counted(invokeHandler([&pending] { return pending.get(); }));
+}
+
+// Route configuration
+
+void Router::setupDefaultRoutes() {
+    registerViewRoute("GET", "/health", [](const HttpRequestView&) {
+        HttpResponse response;
+        response.body = "{\"status\":\"ok\"}";
+        return response;
+    });
+    registerViewRoute("GET", "/metrics", [](const HttpRequestView&) {
+        HttpResponse response(200, "text/plain; version=0.0.4");
+        response.body = Utils::MetricsRegistry::global().renderPrometheus();
+        return response;
+    });
+    setupBookingRoutes();
+    setupShowRoutes();
+}
+
+void Router::setupBookingRoutes() {
+    for (const auto& [prefix, owned] : bookingControllers_) {
+        BookingController* controller = owned.get();
+        auto bind = [controller](std::future<HttpResponse> (BookingController::*method)(const HttpRequest&)) {
+            return [controller, method](const HttpRequest& request) { return (controller->*method)(request); };
+        };
+        registerAsyncRoute("POST", prefix, bind(&BookingController::initiateBookingAsync));
+        registerAsyncRoute("GET", prefix + "/stats", bind(&BookingController::getBookingStatsAsync));
+        registerAsyncRoute("GET", prefix + "/:id", bind(&BookingController::getBookingAsync));
+        registerAsyncRoute("POST", prefix + "/:id/confirm", bind(&BookingController::confirmBookingAsync));
+        registerAsyncRoute("POST", prefix + "/:id/cancel", bind(&BookingController::cancelBookingAsync));
+        registerAsyncRoute("POST", prefix + "/:id/payment", bind(&BookingController::processPaymentAsync));
+        registerAsyncRoute("GET", prefix + "/:id/payment", bind(&BookingController::getPaymentStatusAsync));
+        registerAsyncRoute("GET", prefix + "/users/:userId", bind(&BookingController::getUserBookingsAsync));
+        registerAsyncRoute("GET", prefix + "/users/:userId/stats", bind(&BookingController::getUserStatsAsync));
+        registerAsyncRoute("GET", prefix + "/shows/:showId/seats", bind(&BookingController::getAvailableSeatsAsync));
+        registerAsyncRoute("POST", prefix + "/shows/:showId/locks", bind(&BookingController::lockSeatsAsync));
+    }
+}
+
+void Router::setupShowRoutes() {
+    for (const auto& [prefix, owned] : showControllers_) {
+        ShowController* controller = owned.get();
+        auto bind = [controller](std::future<HttpResponse> (ShowController::*method)(const HttpRequest&)) {
+            return [controller, method](const HttpRequest& request) { return (controller->*method)(request); };
+        };
+        registerAsyncRoute("POST", prefix, bind(&ShowController::createShowAsync));
+        registerAsyncRoute("GET", prefix + "/search", bind(&ShowController::searchShowsAsync));
+        registerAsyncRoute("GET", prefix + "/upcoming", bind(&ShowController::getUpcomingShowsAsync));
+        registerAsyncRoute("GET", prefix + "/movies/:movieId", bind(&ShowController::getShowsByMovieAsync));
+        registerAsyncRoute("GET", prefix + "/:id", bind(&ShowController::getShowAsync));
+        registerAsyncRoute("PUT", prefix + "/:id", bind(&ShowController::updateShowAsync));
+        registerAsyncRoute("DELETE", prefix + "/:id", bind(&ShowController::cancelShowAsync));
+        registerAsyncRoute("GET", prefix + "/:id/layout", bind(&ShowController::getSeatingLayoutAsync));
+        registerAsyncRoute("GET", prefix + "/:id/seats", bind(&ShowController::getAvailableSeatsAsync));
+        registerAsyncRoute("GET", prefix + "/:id/seats/stream", bind(&ShowController::streamSeatChangesAsync));
+    }
+}
+
+// Helpers
+
+RouteTree<Router::Route>& Router::treeFor(const std::string& method) {
+    for (auto& [name, tree] : routes_) {
+        if (name == method) {
+            return tree;
+        }
+    }
+    routes_.emplace_back(method, RouteTree<Route>());
+    return routes_.back().second;
+}
+
+const RouteTree<Router::Route>* Router::findTree(std::string_view method) const {
+    for (const auto& [name, tree] : routes_) {
+        if (name == method) {
+            return &tree;
+        }
+    }
+    return nullptr;
+}
+
+std::string Router::allowedMethods(std::string_view path) const {
+    std::string allowed;
+    RouteParams params;
+    for (const auto& [name, tree] : routes_) {
+        if (tree.match(path, params)) {
+            allowed += (allowed.empty() ? "" : ", ") + name;
+        }
+    }
+    return allowed;
+}
+
+HttpResponse Router::notRouted(std::string_view path) const {
+    const std::string allowed = allowedMethods(path);
+    if (allowed.empty()) {
+        return errorResponse(404, "Not found");
+    }
+    HttpResponse response = errorResponse(405, "Method not allowed");
+    response.headers["Allow"] = allowed;
+    return response;
+}
+
+} // namespace Controllers
+} // namespace MovieBooking
@@ -0,0 +1,51 @@
+#include "../../include/controllers/BookingController.h"
+#include "../../include/utils/Exceptions.h"
+#include "../../include/utils/ThreadPool.h"
+
+#include <charconv>
+
+namespace MovieBooking {
+namespace Controllers {
+
+namespace {
+
+template<typename T>
+bool parseNumber(const std::string& text, T& value) {
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+} // namespace
+
+std::future<HttpResponse> ShowController::streamSeatChangesAsync(const HttpRequest& request) {
+    return Utils::Executors::io().submit([this, request] { return streamSeatChanges(request); });
+}
+
+HttpResponse ShowController::streamSeatChanges(const HttpRequest& request) {
+    int showId = 0;
+    if (!parseNumber(request.getPathParam("id"), showId) || showId <= 0) {
+        throw Utils::ValidationException("Invalid show ID", "id");
+    }
+    size_t seatsPerRow = 0;
+    const std::string seatsPerRowParam = request.getQueryParam("seatsPerRow");
+    if (!seatsPerRowParam.empty() && !parseNumber(seatsPerRowParam, seatsPerRow)) {
+        throw Utils::ValidationException("Invalid seatsPerRow", "seatsPerRow");
+    }
+    if (!seatChangeFeed_) {
+        throw Utils::MovieBookingException("Seat change streaming is not enabled", "SERVICE_UNAVAILABLE", 503);
+    }
+
+    std::shared_ptr<const Models::Show> show = showService_->getShow(showId);
+    if (!show) {
+        throw Utils::ResourceNotFoundException("Show", std::to_string(showId));
+    }
+
+    HttpResponse response(200, "text/event-stream");
+    response.headers["Cache-Control"] = "no-cache";
+    response.headers["X-Accel-Buffering"] = "no"; // keep reverse proxies from buffering events
+    response.stream = seatChangeFeed_->watch(*show, seatsPerRow);
+    return response;
+}
+
+} // namespace Controllers
+} // namespace MovieBooking
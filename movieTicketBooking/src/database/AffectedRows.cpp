@@ -0,0 +1,20 @@
+#include "../../include/database/DatabaseConnection.h"
+
+namespace MovieBooking {
+namespace Database {
+
+bool DatabaseConnection::executeQuery(const std::string& query, uint64_t* affectedRows) {
+    if (!executeQuery(query)) {
+        return false;
+    }
+    if (affectedRows) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const uint64_t rows = static_cast<uint64_t>(mysql_affected_rows(connection_));
+        // (uint64_t)-1 would mean the statement failed, which executeQuery already reported
+        *affectedRows = rows == static_cast<uint64_t>(-1) ? 0 : rows;
+    }
+    return true;
+}
+
+} // namespace Database
+} // namespace MovieBooking
@@ -0,0 +1,29 @@
+#include "../../include/database/DatabaseConnection.h"
+
+namespace MovieBooking {
+namespace Database {
+
+// Parameters are taken by value so they live in the coroutine frame for as
+// long as the offloaded call can reference them.
+
+Utils::Task<bool> DatabaseConnection::executeQueryTask(std::string query) {
+    co_return co_await Utils::offload(Utils::Executors::io(), [this, &query] { return executeQuery(query); });
+}
+
+Utils::Task<std::vector<std::vector<std::string>>> DatabaseConnection::fetchResultsTask(std::string query) {
+    co_return co_await Utils::offload(Utils::Executors::io(), [this, &query] { return fetchResults(query); });
+}
+
+Utils::Task<bool> DatabaseConnection::executeCachedTask(std::string sqlTemplate, std::vector<StatementParam> params,
+                                                        uint64_t* affectedRows) {
+    co_return co_await Utils::offload(Utils::Executors::io(), [this, &sqlTemplate, &params, affectedRows] {
+        return executeCached(sqlTemplate, params, affectedRows);
+    });
+}
+
+Utils::Task<PooledConnection> ConnectionPool::acquireTask() {
+    co_return co_await Utils::offload(Utils::Executors::io(), [this] { return acquire(); });
+}
+
+} // namespace Database
+} // namespace MovieBooking
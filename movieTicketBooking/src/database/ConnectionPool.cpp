@@ -0,0 +1,356 @@
+#include "../../include/database/DatabaseConnection.h"
+#include "../../include/utils/Exceptions.h"
+
+#include <algorithm>
+
+namespace MovieBooking {
+namespace Database {
+
+ConnectionPool::ConnectionPool(const ConnectionPoolConfig& config)
+    : config_(config), openConnections_(0), closed_(false), running_(false),
+      acquireTimeouts_(0), failedHealthChecks_(0) {
+    config_.maxConnections = std::max(1, config_.maxConnections);
+    config_.minConnections = std::clamp(config_.minConnections, 0, config_.maxConnections);
+    metricsCollector_ = Utils::ScopedCollector(Utils::MetricsRegistry::global(),
+                                               [this](Utils::MetricsWriter& out) { collectMetrics(out); });
+}
+
+ConnectionPool::ConnectionPool(const std::string& host, const std::string& username,
+                               const std::string& password, const std::string& database,
+                               int port, int maxConnections)
+    : ConnectionPool(ConnectionPoolConfig{host, username, password, database, port,
+                                          std::min(2, maxConnections), maxConnections}) {}
+
+ConnectionPool::~ConnectionPool() {
+    metricsCollector_.reset();
+    shutdown();
+}
+
+bool ConnectionPool::warmUp() {
+    std::vector<std::unique_ptr<DatabaseConnection>> opened;
+    for (int i = 0; i < config_.minConnections; ++i) {
+        auto connection = openConnection();
+        if (!connection) {
+            break;
+        }
+        opened.push_back(std::move(connection));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        openConnections_ += static_cast<int>(opened.size());
+        for (auto& connection : opened) {
+            idle_.push_back(std::move(connection));
+        }
+    }
+    condition_.notify_all();
+
+    if (!running_.exchange(true)) {
+        healthThread_ = std::thread(&ConnectionPool::healthWorker, this);
+    }
+    return static_cast<int>(opened.size()) == config_.minConnections;
+}
+
+void ConnectionPool::shutdown() {
+    if (running_.exchange(false)) {
+        {
+            std::lock_guard<std::mutex> lock(healthMutex_);
+        }
+        healthCondition_.notify_all();
+        if (healthThread_.joinable()) {
+            healthThread_.join();
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    openConnections_ -= static_cast<int>(idle_.size());
+    idle_.clear();
+}
+
+PooledConnection ConnectionPool::acquire() {
+    return acquire(config_.acquireTimeout);
+}
+
+PooledConnection ConnectionPool::acquire(std::chrono::milliseconds timeout) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + timeout;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool timedOut = false;
+    for (;;) {
+        if (!idle_.empty()) {
+            auto connection = std::move(idle_.back());
+            idle_.pop_back();
+            lock.unlock();
+            waitTime_.record(std::chrono::steady_clock::now() - start);
+            return PooledConnection(weak_from_this(), std::move(connection));
+        }
+
+        if (openConnections_ < config_.maxConnections) {
+            // Reserve the slot, then connect without holding the lock
+            ++openConnections_;
+            lock.unlock();
+            auto connection = openConnection();
+            if (connection) {
+                waitTime_.record(std::chrono::steady_clock::now() - start);
+                return PooledConnection(weak_from_this(), std::move(connection));
+            }
+            lock.lock();
+            --openConnections_;
+            condition_.notify_one();
+        }
+
+        // The loop runs once more after the deadline, for a connection or a
+        // slot freed just as the wait timed out
+        if (timedOut) {
+            acquireTimeouts_.fetch_add(1, std::memory_order_relaxed);
+            waitTime_.record(std::chrono::steady_clock::now() - start);
+            throw Utils::LockTimeoutException("database connection pool",
+                                              static_cast<int>(timeout.count()));
+        }
+        timedOut = condition_.wait_until(lock, deadline) == std::cv_status::timeout;
+    }
+}
+
+PooledConnection ConnectionPool::tryAcquire() {
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!idle_.empty()) {
+        auto connection = std::move(idle_.back());
+        idle_.pop_back();
+        lock.unlock();
+        waitTime_.record(std::chrono::steady_clock::now() - start);
+        return PooledConnection(weak_from_this(), std::move(connection));
+    }
+    if (openConnections_ >= config_.maxConnections) {
+        return PooledConnection();
+    }
+    ++openConnections_;
+    lock.unlock();
+    auto connection = openConnection();
+    if (connection) {
+        waitTime_.record(std::chrono::steady_clock::now() - start);
+        return PooledConnection(weak_from_this(), std::move(connection));
+    }
+    lock.lock();
+    --openConnections_;
+    lock.unlock();
+    condition_.notify_one();
+    return PooledConnection();
+}
+
+void ConnectionPool::release(std::unique_ptr<DatabaseConnection> connection,
+                             std::chrono::steady_clock::time_point leasedAt) {
+    leaseTime_.record(std::chrono::steady_clock::now() - leasedAt);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (closed_ || !connection->isConnected()) {
+        // Drop it; the next acquire() opens a replacement if needed
+        --openConnections_;
+        lock.unlock();
+        connection.reset();
+    } else {
+        idle_.push_back(std::move(connection));
+        lock.unlock();
+    }
+    condition_.notify_one();
+}
+
+int ConnectionPool::getAvailableConnections() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(idle_.size());
+}
+
+int ConnectionPool::getOpenConnections() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return openConnections_;
+}
+
+ConnectionPool::Stats ConnectionPool::getStats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.idleConnections = static_cast<int>(idle_.size());
+        stats.openConnections = openConnections_;
+    }
+    stats.maxConnections = config_.maxConnections;
+    stats.acquireTimeouts = acquireTimeouts_.load(std::memory_order_relaxed);
+    stats.failedHealthChecks = failedHealthChecks_.load(std::memory_order_relaxed);
+    stats.waitTime = waitTime_.snapshot();
+    stats.leaseTime = leaseTime_.snapshot();
+    return stats;
+}
+
+void ConnectionPool::collectMetrics(Utils::MetricsWriter& out) const {
+    const Stats stats = getStats();
+    // A primary and its replicas share the database name, so the host tells them apart
+    const Utils::MetricLabels labels{{"database", config_.database},
+                                     {"host", config_.host + ":" + std::to_string(config_.port)}};
+    out.gauge("db_pool_idle_connections", "Idle pooled connections", labels, stats.idleConnections);
+    out.gauge("db_pool_open_connections", "Open pooled connections", labels, stats.openConnections);
+    out.gauge("db_pool_max_connections", "Pool size limit", labels, stats.maxConnections);
+    out.counter("db_pool_acquire_timeouts_total", "acquire() calls that timed out", labels, stats.acquireTimeouts);
+    out.counter("db_pool_failed_health_checks_total", "Idle connections dropped by the health check", labels,
+                stats.failedHealthChecks);
+    out.summary("db_pool_acquire_wait_seconds", "Time spent waiting for a pooled connection", labels,
+                stats.waitTime);
+    out.summary("db_pool_lease_seconds", "Time a pooled connection was held", labels, stats.leaseTime);
+}
+
+std::unique_ptr<DatabaseConnection> ConnectionPool::openConnection() {
+    auto connection = std::make_unique<DatabaseConnection>(config_.host, config_.username,
+                                                           config_.password, config_.database,
+                                                           config_.port);
+    if (!connection->connect()) {
+        return nullptr;
+    }
+    return connection;
+}
+
+void ConnectionPool::healthWorker() {
+    while (running_.load()) {
+        {
+            std::unique_lock<std::mutex> lock(healthMutex_);
+            healthCondition_.wait_for(lock, config_.healthCheckInterval,
+                                      [this] { return !running_.load(); });
+        }
+        if (!running_.load()) {
+            break;
+        }
+        validateIdleConnections();
+    }
+}
+
+void ConnectionPool::validateIdleConnections() {
+    // One connection at a time, checked outside the pool lock, so a ping only
+    // ever holds back the connection it is on. The coldest is at the front;
+    // a checked one goes back on top, so each pass reaches the others.
+    size_t remaining = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        remaining = idle_.size();
+    }
+    for (; remaining > 0 && running_.load(); --remaining) {
+        std::unique_ptr<DatabaseConnection> connection;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (idle_.empty()) {
+                break;
+            }
+            connection = std::move(idle_.front());
+            idle_.erase(idle_.begin());
+        }
+
+        const bool healthy = connection->ping() || connection->reconnect();
+        if (!healthy) {
+            failedHealthChecks_.fetch_add(1, std::memory_order_relaxed);
+            connection.reset();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (healthy) {
+                idle_.push_back(std::move(connection));
+            } else {
+                --openConnections_;
+            }
+        }
+        condition_.notify_one();
+    }
+
+    // Top back up to the configured minimum. openConnections_ counts leased
+    // connections too, and each slot is reserved before connecting, as in
+    // acquire(), so growth from both never passes maxConnections.
+    while (running_.load()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_ || openConnections_ >= config_.minConnections ||
+                openConnections_ >= config_.maxConnections) {
+                break;
+            }
+            ++openConnections_;
+        }
+        auto connection = openConnection();
+        const bool opened = connection != nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (opened && !closed_) {
+                idle_.push_back(std::move(connection));
+            } else {
+                --openConnections_;
+            }
+        }
+        condition_.notify_one();
+        if (!opened) {
+            break;
+        }
+    }
+}
+
+// DatabaseManager
+
+std::shared_ptr<ConnectionPool> DatabaseManager::pool_;
+std::mutex DatabaseManager::mutex_;
+
+bool DatabaseManager::initialize(const ConnectionPoolConfig& config) {
+    auto pool = std::make_shared<ConnectionPool>(config);
+    if (!pool->warmUp()) {
+        pool->shutdown();
+        return false;
+    }
+    install(std::move(pool), nullptr);
+    return true;
+}
+
+bool DatabaseManager::initialize(const std::string& host, const std::string& username,
+                                 const std::string& password, const std::string& database,
+                                 int port, int maxConnections, int minConnections) {
+    ConnectionPoolConfig config;
+    config.host = host;
+    config.username = username;
+    config.password = password;
+    config.database = database;
+    config.port = port;
+    config.minConnections = minConnections;
+    config.maxConnections = maxConnections;
+    return initialize(config);
+}
+
+PooledConnection DatabaseManager::getConnection() {
+    std::shared_ptr<ConnectionPool> pool = getPool();
+    if (!pool) {
+        throw Utils::ConnectionException("DatabaseManager is not initialized");
+    }
+    return pool->acquire();
+}
+
+std::shared_ptr<ConnectionPool> DatabaseManager::getPool() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pool_;
+}
+
+void DatabaseManager::shutdown() {
+    install(nullptr, nullptr);
+}
+
+bool DatabaseManager::isInitialized() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pool_ != nullptr;
+}
+
+void DatabaseManager::install(std::shared_ptr<ConnectionPool> pool, std::shared_ptr<ConnectionRouter> router) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pool.swap(pool_);
+        router.swap(router_);
+    }
+    // Outside the lock: shutting down joins the replaced pool's and router's threads
+    if (router) {
+        router->shutdown();
+    }
+    if (pool) {
+        pool->shutdown();
+    }
+}
+
+} // namespace Database
+} // namespace MovieBooking
@@ -0,0 +1,265 @@
+#include "../../include/database/DatabaseConnection.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace MovieBooking {
+namespace Database {
+
+namespace {
+
+// The Session entered on this thread, if any
+thread_local const ConnectionRouter::Session* tlsSession = nullptr;
+
+int64_t steadyTicks(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+// The entered Session, else the calling thread's own state
+const std::shared_ptr<ConnectionRouter::AffinityState>& currentAffinity() {
+    if (tlsSession) {
+        return *tlsSession;
+    }
+    thread_local const ConnectionRouter::Session threadState = ConnectionRouter::newSession();
+    return threadState;
+}
+
+} // namespace
+
+ConnectionRouter::SessionScope::SessionScope(Session session)
+    : session_(std::move(session)), previous_(tlsSession) {
+    if (session_) {
+        tlsSession = &session_;
+    }
+}
+
+ConnectionRouter::SessionScope::~SessionScope() {
+    tlsSession = previous_;
+}
+
+void ConnectionRouter::PrimaryAffinity::release() {
+    const std::shared_ptr<AffinityState> state = std::move(state_);
+    if (!state) {
+        return;
+    }
+    state->depth.fetch_sub(1, std::memory_order_release);
+    // Whatever was committed under the affinity still has to reach the replicas
+    state->lastWriteMicros.store(steadyTicks(std::chrono::steady_clock::now()), std::memory_order_release);
+}
+
+ConnectionRouter::ConnectionRouter(const ReplicatedPoolConfig& config)
+    : config_(config), nextReplica_(0), running_(false), writes_(0), replicaReads_(0),
+      primaryReadsPinned_(0), primaryReadsLagging_(0), primaryReadsExhausted_(0) {
+    config_.maxReplicationLag = std::max(std::chrono::milliseconds(0), config_.maxReplicationLag);
+    config_.lagCheckInterval = std::max(std::chrono::milliseconds(1), config_.lagCheckInterval);
+    primary_ = std::make_shared<ConnectionPool>(config_.primary);
+    for (const auto& replicaConfig : config_.replicas) {
+        auto replica = std::make_unique<Replica>();
+        replica->pool = std::make_shared<ConnectionPool>(replicaConfig);
+        replica->name = replicaConfig.host + ":" + std::to_string(replicaConfig.port);
+        replicas_.push_back(std::move(replica));
+    }
+    metricsCollector_ = Utils::ScopedCollector(Utils::MetricsRegistry::global(),
+                                               [this](Utils::MetricsWriter& out) { collectMetrics(out); });
+}
+
+ConnectionRouter::~ConnectionRouter() {
+    metricsCollector_.reset();
+    shutdown();
+}
+
+bool ConnectionRouter::warmUp() {
+    const bool primaryReady = primary_->warmUp();
+    for (auto& replica : replicas_) {
+        replica->pool->warmUp();
+        measureLag(*replica);
+    }
+    if (!replicas_.empty() && !running_.exchange(true)) {
+        lagThread_ = std::thread(&ConnectionRouter::lagWorker, this);
+    }
+    return primaryReady;
+}
+
+void ConnectionRouter::shutdown() {
+    if (running_.exchange(false)) {
+        lagCondition_.notify_all();
+        if (lagThread_.joinable()) {
+            lagThread_.join();
+        }
+    }
+    primary_->shutdown();
+    for (auto& replica : replicas_) {
+        replica->pool->shutdown();
+    }
+}
+
+PooledConnection ConnectionRouter::acquire(QueryIntent intent) {
+    if (intent == QueryIntent::Read) {
+        return acquireRead(config_.maxReplicationLag);
+    }
+    writes_.fetch_add(1, std::memory_order_relaxed);
+    const std::shared_ptr<AffinityState>& affinity = currentAffinity();
+    affinity->lastWriteMicros.store(steadyTicks(std::chrono::steady_clock::now()), std::memory_order_release);
+    PooledConnection connection = primary_->acquire();
+    // Stamped again on release, as the write may run for longer than the lag bound
+    connection.lastWriteMicros_ = std::shared_ptr<std::atomic<int64_t>>(affinity, &affinity->lastWriteMicros);
+    return connection;
+}
+
+PooledConnection ConnectionRouter::acquireRead(std::chrono::milliseconds maxLag) {
+    if (replicas_.empty()) {
+        return primary_->acquire();
+    }
+    const auto now = std::chrono::steady_clock::now();
+    // Replicas within maxLag may still miss this state's writes of the last maxLag
+    const AffinityState& affinity = *currentAffinity();
+    if (affinity.depth.load(std::memory_order_acquire) > 0 ||
+        affinity.lastWriteMicros.load(std::memory_order_acquire) >
+            steadyTicks(now) - std::chrono::duration_cast<std::chrono::microseconds>(maxLag).count()) {
+        primaryReadsPinned_.fetch_add(1, std::memory_order_relaxed);
+        return primary_->acquire();
+    }
+
+    const size_t count = replicas_.size();
+    const size_t first = nextReplica_.fetch_add(1, std::memory_order_relaxed);
+    bool anyEligible = false;
+    for (size_t i = 0; i < count; ++i) {
+        Replica& replica = *replicas_[(first + i) % count];
+        if (!isEligible(replica, maxLag, now)) {
+            continue;
+        }
+        anyEligible = true;
+        // Never wait on a replica while another one, or the primary, may be free
+        if (PooledConnection connection = replica.pool->tryAcquire()) {
+            replicaReads_.fetch_add(1, std::memory_order_relaxed);
+            return connection;
+        }
+    }
+
+    (anyEligible ? primaryReadsExhausted_ : primaryReadsLagging_).fetch_add(1, std::memory_order_relaxed);
+    return primary_->acquire();
+}
+
+ConnectionRouter::PrimaryAffinity ConnectionRouter::pinToPrimary() {
+    std::shared_ptr<AffinityState> state = currentAffinity();
+    state->depth.fetch_add(1, std::memory_order_acq_rel);
+    return PrimaryAffinity(std::move(state));
+}
+
+ConnectionRouter::Stats ConnectionRouter::getStats() const {
+    Stats stats;
+    stats.writes = writes_.load(std::memory_order_relaxed);
+    stats.replicaReads = replicaReads_.load(std::memory_order_relaxed);
+    stats.primaryReadsPinned = primaryReadsPinned_.load(std::memory_order_relaxed);
+    stats.primaryReadsLagging = primaryReadsLagging_.load(std::memory_order_relaxed);
+    stats.primaryReadsExhausted = primaryReadsExhausted_.load(std::memory_order_relaxed);
+    const auto now = std::chrono::steady_clock::now();
+    for (const auto& replica : replicas_) {
+        stats.replicas.push_back(ReplicaStats{
+            replica->name, isEligible(*replica, config_.maxReplicationLag, now),
+            std::chrono::microseconds(replica->lagMicros.load(std::memory_order_relaxed)),
+            replica->pool->getStats()});
+    }
+    return stats;
+}
+
+bool ConnectionRouter::isEligible(const Replica& replica, std::chrono::microseconds maxLag,
+                                  std::chrono::steady_clock::time_point now) const {
+    const int64_t lag = replica.lagMicros.load(std::memory_order_acquire);
+    if (lag < 0) {
+        return false;
+    }
+    // Lag may have grown by as much as the measurement's age since it was taken
+    const int64_t age = std::max<int64_t>(0, steadyTicks(now) - replica.measuredAt.load(std::memory_order_acquire));
+    return lag + age <= maxLag.count();
+}
+
+void ConnectionRouter::measureLag(Replica& replica) {
+    const auto start = std::chrono::steady_clock::now();
+    int64_t lagMicros = -1;
+    try {
+        // Never queue behind a busy replica: keep the old measurement and let it age
+        PooledConnection connection = replica.pool->tryAcquire();
+        if (!connection) {
+            return;
+        }
+        const std::string value = connection->fetchSingleValue(config_.lagQuery);
+        double seconds = 0.0;
+        const auto result = std::from_chars(value.data(), value.data() + value.size(), seconds);
+        if (!value.empty() && result.ec == std::errc() && std::isfinite(seconds)) {
+            lagMicros = std::max<int64_t>(0, std::llround(seconds * 1e6));
+        }
+    } catch (const std::exception&) {
+        // Probe failed; the replica stays out of rotation until one succeeds
+    }
+    // Timestamped at the start, so the probe's own latency counts as lag
+    replica.measuredAt.store(steadyTicks(start), std::memory_order_release);
+    replica.lagMicros.store(lagMicros, std::memory_order_release);
+}
+
+void ConnectionRouter::lagWorker() {
+    while (running_.load()) {
+        {
+            std::unique_lock<std::mutex> lock(lagMutex_);
+            lagCondition_.wait_for(lock, config_.lagCheckInterval, [this] { return !running_.load(); });
+        }
+        if (!running_.load()) {
+            break;
+        }
+        for (auto& replica : replicas_) {
+            measureLag(*replica);
+        }
+    }
+}
+
+void ConnectionRouter::collectMetrics(Utils::MetricsWriter& out) const {
+    const auto reads = [&out](const char* target, const char* reason, const std::atomic<uint64_t>& value) {
+        out.counter("db_router_reads_total", "Read leases by the pool that served them",
+                    {{"target", target}, {"reason", reason}}, value.load(std::memory_order_relaxed));
+    };
+    out.counter("db_router_writes_total", "Write leases, always from the primary", {},
+                writes_.load(std::memory_order_relaxed));
+    reads("replica", "within_lag", replicaReads_);
+    reads("primary", "pinned", primaryReadsPinned_);
+    reads("primary", "lagging", primaryReadsLagging_);
+    reads("primary", "exhausted", primaryReadsExhausted_);
+
+    const auto now = std::chrono::steady_clock::now();
+    for (const auto& replica : replicas_) {
+        const Utils::MetricLabels labels{{"replica", replica->name}};
+        const int64_t lag = replica->lagMicros.load(std::memory_order_relaxed);
+        out.gauge("db_replica_lag_seconds", "Last measured replication lag; -1 if unknown", labels,
+                  lag >= 0 ? static_cast<double>(lag) * 1e-6 : -1.0);
+        out.gauge("db_replica_eligible", "1 while the replica is within the lag bound", labels,
+                  isEligible(*replica, config_.maxReplicationLag, now) ? 1.0 : 0.0);
+    }
+}
+
+// DatabaseManager: replicated setup
+
+std::shared_ptr<ConnectionRouter> DatabaseManager::router_;
+
+bool DatabaseManager::initialize(const ReplicatedPoolConfig& config) {
+    auto router = std::make_shared<ConnectionRouter>(config);
+    if (!router->warmUp()) {
+        router->shutdown();
+        return false;
+    }
+    std::shared_ptr<ConnectionPool> primary = router->getPrimary();
+    install(std::move(primary), std::move(router));
+    return true;
+}
+
+PooledConnection DatabaseManager::getConnection(QueryIntent intent) {
+    std::shared_ptr<ConnectionRouter> router = getRouter();
+    return router ? router->acquire(intent) : getConnection();
+}
+
+std::shared_ptr<ConnectionRouter> DatabaseManager::getRouter() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return router_;
+}
+
+} // namespace Database
+} // namespace MovieBooking
@@ -0,0 +1,204 @@
+#include "../../include/database/DatabaseConnection.h"
+
+#include <cstring>
+#include <ctime>
+
+namespace MovieBooking {
+namespace Database {
+
+namespace {
+
+// MySQL server errors after which a cached statement handle is no longer usable
+constexpr unsigned kErrorUnknownStatementHandler = 1243;
+constexpr unsigned kErrorNeedReprepare = 1615;
+
+bool isStaleStatementError(unsigned error) {
+    return error == kErrorUnknownStatementHandler || error == kErrorNeedReprepare;
+}
+
+// Backing storage for one bound parameter; MYSQL_BIND only points at it
+struct BoundValue {
+    long long integer = 0;
+    double real = 0.0;
+    MYSQL_TIME time{};
+    unsigned long length = 0;
+};
+
+void bindParam(const StatementParam& param, MYSQL_BIND& bind, BoundValue& value) {
+    std::memset(&bind, 0, sizeof(bind));
+    if (std::holds_alternative<std::nullptr_t>(param)) {
+        bind.buffer_type = MYSQL_TYPE_NULL;
+    } else if (const int* i = std::get_if<int>(&param)) {
+        value.integer = *i;
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = &value.integer;
+    } else if (const int64_t* l = std::get_if<int64_t>(&param)) {
+        value.integer = *l;
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = &value.integer;
+    } else if (const double* d = std::get_if<double>(&param)) {
+        value.real = *d;
+        bind.buffer_type = MYSQL_TYPE_DOUBLE;
+        bind.buffer = &value.real;
+    } else if (const std::string* str = std::get_if<std::string>(&param)) {
+        value.length = static_cast<unsigned long>(str->size());
+        bind.buffer_type = MYSQL_TYPE_STRING;
+        bind.buffer = const_cast<char*>(str->data());
+        bind.buffer_length = value.length;
+        bind.length = &value.length;
+    } else {
+        const auto& timePoint = std::get<std::chrono::system_clock::time_point>(param);
+        const std::time_t seconds = std::chrono::system_clock::to_time_t(timePoint);
+        std::tm tm{};
+        localtime_r(&seconds, &tm);
+        value.time.year = static_cast<unsigned>(tm.tm_year + 1900);
+        value.time.month = static_cast<unsigned>(tm.tm_mon + 1);
+        value.time.day = static_cast<unsigned>(tm.tm_mday);
+        value.time.hour = static_cast<unsigned>(tm.tm_hour);
+        value.time.minute = static_cast<unsigned>(tm.tm_min);
+        value.time.second = static_cast<unsigned>(tm.tm_sec);
+        value.time.time_type = MYSQL_TIMESTAMP_DATETIME;
+        bind.buffer_type = MYSQL_TYPE_DATETIME;
+        bind.buffer = &value.time;
+    }
+}
+
+// Statement label for metrics: the SQL template with runs of whitespace
+// collapsed and every parenthesized placeholder list, such as the padded
+// `IN (?, ?, ?, ?)` chunks, written as `(?, ...)`, so all widths of one
+// statement share a series. Cut to a length that keeps the exposition readable.
+std::string statementLabel(const std::string& sqlTemplate) {
+    constexpr size_t kMaxLabelLength = 120;
+    std::string collapsed;
+    collapsed.reserve(sqlTemplate.size());
+    for (char c : sqlTemplate) {
+        const bool space = c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        if (space && (collapsed.empty() || collapsed.back() == ' ')) {
+            continue;
+        }
+        collapsed += space ? ' ' : c;
+    }
+
+    std::string label;
+    for (size_t i = 0; i < collapsed.size() && label.size() < kMaxLabelLength; ++i) {
+        if (collapsed[i] == '(') {
+            const size_t close = collapsed.find_first_not_of("?, ", i + 1);
+            if (close != std::string::npos && collapsed[close] == ')' &&
+                collapsed.find('?', i + 1) < close) {
+                label += "(?, ...)";
+                i = close;
+                continue;
+            }
+        }
+        label += collapsed[i];
+    }
+    if (label.size() > kMaxLabelLength) {
+        label.resize(kMaxLabelLength);
+    }
+    while (!label.empty() && label.back() == ' ') {
+        label.pop_back();
+    }
+    return label;
+}
+
+// Latency histogram for one SQL template. Looked up when the statement is
+// prepared and cached with it, so executions pay no lookup of their own.
+Utils::LatencyHistogram& statementLatency(const std::string& sqlTemplate) {
+    return Utils::MetricsRegistry::global().histogram(
+        "db_statement_duration_seconds", "Prepared statement execution latency",
+        {{"statement", statementLabel(sqlTemplate)}});
+}
+
+} // namespace
+
+bool DatabaseConnection::executeCached(const std::string& sqlTemplate,
+                                       const std::vector<StatementParam>& params,
+                                       uint64_t* affectedRows) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!isConnected_) {
+        return false;
+    }
+
+    // Recorded once a statement is in hand, including any (re-)prepare
+    struct LatencyScope {
+        Utils::LatencyHistogram* histogram = nullptr;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        ~LatencyScope() {
+            if (histogram) {
+                histogram->record(std::chrono::steady_clock::now() - start);
+            }
+        }
+    } latency;
+
+    PreparedStatementCache::Statement stmt = getOrPrepareStatement(sqlTemplate);
+    if (!stmt.handle) {
+        return false;
+    }
+    latency.histogram = stmt.latency;
+    if (bindAndExecute(stmt.handle, params, affectedRows)) {
+        return true;
+    }
+
+    // The server can drop statement handles (e.g. after DDL); re-prepare once
+    if (!isStaleStatementError(mysql_stmt_errno(stmt.handle))) {
+        return false;
+    }
+    statementCache_.erase(sqlTemplate);
+    stmt = getOrPrepareStatement(sqlTemplate);
+    return stmt.handle && bindAndExecute(stmt.handle, params, affectedRows);
+}
+
+void DatabaseConnection::setStatementCacheCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statementCache_.setCapacity(capacity);
+}
+
+PreparedStatementCache::Stats DatabaseConnection::getStatementCacheStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statementCache_.getStats();
+}
+
+PreparedStatementCache::Statement DatabaseConnection::getOrPrepareStatement(const std::string& sqlTemplate) {
+    if (const PreparedStatementCache::Statement* cached = statementCache_.find(sqlTemplate)) {
+        return *cached;
+    }
+
+    MYSQL_STMT* stmt = mysql_stmt_init(connection_);
+    if (!stmt) {
+        return {};
+    }
+    if (mysql_stmt_prepare(stmt, sqlTemplate.c_str(), static_cast<unsigned long>(sqlTemplate.size())) != 0) {
+        mysql_stmt_close(stmt);
+        return {};
+    }
+    const PreparedStatementCache::Statement statement{stmt, &statementLatency(sqlTemplate)};
+    statementCache_.insert(sqlTemplate, statement);
+    return statement;
+}
+
+bool DatabaseConnection::bindAndExecute(MYSQL_STMT* stmt, const std::vector<StatementParam>& params,
+                                        uint64_t* affectedRows) {
+    if (mysql_stmt_param_count(stmt) != params.size()) {
+        return false;
+    }
+
+    std::vector<MYSQL_BIND> binds(params.size());
+    std::vector<BoundValue> values(params.size());
+    for (size_t i = 0; i < params.size(); ++i) {
+        bindParam(params[i], binds[i], values[i]);
+    }
+
+    if (!binds.empty() && mysql_stmt_bind_param(stmt, binds.data()) != 0) {
+        return false;
+    }
+    if (mysql_stmt_execute(stmt) != 0) {
+        return false;
+    }
+    if (affectedRows) {
+        *affectedRows = static_cast<uint64_t>(mysql_stmt_affected_rows(stmt));
+    }
+    return true;
+}
+
+} // namespace Database
+} // namespace MovieBooking
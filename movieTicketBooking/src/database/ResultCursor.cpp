@@ -0,0 +1,20 @@
+#include "../../include/database/DatabaseConnection.h"
+
+namespace MovieBooking {
+namespace Database {
+
+ResultCursor DatabaseConnection::openCursor(const std::string& query) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!isConnected_ ||
+        mysql_real_query(connection_, query.c_str(), static_cast<unsigned long>(query.size())) != 0) {
+        return ResultCursor();
+    }
+    MYSQL_RES* result = mysql_use_result(connection_);
+    if (!result) {
+        return ResultCursor();
+    }
+    return ResultCursor(std::move(lock), result);
+}
+
+} // namespace Database
+} // namespace MovieBooking
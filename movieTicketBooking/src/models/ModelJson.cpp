@@ -0,0 +1,276 @@
+#include "../../include/models/Booking.h"
+#include "../../include/models/Movie.h"
+#include "../../include/models/Screen.h"
+#include "../../include/models/Show.h"
+#include "../../include/models/User.h"
+#include "../../include/utils/JsonWriter.h"
+
+#include <string_view>
+
+// Streaming counterparts of the models' toJson(). Enum names are written from
+// static tables so that serializing a seat or booking allocates nothing.
+
+namespace MovieBooking {
+namespace Models {
+
+namespace {
+
+constexpr char kSeatStatusCodes[] = {'A', 'L', 'B', 'M'};
+
+std::string_view statusName(ShowSeatStatus status) {
+    switch (status) {
+        case ShowSeatStatus::AVAILABLE: return "AVAILABLE";
+        case ShowSeatStatus::LOCKED: return "LOCKED";
+        case ShowSeatStatus::BOOKED: return "BOOKED";
+        case ShowSeatStatus::MAINTENANCE: return "MAINTENANCE";
+    }
+    return "UNKNOWN";
+}
+
+std::string_view statusName(ShowStatus status) {
+    switch (status) {
+        case ShowStatus::SCHEDULED: return "SCHEDULED";
+        case ShowStatus::CANCELLED: return "CANCELLED";
+        case ShowStatus::COMPLETED: return "COMPLETED";
+        case ShowStatus::IN_PROGRESS: return "IN_PROGRESS";
+    }
+    return "UNKNOWN";
+}
+
+std::string_view statusName(MovieStatus status) {
+    switch (status) {
+        case MovieStatus::NOW_SHOWING: return "NOW_SHOWING";
+        case MovieStatus::COMING_SOON: return "COMING_SOON";
+        case MovieStatus::ENDED: return "ENDED";
+    }
+    return "UNKNOWN";
+}
+
+std::string_view statusName(BookingStatus status) {
+    switch (status) {
+        case BookingStatus::PENDING: return "PENDING";
+        case BookingStatus::CONFIRMED: return "CONFIRMED";
+        case BookingStatus::CANCELLED: return "CANCELLED";
+        case BookingStatus::EXPIRED: return "EXPIRED";
+    }
+    return "UNKNOWN";
+}
+
+std::string_view statusName(PaymentStatus status) {
+    switch (status) {
+        case PaymentStatus::PENDING: return "PENDING";
+        case PaymentStatus::PROCESSING: return "PROCESSING";
+        case PaymentStatus::COMPLETED: return "COMPLETED";
+        case PaymentStatus::FAILED: return "FAILED";
+        case PaymentStatus::REFUNDED: return "REFUNDED";
+    }
+    return "UNKNOWN";
+}
+
+std::string_view typeName(SeatType type) {
+    switch (type) {
+        case SeatType::REGULAR: return "REGULAR";
+        case SeatType::PREMIUM: return "PREMIUM";
+        case SeatType::RECLINER: return "RECLINER";
+        case SeatType::VIP: return "VIP";
+    }
+    return "UNKNOWN";
+}
+
+} // namespace
+
+// Shows
+
+void ShowSeat::writeJson(Utils::JsonWriter& writer) const {
+    const ShowSeatStatus status = getStatus();
+    writer.beginObject();
+    writer.field("id", getId());
+    writer.field("showId", getShowId());
+    writer.field("seatId", getSeatId());
+    writer.field("status", statusName(status));
+    writer.field("price", getPrice());
+    if (status == ShowSeatStatus::LOCKED || status == ShowSeatStatus::BOOKED) {
+        writer.field("bookingId", getBookingId());
+    }
+    if (status == ShowSeatStatus::LOCKED) {
+        writer.field("lockedUntil", getLockedUntil());
+    }
+    writer.endObject();
+}
+
+void Show::writeJson(Utils::JsonWriter& writer) const {
+    writer.beginObject();
+    writer.field("id", id_);
+    writer.field("movieId", movieId_);
+    writer.field("screenId", screenId_);
+    writer.field("startTime", startTime_);
+    writer.field("endTime", endTime_);
+    writer.field("basePrice", basePrice_);
+    writer.field("status", statusName(getStatus()));
+    writer.field("totalSeats", seatStates_.size());
+    writer.field("availableSeats", seatStates_.count(ShowSeatStatus::AVAILABLE));
+    writer.field("createdAt", createdAt_);
+    writer.field("updatedAt", updatedAt_);
+    writer.endObject();
+}
+
+void Show::writeSeatsJson(Utils::JsonWriter& writer) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    writer.beginArray();
+    for (size_t ordinal = 0; ordinal < seatStates_.size(); ++ordinal) {
+        ShowSeat(this, ordinal).writeJson(writer);
+    }
+    writer.endArray();
+}
+
+void Show::writeCompactLayout(Utils::JsonWriter& writer, size_t seatsPerRow) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const size_t seatCount = seatStates_.size();
+    if (seatsPerRow == 0) {
+        seatsPerRow = seatCount > 0 ? seatCount : 1;
+    }
+
+    writer.beginObject();
+    writer.field("showId", id_);
+    writer.field("seatsPerRow", seatsPerRow);
+    writer.key("rows");
+    writer.beginArray();
+    // Decode a packed word at a time rather than seat by seat
+    std::string row;
+    row.reserve(seatsPerRow);
+    uint64_t word = 0;
+    for (size_t ordinal = 0; ordinal < seatCount; ++ordinal) {
+        if (ordinal % SeatStateMap::kSeatsPerWord == 0) {
+            word = seatStates_.loadWord(ordinal / SeatStateMap::kSeatsPerWord);
+        }
+        row += kSeatStatusCodes[word & 0x3];
+        word >>= SeatStateMap::kBitsPerSeat;
+        if (row.size() == seatsPerRow) {
+            writer.value(row);
+            row.clear();
+        }
+    }
+    if (!row.empty()) {
+        writer.value(row);
+    }
+    writer.endArray();
+    writer.endObject();
+}
+
+void SeatDelta::writeJson(Utils::JsonWriter& writer) const {
+    writer.beginObject();
+    writer.field("showId", showId);
+    writer.field("version", version);
+    writer.key("seats");
+    writer.beginArray();
+    for (const SeatChange& seat : seats) {
+        writer.beginArray();
+        writer.value(seat.seatId);
+        writer.value(std::string_view(&kSeatStatusCodes[static_cast<size_t>(seat.status) & 0x3], 1));
+        writer.endArray();
+    }
+    writer.endArray();
+    writer.endObject();
+}
+
+// Movies, screens, users
+
+void Movie::writeJson(Utils::JsonWriter& writer) const {
+    writer.beginObject();
+    writer.field("id", id_);
+    writer.field("title", title_);
+    writer.field("description", description_);
+    writer.field("durationMinutes", durationMinutes_);
+    writer.field("genre", genre_);
+    writer.field("language", language_);
+    writer.field("rating", rating_);
+    writer.field("releaseDate", releaseDate_);
+    writer.field("status", statusName(status_));
+    writer.field("posterUrl", posterUrl_);
+    writer.field("createdAt", createdAt_);
+    writer.field("updatedAt", updatedAt_);
+    writer.endObject();
+}
+
+void Seat::writeJson(Utils::JsonWriter& writer) const {
+    writer.beginObject();
+    writer.field("id", id_);
+    writer.field("screenId", screenId_);
+    writer.field("rowNumber", rowNumber_);
+    writer.field("seatNumber", seatNumber_);
+    writer.field("seatType", typeName(seatType_));
+    writer.field("priceMultiplier", priceMultiplier_);
+    writer.field("isAvailable", isAvailable_);
+    writer.endObject();
+}
+
+void Screen::writeJson(Utils::JsonWriter& writer) const {
+    writer.beginObject();
+    writer.field("id", id_);
+    writer.field("theaterId", theaterId_);
+    writer.field("name", name_);
+    writer.field("totalSeats", totalSeats_);
+    writer.field("rows", rows_);
+    writer.field("seatsPerRow", seatsPerRow_);
+    writer.key("seatTypes");
+    writer.beginArray();
+    for (SeatType type : seatTypes_) {
+        writer.value(typeName(type));
+    }
+    writer.endArray();
+    writer.field("createdAt", createdAt_);
+    writer.field("updatedAt", updatedAt_);
+    writer.endObject();
+}
+
+// The password hash is never serialized
+void User::writeJson(Utils::JsonWriter& writer) const {
+    writer.beginObject();
+    writer.field("id", id_);
+    writer.field("username", username_);
+    writer.field("email", email_);
+    writer.field("firstName", firstName_);
+    writer.field("lastName", lastName_);
+    writer.field("phone", phone_);
+    writer.field("isActive", isActive_);
+    writer.field("createdAt", createdAt_);
+    writer.field("updatedAt", updatedAt_);
+    writer.endObject();
+}
+
+// Bookings
+
+void BookingSeat::writeJson(Utils::JsonWriter& writer) const {
+    writer.beginObject();
+    writer.field("id", id_);
+    writer.field("bookingId", bookingId_);
+    writer.field("showSeatId", showSeatId_);
+    writer.field("price", price_);
+    writer.endObject();
+}
+
+void Booking::writeJson(Utils::JsonWriter& writer) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    writer.beginObject();
+    writer.field("id", id_);
+    writer.field("userId", userId_);
+    writer.field("showId", showId_);
+    writer.field("bookingStatus", statusName(bookingStatus_.load()));
+    writer.field("paymentStatus", statusName(paymentStatus_.load()));
+    writer.field("totalAmount", totalAmount_);
+    writer.field("bookingTime", bookingTime_);
+    writer.field("expiresAt", expiresAt_);
+    writer.field("paymentId", paymentId_);
+    writer.key("seats");
+    writer.beginArray();
+    for (const auto& seat : bookingSeats_) {
+        seat->writeJson(writer);
+    }
+    writer.endArray();
+    writer.field("createdAt", createdAt_);
+    writer.field("updatedAt", updatedAt_);
+    writer.endObject();
+}
+
+} // namespace Models
+} // namespace MovieBooking
@@ -0,0 +1,196 @@
+#include "../../include/models/SeatLayout.h"
+#include "../../include/models/Show.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace MovieBooking {
+namespace Models {
+
+namespace {
+
+// Row labels order by length first, so "Z" comes before "AA"
+bool rowLabelBefore(const std::string& a, const std::string& b) {
+    return a.size() != b.size() ? a.size() < b.size() : a < b;
+}
+
+void setBit(std::vector<uint64_t>& mask, size_t position) {
+    mask[position / SeatLayout::kBitsPerWord] |= uint64_t{1} << (position % SeatLayout::kBitsPerWord);
+}
+
+// First position >= from whose bit equals `set`, or `width` if none
+size_t nextPosition(const std::vector<uint64_t>& mask, size_t from, size_t width, bool set) {
+    while (from < width) {
+        const size_t wordIndex = from / SeatLayout::kBitsPerWord;
+        const unsigned offset = static_cast<unsigned>(from % SeatLayout::kBitsPerWord);
+        const uint64_t word = (set ? mask[wordIndex] : ~mask[wordIndex]) >> offset;
+        if (word != 0) {
+            return std::min(width, from + static_cast<size_t>(std::countr_zero(word)));
+        }
+        from = (wordIndex + 1) * SeatLayout::kBitsPerWord;
+    }
+    return width;
+}
+
+} // namespace
+
+SeatLayout::SeatLayout(const Screen& screen, const std::vector<Seat>& seats)
+    : width_(static_cast<size_t>(std::max(0, screen.getSeatsPerRow()))) {
+    std::vector<std::string> labels;
+    labels.reserve(static_cast<size_t>(std::max(0, screen.getRows())));
+    for (const Seat& seat : seats) {
+        if (seat.getScreenId() == screen.getId() && seat.getSeatNumber() > 0) {
+            labels.push_back(seat.getRowNumber());
+            width_ = std::max(width_, static_cast<size_t>(seat.getSeatNumber()));
+        }
+    }
+    std::sort(labels.begin(), labels.end(), rowLabelBefore);
+    labels.erase(std::unique(labels.begin(), labels.end()), labels.end());
+
+    const size_t words = getWordsPerRow();
+    rows_.resize(labels.size());
+    for (size_t i = 0; i < labels.size(); ++i) {
+        Row& row = rows_[i];
+        row.label = labels[i];
+        row.seatIds.assign(width_, kNoSeat);
+        row.seatMask.assign(words, 0);
+        for (auto& typeMask : row.typeMask) {
+            typeMask.assign(words, 0);
+        }
+    }
+
+    for (const Seat& seat : seats) {
+        if (seat.getScreenId() != screen.getId() || seat.getSeatNumber() <= 0 || !seat.isAvailable()) {
+            continue;
+        }
+        const auto label = std::lower_bound(labels.begin(), labels.end(), seat.getRowNumber(), rowLabelBefore);
+        Row& row = rows_[static_cast<size_t>(label - labels.begin())];
+        const size_t position = static_cast<size_t>(seat.getSeatNumber() - 1);
+        row.seatIds[position] = seat.getId();
+        setBit(row.seatMask, position);
+        const size_t type = static_cast<size_t>(seat.getSeatType());
+        if (type < kSeatTypeCount) {
+            setBit(row.typeMask[type], position);
+        }
+    }
+}
+
+std::shared_ptr<const Show::LayoutOrdinals> Show::ordinalsOf(const SeatLayout& layout) const {
+    std::lock_guard<std::mutex> lock(layoutOrdinalsMutex_);
+    if (layoutOrdinals_ && layoutOrdinals_->layout == &layout && layoutOrdinals_->seats == seatSlots_.get()) {
+        return layoutOrdinals_;
+    }
+    auto table = std::make_shared<LayoutOrdinals>();
+    table->layout = &layout;
+    table->seats = seatSlots_.get();
+    table->ordinals.reserve(layout.getRowCount() * layout.getWidth());
+    for (const SeatLayout::Row& row : layout.getRows()) {
+        for (int seatId : row.seatIds) {
+            auto it = seatId == SeatLayout::kNoSeat ? seatOrdinals_.end() : seatOrdinals_.find(seatId);
+            table->ordinals.push_back(it == seatOrdinals_.end() ? kNoOrdinal : it->second);
+        }
+    }
+    layoutOrdinals_ = table;
+    return table;
+}
+
+std::vector<int> Show::findBestAvailableSeats(const SeatLayout& layout, size_t count,
+                                              const BestSeatPreferences& preferences) const {
+    const size_t width = layout.getWidth();
+    const size_t rowCount = layout.getRowCount();
+    if (count == 0 || count > width || rowCount == 0) {
+        return {};
+    }
+    const size_t seatType = preferences.seatType ? static_cast<size_t>(*preferences.seatType) : 0;
+    if (seatType >= SeatLayout::kSeatTypeCount) {
+        return {};
+    }
+
+    // One snapshot of the status words; the scan below never touches them again
+    std::vector<uint64_t> available(seatStates_.wordCount());
+    for (size_t i = 0; i < available.size(); ++i) {
+        available[i] = seatStates_.matchMask(i, ShowSeatStatus::AVAILABLE);
+    }
+
+    const double rowCenter = static_cast<double>(width - 1) / 2.0;
+    const double halfWidth = std::max(1.0, static_cast<double>(width) / 2.0);
+    const double idealRow = preferences.idealRowFraction * static_cast<double>(rowCount - 1);
+    const double blockOffset = static_cast<double>(count - 1) / 2.0;
+
+    const std::shared_ptr<const LayoutOrdinals> layoutOrdinals = ordinalsOf(layout);
+
+    double bestScore = std::numeric_limits<double>::infinity();
+    size_t bestRow = 0;
+    size_t bestStart = 0;
+    std::vector<uint64_t> freeSeats(layout.getWordsPerRow());
+    for (size_t r = 0; r < rowCount; ++r) {
+        const double dy = rowCount > 1 ? (static_cast<double>(r) - idealRow) / static_cast<double>(rowCount - 1) : 0.0;
+        const double rowScore = preferences.rowWeight * dy * dy;
+        if (rowScore >= bestScore) {
+            continue; // no block in this row can beat the best so far
+        }
+
+        // Free positions of the row: candidate seats whose show seat is available
+        const SeatLayout::Row& row = layout.getRows()[r];
+        const std::vector<uint64_t>& candidates = preferences.seatType ? row.typeMask[seatType] : row.seatMask;
+        const size_t* rowOrdinals = layoutOrdinals->ordinals.data() + r * width;
+        for (size_t w = 0; w < freeSeats.size(); ++w) {
+            freeSeats[w] = 0;
+            for (uint64_t mask = candidates[w]; mask != 0; mask &= mask - 1) {
+                const size_t position = w * SeatLayout::kBitsPerWord + static_cast<size_t>(std::countr_zero(mask));
+                const size_t ordinal = rowOrdinals[position];
+                if (ordinal == kNoOrdinal) {
+                    continue;
+                }
+                const uint64_t bit = available[ordinal / SeatStateMap::kSeatsPerWord] >>
+                                     ((ordinal % SeatStateMap::kSeatsPerWord) * SeatStateMap::kBitsPerSeat);
+                freeSeats[w] |= (bit & 1) << (position % SeatLayout::kBitsPerWord);
+            }
+        }
+
+        // Each run of free seats long enough contributes its most central block
+        for (size_t begin = nextPosition(freeSeats, 0, width, true); begin < width;) {
+            const size_t end = nextPosition(freeSeats, begin, width, false);
+            if (end - begin >= count) {
+                const double ideal = std::round(rowCenter - blockOffset);
+                const double clamped = std::clamp(ideal, static_cast<double>(begin), static_cast<double>(end - count));
+                const size_t start = static_cast<size_t>(clamped);
+                const double dx = (static_cast<double>(start) + blockOffset - rowCenter) / halfWidth;
+                const double score = rowScore + preferences.centerWeight * dx * dx;
+                if (score < bestScore) {
+                    bestScore = score;
+                    bestRow = r;
+                    bestStart = start;
+                }
+            }
+            begin = nextPosition(freeSeats, end, width, true);
+        }
+    }
+
+    if (bestScore == std::numeric_limits<double>::infinity()) {
+        return {};
+    }
+    const auto& seatIds = layout.getRows()[bestRow].seatIds;
+    return std::vector<int>(seatIds.begin() + static_cast<std::ptrdiff_t>(bestStart),
+                            seatIds.begin() + static_cast<std::ptrdiff_t>(bestStart + count));
+}
+
+std::vector<int> Show::lockBestAvailableSeats(const SeatLayout& layout, size_t count, int bookingId,
+                                              int lockDurationMinutes, const BestSeatPreferences& preferences,
+                                              int maxAttempts) {
+    for (int attempt = 0; attempt < maxAttempts; ++attempt) {
+        std::vector<int> seatIds = findBestAvailableSeats(layout, count, preferences);
+        if (seatIds.empty()) {
+            break;
+        }
+        if (lockSeats(seatIds, bookingId, lockDurationMinutes)) {
+            return seatIds;
+        }
+    }
+    return {};
+}
+
+} // namespace Models
+} // namespace MovieBooking
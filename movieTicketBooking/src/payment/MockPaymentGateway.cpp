@@ -0,0 +1,233 @@
+#include "../../include/payment/PaymentGateway.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+
+namespace MovieBooking {
+namespace Payment {
+
+namespace {
+
+// z-score of the 99th percentile of the standard normal distribution
+constexpr double kZ99 = 2.3263478740408408;
+
+std::mt19937_64& randomEngine() {
+    thread_local std::mt19937_64 engine(std::random_device{}());
+    return engine;
+}
+
+} // namespace
+
+MockPaymentGateway::MockPaymentGateway(double successRate, std::chrono::milliseconds processingDelay,
+                                       size_t maxRetainedTransactions, std::chrono::minutes retention)
+    : transactions_(maxRetainedTransactions, retention, 64), paymentsByKey_(maxRetainedTransactions, retention, 64),
+      successRate_(successRate),
+      latencyMu_(0.0), latencySigma_(0.0), spikeProbability_(0.0), spikeLatencyMs_(0), nextId_(1) {
+    setProcessingDelay(processingDelay);
+}
+
+// Payments
+
+std::future<PaymentResponse> MockPaymentGateway::processPaymentAsync(const PaymentRequest& request) {
+    return Utils::toFuture(processPaymentTask(request));
+}
+
+PaymentResponse MockPaymentGateway::processPayment(const PaymentRequest& request) {
+    std::this_thread::sleep_for(sampleLatency());
+    return settlePayment(request);
+}
+
+Utils::Task<PaymentResponse> MockPaymentGateway::processPaymentTask(PaymentRequest request) {
+    co_await Utils::TimerScheduler::shared().sleepFor(sampleLatency());
+    co_return settlePayment(request);
+}
+
+// Refunds
+
+std::future<RefundResponse> MockPaymentGateway::processRefundAsync(const RefundRequest& request) {
+    return Utils::toFuture(processRefundTask(request));
+}
+
+RefundResponse MockPaymentGateway::processRefund(const RefundRequest& request) {
+    std::this_thread::sleep_for(sampleLatency());
+    return settleRefund(request);
+}
+
+Utils::Task<RefundResponse> MockPaymentGateway::processRefundTask(RefundRequest request) {
+    co_await Utils::TimerScheduler::shared().sleepFor(sampleLatency());
+    co_return settleRefund(request);
+}
+
+// Status
+
+std::future<PaymentStatus> MockPaymentGateway::checkPaymentStatusAsync(const std::string& transactionId) {
+    return Utils::toFuture(checkPaymentStatusTask(transactionId));
+}
+
+PaymentStatus MockPaymentGateway::checkPaymentStatus(const std::string& transactionId) {
+    std::this_thread::sleep_for(sampleLatency());
+    return lookupStatus(transactionId);
+}
+
+Utils::Task<PaymentStatus> MockPaymentGateway::checkPaymentStatusTask(std::string transactionId) {
+    co_await Utils::TimerScheduler::shared().sleepFor(sampleLatency());
+    co_return lookupStatus(transactionId);
+}
+
+// Lookup by idempotency key
+
+std::optional<PaymentResponse> MockPaymentGateway::findPayment(const std::string& idempotencyKey) {
+    std::this_thread::sleep_for(sampleLatency());
+    return lookupPayment(idempotencyKey);
+}
+
+Utils::Task<std::optional<PaymentResponse>> MockPaymentGateway::findPaymentTask(std::string idempotencyKey) {
+    co_await Utils::TimerScheduler::shared().sleepFor(sampleLatency());
+    co_return lookupPayment(idempotencyKey);
+}
+
+// Gateway information
+
+std::vector<PaymentMethod> MockPaymentGateway::getSupportedMethods() const {
+    return {PaymentMethod::CREDIT_CARD, PaymentMethod::DEBIT_CARD, PaymentMethod::UPI,
+            PaymentMethod::NET_BANKING, PaymentMethod::WALLET};
+}
+
+bool MockPaymentGateway::isMethodSupported(PaymentMethod method) const {
+    const auto methods = getSupportedMethods();
+    return std::find(methods.begin(), methods.end(), method) != methods.end();
+}
+
+bool MockPaymentGateway::validatePaymentDetails(const PaymentRequest& request) {
+    return !request.bookingId.empty() && request.amount > 0.0 && isMethodSupported(request.method);
+}
+
+bool MockPaymentGateway::validateRefundDetails(const RefundRequest& request) {
+    return !request.originalTransactionId.empty() && request.amount > 0.0;
+}
+
+// Configuration
+
+void MockPaymentGateway::setLatencyProfile(const LatencyProfile& profile) {
+    const double p50 = std::max<double>(0.0, static_cast<double>(profile.p50.count()));
+    const double p99 = std::max<double>(p50, static_cast<double>(profile.p99.count()));
+    // A zero median has no log-normal fit; it simply means no delay
+    latencyMu_ = p50 > 0.0 ? std::log(p50) : -INFINITY;
+    latencySigma_ = p50 > 0.0 ? std::log(p99 / p50) / kZ99 : 0.0;
+    spikeProbability_ = std::clamp(profile.spikeProbability, 0.0, 1.0);
+    spikeLatencyMs_ = std::max<int64_t>(0, profile.spikeLatency.count());
+}
+
+// Call before traffic starts: the store's TTL is not synchronised with puts
+void MockPaymentGateway::setRetention(size_t maxTransactions, std::chrono::minutes retention) {
+    transactions_.setCapacity(maxTransactions);
+    transactions_.setTtl(retention);
+    paymentsByKey_.setCapacity(maxTransactions);
+    paymentsByKey_.setTtl(retention);
+}
+
+// Helpers
+
+std::chrono::microseconds MockPaymentGateway::sampleLatency() {
+    auto& engine = randomEngine();
+    const double mu = latencyMu_.load(std::memory_order_relaxed);
+    const double sigma = latencySigma_.load(std::memory_order_relaxed);
+    double millis = 0.0;
+    if (std::isfinite(mu)) {
+        millis = sigma > 0.0 ? std::lognormal_distribution<double>(mu, sigma)(engine) : std::exp(mu);
+    }
+    const double spikeProbability = spikeProbability_.load(std::memory_order_relaxed);
+    if (spikeProbability > 0.0 && std::bernoulli_distribution(spikeProbability)(engine)) {
+        millis += static_cast<double>(spikeLatencyMs_.load(std::memory_order_relaxed));
+    }
+    return std::chrono::microseconds(static_cast<int64_t>(millis * 1000.0));
+}
+
+PaymentResponse MockPaymentGateway::settlePayment(const PaymentRequest& request) {
+    if (!validatePaymentDetails(request)) {
+        return PaymentResponse(false, "Invalid payment details");
+    }
+    const bool success = shouldSucceed();
+    PaymentResponse response(success, success ? "Payment processed successfully" : "Payment declined by issuer");
+    response.transactionId = generateTransactionId();
+    response.paymentId = "pay_" + response.transactionId;
+    response.status = success ? PaymentStatus::COMPLETED : PaymentStatus::FAILED;
+    response.gatewayResponse = success ? "approved" : "declined";
+    response.additionalData["bookingId"] = request.bookingId;
+    auto settled = std::make_shared<const PaymentResponse>(response);
+    if (!request.idempotencyKey.empty()) {
+        // A key already settled replays its first settlement's response
+        const auto first = paymentsByKey_.putIfAbsent(request.idempotencyKey, settled);
+        if (first != settled) {
+            return *first;
+        }
+    }
+    transactions_.put(response.transactionId, std::move(settled));
+    return response;
+}
+
+RefundResponse MockPaymentGateway::settleRefund(const RefundRequest& request) {
+    if (!validateRefundDetails(request)) {
+        return RefundResponse(false, "Invalid refund details");
+    }
+    // Check and mark refunded under the shard lock so a payment refunds once
+    bool refundable = false;
+    const bool known = transactions_.update(request.originalTransactionId, [&refundable](const PaymentResponse& payment) {
+        refundable = payment.status == PaymentStatus::COMPLETED;
+        if (!refundable) {
+            return std::shared_ptr<const PaymentResponse>();
+        }
+        auto refunded = std::make_shared<PaymentResponse>(payment);
+        refunded->status = PaymentStatus::REFUNDED;
+        return std::shared_ptr<const PaymentResponse>(std::move(refunded));
+    });
+    if (!known) {
+        return RefundResponse(false, "Unknown transaction");
+    }
+    if (!refundable) {
+        return RefundResponse(false, "Transaction is not refundable");
+    }
+    RefundResponse response(true, "Refund processed successfully");
+    response.refundId = generateRefundId();
+    response.transactionId = request.originalTransactionId;
+    response.refundedAmount = request.amount;
+    response.status = "completed";
+    return response;
+}
+
+// Transactions past retention read as unknown, which a gateway reports as failed
+PaymentStatus MockPaymentGateway::lookupStatus(const std::string& transactionId) {
+    const auto payment = transactions_.get(transactionId);
+    return payment ? payment->status : PaymentStatus::FAILED;
+}
+
+// The key's settlement with its transaction's current status, e.g. REFUNDED
+std::optional<PaymentResponse> MockPaymentGateway::lookupPayment(const std::string& idempotencyKey) {
+    const auto payment = paymentsByKey_.get(idempotencyKey);
+    if (!payment) {
+        return std::nullopt;
+    }
+    PaymentResponse response = *payment;
+    if (const auto transaction = transactions_.get(response.transactionId)) {
+        response.status = transaction->status;
+    }
+    return response;
+}
+
+std::string MockPaymentGateway::generateTransactionId() {
+    return "mock_txn_" + std::to_string(nextId_.fetch_add(1, std::memory_order_relaxed));
+}
+
+std::string MockPaymentGateway::generateRefundId() {
+    return "mock_ref_" + std::to_string(nextId_.fetch_add(1, std::memory_order_relaxed));
+}
+
+bool MockPaymentGateway::shouldSucceed() {
+    return std::bernoulli_distribution(std::clamp(successRate_.load(std::memory_order_relaxed), 0.0, 1.0))(
+        randomEngine());
+}
+
+} // namespace Payment
+} // namespace MovieBooking
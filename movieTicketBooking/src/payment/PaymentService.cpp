@@ -0,0 +1,438 @@
+#include "../../include/payment/PaymentGateway.h"
+#include "../../include/repositories/BookingRepository.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <iterator>
+#include <map>
+#include <random>
+
+namespace MovieBooking {
+namespace Payment {
+
+namespace {
+
+// Gateway status as stored on the booking; a cancelled payment never settled
+Models::PaymentStatus toBookingPaymentStatus(PaymentStatus status) {
+    switch (status) {
+    case PaymentStatus::PENDING:
+        return Models::PaymentStatus::PENDING;
+    case PaymentStatus::PROCESSING:
+        return Models::PaymentStatus::PROCESSING;
+    case PaymentStatus::COMPLETED:
+        return Models::PaymentStatus::COMPLETED;
+    case PaymentStatus::REFUNDED:
+        return Models::PaymentStatus::REFUNDED;
+    case PaymentStatus::FAILED:
+    case PaymentStatus::CANCELLED:
+        break;
+    }
+    return Models::PaymentStatus::FAILED;
+}
+
+} // namespace
+
+PaymentService::PaymentService(const std::string& defaultGateway, int maxRetries,
+                               std::chrono::milliseconds retryDelay)
+    : defaultGateway_(defaultGateway), maxRetries_(maxRetries), retryDelay_(retryDelay),
+      maxRetryDelay_(std::chrono::seconds(30)), enableLogging_(false) {}
+
+// Gateways are expected to be registered at startup; replacing one while
+// payments are in flight is not supported.
+void PaymentService::addGateway(const std::string& name, std::unique_ptr<IPaymentGateway> gateway,
+                                const GatewayPolicy& policy) {
+    GatewayEntry entry{std::move(gateway),
+                       std::make_unique<Utils::AdaptiveConcurrencyLimit>(policy.concurrency),
+                       std::make_unique<Utils::CircuitBreaker>(policy.breakerFailureThreshold,
+                                                               policy.breakerOpenDuration),
+                       nullptr, nullptr};
+    auto& metrics = Utils::MetricsRegistry::global();
+    entry.latency = &metrics.histogram("payment_gateway_call_duration_seconds",
+                                       "Payment gateway call latency", {{"gateway", name}});
+    entry.failures = &metrics.counter("payment_gateway_call_failures_total",
+                                      "Payment gateway calls that failed or threw", {{"gateway", name}});
+    std::lock_guard<std::mutex> lock(gatewaysMutex_);
+    if (gateways_.find(name) == gateways_.end()) {
+        gatewayOrder_.push_back(name);
+    }
+    gateways_[name] = std::move(entry);
+}
+
+void PaymentService::setDefaultGateway(const std::string& name) {
+    std::lock_guard<std::mutex> lock(gatewaysMutex_);
+    defaultGateway_ = name;
+}
+
+void PaymentService::setPaymentLogger(std::function<void(const PaymentRequest&, const PaymentResponse&)> logger) {
+    paymentLogger_ = std::move(logger);
+}
+
+// Payments
+
+Utils::Task<PaymentResponse> PaymentService::processPaymentTask(PaymentRequest request, std::string gatewayName) {
+    if (request.idempotencyKey.empty()) {
+        request.idempotencyKey = newIdempotencyKey(request);
+    }
+    PaymentResponse response = co_await processPaymentWithRetryTask(request, std::move(gatewayName));
+    logPayment(request, response);
+    co_return response;
+}
+
+PaymentResponse PaymentService::processPayment(const PaymentRequest& request, const std::string& gatewayName) {
+    return Utils::syncWait(processPaymentTask(request, gatewayName));
+}
+
+Utils::Task<PaymentResponse> PaymentService::processPaymentWithRetryTask(PaymentRequest request,
+                                                                       std::string preferredGateway) {
+    PaymentResponse last(false, "No payment gateway supports this payment method");
+    // A gateway whose failed attempt may still have charged under the key
+    std::string unsettled;
+    for (int attempt = 0; attempt <= maxRetries_; ++attempt) {
+        if (attempt > 0) {
+            co_await Utils::TimerScheduler::shared().sleepFor(backoffDelay(attempt - 1));
+        }
+        if (!unsettled.empty()) {
+            std::optional<PaymentResponse> charge;
+            if (co_await findPaymentOn(unsettled, request.idempotencyKey, charge)) {
+                if (!charge) {
+                    unsettled.clear(); // nothing was charged: free to fail over
+                } else if (charge->status != PaymentStatus::PENDING && charge->status != PaymentStatus::PROCESSING) {
+                    charge->additionalData["gateway"] = unsettled;
+                    co_return std::move(*charge);
+                }
+            }
+        }
+
+        bool attempted = false;
+        for (auto& [name, entry] : failoverCandidates(unsettled.empty() ? preferredGateway : unsettled)) {
+            if (!unsettled.empty() && name != unsettled) {
+                break;
+            }
+            // Saturated or tripped gateways are skipped, not waited for
+            if (!entry->gateway->isMethodSupported(request.method) || !tryAdmit(*entry)) {
+                continue;
+            }
+            attempted = true;
+            const auto start = std::chrono::steady_clock::now();
+            PaymentResponse response(false);
+            try {
+                response = co_await entry->gateway->processPaymentTask(request);
+            } catch (const std::exception& e) {
+                response = PaymentResponse(false, e.what(), true);
+            }
+            // A decline is the issuer's answer: the gateway worked and a retry would be declined too
+            complete(*entry, !response.gatewayError, start);
+            response.additionalData["gateway"] = name;
+            if (!response.gatewayError) {
+                co_return response;
+            }
+            // Retried after backoff on this gateway, with the same key, until its charge is settled
+            unsettled = name;
+            last = std::move(response);
+            break;
+        }
+        if (!attempted && unsettled.empty()) {
+            last = PaymentResponse(false, "All payment gateways are saturated or unavailable", true);
+        }
+    }
+    last.additionalData["idempotencyKey"] = request.idempotencyKey;
+    co_return last;
+}
+
+// Looks the key up on `gatewayName`, admitted like any other call. False if
+// the lookup was refused or failed, i.e. the charge is still unsettled.
+Utils::Task<bool> PaymentService::findPaymentOn(const std::string& gatewayName, std::string idempotencyKey,
+                                                std::optional<PaymentResponse>& charge) {
+    GatewayEntry* entry = getGateway(gatewayName);
+    if (!entry || !tryAdmit(*entry)) {
+        co_return false;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    bool found = true;
+    try {
+        charge = co_await entry->gateway->findPaymentTask(std::move(idempotencyKey));
+    } catch (const std::exception&) {
+        found = false;
+    }
+    complete(*entry, found, start);
+    co_return found;
+}
+
+// Refunds
+
+Utils::Task<RefundResponse> PaymentService::processRefundTask(RefundRequest request, std::string gatewayName) {
+    co_return co_await processRefundWithRetryTask(std::move(request), std::move(gatewayName));
+}
+
+RefundResponse PaymentService::processRefund(const RefundRequest& request, const std::string& gatewayName) {
+    return Utils::syncWait(processRefundTask(request, gatewayName));
+}
+
+Utils::Task<RefundResponse> PaymentService::processRefundWithRetryTask(RefundRequest request,
+                                                                     std::string gatewayName) {
+    GatewayEntry* entry = getGateway(gatewayName);
+    if (!entry) {
+        co_return RefundResponse(false, "Unknown payment gateway");
+    }
+    RefundResponse last(false, "Payment gateway is saturated or unavailable", true);
+    for (int attempt = 0; attempt <= maxRetries_; ++attempt) {
+        if (attempt > 0) {
+            co_await Utils::TimerScheduler::shared().sleepFor(backoffDelay(attempt - 1));
+        }
+        if (!tryAdmit(*entry)) {
+            continue;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        RefundResponse response(false);
+        try {
+            response = co_await entry->gateway->processRefundTask(request);
+        } catch (const std::exception& e) {
+            response = RefundResponse(false, e.what(), true);
+        }
+        complete(*entry, !response.gatewayError, start);
+        if (!response.gatewayError) {
+            co_return response;
+        }
+        last = std::move(response);
+    }
+    co_return last;
+}
+
+// Status
+
+Utils::Task<PaymentStatus> PaymentService::checkPaymentStatusTask(std::string transactionId,
+                                                                 std::string gatewayName) {
+    GatewayEntry* entry = getGateway(gatewayName);
+    // Unknown gateway or no capacity: the status is not known yet, callers poll again
+    if (!entry || !tryAdmit(*entry)) {
+        co_return PaymentStatus::PENDING;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    PaymentStatus status = PaymentStatus::PENDING;
+    std::exception_ptr error;
+    try {
+        status = co_await entry->gateway->checkPaymentStatusTask(transactionId);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    complete(*entry, error == nullptr, start);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    co_return status;
+}
+
+PaymentStatus PaymentService::checkPaymentStatus(const std::string& transactionId, const std::string& gatewayName) {
+    return Utils::syncWait(checkPaymentStatusTask(transactionId, gatewayName));
+}
+
+Utils::Task<std::vector<PaymentStatus>> PaymentService::checkPaymentStatusBatchTask(
+    std::vector<std::string> transactionIds, std::string gatewayName, size_t maxParallelChunks) {
+    GatewayEntry* entry = getGateway(gatewayName);
+    if (!entry) {
+        co_return std::vector<PaymentStatus>(transactionIds.size(), PaymentStatus::PENDING);
+    }
+    const size_t chunkSize = std::max<size_t>(1, entry->gateway->getMaxStatusBatchSize());
+    std::vector<Utils::Task<std::vector<PaymentStatus>>> chunks;
+    chunks.reserve((transactionIds.size() + chunkSize - 1) / chunkSize);
+    for (size_t begin = 0; begin < transactionIds.size(); begin += chunkSize) {
+        const size_t end = std::min(transactionIds.size(), begin + chunkSize);
+        chunks.push_back(checkStatusChunkTask(*entry, std::vector<std::string>(
+            std::make_move_iterator(transactionIds.begin() + begin),
+            std::make_move_iterator(transactionIds.begin() + end))));
+    }
+    
+    std::vector<PaymentStatus> statuses;
+    statuses.reserve(transactionIds.size());
+    for (const auto& chunk : co_await Utils::whenAllBounded(std::move(chunks), maxParallelChunks)) {
+        statuses.insert(statuses.end(), chunk.begin(), chunk.end());
+    }
+    co_return statuses;
+}
+
+Utils::Task<ReconciliationResult> PaymentService::reconcilePaymentsTask(Repositories::BookingRepository& repository,
+                                                                        std::string gatewayName,
+                                                                        size_t maxParallelChunks) {
+    ReconciliationResult result;
+    const auto bookings = co_await Utils::offload(Utils::Executors::io(), [&repository] {
+        return repository.findBookingsWithFailedPayments();
+    });
+    
+    std::vector<std::string> transactionIds;
+    std::vector<const Models::Booking*> checked;
+    for (const auto& booking : bookings) {
+        if (booking && !booking->getPaymentId().empty()) {
+            transactionIds.push_back(booking->getPaymentId());
+            checked.push_back(booking.get());
+        }
+    }
+    result.checked = checked.size();
+    const auto statuses = co_await checkPaymentStatusBatchTask(std::move(transactionIds), std::move(gatewayName),
+                                                               maxParallelChunks);
+    
+    // Group by target status so the write-back is one statement per status
+    std::map<Models::PaymentStatus, std::vector<int>> changes;
+    for (size_t i = 0; i < checked.size(); ++i) {
+        if (statuses[i] == PaymentStatus::PENDING) {
+            ++result.unresolved;
+            continue;
+        }
+        const auto status = toBookingPaymentStatus(statuses[i]);
+        if (status != checked[i]->getPaymentStatus()) {
+            changes[status].push_back(checked[i]->getId());
+        }
+    }
+    if (changes.empty()) {
+        co_return result;
+    }
+    
+    result.writeFailed = !co_await Utils::offload(Utils::Executors::io(), [&repository, &changes, &result] {
+        bool written = true;
+        for (const auto& [status, bookingIds] : changes) {
+            if (repository.updatePaymentStatusBatch(bookingIds, status)) {
+                result.updated += bookingIds.size();
+            } else {
+                written = false;
+            }
+        }
+        return written;
+    });
+    co_return result;
+}
+
+// Gateway information
+
+std::vector<std::string> PaymentService::getAvailableGateways() const {
+    std::lock_guard<std::mutex> lock(gatewaysMutex_);
+    return gatewayOrder_;
+}
+
+std::vector<PaymentMethod> PaymentService::getSupportedMethods(const std::string& gatewayName) const {
+    const GatewayEntry* entry = getGateway(gatewayName);
+    return entry ? entry->gateway->getSupportedMethods() : std::vector<PaymentMethod>();
+}
+
+std::vector<GatewayStats> PaymentService::getGatewayStats() const {
+    std::lock_guard<std::mutex> lock(gatewaysMutex_);
+    std::vector<GatewayStats> stats;
+    stats.reserve(gatewayOrder_.size());
+    for (const auto& name : gatewayOrder_) {
+        const GatewayEntry& entry = gateways_.at(name);
+        const auto limit = entry.limiter->getStats();
+        stats.push_back({name, limit.limit, limit.inFlight, limit.rejected,
+                         entry.breaker->getState(), entry.breaker->getTimesOpened()});
+    }
+    return stats;
+}
+
+// Helpers
+
+PaymentService::GatewayEntry* PaymentService::getGateway(const std::string& name) {
+    std::lock_guard<std::mutex> lock(gatewaysMutex_);
+    auto it = gateways_.find(name.empty() ? defaultGateway_ : name);
+    return it == gateways_.end() ? nullptr : &it->second;
+}
+
+const PaymentService::GatewayEntry* PaymentService::getGateway(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(gatewaysMutex_);
+    auto it = gateways_.find(name.empty() ? defaultGateway_ : name);
+    return it == gateways_.end() ? nullptr : &it->second;
+}
+
+std::vector<std::pair<std::string, PaymentService::GatewayEntry*>>
+PaymentService::failoverCandidates(const std::string& preferred) {
+    std::lock_guard<std::mutex> lock(gatewaysMutex_);
+    const std::string& first = preferred.empty() ? defaultGateway_ : preferred;
+    std::vector<std::pair<std::string, GatewayEntry*>> candidates;
+    candidates.reserve(gatewayOrder_.size());
+    if (auto it = gateways_.find(first); it != gateways_.end()) {
+        candidates.emplace_back(first, &it->second);
+    }
+    for (const auto& name : gatewayOrder_) {
+        if (name != first) {
+            candidates.emplace_back(name, &gateways_.at(name));
+        }
+    }
+    return candidates;
+}
+
+bool PaymentService::tryAdmit(GatewayEntry& entry) {
+    if (!entry.limiter->tryAcquire()) {
+        return false;
+    }
+    if (!entry.breaker->allowRequest()) {
+        entry.limiter->releaseUnused();
+        return false;
+    }
+    return true;
+}
+
+void PaymentService::complete(GatewayEntry& entry, bool success, std::chrono::steady_clock::time_point start) {
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    entry.limiter->release(success, elapsed);
+    entry.latency->record(elapsed);
+    if (success) {
+        entry.breaker->recordSuccess();
+    } else {
+        entry.breaker->recordFailure();
+        entry.failures->increment();
+    }
+}
+
+// Unique per payment, random so keys from several service instances never collide
+std::string PaymentService::newIdempotencyKey(const PaymentRequest& request) {
+    thread_local std::mt19937_64 random(std::random_device{}());
+    char suffix[17];
+    std::snprintf(suffix, sizeof(suffix), "%016llx", static_cast<unsigned long long>(random()));
+    return request.bookingId + "-" + suffix;
+}
+
+// Exponential backoff capped at maxRetryDelay_, with "equal jitter": a
+// uniformly random delay in [cap/2, cap] so retries from many bookings spread out
+std::chrono::milliseconds PaymentService::backoffDelay(int attempt) const {
+    const auto exponent = std::min(attempt, 20);
+    const auto cap = std::min<std::chrono::milliseconds::rep>(
+        maxRetryDelay_.count(), retryDelay_.count() * (std::chrono::milliseconds::rep{1} << exponent));
+    thread_local std::mt19937_64 random(std::random_device{}());
+    std::uniform_int_distribution<std::chrono::milliseconds::rep> jitter(cap / 2, cap);
+    return std::chrono::milliseconds(jitter(random));
+}
+
+// One gateway batch call, admitted like any other request. Admission refusals
+// and failures back off and retry; after maxRetries_ the chunk reads as PENDING.
+Utils::Task<std::vector<PaymentStatus>> PaymentService::checkStatusChunkTask(GatewayEntry& entry,
+                                                                            std::vector<std::string> transactionIds) {
+    const size_t count = transactionIds.size();
+    for (int attempt = 0; attempt <= maxRetries_; ++attempt) {
+        if (attempt > 0) {
+            co_await Utils::TimerScheduler::shared().sleepFor(backoffDelay(attempt - 1));
+        }
+        if (!tryAdmit(entry)) {
+            continue;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<PaymentStatus> statuses;
+        bool success = true;
+        try {
+            statuses = co_await entry.gateway->checkPaymentStatusBatchTask(transactionIds);
+        } catch (const std::exception&) {
+            success = false;
+        }
+        success = success && statuses.size() == count;
+        complete(entry, success, start);
+        if (success) {
+            co_return statuses;
+        }
+    }
+    co_return std::vector<PaymentStatus>(count, PaymentStatus::PENDING);
+}
+
+void PaymentService::logPayment(const PaymentRequest& request, const PaymentResponse& response) {
+    if (enableLogging_ && paymentLogger_) {
+        paymentLogger_(request, response);
+    }
+}
+
+} // namespace Payment
+} // namespace MovieBooking
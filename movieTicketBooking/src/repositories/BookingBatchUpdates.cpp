@@ -0,0 +1,40 @@
+#include "../../include/repositories/BookingRepository.h"
+
+namespace MovieBooking {
+namespace Repositories {
+
+namespace {
+
+// payment_status column values
+const char* paymentStatusColumn(Models::PaymentStatus status) {
+    switch (status) {
+    case Models::PaymentStatus::PENDING:
+        return "PENDING";
+    case Models::PaymentStatus::PROCESSING:
+        return "PROCESSING";
+    case Models::PaymentStatus::COMPLETED:
+        return "COMPLETED";
+    case Models::PaymentStatus::FAILED:
+        return "FAILED";
+    case Models::PaymentStatus::REFUNDED:
+        return "REFUNDED";
+    }
+    return "FAILED";
+}
+
+} // namespace
+
+// One statement per chunk of ids, all in one transaction
+bool BookingRepository::updatePaymentStatusBatch(const std::vector<int>& bookingIds,
+                                                 Models::PaymentStatus status) {
+    if (bookingIds.empty()) {
+        return true;
+    }
+    Transaction transaction = beginTransaction();
+    return executeForIdChunks(transaction, kUpdatePaymentStatusBatchSql,
+                              {std::string(paymentStatusColumn(status))}, bookingIds) &&
+           transaction.commit();
+}
+
+} // namespace Repositories
+} // namespace MovieBooking
@@ -0,0 +1,73 @@
+#include "../../include/repositories/ShowRepository.h"
+
+#include <algorithm>
+
+namespace MovieBooking {
+namespace Repositories {
+
+namespace {
+
+// Each seat once, so the affected row count can be compared with the request
+std::vector<int> distinctSeats(const std::vector<int>& seatIds) {
+    std::vector<int> seats(seatIds);
+    std::sort(seats.begin(), seats.end());
+    seats.erase(std::unique(seats.begin(), seats.end()), seats.end());
+    return seats;
+}
+
+} // namespace
+
+// All or nothing: if any seat is no longer AVAILABLE, none is locked
+bool ShowRepository::lockShowSeats(int showId, const std::vector<int>& seatIds, int bookingId,
+                                   int lockDurationMinutes) {
+    const std::vector<int> seats = distinctSeats(seatIds);
+    if (seats.empty()) {
+        return false;
+    }
+    const auto lockedUntil = std::chrono::system_clock::now() + std::chrono::minutes(lockDurationMinutes);
+    Transaction transaction = beginTransaction();
+    uint64_t affected = 0;
+    if (!executeForIdChunks(transaction, kLockShowSeatsSql, {bookingId, lockedUntil, showId}, seats,
+                            kLockShowSeatsSuffix, {}, &affected)) {
+        return false;
+    }
+    if (affected != seats.size()) {
+        transaction.rollback();
+        return false;
+    }
+    return transaction.commit();
+}
+
+// All or nothing: every seat must still be LOCKED by `bookingId`
+bool ShowRepository::bookShowSeats(int showId, const std::vector<int>& seatIds, int bookingId) {
+    const std::vector<int> seats = distinctSeats(seatIds);
+    if (seats.empty()) {
+        return false;
+    }
+    Transaction transaction = beginTransaction();
+    uint64_t affected = 0;
+    if (!executeForIdChunks(transaction, kBookShowSeatsSql, {showId}, seats, kBookShowSeatsSuffix,
+                            {bookingId}, &affected)) {
+        return false;
+    }
+    if (affected != seats.size()) {
+        transaction.rollback();
+        return false;
+    }
+    return transaction.commit();
+}
+
+// Only seats still LOCKED past their deadline by a still-PENDING booking are
+// released, so a timer that fires after a confirmation or a re-lock is a no-op
+bool ShowRepository::releaseExpiredLocksForBookings(const std::vector<int>& bookingIds) {
+    if (bookingIds.empty()) {
+        return true;
+    }
+    Transaction transaction = beginTransaction();
+    return executeForIdChunks(transaction, kReleaseExpiredLocksForBookingsSql,
+                              {std::chrono::system_clock::now()}, bookingIds) &&
+           transaction.commit();
+}
+
+} // namespace Repositories
+} // namespace MovieBooking
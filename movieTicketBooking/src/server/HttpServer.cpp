@@ -0,0 +1,623 @@
+#include "../../include/server/HttpServer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace MovieBooking {
+namespace Server {
+
+namespace {
+
+constexpr size_t kReadChunk = 64 * 1024;
+constexpr int kMaxEvents = 256;
+// Comment sent on a quiet event stream, so proxies and clients keep it open
+constexpr std::chrono::seconds kStreamKeepAlive{15};
+
+const char* reasonPhrase(int statusCode) {
+    switch (statusCode) {
+    case 200: return "OK";
+    case 201: return "Created";
+    case 202: return "Accepted";
+    case 204: return "No Content";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 409: return "Conflict";
+    case 413: return "Payload Too Large";
+    case 422: return "Unprocessable Entity";
+    case 429: return "Too Many Requests";
+    case 500: return "Internal Server Error";
+    case 502: return "Bad Gateway";
+    case 503: return "Service Unavailable";
+    default: return statusCode < 400 ? "OK" : "Error";
+    }
+}
+
+void serialize(const HttpResponse& response, bool keepAlive, std::string& out) {
+    out += "HTTP/1.1 ";
+    out += std::to_string(response.statusCode);
+    out += ' ';
+    out += reasonPhrase(response.statusCode);
+    out += "\r\n";
+    if (!response.contentType.empty()) {
+        out += "Content-Type: ";
+        out += response.contentType;
+        out += "\r\n";
+    }
+    // A stream has no length: it ends when the connection does
+    if (!response.stream) {
+        out += "Content-Length: ";
+        out += std::to_string(response.body.size());
+        out += "\r\n";
+    }
+    for (const auto& [name, value] : response.headers) {
+        out += name;
+        out += ": ";
+        out += value;
+        out += "\r\n";
+    }
+    out += keepAlive && !response.stream ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    out += response.body;
+}
+
+HttpResponse errorResponse(int statusCode, const std::string& message) {
+    HttpResponse response(statusCode);
+    response.body = "{\"error\":\"" + message + "\"}";
+    return response;
+}
+
+int openListener(const std::string& host, uint16_t port, int backlog) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw Utils::ConfigurationException(std::string("socket() failed: ") + std::strerror(errno), "server.host");
+    }
+    const int on = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (::inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+        ::close(fd);
+        throw Utils::ConfigurationException("Invalid listen address: " + host, "server.host");
+    }
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(fd, backlog) < 0) {
+        const std::string error = std::strerror(errno);
+        ::close(fd);
+        throw Utils::ConfigurationException("Cannot listen on " + host + ":" + std::to_string(port) + ": " + error,
+                                            "server.port");
+    }
+    return fd;
+}
+
+uint16_t localPort(int fd) {
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+    return ntohs(address.sin_port);
+}
+
+} // namespace
+
+// One thread, one epoll instance, one listener, and the connections it accepted
+class HttpServer::EventLoop {
+private:
+    // A response slot per parsed request, kept in request order for pipelining
+    struct Slot {
+        std::optional<HttpResponse> response;
+        std::future<HttpResponse> pending;
+        std::shared_ptr<const HttpRequest> request;
+        bool keepAlive = true;
+    };
+
+    struct Connection {
+        int fd;
+        std::string in;
+        std::string out;
+        size_t outOffset = 0;
+        std::deque<Slot> slots;
+        bool closing = false;    // no further requests are read
+        bool peerClosed = false;
+        bool readPaused = false; // input buffer full; resume once drained
+        std::chrono::steady_clock::time_point lastActive;
+        // Set once a streaming response is sent; the connection then only
+        // carries its events, and ends after the stream closes
+        std::shared_ptr<Utils::EventStream> stream;
+        bool streamEnded = false;
+    };
+
+    Controllers::Router& router_;
+    const HttpServerConfig& config_;
+    int listenFd_;
+    int epollFd_;
+    int wakeFd_;
+    std::thread thread_;
+    std::atomic<bool> stopping_;
+
+    std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+    std::unordered_set<int> awaiting_;  // connections whose next response is a pending future
+    std::vector<Slot> orphans_;         // pending work of closed connections
+    HttpRequestView view_;              // reused by every parse on this loop
+
+    // Streaming connections with events queued, pushed by producer threads
+    std::mutex streamMutex_;
+    std::vector<int> readableStreams_;
+
+public:
+    std::atomic<uint64_t> connectionsAccepted{0};
+    std::atomic<uint64_t> requestsServed{0};
+    std::atomic<uint64_t> protocolErrors{0};
+    std::atomic<size_t> openConnections{0};
+    std::atomic<size_t> openStreams{0};
+
+    EventLoop(Controllers::Router& router, const HttpServerConfig& config, int listenFd)
+        : router_(router), config_(config), listenFd_(listenFd), epollFd_(::epoll_create1(EPOLL_CLOEXEC)),
+          wakeFd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), stopping_(false) {
+        if (epollFd_ < 0 || wakeFd_ < 0) {
+            closeFds();
+            throw Utils::ConfigurationException(std::string("epoll setup failed: ") + std::strerror(errno));
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = listenFd_;
+        ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &event);
+        event.data.fd = wakeFd_;
+        ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event);
+    }
+
+    ~EventLoop() {
+        stop();
+        closeFds();
+    }
+
+    void start() { thread_ = std::thread(&EventLoop::run, this); }
+
+    void stop() {
+        if (!thread_.joinable()) {
+            return;
+        }
+        stopping_ = true;
+        const uint64_t one = 1;
+        [[maybe_unused]] const auto written = ::write(wakeFd_, &one, sizeof(one));
+        thread_.join();
+    }
+
+private:
+    void closeFds() {
+        for (int* fd : {&listenFd_, &epollFd_, &wakeFd_}) {
+            if (*fd >= 0) {
+                ::close(*fd);
+                *fd = -1;
+            }
+        }
+    }
+
+    void run() {
+        epoll_event events[kMaxEvents];
+        auto lastSweep = std::chrono::steady_clock::now();
+        while (!stopping_.load()) {
+            const int timeout = awaiting_.empty() && orphans_.empty() ? 1000 : 1;
+            const int ready = ::epoll_wait(epollFd_, events, kMaxEvents, timeout);
+            for (int i = 0; i < ready; ++i) {
+                const int fd = events[i].data.fd;
+                if (fd == listenFd_) {
+                    acceptAll();
+                } else if (fd == wakeFd_) {
+                    uint64_t count = 0;
+                    [[maybe_unused]] const auto read = ::read(wakeFd_, &count, sizeof(count));
+                } else {
+                    onEvent(fd, events[i].events);
+                }
+            }
+            serviceReadableStreams();
+            pollPending();
+            const auto now = std::chrono::steady_clock::now();
+            if (now - lastSweep >= std::chrono::seconds(1)) {
+                sweepIdle(now);
+                lastSweep = now;
+            }
+        }
+        while (!connections_.empty()) {
+            closeConnection(*connections_.begin()->second);
+        }
+        // Handlers may still hold the requests they were given
+        for (auto& orphan : orphans_) {
+            orphan.pending.wait();
+        }
+        orphans_.clear();
+    }
+
+    // Called by EventStream under its own lock, from any thread
+    void notifyReadable(int fd) {
+        {
+            std::lock_guard<std::mutex> lock(streamMutex_);
+            readableStreams_.push_back(fd);
+        }
+        const uint64_t one = 1;
+        [[maybe_unused]] const auto written = ::write(wakeFd_, &one, sizeof(one));
+    }
+
+    void serviceReadableStreams() {
+        std::vector<int> fds;
+        {
+            std::lock_guard<std::mutex> lock(streamMutex_);
+            fds.swap(readableStreams_);
+        }
+        for (const int fd : fds) {
+            // The descriptor may have been closed, or even reused, since
+            auto it = connections_.find(fd);
+            if (it != connections_.end() && it->second->stream) {
+                service(*it->second);
+            }
+        }
+    }
+
+    void acceptAll() {
+        while (true) {
+            const int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return; // EAGAIN, or out of descriptors until a connection closes
+            }
+            const int on = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            event.data.fd = fd;
+            if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+                ::close(fd);
+                continue;
+            }
+            auto connection = std::make_unique<Connection>();
+            connection->fd = fd;
+            connection->lastActive = std::chrono::steady_clock::now();
+            connections_[fd] = std::move(connection);
+            ++connectionsAccepted;
+            ++openConnections;
+        }
+    }
+
+    void onEvent(int fd, uint32_t events) {
+        auto it = connections_.find(fd);
+        if (it == connections_.end()) {
+            return;
+        }
+        Connection& connection = *it->second;
+        if ((events & EPOLLERR) || ((events & EPOLLHUP) && !(events & EPOLLIN))) {
+            closeConnection(connection);
+            return;
+        }
+        connection.lastActive = std::chrono::steady_clock::now();
+        if ((events & (EPOLLIN | EPOLLRDHUP)) && !readAll(connection)) {
+            return;
+        }
+        service(connection);
+    }
+
+    // Read until EAGAIN or the input cap; false if the connection was closed
+    bool readAll(Connection& connection) {
+        char buffer[kReadChunk];
+        while (!connection.peerClosed) {
+            if (connection.stream) {
+                connection.in.clear(); // nothing more is parsed; read only to see the peer leave
+            }
+            if (connection.in.size() >= config_.maxRequestBytes + kReadChunk) {
+                connection.readPaused = true;
+                return true;
+            }
+            const ssize_t n = ::read(connection.fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                connection.in.append(buffer, static_cast<size_t>(n));
+            } else if (n == 0) {
+                connection.peerClosed = true;
+            } else if (errno == EINTR) {
+                continue;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            } else {
+                closeConnection(connection);
+                return false;
+            }
+        }
+        connection.readPaused = false;
+        return true;
+    }
+
+    // Parse what has arrived, dispatch it, and send every response that is
+    // ready, repeating while either side makes progress
+    void service(Connection& connection) {
+        while (true) {
+            bool progress = true;
+            while (progress) {
+                progress = parseRequests(connection);
+                progress = flushReady(connection) || progress;
+                if (connection.readPaused && connection.in.size() < config_.maxRequestBytes) {
+                    if (!readAll(connection)) {
+                        return;
+                    }
+                    progress = true;
+                }
+            }
+            if (!connection.slots.empty() && !connection.slots.front().response) {
+                awaiting_.insert(connection.fd);
+            } else {
+                awaiting_.erase(connection.fd);
+            }
+            // Events are taken only once earlier output is written, so a client
+            // that stops reading backs up into its stream, which cuts it off
+            if (connection.stream && !connection.streamEnded && connection.outOffset == connection.out.size()) {
+                connection.out.clear();
+                connection.outOffset = 0;
+                connection.streamEnded = !connection.stream->drain(connection.out);
+                if (!connection.out.empty()) {
+                    connection.lastActive = std::chrono::steady_clock::now();
+                }
+            }
+            const bool wasFull = outputFull(connection);
+            if (!writeOut(connection)) {
+                return;
+            }
+            // Still full means EAGAIN, and EPOLLOUT resumes us; otherwise take
+            // up right away the parsing and serializing the cap paused
+            if (!wasFull || outputFull(connection)) {
+                break;
+            }
+        }
+        const bool idle = connection.slots.empty() && connection.outOffset == connection.out.size();
+        if (connection.stream) {
+            if (connection.peerClosed || (connection.streamEnded && idle)) {
+                closeConnection(connection);
+            }
+        } else if (idle && (connection.closing || connection.peerClosed)) {
+            closeConnection(connection);
+        }
+    }
+
+    // Too much unsent output: neither parse nor serialize more for now
+    bool outputFull(const Connection& connection) const {
+        return connection.out.size() - connection.outOffset >= config_.maxPendingOutputBytes;
+    }
+
+    bool parseRequests(Connection& connection) {
+        size_t consumed = 0;
+        while (!connection.closing && connection.slots.size() < config_.maxPipelinedRequests &&
+               !outputFull(connection)) {
+            const std::string_view input = std::string_view(connection.in).substr(consumed);
+            size_t used = 0;
+            try {
+                used = HttpRequestView::parse(input, view_);
+            } catch (const Utils::ValidationException& e) {
+                reject(connection, errorResponse(400, e.what()));
+                break;
+            }
+            if (used == 0) {
+                if (input.size() > config_.maxRequestBytes) {
+                    reject(connection, errorResponse(413, "Request too large"));
+                }
+                break;
+            }
+            consumed += used;
+
+            Slot slot;
+            slot.keepAlive = view_.wantsKeepAlive();
+            connection.closing = !slot.keepAlive;
+            Controllers::Router::Dispatched dispatched = router_.dispatch(view_);
+            slot.response = std::move(dispatched.response);
+            slot.pending = std::move(dispatched.pending);
+            slot.request = std::move(dispatched.request);
+            connection.slots.push_back(std::move(slot));
+        }
+        connection.in.erase(0, consumed);
+        return consumed > 0;
+    }
+
+    void reject(Connection& connection, HttpResponse response) {
+        ++protocolErrors;
+        Slot slot;
+        slot.response = std::move(response);
+        slot.keepAlive = false;
+        connection.slots.push_back(std::move(slot));
+        connection.closing = true;
+        connection.in.clear();
+    }
+
+    // Serialize responses from the front while they are ready
+    bool flushReady(Connection& connection) {
+        bool flushed = false;
+        while (!connection.slots.empty() && !outputFull(connection)) {
+            Slot& slot = connection.slots.front();
+            if (!slot.response) {
+                if (slot.pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                    break;
+                }
+                slot.response = Controllers::Router::collect(slot.pending);
+            }
+            if (connection.outOffset == connection.out.size()) {
+                connection.out.clear();
+                connection.outOffset = 0;
+            }
+            serialize(*slot.response, slot.keepAlive, connection.out);
+            ++requestsServed;
+            flushed = true;
+            if (slot.response->stream) {
+                startStream(connection, slot.response->stream);
+                break;
+            }
+            connection.slots.pop_front();
+        }
+        return flushed;
+    }
+
+    // The stream's response is the connection's last: requests pipelined
+    // behind it are dropped
+    void startStream(Connection& connection, std::shared_ptr<Utils::EventStream> stream) {
+        for (auto& slot : connection.slots) {
+            if (slot.pending.valid()) {
+                orphans_.push_back(std::move(slot));
+            }
+        }
+        connection.slots.clear();
+        connection.closing = true;
+        connection.in.clear();
+        connection.stream = std::move(stream);
+        ++openStreams;
+        const int fd = connection.fd;
+        connection.stream->setReadableCallback([this, fd] { notifyReadable(fd); });
+    }
+
+    // False if the connection was closed
+    bool writeOut(Connection& connection) {
+        while (connection.outOffset < connection.out.size()) {
+            const ssize_t n = ::send(connection.fd, connection.out.data() + connection.outOffset,
+                                     connection.out.size() - connection.outOffset, MSG_NOSIGNAL);
+            if (n > 0) {
+                connection.outOffset += static_cast<size_t>(n);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return true; // EPOLLOUT (edge-triggered) resumes us
+            } else {
+                closeConnection(connection);
+                return false;
+            }
+        }
+        connection.out.clear();
+        connection.outOffset = 0;
+        return true;
+    }
+
+    void pollPending() {
+        if (!awaiting_.empty()) {
+            const std::vector<int> fds(awaiting_.begin(), awaiting_.end());
+            for (const int fd : fds) {
+                auto it = connections_.find(fd);
+                if (it == connections_.end()) {
+                    awaiting_.erase(fd);
+                    continue;
+                }
+                const Slot& front = it->second->slots.front();
+                if (front.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                    service(*it->second);
+                }
+            }
+        }
+        orphans_.erase(std::remove_if(orphans_.begin(), orphans_.end(), [](const Slot& orphan) {
+            return orphan.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }), orphans_.end());
+    }
+
+    void sweepIdle(std::chrono::steady_clock::time_point now) {
+        std::vector<Connection*> idle;
+        for (const auto& [fd, connection] : connections_) {
+            if (connection->stream) {
+                if (now - connection->lastActive > kStreamKeepAlive) {
+                    connection->lastActive = now;
+                    connection->stream->comment("keep-alive");
+                }
+            } else if (connection->slots.empty() && now - connection->lastActive > config_.idleTimeout) {
+                idle.push_back(connection.get());
+            }
+        }
+        for (Connection* connection : idle) {
+            closeConnection(*connection);
+        }
+    }
+
+    void closeConnection(Connection& connection) {
+        for (auto& slot : connection.slots) {
+            if (slot.pending.valid()) {
+                orphans_.push_back(std::move(slot));
+            }
+        }
+        if (connection.stream) {
+            // Once detached no callback can name this descriptor again;
+            // closing tells the producer to drop the stream
+            connection.stream->setReadableCallback(nullptr);
+            connection.stream->close();
+            --openStreams;
+        }
+        const int fd = connection.fd;
+        ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        awaiting_.erase(fd);
+        connections_.erase(fd);
+        --openConnections;
+    }
+};
+
+HttpServer::HttpServer(Controllers::Router& router, HttpServerConfig config)
+    : router_(router), config_(std::move(config)), boundPort_(0), running_(false) {}
+
+HttpServer::~HttpServer() {
+    stop();
+}
+
+void HttpServer::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    const size_t threads = config_.threads > 0 ? config_.threads
+                                               : std::max<size_t>(1, std::thread::hardware_concurrency());
+    uint16_t port = config_.port;
+    try {
+        for (size_t i = 0; i < threads; ++i) {
+            const int fd = openListener(config_.host, port, config_.backlog);
+            if (port == 0) {
+                port = localPort(fd); // the remaining loops share the port picked for the first
+            }
+            loops_.push_back(std::make_unique<EventLoop>(router_, config_, fd));
+        }
+    } catch (...) {
+        loops_.clear();
+        running_ = false;
+        throw;
+    }
+    boundPort_ = port;
+    for (auto& loop : loops_) {
+        loop->start();
+    }
+}
+
+void HttpServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    for (auto& loop : loops_) {
+        loop->stop();
+    }
+    loops_.clear();
+}
+
+HttpServerStats HttpServer::getStats() const {
+    HttpServerStats stats{0, 0, 0, 0, 0};
+    for (const auto& loop : loops_) {
+        stats.connectionsAccepted += loop->connectionsAccepted.load();
+        stats.requestsServed += loop->requestsServed.load();
+        stats.protocolErrors += loop->protocolErrors.load();
+        stats.openConnections += loop->openConnections.load();
+        stats.openStreams += loop->openStreams.load();
+    }
+    return stats;
+}
+
+} // namespace Server
+} // namespace MovieBooking
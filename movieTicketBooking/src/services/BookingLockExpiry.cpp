@@ -0,0 +1,99 @@
+#include "../../include/services/BookingService.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace MovieBooking {
+namespace Services {
+
+BookingService::~BookingService() {
+    stop();
+}
+
+void BookingService::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    cleanupThread_ = std::thread(&BookingService::cleanupWorker, this);
+    expiryThread_ = std::thread(&BookingService::expiryWorker, this);
+}
+
+void BookingService::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        // Both workers check running_ under cleanupMutex_, so none misses this
+        std::lock_guard<std::mutex> lock(cleanupMutex_);
+    }
+    cleanupCondition_.notify_all();
+    if (cleanupThread_.joinable()) {
+        cleanupThread_.join();
+    }
+    if (expiryThread_.joinable()) {
+        expiryThread_.join();
+    }
+}
+
+Utils::Expected<std::chrono::system_clock::time_point, Utils::BookingError>
+BookingService::attemptSeatLocking(int showId, const std::vector<int>& seatIds, int bookingId) {
+    if (seatIds.empty()) {
+        return Utils::makeUnexpected(Utils::BookingError::seats(Utils::BookingErrorCode::NO_SEATS, showId, {}));
+    }
+    auto lock = lockShow(showId);
+    const int minutes = defaultLockDurationMinutes_;
+    if (!showRepository_->lockShowSeats(showId, seatIds, bookingId, minutes)) {
+        return Utils::makeUnexpected(
+            Utils::BookingError::seats(Utils::BookingErrorCode::SEATS_UNAVAILABLE, showId, seatIds));
+    }
+    // Taken after the lock was written, so never earlier than its locked_until
+    const auto lockedUntil = std::chrono::system_clock::now() + std::chrono::minutes(minutes);
+    scheduleLockExpiry(showId, bookingId, lockedUntil);
+    return lockedUntil;
+}
+
+void BookingService::scheduleLockExpiry(int showId, int bookingId,
+                                        std::chrono::system_clock::time_point lockedUntil) {
+    lockExpiryWheel_.schedule(lockedUntil, SeatLockExpiry{showId, bookingId});
+}
+
+void BookingService::expiryWorker() {
+    std::unique_lock<std::mutex> lock(cleanupMutex_);
+    while (running_.load()) {
+        cleanupCondition_.wait_for(lock, lockExpiryWheel_.getTick(), [this] { return !running_.load(); });
+        if (!running_.load()) {
+            break;
+        }
+        lock.unlock();
+        const std::vector<SeatLockExpiry> expired = lockExpiryWheel_.advance();
+        const size_t batchSize = std::max<size_t>(1, expiryBatchSize_);
+        for (size_t begin = 0; begin < expired.size(); begin += batchSize) {
+            const size_t end = std::min(expired.size(), begin + batchSize);
+            releaseExpiredLockBatch(std::vector<SeatLockExpiry>(expired.begin() + static_cast<std::ptrdiff_t>(begin),
+                                                                expired.begin() + static_cast<std::ptrdiff_t>(end)));
+        }
+        lock.lock();
+    }
+}
+
+// A batch that fails is left to the periodic sweep in cleanupWorker
+void BookingService::releaseExpiredLockBatch(const std::vector<SeatLockExpiry>& expired) {
+    std::vector<int> bookingIds;
+    bookingIds.reserve(expired.size());
+    for (const SeatLockExpiry& expiry : expired) {
+        bookingIds.push_back(expiry.bookingId);
+    }
+    std::sort(bookingIds.begin(), bookingIds.end());
+    bookingIds.erase(std::unique(bookingIds.begin(), bookingIds.end()), bookingIds.end());
+    try {
+        if (!showRepository_->releaseExpiredLocksForBookings(bookingIds)) {
+            logError("releaseExpiredLockBatch",
+                     "releasing expired seat locks of " + std::to_string(bookingIds.size()) + " bookings failed");
+        }
+    } catch (const std::exception& e) {
+        logError("releaseExpiredLockBatch", e.what());
+    }
+}
+
+} // namespace Services
+} // namespace MovieBooking
@@ -0,0 +1,131 @@
+#include "../../include/services/SeatChangeFeed.h"
+#include "../../include/utils/JsonWriter.h"
+
+#include <algorithm>
+
+namespace MovieBooking {
+namespace Services {
+
+SeatChangeFeed::SeatChangeFeed(size_t maxPendingBytes)
+    : maxPendingBytes_(maxPendingBytes),
+      metricsCollector_(Utils::MetricsRegistry::global(),
+                        [this](Utils::MetricsWriter& out) { collectMetrics(out); }),
+      subscription_(Models::Show::seatEvents().subscribe(
+          [this](const Models::SeatDelta& delta) { onDelta(delta); })) {}
+
+SeatChangeFeed::~SeatChangeFeed() {
+    // No delta is in flight once the subscription is gone, so the lock order
+    // here (map, then watchers) cannot meet onDelta's (watchers, then map)
+    subscription_.reset();
+    metricsCollector_.reset();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [showId, watchers] : byShow_) {
+        std::lock_guard<std::mutex> watchersLock(watchers->mutex);
+        for (auto& stream : watchers->streams) {
+            stream->close();
+        }
+    }
+}
+
+std::shared_ptr<Utils::EventStream> SeatChangeFeed::watch(const Models::Show& show, size_t seatsPerRow) {
+    auto stream = std::make_shared<Utils::EventStream>(maxPendingBytes_);
+    for (;;) {
+        std::shared_ptr<Watchers> watchers;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& entry = byShow_[show.getId()];
+            if (!entry) {
+                entry = std::make_shared<Watchers>();
+            }
+            watchers = entry;
+        }
+
+        // The snapshot is queued under the watchers lock, so no delta of this
+        // show can slip between it and the stream joining
+        std::lock_guard<std::mutex> lock(watchers->mutex);
+        if (watchers->retired) {
+            continue;
+        }
+        // Version first: the layout may then be newer, never older, and
+        // re-applying a delta it already contains is harmless
+        const uint64_t version = show.getSeatVersion();
+        std::string snapshot;
+        Utils::JsonWriter writer(snapshot);
+        writer.beginObject();
+        writer.field("version", version);
+        writer.key("layout");
+        show.writeCompactLayout(writer, seatsPerRow);
+        writer.endObject();
+        stream->send("snapshot", snapshot, std::to_string(version));
+        watchers->streams.push_back(stream);
+        return stream;
+    }
+}
+
+void SeatChangeFeed::onDelta(const Models::SeatDelta& delta) {
+    std::shared_ptr<Watchers> watchers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = byShow_.find(delta.showId);
+        if (it == byShow_.end()) {
+            return;
+        }
+        watchers = it->second;
+    }
+
+    std::string data;
+    Utils::JsonWriter writer(data);
+    delta.writeJson(writer);
+    const std::string id = std::to_string(delta.version);
+
+    std::lock_guard<std::mutex> lock(watchers->mutex);
+    auto& streams = watchers->streams;
+    const size_t before = streams.size();
+    streams.erase(std::remove_if(streams.begin(), streams.end(),
+                                 [&](const std::shared_ptr<Utils::EventStream>& stream) {
+                                     return !stream->send("seats", data, id);
+                                 }),
+                  streams.end());
+    eventsSent_.fetch_add(streams.size(), std::memory_order_relaxed);
+    watchersDropped_.fetch_add(before - streams.size(), std::memory_order_relaxed);
+
+    if (streams.empty()) {
+        watchers->retired = true;
+        std::lock_guard<std::mutex> mapLock(mutex_);
+        auto it = byShow_.find(delta.showId);
+        if (it != byShow_.end() && it->second == watchers) {
+            byShow_.erase(it);
+        }
+    }
+}
+
+SeatChangeFeed::Stats SeatChangeFeed::getStats() const {
+    std::vector<std::shared_ptr<Watchers>> all;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        all.reserve(byShow_.size());
+        for (const auto& [showId, watchers] : byShow_) {
+            all.push_back(watchers);
+        }
+    }
+    Stats stats{0, all.size(), eventsSent_.load(std::memory_order_relaxed),
+                watchersDropped_.load(std::memory_order_relaxed)};
+    for (const auto& watchers : all) {
+        std::lock_guard<std::mutex> lock(watchers->mutex);
+        stats.watchers += watchers->streams.size();
+    }
+    return stats;
+}
+
+void SeatChangeFeed::collectMetrics(Utils::MetricsWriter& out) const {
+    const Stats stats = getStats();
+    out.gauge("seat_feed_watchers", "Clients streaming seat changes", {}, static_cast<double>(stats.watchers));
+    out.gauge("seat_feed_watched_shows", "Shows with at least one watcher", {},
+              static_cast<double>(stats.watchedShows));
+    out.counter("seat_feed_events_sent_total", "Seat deltas queued to watchers", {}, stats.eventsSent);
+    out.counter("seat_feed_watchers_dropped_total", "Watchers disconnected or cut off for falling behind", {},
+                stats.watchersDropped);
+}
+
+} // namespace Services
+} // namespace MovieBooking
@@ -0,0 +1,93 @@
+#include "../../include/services/ShowService.h"
+
+#include <exception>
+#include <unordered_set>
+
+namespace MovieBooking {
+namespace Services {
+
+namespace {
+
+// Shows that occupy their screen; cancelled and completed ones free it
+bool holdsScreen(Models::ShowStatus status) {
+    return status == Models::ShowStatus::SCHEDULED || status == Models::ShowStatus::IN_PROGRESS;
+}
+
+} // namespace
+
+bool ShowService::hasTimeConflict(const ShowCreationRequest& request, int excludeShowId) {
+    if (isScheduleIndexLoaded()) {
+        return scheduleIndex_.hasConflict(slotOf(request), excludeShowId);
+    }
+    return showRepository_->hasTimeConflict(request.screenId, request.startTime, request.endTime, excludeShowId);
+}
+
+std::vector<std::unique_ptr<Models::Show>> ShowService::findConflictingShows(const ShowCreationRequest& request) {
+    if (!isScheduleIndexLoaded()) {
+        return showRepository_->findConflictingShows(request.screenId, request.startTime, request.endTime);
+    }
+    std::vector<std::unique_ptr<Models::Show>> shows;
+    for (int showId : scheduleIndex_.findConflicts(slotOf(request))) {
+        if (auto show = showRepository_->findById(showId)) {
+            shows.push_back(std::move(show));
+        }
+    }
+    return shows;
+}
+
+std::vector<ScheduleConflict> ShowService::validateShowBatch(const std::vector<ShowCreationRequest>& requests) {
+    std::vector<ScheduleSlot> slots;
+    slots.reserve(requests.size());
+    for (const auto& request : requests) {
+        slots.push_back(slotOf(request));
+    }
+    if (isScheduleIndexLoaded()) {
+        return scheduleIndex_.validateBatch(slots);
+    }
+
+    // One read per distinct screen into a throwaway index
+    ShowScheduleIndex existing;
+    std::unordered_set<int> loadedScreens;
+    for (const auto& slot : slots) {
+        if (!loadedScreens.insert(slot.screenId).second) {
+            continue;
+        }
+        for (const auto& show : showRepository_->findByScreenId(slot.screenId)) {
+            if (holdsScreen(show->getStatus())) {
+                existing.add(show->getId(), ScheduleSlot{show->getScreenId(), show->getStartTime(), show->getEndTime()});
+            }
+        }
+    }
+    return existing.validateBatch(slots);
+}
+
+// Meant for startup: a show written between the repository read and the end
+// of the rebuild must be indexed again by its write path
+bool ShowService::loadScheduleIndex() {
+    scheduleIndexLoaded_.store(false, std::memory_order_release);
+    scheduleIndex_.clear();
+    try {
+        for (Models::ShowStatus status : {Models::ShowStatus::SCHEDULED, Models::ShowStatus::IN_PROGRESS}) {
+            for (const auto& show : showRepository_->findByStatus(status)) {
+                indexShow(*show);
+            }
+        }
+    } catch (const std::exception& e) {
+        logError("loadScheduleIndex", e.what());
+        scheduleIndex_.clear();
+        return false;
+    }
+    scheduleIndexLoaded_.store(true, std::memory_order_release);
+    return true;
+}
+
+void ShowService::indexShow(const Models::Show& show) {
+    if (holdsScreen(show.getStatus())) {
+        scheduleIndex_.add(show.getId(), ScheduleSlot{show.getScreenId(), show.getStartTime(), show.getEndTime()});
+    } else {
+        scheduleIndex_.remove(show.getId());
+    }
+}
+
+} // namespace Services
+} // namespace MovieBooking
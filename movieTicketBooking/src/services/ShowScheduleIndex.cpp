@@ -0,0 +1,224 @@
+#include "../../include/services/ShowScheduleIndex.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace MovieBooking {
+namespace Services {
+
+void ShowScheduleIndex::add(int showId, const ScheduleSlot& slot) {
+    std::lock_guard<std::mutex> lock(locationsMutex_);
+    auto it = locations_.find(showId);
+    if (it != locations_.end()) {
+        Screen& previous = screenFor(it->second.screenId);
+        std::unique_lock<std::shared_mutex> screenLock(previous.mutex);
+        eraseEntry(previous, showId, it->second.startTime);
+    }
+    Screen& screen = screenFor(slot.screenId);
+    std::unique_lock<std::shared_mutex> screenLock(screen.mutex);
+    insertEntry(screen, showId, slot);
+    locations_[showId] = Location{slot.screenId, slot.startTime};
+}
+
+bool ShowScheduleIndex::tryAdd(int showId, const ScheduleSlot& slot) {
+    std::lock_guard<std::mutex> lock(locationsMutex_);
+    Screen& screen = screenFor(slot.screenId);
+    {
+        std::unique_lock<std::shared_mutex> screenLock(screen.mutex);
+        bool conflict = false;
+        forEachOverlap(screen, slot.startTime, slot.endTime, showId, [&conflict](int) {
+            conflict = true;
+            return false;
+        });
+        if (conflict) {
+            return false;
+        }
+    }
+
+    // Moving an indexed show: drop its old slot before taking the new one
+    auto it = locations_.find(showId);
+    if (it != locations_.end()) {
+        Screen& previous = screenFor(it->second.screenId);
+        std::unique_lock<std::shared_mutex> screenLock(previous.mutex);
+        eraseEntry(previous, showId, it->second.startTime);
+    }
+    std::unique_lock<std::shared_mutex> screenLock(screen.mutex);
+    insertEntry(screen, showId, slot);
+    locations_[showId] = Location{slot.screenId, slot.startTime};
+    return true;
+}
+
+bool ShowScheduleIndex::remove(int showId) {
+    std::lock_guard<std::mutex> lock(locationsMutex_);
+    auto it = locations_.find(showId);
+    if (it == locations_.end()) {
+        return false;
+    }
+    Screen& screen = screenFor(it->second.screenId);
+    std::unique_lock<std::shared_mutex> screenLock(screen.mutex);
+    eraseEntry(screen, showId, it->second.startTime);
+    locations_.erase(it);
+    return true;
+}
+
+// Screens stay allocated: readers may hold a Screen* without the table lock
+void ShowScheduleIndex::clear() {
+    std::lock_guard<std::mutex> lock(locationsMutex_);
+    std::shared_lock<std::shared_mutex> tableLock(screensMutex_);
+    for (auto& [screenId, screen] : screens_) {
+        std::unique_lock<std::shared_mutex> screenLock(screen->mutex);
+        screen->byStart.clear();
+        screen->longestDuration = TimePoint::duration::zero();
+    }
+    locations_.clear();
+}
+
+bool ShowScheduleIndex::hasConflict(const ScheduleSlot& slot, int excludeShowId) const {
+    const Screen* screen = findScreen(slot.screenId);
+    if (!screen) {
+        return false;
+    }
+    std::shared_lock<std::shared_mutex> lock(screen->mutex);
+    bool conflict = false;
+    forEachOverlap(*screen, slot.startTime, slot.endTime, excludeShowId, [&conflict](int) {
+        conflict = true;
+        return false;
+    });
+    return conflict;
+}
+
+std::vector<int> ShowScheduleIndex::findConflicts(const ScheduleSlot& slot, int excludeShowId) const {
+    std::vector<int> showIds;
+    const Screen* screen = findScreen(slot.screenId);
+    if (!screen) {
+        return showIds;
+    }
+    std::shared_lock<std::shared_mutex> lock(screen->mutex);
+    forEachOverlap(*screen, slot.startTime, slot.endTime, excludeShowId, [&showIds](int showId) {
+        showIds.push_back(showId);
+        return true;
+    });
+    return showIds;
+}
+
+std::vector<ScheduleConflict> ShowScheduleIndex::validateBatch(const std::vector<ScheduleSlot>& slots) const {
+    std::vector<size_t> order(slots.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::sort(order.begin(), order.end(), [&slots](size_t a, size_t b) {
+        if (slots[a].screenId != slots[b].screenId) {
+            return slots[a].screenId < slots[b].screenId;
+        }
+        return slots[a].startTime < slots[b].startTime;
+    });
+
+    std::vector<ScheduleConflict> conflicts;
+    for (size_t groupStart = 0; groupStart < order.size();) {
+        const int screenId = slots[order[groupStart]].screenId;
+        size_t groupEnd = groupStart;
+        while (groupEnd < order.size() && slots[order[groupEnd]].screenId == screenId) {
+            ++groupEnd;
+        }
+
+        const Screen* screen = findScreen(screenId);
+        std::shared_lock<std::shared_mutex> lock;
+        if (screen) {
+            lock = std::shared_lock<std::shared_mutex>(screen->mutex);
+        }
+
+        // Accepted slots of this screen do not overlap each other and arrive in
+        // start order, so the one ending last is the only one a new slot can hit
+        size_t latestAccepted = ScheduleConflict::kNoSlot;
+        for (size_t i = groupStart; i < groupEnd; ++i) {
+            const size_t index = order[i];
+            const ScheduleSlot& slot = slots[index];
+            ScheduleConflict conflict{index};
+            if (screen) {
+                forEachOverlap(*screen, slot.startTime, slot.endTime, -1, [&conflict](int showId) {
+                    conflict.showId = showId;
+                    return false;
+                });
+            }
+            if (conflict.showId < 0 && latestAccepted != ScheduleConflict::kNoSlot &&
+                slots[latestAccepted].endTime > slot.startTime && slot.endTime > slot.startTime) {
+                conflict.otherSlot = latestAccepted;
+            }
+
+            if (conflict.showId >= 0 || conflict.otherSlot != ScheduleConflict::kNoSlot) {
+                conflicts.push_back(conflict);
+            } else if (latestAccepted == ScheduleConflict::kNoSlot ||
+                       slot.endTime > slots[latestAccepted].endTime) {
+                latestAccepted = index;
+            }
+        }
+        groupStart = groupEnd;
+    }
+
+    std::sort(conflicts.begin(), conflicts.end(),
+              [](const ScheduleConflict& a, const ScheduleConflict& b) { return a.slot < b.slot; });
+    return conflicts;
+}
+
+size_t ShowScheduleIndex::size() const {
+    std::lock_guard<std::mutex> lock(locationsMutex_);
+    return locations_.size();
+}
+
+size_t ShowScheduleIndex::getScreenCount() const {
+    std::shared_lock<std::shared_mutex> lock(screensMutex_);
+    return screens_.size();
+}
+
+// Helpers
+
+ShowScheduleIndex::Screen* ShowScheduleIndex::findScreen(int screenId) const {
+    std::shared_lock<std::shared_mutex> lock(screensMutex_);
+    auto it = screens_.find(screenId);
+    return it != screens_.end() ? it->second.get() : nullptr;
+}
+
+ShowScheduleIndex::Screen& ShowScheduleIndex::screenFor(int screenId) {
+    if (Screen* screen = findScreen(screenId)) {
+        return *screen;
+    }
+    std::unique_lock<std::shared_mutex> lock(screensMutex_);
+    auto& screen = screens_[screenId];
+    if (!screen) {
+        screen = std::make_unique<Screen>();
+    }
+    return *screen;
+}
+
+template<typename Fn>
+void ShowScheduleIndex::forEachOverlap(const Screen& screen, TimePoint start, TimePoint end, int excludeShowId,
+                                       Fn&& fn) {
+    if (end <= start || screen.byStart.empty()) {
+        return;
+    }
+    // Anything starting at or before start - longestDuration has ended by start
+    auto it = start > TimePoint::min() + screen.longestDuration
+                  ? screen.byStart.upper_bound(start - screen.longestDuration)
+                  : screen.byStart.begin();
+    for (; it != screen.byStart.end() && it->first < end; ++it) {
+        if (it->second.endTime > start && it->second.showId != excludeShowId && !fn(it->second.showId)) {
+            return;
+        }
+    }
+}
+
+void ShowScheduleIndex::eraseEntry(Screen& screen, int showId, TimePoint start) {
+    auto [first, last] = screen.byStart.equal_range(start);
+    for (auto it = first; it != last; ++it) {
+        if (it->second.showId == showId) {
+            screen.byStart.erase(it);
+            return;
+        }
+    }
+}
+
+void ShowScheduleIndex::insertEntry(Screen& screen, int showId, const ScheduleSlot& slot) {
+    screen.byStart.emplace(slot.startTime, Entry{showId, slot.endTime});
+    screen.longestDuration = std::max(screen.longestDuration, slot.endTime - slot.startTime);
+}
+
+} // namespace Services
+} // namespace MovieBooking
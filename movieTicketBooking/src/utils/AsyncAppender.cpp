@@ -0,0 +1,128 @@
+#include "../../include/utils/Logger.h"
+
+namespace MovieBooking {
+namespace Utils {
+
+namespace {
+// How long the writer spins on an empty ring before it sleeps
+constexpr int kWriterSpinRounds = 64;
+// Upper bound on a sleep, in case a wake-up races with going to sleep
+constexpr std::chrono::milliseconds kWriterMaxSleep{50};
+}
+
+AsyncAppender::AsyncAppender(std::unique_ptr<ILogAppender> appender, size_t maxQueueSize,
+                             LogOverflowPolicy overflowPolicy)
+    : underlyingAppender_(std::move(appender)), ring_(maxQueueSize), overflowPolicy_(overflowPolicy),
+      running_(false), writerSleeping_(false), enqueued_(0), written_(0), dropped_(0) {
+    start();
+}
+
+AsyncAppender::~AsyncAppender() {
+    stop();
+}
+
+void AsyncAppender::append(const LogEntry& entry) {
+    const auto fill = [&entry](LogEntry& slot) { slot = entry; };
+    while (!ring_.tryPush(fill)) {
+        if (overflowPolicy_.load(std::memory_order_relaxed) == LogOverflowPolicy::DROP ||
+            !running_.load(std::memory_order_relaxed)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        wakeWriter();
+        std::this_thread::yield();
+    }
+    // seq_cst pairs with the writer's sleep announcement (store flag, load count)
+    enqueued_.fetch_add(1, std::memory_order_seq_cst);
+    if (writerSleeping_.load(std::memory_order_seq_cst)) {
+        wakeWriter();
+    }
+}
+
+void AsyncAppender::flush() {
+    const uint64_t target = enqueued_.load(std::memory_order_acquire);
+    while (running_.load() && written_.load(std::memory_order_acquire) < target) {
+        wakeWriter();
+        std::this_thread::yield();
+    }
+    if (underlyingAppender_) {
+        underlyingAppender_->flush();
+    }
+}
+
+bool AsyncAppender::isReady() const {
+    return running_.load() && underlyingAppender_ && underlyingAppender_->isReady();
+}
+
+void AsyncAppender::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    workerThread_ = std::thread(&AsyncAppender::workerFunction, this);
+}
+
+void AsyncAppender::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    wakeWriter();
+    if (workerThread_.joinable()) {
+        workerThread_.join();
+    }
+    // Producers that raced with stop() may still have published entries
+    drain();
+    if (underlyingAppender_) {
+        underlyingAppender_->flush();
+    }
+}
+
+void AsyncAppender::workerFunction() {
+    int idleRounds = 0;
+    while (running_.load(std::memory_order_relaxed)) {
+        if (drain() > 0) {
+            idleRounds = 0;
+            continue;
+        }
+        if (++idleRounds < kWriterSpinRounds) {
+            std::this_thread::yield();
+            continue;
+        }
+        // Announce the sleep, then re-check so a concurrent append cannot be missed
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        writerSleeping_.store(true, std::memory_order_seq_cst);
+        if (enqueued_.load(std::memory_order_seq_cst) == written_.load(std::memory_order_relaxed) &&
+            running_.load()) {
+            wakeCondition_.wait_for(lock, kWriterMaxSleep);
+        }
+        writerSleeping_.store(false, std::memory_order_relaxed);
+        idleRounds = 0;
+    }
+}
+
+size_t AsyncAppender::drain() {
+    size_t count = 0;
+    while (ring_.tryConsume([this](LogEntry& entry) {
+        if (!underlyingAppender_ || !underlyingAppender_->acceptsDeferred()) {
+            entry.materialize();
+        }
+        if (underlyingAppender_) {
+            underlyingAppender_->append(entry);
+        }
+    })) {
+        ++count;
+    }
+    if (count > 0) {
+        written_.fetch_add(count, std::memory_order_release);
+    }
+    return count;
+}
+
+void AsyncAppender::wakeWriter() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+    }
+    wakeCondition_.notify_one();
+}
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -0,0 +1,112 @@
+#include "../../include/utils/BookingError.h"
+#include "../../include/utils/Exceptions.h"
+#include "../../include/utils/JsonWriter.h"
+
+namespace MovieBooking {
+namespace Utils {
+
+namespace {
+
+std::string joinSeatIds(const std::vector<int>& seatIds) {
+    std::string text;
+    for (size_t i = 0; i < seatIds.size(); ++i) {
+        if (i > 0) {
+            text += ", ";
+        }
+        text += std::to_string(seatIds[i]);
+    }
+    return text;
+}
+
+} // namespace
+
+const char* BookingError::getErrorCode() const {
+    switch (code) {
+    case BookingErrorCode::SEATS_UNAVAILABLE: return "SEATS_UNAVAILABLE";
+    case BookingErrorCode::UNKNOWN_SEATS: return "UNKNOWN_SEATS";
+    case BookingErrorCode::NO_SEATS: return "NO_SEATS";
+    case BookingErrorCode::INSUFFICIENT_SEATS: return "INSUFFICIENT_SEATS";
+    case BookingErrorCode::NOT_LOCK_HOLDER: return "NOT_LOCK_HOLDER";
+    case BookingErrorCode::LOCK_TIMEOUT: return "LOCK_TIMEOUT";
+    case BookingErrorCode::BOOKING_EXPIRED: return "BOOKING_EXPIRED";
+    }
+    return "BOOKING_ERROR";
+}
+
+int BookingError::getHttpStatusCode() const {
+    switch (code) {
+    case BookingErrorCode::UNKNOWN_SEATS:
+    case BookingErrorCode::NO_SEATS:
+        return 400;
+    case BookingErrorCode::INSUFFICIENT_SEATS:
+    case BookingErrorCode::BOOKING_EXPIRED:
+        return 422;
+    case BookingErrorCode::SEATS_UNAVAILABLE:
+    case BookingErrorCode::NOT_LOCK_HOLDER:
+    case BookingErrorCode::LOCK_TIMEOUT:
+        return 409;
+    }
+    return 409;
+}
+
+std::string BookingError::getMessage() const {
+    const std::string show = " for show " + std::to_string(showId);
+    switch (code) {
+    case BookingErrorCode::SEATS_UNAVAILABLE:
+        return "Seats already taken" + show + ": " + joinSeatIds(seatIds);
+    case BookingErrorCode::UNKNOWN_SEATS:
+        return "Unknown seats" + show + ": " + joinSeatIds(seatIds);
+    case BookingErrorCode::NO_SEATS:
+        return "No seats selected" + show;
+    case BookingErrorCode::INSUFFICIENT_SEATS:
+        return "Insufficient seats available. Requested: " + std::to_string(requested) +
+               ", Available: " + std::to_string(available);
+    case BookingErrorCode::NOT_LOCK_HOLDER:
+        return "Seats are not locked by booking " + std::to_string(bookingId) + ": " + joinSeatIds(seatIds);
+    case BookingErrorCode::LOCK_TIMEOUT:
+        return "Timed out waiting for the seat lock" + show;
+    case BookingErrorCode::BOOKING_EXPIRED:
+        return "Booking " + std::to_string(bookingId) + " has expired";
+    }
+    return "Booking failed" + show;
+}
+
+void BookingError::writeJson(JsonWriter& writer) const {
+    writer.beginObject();
+    writer.field("error", getMessage());
+    writer.field("code", getErrorCode());
+    if (!seatIds.empty()) {
+        writer.key("seatIds");
+        writer.beginArray();
+        for (int seatId : seatIds) {
+            writer.value(seatId);
+        }
+        writer.endArray();
+    }
+    writer.endObject();
+}
+
+void BookingError::raise() const {
+    switch (code) {
+    case BookingErrorCode::SEATS_UNAVAILABLE:
+        if (!seatIds.empty()) {
+            throw SeatAlreadyBookedException(seatIds.front(), showId);
+        }
+        break;
+    case BookingErrorCode::UNKNOWN_SEATS:
+    case BookingErrorCode::NO_SEATS:
+        throw ValidationException(getMessage(), "seatIds");
+    case BookingErrorCode::INSUFFICIENT_SEATS:
+        throw InsufficientSeatsException(requested, available);
+    case BookingErrorCode::LOCK_TIMEOUT:
+        throw ConcurrencyException(getMessage());
+    case BookingErrorCode::BOOKING_EXPIRED:
+        throw BookingExpiredException(bookingId);
+    case BookingErrorCode::NOT_LOCK_HOLDER:
+        break;
+    }
+    throw ConflictException(getMessage(), getErrorCode());
+}
+
+} // namespace Utils
+} // namespace MovieBooking
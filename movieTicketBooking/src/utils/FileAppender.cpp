@@ -0,0 +1,201 @@
+#include "../../include/utils/Logger.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <climits>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace MovieBooking {
+namespace Utils {
+
+namespace {
+#ifdef IOV_MAX
+constexpr size_t kMaxIov = IOV_MAX;
+#else
+constexpr size_t kMaxIov = 1024;
+#endif
+}
+
+FileAppender::FileAppender(const std::string& filename, std::unique_ptr<ILogFormatter> formatter,
+                           size_t maxFileSize, int maxBackupFiles, size_t blockSize,
+                           std::chrono::milliseconds flushInterval)
+    : filename_(filename),
+      formatter_(formatter ? std::move(formatter) : std::make_unique<DefaultLogFormatter>()),
+      fd_(-1), fileSize_(0), maxFileSize_(maxFileSize), maxBackupFiles_(maxBackupFiles),
+      blockSize_(blockSize > 0 ? blockSize : 1), flushInterval_(flushInterval),
+      flushRequested_(0), flushCompleted_(0), running_(true),
+      bytesWritten_(0), writeCalls_(0), rotations_(0) {
+    openFile();
+    writerThread_ = std::thread(&FileAppender::writerFunction, this);
+}
+
+FileAppender::~FileAppender() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    writerCondition_.notify_one();
+    if (writerThread_.joinable()) {
+        writerThread_.join();
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void FileAppender::append(const LogEntry& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (activeBlock_.empty()) {
+        formatter_->beginBlock(activeBlock_);
+    }
+    formatter_->formatTo(entry, activeBlock_);
+    if (activeBlock_.size() >= blockSize_) {
+        fullBlocks_.push_back(std::move(activeBlock_));
+        if (!freeBlocks_.empty()) {
+            activeBlock_ = std::move(freeBlocks_.back());
+            freeBlocks_.pop_back();
+        } else {
+            activeBlock_ = std::string();
+            activeBlock_.reserve(blockSize_ + blockSize_ / 4);
+        }
+        writerCondition_.notify_one();
+    }
+}
+
+void FileAppender::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const uint64_t ticket = ++flushRequested_;
+    writerCondition_.notify_one();
+    flushedCondition_.wait(lock, [this, ticket] { return flushCompleted_ >= ticket || !running_; });
+}
+
+bool FileAppender::isReady() const {
+    return fd_.load(std::memory_order_relaxed) >= 0;
+}
+
+void FileAppender::writerFunction() {
+    std::vector<std::string> blocks;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        writerCondition_.wait_for(lock, flushInterval_, [this] {
+            return !running_ || !fullBlocks_.empty() || flushRequested_ > flushCompleted_;
+        });
+        // Take the partial block too, so one writev() covers everything pending
+        blocks.swap(fullBlocks_);
+        if (!activeBlock_.empty()) {
+            blocks.push_back(std::move(activeBlock_));
+            activeBlock_.clear();
+        }
+        const uint64_t flushTicket = flushRequested_;
+        const bool stopping = !running_;
+        lock.unlock();
+
+        writeBlocks(blocks);
+
+        lock.lock();
+        for (auto& block : blocks) {
+            block.clear();
+            if (freeBlocks_.size() < 4) {
+                freeBlocks_.push_back(std::move(block));
+            }
+        }
+        blocks.clear();
+        if (flushTicket > flushCompleted_) {
+            flushCompleted_ = flushTicket;
+            flushedCondition_.notify_all();
+        }
+        if (stopping && fullBlocks_.empty() && activeBlock_.empty()) {
+            flushedCondition_.notify_all();
+            return;
+        }
+    }
+}
+
+void FileAppender::writeBlocks(std::vector<std::string>& blocks) {
+    if (blocks.empty() || fd_ < 0) {
+        return;
+    }
+    std::vector<iovec> iov;
+    iov.reserve(std::min(blocks.size(), kMaxIov));
+    size_t index = 0;
+    while (index < blocks.size()) {
+        iov.clear();
+        for (size_t i = index; i < blocks.size() && iov.size() < kMaxIov; ++i) {
+            iov.push_back({blocks[i].data(), blocks[i].size()});
+        }
+        index += iov.size();
+
+        size_t first = 0;
+        while (first < iov.size()) {
+            const ssize_t written = ::writev(fd_, iov.data() + first, static_cast<int>(iov.size() - first));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return; // disk error: drop the batch rather than block callers
+            }
+            writeCalls_.fetch_add(1, std::memory_order_relaxed);
+            bytesWritten_.fetch_add(static_cast<uint64_t>(written), std::memory_order_relaxed);
+            fileSize_ += static_cast<size_t>(written);
+            // Skip fully written vectors and trim a partially written one
+            size_t remaining = static_cast<size_t>(written);
+            while (first < iov.size() && remaining >= iov[first].iov_len) {
+                remaining -= iov[first].iov_len;
+                ++first;
+            }
+            if (first < iov.size()) {
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + remaining;
+                iov[first].iov_len -= remaining;
+            }
+        }
+    }
+    // Rotate only between blocks, so a block never straddles two files
+    if (fileSize_ >= maxFileSize_.load(std::memory_order_relaxed)) {
+        rotateFile();
+    }
+}
+
+void FileAppender::openFile() {
+    fd_ = ::open(filename_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        return;
+    }
+    struct stat info {};
+    fileSize_ = ::fstat(fd_, &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+    const std::string_view header = formatter_->fileHeader();
+    if (fileSize_ == 0 && !header.empty()) {
+        if (::write(fd_, header.data(), header.size()) == static_cast<ssize_t>(header.size())) {
+            fileSize_ = header.size();
+        }
+    }
+}
+
+void FileAppender::rotateFile() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    const int backups = maxBackupFiles_.load(std::memory_order_relaxed);
+    if (backups > 0) {
+        std::remove(generateBackupFilename(backups).c_str());
+        for (int i = backups - 1; i >= 1; --i) {
+            std::rename(generateBackupFilename(i).c_str(), generateBackupFilename(i + 1).c_str());
+        }
+        std::rename(filename_.c_str(), generateBackupFilename(1).c_str());
+    } else {
+        std::remove(filename_.c_str());
+    }
+    rotations_.fetch_add(1, std::memory_order_relaxed);
+    openFile();
+}
+
+std::string FileAppender::generateBackupFilename(int backupNumber) const {
+    return filename_ + "." + std::to_string(backupNumber);
+}
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -0,0 +1,263 @@
+#include "../../include/utils/Metrics.h"
+#include "../../include/utils/Exceptions.h"
+
+#include <charconv>
+#include <cmath>
+
+namespace MovieBooking {
+namespace Utils {
+
+namespace {
+
+constexpr double kQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+void appendEscaped(std::string& out, const std::string& text, bool quoted) {
+    for (char c : text) {
+        if (c == '\\') {
+            out += "\\\\";
+        } else if (c == '\n') {
+            out += "\\n";
+        } else if (c == '"' && quoted) {
+            out += "\\\"";
+        } else {
+            out += c;
+        }
+    }
+}
+
+void appendNumber(std::string& out, double value) {
+    if (std::isnan(value)) {
+        out += "NaN";
+        return;
+    }
+    if (std::isinf(value)) {
+        out += value > 0 ? "+Inf" : "-Inf";
+        return;
+    }
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void appendNumber(std::string& out, uint64_t value) {
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+// name{label="value",...}; `extra` is appended last, e.g. a summary quantile
+void appendSeries(std::string& out, const std::string& name, const char* suffix, const MetricLabels& labels,
+                  const std::pair<const char*, std::string>* extra = nullptr) {
+    out += name;
+    out += suffix;
+    if (labels.empty() && !extra) {
+        return;
+    }
+    out += '{';
+    bool first = true;
+    auto appendLabel = [&](const std::string& key, const std::string& value) {
+        if (!first) {
+            out += ',';
+        }
+        first = false;
+        out += key;
+        out += "=\"";
+        appendEscaped(out, value, true);
+        out += '"';
+    };
+    for (const auto& [key, value] : labels) {
+        appendLabel(key, value);
+    }
+    if (extra) {
+        appendLabel(extra->first, extra->second);
+    }
+    out += '}';
+}
+
+std::string metricKey(const std::string& name, const MetricLabels& labels) {
+    std::string key = name;
+    for (const auto& [label, value] : labels) {
+        key += '\0';
+        key += label;
+        key += '\0';
+        key += value;
+    }
+    return key;
+}
+
+} // namespace
+
+// MetricsWriter
+
+void MetricsWriter::counter(const std::string& name, const std::string& help, const MetricLabels& labels,
+                            uint64_t value) {
+    std::string& out = samplesFor(name, help, "counter");
+    appendSeries(out, name, "", labels);
+    out += ' ';
+    appendNumber(out, value);
+    out += '\n';
+}
+
+void MetricsWriter::gauge(const std::string& name, const std::string& help, const MetricLabels& labels,
+                          double value) {
+    std::string& out = samplesFor(name, help, "gauge");
+    appendSeries(out, name, "", labels);
+    out += ' ';
+    appendNumber(out, value);
+    out += '\n';
+}
+
+void MetricsWriter::summary(const std::string& name, const std::string& help, const MetricLabels& labels,
+                            const LatencyHistogram::Snapshot& snapshot, double scale) {
+    std::string& out = samplesFor(name, help, "summary");
+    for (double q : kQuantiles) {
+        std::string quantile;
+        appendNumber(quantile, q);
+        const std::pair<const char*, std::string> extra{"quantile", quantile};
+        appendSeries(out, name, "", labels, &extra);
+        out += ' ';
+        appendNumber(out, static_cast<double>(snapshot.percentile(q)) * scale);
+        out += '\n';
+    }
+    appendSeries(out, name, "_sum", labels);
+    out += ' ';
+    appendNumber(out, static_cast<double>(snapshot.sum) * scale);
+    out += '\n';
+    appendSeries(out, name, "_count", labels);
+    out += ' ';
+    appendNumber(out, snapshot.count);
+    out += '\n';
+}
+
+std::string MetricsWriter::str() const {
+    std::string out;
+    for (const Family& family : families_) {
+        out += "# HELP ";
+        out += family.name;
+        out += ' ';
+        appendEscaped(out, family.help, false);
+        out += "\n# TYPE ";
+        out += family.name;
+        out += ' ';
+        out += family.type;
+        out += '\n';
+        out += family.samples;
+    }
+    return out;
+}
+
+std::string& MetricsWriter::samplesFor(const std::string& name, const std::string& help, const char* type) {
+    auto it = index_.find(name);
+    if (it == index_.end()) {
+        it = index_.emplace(name, families_.size()).first;
+        families_.push_back(Family{name, help, type, std::string()});
+    }
+    return families_[it->second].samples;
+}
+
+// MetricsRegistry
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    return *findOrCreate(Kind::COUNTER, name, help, labels).counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    return *findOrCreate(Kind::GAUGE, name, help, labels).gauge;
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                             const MetricLabels& labels) {
+    return *findOrCreate(Kind::HISTOGRAM, name, help, labels).histogram;
+}
+
+uint64_t MetricsRegistry::addCollector(Collector collector) {
+    std::lock_guard<std::mutex> lock(collectorsMutex_);
+    const uint64_t id = nextCollectorId_++;
+    collectors_.emplace_back(id, std::move(collector));
+    return id;
+}
+
+void MetricsRegistry::removeCollector(uint64_t id) {
+    std::lock_guard<std::mutex> lock(collectorsMutex_);
+    for (auto it = collectors_.begin(); it != collectors_.end(); ++it) {
+        if (it->first == id) {
+            collectors_.erase(it);
+            return;
+        }
+    }
+}
+
+std::string MetricsRegistry::renderPrometheus() const {
+    MetricsWriter writer;
+    {
+        std::lock_guard<std::mutex> lock(metricsMutex_);
+        for (const auto& metric : metrics_) {
+            switch (metric->kind) {
+                case Kind::COUNTER:
+                    writer.counter(metric->name, metric->help, metric->labels, metric->counter->value());
+                    break;
+                case Kind::GAUGE:
+                    writer.gauge(metric->name, metric->help, metric->labels,
+                                 static_cast<double>(metric->gauge->value()));
+                    break;
+                case Kind::HISTOGRAM:
+                    writer.summary(metric->name, metric->help, metric->labels, metric->histogram->snapshot());
+                    break;
+            }
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(collectorsMutex_);
+        for (const auto& [id, collector] : collectors_) {
+            collector(writer);
+        }
+    }
+    return writer.str();
+}
+
+MetricsRegistry::Metric& MetricsRegistry::findOrCreate(Kind kind, const std::string& name,
+                                                       const std::string& help, const MetricLabels& labels) {
+    const std::string key = metricKey(name, labels);
+    std::lock_guard<std::mutex> lock(metricsMutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        if (it->second->kind != kind) {
+            throw ConfigurationException("Metric registered with a different type: " + name, name);
+        }
+        return *it->second;
+    }
+    for (const auto& metric : metrics_) {
+        if (metric->name == name && metric->kind != kind) {
+            throw ConfigurationException("Metric registered with a different type: " + name, name);
+        }
+    }
+
+    auto metric = std::make_unique<Metric>();
+    metric->kind = kind;
+    metric->name = name;
+    metric->help = help;
+    metric->labels = labels;
+    switch (kind) {
+        case Kind::COUNTER:
+            metric->counter = std::make_unique<Counter>();
+            break;
+        case Kind::GAUGE:
+            metric->gauge = std::make_unique<Gauge>();
+            break;
+        case Kind::HISTOGRAM:
+            metric->histogram = std::make_unique<LatencyHistogram>();
+            break;
+    }
+    Metric& created = *metric;
+    metrics_.push_back(std::move(metric));
+    index_.emplace(key, &created);
+    return created;
+}
+
+} // namespace Utils
+} // namespace MovieBooking
@@ -0,0 +1,87 @@
+// Offline decoder for binary log files written by FileAppender with a
+// BinaryLogFormatter. Prints one text line per entry, oldest first.
+//
+//   log_decoder [--min-level=LEVEL] file...
+//
+// Rotated files (app.log.N) are plain binary logs too; pass them oldest first.
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../include/utils/BinaryLog.h"
+
+using MovieBooking::Utils::BinaryLogReader;
+using MovieBooking::Utils::DecodedLogRecord;
+using MovieBooking::Utils::LogLevel;
+
+namespace {
+
+bool parseLevel(const std::string& name, LogLevel& level) {
+    static const char* const kNames[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+    for (int i = 0; i < 6; ++i) {
+        if (name == kNames[i]) {
+            level = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+int decodeFile(const std::string& path, LogLevel minLevel) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        std::cerr << path << ": cannot open\n";
+        return 1;
+    }
+    const std::vector<char> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    BinaryLogReader reader(data.data(), data.size());
+    if (!reader.isValid()) {
+        std::cerr << path << ": not a binary log file\n";
+        return 1;
+    }
+    DecodedLogRecord record;
+    while (reader.next(record)) {
+        if (record.level >= minLevel) {
+            std::cout << record.toText() << '\n';
+        }
+    }
+    if (reader.remaining() > 0) {
+        std::cerr << path << ": stopped at a truncated or corrupt record, "
+                  << reader.remaining() << " bytes left\n";
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    LogLevel minLevel = LogLevel::TRACE;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.rfind("--min-level=", 0) == 0) {
+            if (!parseLevel(arg.substr(12), minLevel)) {
+                std::cerr << "unknown level: " << arg.substr(12) << '\n';
+                return 2;
+            }
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) {
+        std::cerr << "usage: " << argv[0] << " [--min-level=LEVEL] file...\n";
+        return 2;
+    }
+    int status = 0;
+    for (const auto& file : files) {
+        status |= decodeFile(file, minLevel);
+    }
+    return status;
+}
@@ -0,0 +1,74 @@
+#include "../include/ParkingId.h"
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+const uint64_t SEQUENCE_MASK = (uint64_t(1) << ParkingId::SEQUENCE_BITS) - 1;
+const int SEQUENCE_MIN_DIGITS = 8;
+
+} // namespace
+
+ParkingId::ParkingId(uint8_t prefix, uint64_t sequence)
+    : value((uint64_t(prefix) << SEQUENCE_BITS) | (sequence & SEQUENCE_MASK)) {}
+
+uint8_t ParkingId::getPrefix() const {
+    return static_cast<uint8_t>(value >> SEQUENCE_BITS);
+}
+
+uint64_t ParkingId::getSequence() const {
+    return value & SEQUENCE_MASK;
+}
+
+char* ParkingId::toChars(char* first, char* last, const char* tag) const {
+    size_t tagLength = std::strlen(tag);
+    if (last - first < static_cast<std::ptrdiff_t>(tagLength)) return nullptr;
+    std::memcpy(first, tag, tagLength);
+    char* out = first + tagLength;
+    
+    auto prefixEnd = std::to_chars(out, last, getPrefix());
+    if (prefixEnd.ec != std::errc() || prefixEnd.ptr == last) return nullptr;
+    out = prefixEnd.ptr;
+    *out++ = '-';
+    
+    // Render the sequence, then shift it right to zero-pad to the minimum width
+    auto sequenceEnd = std::to_chars(out, last, getSequence());
+    if (sequenceEnd.ec != std::errc()) return nullptr;
+    std::ptrdiff_t digits = sequenceEnd.ptr - out;
+    if (digits >= SEQUENCE_MIN_DIGITS) return sequenceEnd.ptr;
+    std::ptrdiff_t padding = SEQUENCE_MIN_DIGITS - digits;
+    if (last - sequenceEnd.ptr < padding) return nullptr;
+    std::memmove(out + padding, out, digits);
+    std::memset(out, '0', padding);
+    return out + SEQUENCE_MIN_DIGITS;
+}
+
+std::string ParkingId::toString(const char* tag) const {
+    char buffer[MAX_TEXT_LENGTH + 8];
+    char* end = toChars(buffer, buffer + sizeof(buffer), tag);
+    return end ? std::string(buffer, end) : std::string();
+}
+
+ParkingId ParkingId::parse(const std::string& text, const char* tag) {
+    size_t tagLength = std::strlen(tag);
+    if (text.compare(0, tagLength, tag) != 0) return ParkingId();
+    const char* first = text.data() + tagLength;
+    const char* last = text.data() + text.size();
+    
+    unsigned prefix = 0;
+    auto prefixEnd = std::from_chars(first, last, prefix);
+    if (prefixEnd.ec != std::errc() || prefix > 0xFF || prefixEnd.ptr == last || *prefixEnd.ptr != '-') {
+        return ParkingId();
+    }
+    uint64_t sequence = 0;
+    auto sequenceEnd = std::from_chars(prefixEnd.ptr + 1, last, sequence);
+    if (sequenceEnd.ec != std::errc() || sequenceEnd.ptr != last || sequence > SEQUENCE_MASK) {
+        return ParkingId();
+    }
+    return ParkingId(static_cast<uint8_t>(prefix), sequence);
+}
+
+size_t ParkingIdHash::operator()(const ParkingId& id) const {
+    // Fibonacci hashing spreads consecutive sequences across buckets
+    return static_cast<size_t>((id.getValue() * 0x9E3779B97F4A7C15ull) >> 16);
+}
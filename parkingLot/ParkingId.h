@@ -0,0 +1,48 @@
+#ifndef PARKING_ID_H
+#define PARKING_ID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Compact 64-bit identifier for tickets and payments: an 8-bit prefix naming
+// the gate shard that issued it and a 56-bit monotonic sequence within that
+// prefix. Compared and hashed as an integer; rendered as text such as
+// "TKT3-00000042" only when shown to people.
+class ParkingId {
+public:
+    static const int PREFIX_BITS = 8;
+    static const int SEQUENCE_BITS = 64 - PREFIX_BITS;
+    // Longest rendering: 3-char tag, 3-digit prefix, '-', 17-digit sequence
+    static const size_t MAX_TEXT_LENGTH = 24;
+    
+private:
+    uint64_t value;
+    
+public:
+    constexpr ParkingId() : value(0) {}
+    constexpr explicit ParkingId(uint64_t raw) : value(raw) {}
+    ParkingId(uint8_t prefix, uint64_t sequence);
+    
+    uint64_t getValue() const { return value; }
+    uint8_t getPrefix() const;
+    uint64_t getSequence() const;
+    bool isValid() const { return value != 0; } // sequences start at 1
+    
+    // Writes "<tag><prefix>-<sequence>" with the sequence zero-padded to eight
+    // digits and returns one past the last char written, or nullptr if
+    // [first, last) is too small. No terminator is written.
+    char* toChars(char* first, char* last, const char* tag) const;
+    std::string toString(const char* tag) const;
+    // Inverse of toString; returns an invalid id if `text` does not match
+    static ParkingId parse(const std::string& text, const char* tag);
+    
+    bool operator==(const ParkingId& other) const { return value == other.value; }
+    bool operator!=(const ParkingId& other) const { return value != other.value; }
+};
+
+struct ParkingIdHash {
+    size_t operator()(const ParkingId& id) const;
+};
+
+#endif // PARKING_ID_H
@@ -0,0 +1,300 @@
+#include "../include/ParkingJournal.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Record layout, host byte order:
+//   uint32 payloadLength, uint32 checksum of the payload, then the payload
+//   uint64 sequence, uint8 kind, uint8 vehicleType, uint16 licenseLength,
+//   int32 slotNumber, uint64 ticketId, int64 entryTime (ns since epoch),
+//   licenseLength bytes of license number
+const size_t FRAME_HEADER_SIZE = 8;
+const size_t PAYLOAD_FIXED_SIZE = 32;
+const size_t MAX_LICENSE_LENGTH = 0xFFFF;
+
+template <typename T>
+void put(char*& out, T value) {
+    std::memcpy(out, &value, sizeof(T));
+    out += sizeof(T);
+}
+
+template <typename T>
+T get(const char*& in) {
+    T value;
+    std::memcpy(&value, in, sizeof(T));
+    in += sizeof(T);
+    return value;
+}
+
+void encode(std::string& buffer, uint64_t sequence, JournalEventKind kind, const TicketRecord& ticket) {
+    size_t licenseLength = std::min(ticket.licenseNumber.size(), MAX_LICENSE_LENGTH);
+    uint32_t payloadLength = static_cast<uint32_t>(PAYLOAD_FIXED_SIZE + licenseLength);
+    size_t start = buffer.size();
+    buffer.resize(start + FRAME_HEADER_SIZE + payloadLength);
+    
+    char* payload = &buffer[start + FRAME_HEADER_SIZE];
+    char* out = payload;
+    put<uint64_t>(out, sequence);
+    put<uint8_t>(out, static_cast<uint8_t>(kind));
+    put<uint8_t>(out, static_cast<uint8_t>(ticket.vehicleType));
+    put<uint16_t>(out, static_cast<uint16_t>(licenseLength));
+    put<int32_t>(out, ticket.slotNumber);
+    put<uint64_t>(out, ticket.ticketId.getValue());
+    put<int64_t>(out, std::chrono::duration_cast<std::chrono::nanoseconds>(
+        ticket.entryTime.time_since_epoch()).count());
+    std::memcpy(out, ticket.licenseNumber.data(), licenseLength);
+    
+    char* header = &buffer[start];
+    put<uint32_t>(header, payloadLength);
+    put<uint32_t>(header, ParkingJournal::checksum(payload, payloadLength));
+}
+
+bool writeAll(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Makes a newly created file's directory entry durable
+void syncDirectory(const std::string& directory) {
+    int dirFd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+}
+
+} // namespace
+
+ParkingJournal::ParkingJournal()
+    : fd(-1), segmentNumber(0), lastSequence(0), durableSequence(0), stopping(false), failed(false) {}
+
+ParkingJournal::~ParkingJournal() {
+    close();
+}
+
+bool ParkingJournal::open(const std::string& dir, uint64_t last) {
+    close();
+    if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        return false;
+    }
+    directory = dir;
+    std::vector<uint64_t> segments = listSegments(directory);
+    if (!openSegment(segments.empty() ? 1 : segments.back() + 1)) {
+        return false;
+    }
+    lastSequence = durableSequence = last;
+    stopping = failed = false;
+    writer = std::thread(&ParkingJournal::writerLoop, this);
+    return true;
+}
+
+void ParkingJournal::close() {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        writerWake.notify_one();
+        writer.join(); // flushes what is pending first
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool ParkingJournal::openSegment(uint64_t number) {
+    int segmentFd = ::open(segmentPath(directory, number).c_str(),
+                           O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (segmentFd < 0) {
+        return false;
+    }
+    syncDirectory(directory);
+    fd = segmentFd;
+    segmentNumber = number;
+    return true;
+}
+
+uint64_t ParkingJournal::appendPark(const TicketRecord& ticket) {
+    return append(JournalEventKind::PARK, ticket);
+}
+
+uint64_t ParkingJournal::appendExit(ParkingId ticketId) {
+    TicketRecord ticket{ticketId, 0, VehicleType::CAR, std::string(), std::chrono::system_clock::time_point()};
+    return append(JournalEventKind::EXIT, ticket);
+}
+
+uint64_t ParkingJournal::appendPaymentReservation(uint64_t limit) {
+    TicketRecord ticket{ParkingId(limit), 0, VehicleType::CAR, std::string(), std::chrono::system_clock::time_point()};
+    return append(JournalEventKind::RESERVE_PAYMENTS, ticket);
+}
+
+uint64_t ParkingJournal::append(JournalEventKind kind, const TicketRecord& ticket) {
+    uint64_t sequence;
+    bool wakeWriter;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sequence = ++lastSequence;
+        if (failed) {
+            return sequence; // never written; waitDurable reports the failure
+        }
+        wakeWriter = pending.empty();
+        encode(pending, sequence, kind, ticket);
+    }
+    if (wakeWriter) {
+        writerWake.notify_one();
+    }
+    return sequence;
+}
+
+bool ParkingJournal::waitDurable(uint64_t sequence) {
+    std::unique_lock<std::mutex> lock(mutex);
+    durableWake.wait(lock, [&] { return durableSequence >= sequence || failed; });
+    return durableSequence >= sequence;
+}
+
+void ParkingJournal::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    std::string batch;
+    while (true) {
+        writerWake.wait(lock, [&] { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            break; // stopping, and everything is flushed
+        }
+        
+        // Everything appended while the previous flush ran goes out together
+        batch.clear();
+        batch.swap(pending);
+        uint64_t batchEnd = lastSequence;
+        int out = fd;
+        lock.unlock();
+        bool written = writeAll(out, batch) && ::fdatasync(out) == 0;
+        lock.lock();
+        
+        if (written) {
+            durableSequence = batchEnd;
+        } else {
+            // Nothing follows a possibly torn record: what was appended
+            // meanwhile is dropped, and append() stops accepting events
+            failed = true;
+            pending.clear();
+        }
+        durableWake.notify_all();
+    }
+}
+
+bool ParkingJournal::rotate(uint64_t& coveredSequence, uint64_t& firstLiveSegment) {
+    std::unique_lock<std::mutex> lock(mutex);
+    // With nothing pending and everything durable the writer is idle, so the
+    // segment can be swapped under the lock
+    durableWake.wait(lock, [&] { return (pending.empty() && durableSequence == lastSequence) || failed; });
+    int previous = fd;
+    if (failed || !openSegment(segmentNumber + 1)) {
+        return false;
+    }
+    ::close(previous);
+    coveredSequence = durableSequence;
+    firstLiveSegment = segmentNumber;
+    return true;
+}
+
+bool ParkingJournal::hasFailed() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return failed;
+}
+
+uint32_t ParkingJournal::checksum(const void* data, size_t length) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+std::string ParkingJournal::segmentPath(const std::string& directory, uint64_t number) {
+    char name[40];
+    std::snprintf(name, sizeof(name), "journal-%08llu.log", static_cast<unsigned long long>(number));
+    return directory + "/" + name;
+}
+
+std::vector<uint64_t> ParkingJournal::listSegments(const std::string& directory) {
+    std::vector<uint64_t> segments;
+    DIR* dir = ::opendir(directory.c_str());
+    if (!dir) {
+        return segments;
+    }
+    while (dirent* entry = ::readdir(dir)) {
+        unsigned long long number;
+        char tail;
+        if (std::sscanf(entry->d_name, "journal-%llu.lo%c", &number, &tail) == 2 && tail == 'g') {
+            segments.push_back(number);
+        }
+    }
+    ::closedir(dir);
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+bool ParkingJournal::readSegment(const std::string& path, std::vector<JournalEvent>& events) {
+    int segmentFd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (segmentFd < 0) {
+        return false;
+    }
+    std::string data;
+    char chunk[1 << 16];
+    ssize_t n;
+    while ((n = ::read(segmentFd, chunk, sizeof(chunk))) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ::close(segmentFd);
+            return false;
+        }
+        data.append(chunk, static_cast<size_t>(n));
+    }
+    ::close(segmentFd);
+    
+    // Stop at the first incomplete or corrupt record: a crash mid-write
+    // leaves at most a torn tail
+    size_t offset = 0;
+    while (data.size() - offset >= FRAME_HEADER_SIZE) {
+        const char* in = data.data() + offset;
+        uint32_t payloadLength = get<uint32_t>(in);
+        uint32_t expected = get<uint32_t>(in);
+        if (payloadLength < PAYLOAD_FIXED_SIZE || data.size() - offset - FRAME_HEADER_SIZE < payloadLength ||
+            checksum(in, payloadLength) != expected) {
+            break;
+        }
+        JournalEvent event;
+        event.sequence = get<uint64_t>(in);
+        event.kind = static_cast<JournalEventKind>(get<uint8_t>(in));
+        event.ticket.vehicleType = static_cast<VehicleType>(get<uint8_t>(in));
+        uint16_t licenseLength = get<uint16_t>(in);
+        event.ticket.slotNumber = get<int32_t>(in);
+        event.ticket.ticketId = ParkingId(get<uint64_t>(in));
+        event.ticket.entryTime = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(get<int64_t>(in))));
+        if (PAYLOAD_FIXED_SIZE + licenseLength != payloadLength) {
+            break;
+        }
+        event.ticket.licenseNumber.assign(in, licenseLength);
+        events.push_back(std::move(event));
+        offset += FRAME_HEADER_SIZE + payloadLength;
+    }
+    return true;
+}
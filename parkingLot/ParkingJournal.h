@@ -0,0 +1,103 @@
+#ifndef PARKING_JOURNAL_H
+#define PARKING_JOURNAL_H
+
+#include "ParkingId.h"
+#include "Vehicle.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Everything needed to reissue an active ticket after a restart
+struct TicketRecord {
+    ParkingId ticketId;
+    int slotNumber;
+    VehicleType vehicleType;
+    std::string licenseNumber;
+    std::chrono::system_clock::time_point entryTime;
+};
+
+enum class JournalEventKind : uint8_t {
+    PARK = 1,
+    EXIT = 2,
+    RESERVE_PAYMENTS = 3 // payment sequences up to a limit may be issued
+};
+
+struct JournalEvent {
+    uint64_t sequence;
+    JournalEventKind kind;
+    // Only ticketId is meaningful for EXIT; for RESERVE_PAYMENTS its raw
+    // value is the reserved limit
+    TicketRecord ticket;
+};
+
+// Append-only binary journal of park and exit events, split into numbered
+// segment files "journal-<n>.log" in one directory. Each record is framed
+// with its length and a checksum so a torn tail from a crash is detected and
+// dropped on replay.
+//
+// Group commit: gates append into a shared buffer and wait; one writer
+// thread writes whatever has accumulated with a single write + fdatasync and
+// wakes every gate it covered, so concurrent gates share one disk flush.
+// A failed write may leave a torn record, so after one the journal writes
+// nothing more: every pending and later event is reported as not durable.
+class ParkingJournal {
+private:
+    std::string directory;
+    int fd;
+    uint64_t segmentNumber;
+    
+    std::mutex mutex;
+    std::condition_variable writerWake;
+    std::condition_variable durableWake;
+    std::string pending; // encoded records not yet handed to the writer
+    uint64_t lastSequence;
+    uint64_t durableSequence;
+    bool stopping;
+    bool failed;
+    std::thread writer;
+    
+    uint64_t append(JournalEventKind kind, const TicketRecord& ticket);
+    bool openSegment(uint64_t number);
+    void writerLoop();
+    
+public:
+    ParkingJournal();
+    ~ParkingJournal();
+    ParkingJournal(const ParkingJournal&) = delete;
+    ParkingJournal& operator=(const ParkingJournal&) = delete;
+    
+    // Starts a new segment after any existing ones, numbering events from
+    // `lastSequence` + 1; false if the segment cannot be created
+    bool open(const std::string& directory, uint64_t lastSequence);
+    void close();
+    
+    // Return the event's sequence number right away; pass it to waitDurable
+    uint64_t appendPark(const TicketRecord& ticket);
+    uint64_t appendExit(ParkingId ticketId);
+    uint64_t appendPaymentReservation(uint64_t limit);
+    // Blocks until `sequence` is on disk; false if the journal failed
+    bool waitDurable(uint64_t sequence);
+    
+    // Flushes, closes the current segment and starts the next one. On success
+    // `coveredSequence` is the last sequence in the closed segments, which can
+    // all be dropped (every number below `firstLiveSegment`) once a snapshot
+    // covers that sequence.
+    bool rotate(uint64_t& coveredSequence, uint64_t& firstLiveSegment);
+    bool hasFailed();
+    
+    // FNV-1a, used to detect torn or corrupt records and snapshots
+    static uint32_t checksum(const void* data, size_t length);
+    
+    // Segment numbers present in `directory`, ascending
+    static std::vector<uint64_t> listSegments(const std::string& directory);
+    static std::string segmentPath(const std::string& directory, uint64_t number);
+    // Appends the intact events of one segment to `events`; returns false if
+    // the file could not be read
+    static bool readSegment(const std::string& path, std::vector<JournalEvent>& events);
+};
+
+#endif // PARKING_JOURNAL_H
@@ -1,109 +1,382 @@
-#include "../include/ParkingLot.h"
-#include <sstream>
-#include <iomanip>
-#include <algorithm>
-
-ParkingLot::ParkingLot(int carSpaces, int truckSpaces, int motorcycleSpaces, double rate)
-    : hourlyRate(rate), nextTicketNumber(1) {
-    
-    // Initialize parking slots
-    int slotNumber = 1;
-    
-    // Add truck slots
-    for (int i = 0; i < truckSpaces; ++i) {
-        parkingSlots.push_back(std::make_shared<ParkingSlot>(slotNumber++, VehicleType::TRUCK));
-    }
-    
-    // Add car slots
-    for (int i = 0; i < carSpaces; ++i) {
-        parkingSlots.push_back(std::make_shared<ParkingSlot>(slotNumber++, VehicleType::CAR));
-    }
-    
-    // Add motorcycle slots
-    for (int i = 0; i < motorcycleSpaces; ++i) {
-        parkingSlots.push_back(std::make_shared<ParkingSlot>(slotNumber++, VehicleType::MOTORCYCLE));
-    }
-}
-
-std::string ParkingLot::generateTicketNumber() {
-    std::stringstream ss;
-    ss << "TKT" << std::setw(8) << std::setfill('0') << nextTicketNumber++;
-    return ss.str();
-}
-
-std::shared_ptr<ParkingTicket> ParkingLot::parkVehicle(std::shared_ptr<Vehicle> vehicle) {
-    if (!vehicle) return nullptr;
-    
-    // Find first available slot for the vehicle type
-    auto it = std::find_if(parkingSlots.begin(), parkingSlots.end(),
-        [&vehicle](const std::shared_ptr<ParkingSlot>& slot) {
-            return slot->canPark(vehicle->getType());
-        });
-    
-    if (it == parkingSlots.end()) {
-        return nullptr; // No available slot
-    }
-    
-    auto slot = *it;
-    if (slot->parkVehicle(vehicle)) {
-        std::string ticketNumber = generateTicketNumber();
-        auto ticket = std::make_shared<ParkingTicket>(ticketNumber, vehicle, slot->getSlotNumber());
-        activeTickets[ticketNumber] = ticket;
-        return ticket;
-    }
-    
-    return nullptr;
-}
-
-double ParkingLot::exitParking(const std::string& ticketNumber) {
-    auto it = activeTickets.find(ticketNumber);
-    if (it == activeTickets.end()) {
-        return -1.0; // Invalid ticket
-    }
-    
-    auto ticket = it->second;
-    double fee = ticket->calculateFee(hourlyRate);
-    
-    // Free up the parking slot
-    int slotNum = ticket->getSlotNumber();
-    if (slotNum > 0 && slotNum <= parkingSlots.size()) {
-        parkingSlots[slotNum - 1]->vacateSlot();
-    }
-    
-    // Remove from active tickets
-    activeTickets.erase(it);
-    
-    return fee;
-}
-
-int ParkingLot::getAvailableSpaces(VehicleType type) const {
-    return std::count_if(parkingSlots.begin(), parkingSlots.end(),
-        [type](const std::shared_ptr<ParkingSlot>& slot) {
-            return slot->isAvailable() && 
-                  (slot->getSlotType() == type || 
-                   (type == VehicleType::CAR && slot->getSlotType() == VehicleType::TRUCK));
-        });
-}
-
-int ParkingLot::getTotalSpaces() const {
-    return static_cast<int>(parkingSlots.size());
-}
-
-int ParkingLot::getOccupiedSpaces() const {
-    return getTotalSpaces() - 
-           std::count_if(parkingSlots.begin(), parkingSlots.end(),
-               [](const std::shared_ptr<ParkingSlot>& slot) {
-                   return slot->isAvailable();
-               });
-}
-
-bool ParkingLot::isFull() const {
-    return std::none_of(parkingSlots.begin(), parkingSlots.end(),
-        [](const std::shared_ptr<ParkingSlot>& slot) {
-            return slot->isAvailable();
-        });
-}
-
-bool ParkingLot::isFull(VehicleType type) const {
-    return getAvailableSpaces(type) == 0;
-}
+#include "../include/ParkingLot.h"
+#include <functional>
+#include <thread>
+
+namespace {
+
+// Shard a gate thread starts from, for both free slots and new tickets
+int homeShard(int shardCount) {
+    static thread_local const size_t threadHash = std::hash<std::thread::id>()(std::this_thread::get_id());
+    return static_cast<int>(threadHash % shardCount);
+}
+
+// Slot types in slot-number order: trucks, then cars, then motorcycles
+std::vector<VehicleType> slotLayout(int carSpaces, int truckSpaces, int motorcycleSpaces) {
+    std::vector<VehicleType> layout;
+    layout.reserve(carSpaces + truckSpaces + motorcycleSpaces);
+    layout.insert(layout.end(), truckSpaces, VehicleType::TRUCK);
+    layout.insert(layout.end(), carSpaces, VehicleType::CAR);
+    layout.insert(layout.end(), motorcycleSpaces, VehicleType::MOTORCYCLE);
+    return layout;
+}
+
+} // namespace
+
+ParkingLot::ParkingLot(int carSpaces, int truckSpaces, int motorcycleSpaces, double rate)
+    : ParkingLot(carSpaces, truckSpaces, motorcycleSpaces, TariffPlan(rate)) {}
+
+ParkingLot::ParkingLot(int carSpaces, int truckSpaces, int motorcycleSpaces, const TariffPlan& tariffPlan)
+    : slots(slotLayout(carSpaces, truckSpaces, motorcycleSpaces)),
+      tariff(tariffPlan), occupiedSlots(0), journal(nullptr) {
+    for (auto& count : freeCounts) {
+        count.store(0);
+    }
+    
+    // Build the free lists, highest index first so the lowest is popped first
+    for (int i = slots.size() - 1; i >= 0; --i) {
+        int typeIndex = static_cast<int>(slots.getType(i));
+        freeSlots[typeIndex][i % SHARD_COUNT].slots.push_back(i);
+        ++freeCounts[typeIndex];
+    }
+}
+
+std::shared_ptr<ParkingTicket> ParkingLot::parkVehicle(const Vehicle& vehicle) {
+    int slotIndex = claimSlot(vehicle.getType());
+    if (slotIndex < 0) {
+        return nullptr; // No available slot
+    }
+    
+    uint32_t vehicleIndex = vehicles.add(vehicle);
+    ParkingSlot slot(slots, slotIndex);
+    if (slot.parkVehicle(vehicleIndex, vehicle.getType())) {
+        int shardIndex = homeShard(SHARD_COUNT);
+        TicketShard& shard = activeTickets[shardIndex];
+        ParkingId ticketId(static_cast<uint8_t>(shardIndex), shard.nextSequence.fetch_add(1, std::memory_order_relaxed));
+        auto ticket = std::make_shared<ParkingTicket>(ticketId, vehicle, slot.getSlotNumber());
+        uint64_t parkSequence = 0;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (journal) {
+                parkSequence = journal->appendPark(TicketRecord{ticketId, slot.getSlotNumber(), vehicle.getType(),
+                                                                vehicle.getLicenseNumber(), ticket->getEntryTime()});
+            }
+            shard.tickets[ticketId] = ActiveTicket{ticket, parkSequence, 0};
+        }
+        if (!journal || journal->waitDurable(parkSequence)) {
+            return ticket;
+        }
+        // Not durable: the ticket was never handed out, so take it back
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.tickets.erase(ticketId);
+        }
+        slot.vacateSlot();
+    }
+    
+    vehicles.remove(vehicleIndex);
+    releaseSlot(slotIndex);
+    return nullptr;
+}
+
+std::shared_ptr<ParkingTicket> ParkingLot::parkVehicle(std::shared_ptr<Vehicle> vehicle) {
+    if (!vehicle) return nullptr;
+    return parkVehicle(*vehicle);
+}
+
+double ParkingLot::exitParking(const std::string& ticketNumber) {
+    return exitParking(ParkingId::parse(ticketNumber, ParkingTicket::ID_TAG));
+}
+
+double ParkingLot::exitParking(ParkingId ticketId) {
+    if (!ticketId.isValid()) {
+        return -1.0; // Invalid ticket
+    }
+    
+    // Marking the ticket as leaving (or, without a journal, taking it out of
+    // its shard) makes this call its only owner, so two gates presenting the
+    // same ticket cannot both vacate the slot
+    TicketShard& shard = ticketShard(ticketId);
+    std::shared_ptr<ParkingTicket> ticket;
+    uint64_t exitSequence = 0;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.tickets.find(ticketId);
+        if (it == shard.tickets.end() || it->second.exitSequence != 0) {
+            return -1.0; // Invalid ticket
+        }
+        ticket = it->second.ticket;
+        if (journal) {
+            exitSequence = journal->appendExit(ticketId);
+            it->second.exitSequence = exitSequence;
+        } else {
+            shard.tickets.erase(it);
+        }
+    }
+    if (journal) {
+        // Held in the shard until the exit is durable, so a checkpoint never
+        // drops a ticket whose exit may yet be undone
+        bool durable = journal->waitDurable(exitSequence);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.tickets.find(ticketId);
+        if (!durable) {
+            // The vehicle has not left as far as the disk knows: keep the ticket
+            it->second.exitSequence = 0;
+            return -1.0;
+        }
+        shard.tickets.erase(it);
+    }
+    
+    double fee = ticket->calculateFee(tariff, std::chrono::steady_clock::now());
+    
+    // Free up the parking slot
+    int slotNum = ticket->getSlotNumber();
+    if (slotNum > 0 && slotNum <= slots.size()) {
+        vehicles.remove(ParkingSlot(slots, slotNum - 1).vacateSlot());
+        releaseSlot(slotNum - 1);
+    }
+    
+    return fee;
+}
+
+double ParkingLot::quoteFee(ParkingId ticketId) {
+    if (!ticketId.isValid()) {
+        return -1.0;
+    }
+    // Under the shard lock, so a quote never races the ticket's exit
+    TicketShard& shard = ticketShard(ticketId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.tickets.find(ticketId);
+    if (it == shard.tickets.end() || it->second.exitSequence != 0) {
+        return -1.0;
+    }
+    return it->second.ticket->calculateFee(tariff, std::chrono::steady_clock::now());
+}
+
+std::vector<ParkingLot::TicketFee> ParkingLot::calculateActiveFees() const {
+    // Gather the stays into parallel arrays, then price them in one pass
+    auto now = std::chrono::steady_clock::now();
+    size_t expected = static_cast<size_t>(getOccupiedSpaces());
+    std::vector<TicketFee> fees;
+    std::vector<VehicleType> types;
+    std::vector<uint8_t> entryHours;
+    std::vector<int64_t> hours;
+    fees.reserve(expected);
+    types.reserve(expected);
+    entryHours.reserve(expected);
+    hours.reserve(expected);
+    for (const TicketShard& shard : activeTickets) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& entry : shard.tickets) {
+            const ParkingTicket& ticket = *entry.second.ticket;
+            fees.push_back(TicketFee{entry.first, 0.0});
+            types.push_back(ticket.getVehicleType());
+            entryHours.push_back(static_cast<uint8_t>(tariff.hourOfDay(ticket.getEntryTime())));
+            hours.push_back(TariffEngine::billableHours(ticket.getStayDuration(now)));
+        }
+    }
+    
+    std::vector<double> amounts(fees.size());
+    tariff.calculateFees(types.data(), entryHours.data(), hours.data(), amounts.data(), fees.size());
+    for (size_t i = 0; i < fees.size(); ++i) {
+        fees[i].fee = amounts[i];
+    }
+    return fees;
+}
+
+int ParkingLot::claimSlot(VehicleType type) {
+    int slotIndex = claimSlotOfType(static_cast<int>(type));
+    // Cars fall back to truck slots once the car slots are taken
+    if (slotIndex < 0 && type == VehicleType::CAR) {
+        slotIndex = claimSlotOfType(static_cast<int>(VehicleType::TRUCK));
+    }
+    return slotIndex;
+}
+
+int ParkingLot::claimSlotOfType(int typeIndex) {
+    // Reserve one free slot first so an exhausted type costs no locking
+    std::atomic<int>& freeCount = freeCounts[typeIndex];
+    int available = freeCount.load(std::memory_order_relaxed);
+    do {
+        if (available <= 0) {
+            return -1;
+        }
+    } while (!freeCount.compare_exchange_weak(available, available - 1, std::memory_order_acq_rel));
+    notifyAvailability(typeIndex, available, available - 1);
+    
+    // The reservation guarantees some shard holds a slot; start at this gate's own
+    int firstShard = homeShard(SHARD_COUNT);
+    while (true) {
+        for (int i = 0; i < SHARD_COUNT; ++i) {
+            FreeList& list = freeSlots[typeIndex][(firstShard + i) % SHARD_COUNT];
+            std::lock_guard<std::mutex> lock(list.mutex);
+            if (!list.slots.empty()) {
+                int slotIndex = list.slots.back();
+                list.slots.pop_back();
+                occupiedSlots.fetch_add(1, std::memory_order_relaxed);
+                return slotIndex;
+            }
+        }
+    }
+}
+
+void ParkingLot::releaseSlot(int slotIndex) {
+    int typeIndex = static_cast<int>(slots.getType(slotIndex));
+    {
+        FreeList& list = freeSlots[typeIndex][slotIndex % SHARD_COUNT];
+        std::lock_guard<std::mutex> lock(list.mutex);
+        list.slots.push_back(slotIndex);
+    }
+    occupiedSlots.fetch_sub(1, std::memory_order_relaxed);
+    int freeBefore = freeCounts[typeIndex].fetch_add(1, std::memory_order_release);
+    notifyAvailability(typeIndex, freeBefore, freeBefore + 1);
+}
+
+void ParkingLot::notifyAvailability(int typeIndex, int freeBefore, int freeAfter) {
+    if (availabilityListener) {
+        availabilityListener(static_cast<VehicleType>(typeIndex), freeBefore, freeAfter);
+    }
+}
+
+void ParkingLot::setAvailabilityListener(AvailabilityListener listener) {
+    availabilityListener = std::move(listener);
+}
+
+void ParkingLot::attachJournal(ParkingJournal* parkingJournal) {
+    journal = parkingJournal;
+}
+
+int ParkingLot::restoreTickets(const std::vector<TicketRecord>& tickets) {
+    int restored = 0;
+    for (const TicketRecord& record : tickets) {
+        int slotIndex = record.slotNumber - 1;
+        if (!record.ticketId.isValid() || slotIndex < 0 || slotIndex >= slots.size()) {
+            continue;
+        }
+        TicketShard& shard = ticketShard(record.ticketId);
+        if (shard.tickets.count(record.ticketId)) {
+            continue;
+        }
+        Vehicle vehicle(record.licenseNumber, record.vehicleType);
+        uint32_t vehicleIndex = vehicles.add(vehicle);
+        if (!ParkingSlot(slots, slotIndex).parkVehicle(vehicleIndex, record.vehicleType)) {
+            vehicles.remove(vehicleIndex);
+            continue;
+        }
+        shard.tickets.emplace(record.ticketId, ActiveTicket{std::make_shared<ParkingTicket>(
+            record.ticketId, vehicle, record.slotNumber, record.entryTime), 0, 0});
+        ++restored;
+    }
+    std::vector<ParkingId> restoredIds;
+    restoredIds.reserve(tickets.size());
+    for (const TicketRecord& record : tickets) {
+        restoredIds.push_back(record.ticketId);
+    }
+    resumeTicketSequences(restoredIds);
+    
+    // Rebuild the free lists from the occupancy the tickets left behind
+    for (int type = 0; type < VEHICLE_TYPE_COUNT; ++type) {
+        for (FreeList& list : freeSlots[type]) {
+            list.slots.clear();
+        }
+        freeCounts[type].store(0, std::memory_order_relaxed);
+    }
+    int free = 0;
+    for (int i = slots.size() - 1; i >= 0; --i) {
+        if (ParkingSlot(slots, i).isAvailable()) {
+            int typeIndex = static_cast<int>(slots.getType(i));
+            freeSlots[typeIndex][i % SHARD_COUNT].slots.push_back(i);
+            freeCounts[typeIndex].fetch_add(1, std::memory_order_relaxed);
+            ++free;
+        }
+    }
+    occupiedSlots.store(slots.size() - free, std::memory_order_release);
+    return restored;
+}
+
+std::vector<ParkingId> ParkingLot::getLastIssuedTicketIds() const {
+    std::vector<ParkingId> issued;
+    for (int shardIndex = 0; shardIndex < SHARD_COUNT; ++shardIndex) {
+        uint64_t next = activeTickets[shardIndex].nextSequence.load(std::memory_order_relaxed);
+        if (next > 1) {
+            issued.emplace_back(static_cast<uint8_t>(shardIndex), next - 1);
+        }
+    }
+    return issued;
+}
+
+void ParkingLot::resumeTicketSequences(const std::vector<ParkingId>& issued) {
+    for (ParkingId id : issued) {
+        if (!id.isValid()) {
+            continue;
+        }
+        std::atomic<uint64_t>& nextSequence = ticketShard(id).nextSequence;
+        uint64_t next = id.getSequence() + 1;
+        uint64_t current = nextSequence.load(std::memory_order_relaxed);
+        while (current < next && !nextSequence.compare_exchange_weak(current, next, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+ParkingLot::TicketShard& ParkingLot::ticketShard(ParkingId ticketId) {
+    return activeTickets[ticketId.getPrefix() % SHARD_COUNT];
+}
+
+int ParkingLot::getAvailableSpaces(VehicleType type) const {
+    int available = freeCounts[static_cast<int>(type)].load(std::memory_order_relaxed);
+    if (type == VehicleType::CAR) {
+        available += freeCounts[static_cast<int>(VehicleType::TRUCK)].load(std::memory_order_relaxed);
+    }
+    return available;
+}
+
+int ParkingLot::getFreeSlots(VehicleType slotType) const {
+    return freeCounts[static_cast<int>(slotType)].load(std::memory_order_relaxed);
+}
+
+VehicleType ParkingLot::getSlotType(int slotNumber) const {
+    return slots.getType(slotNumber - 1);
+}
+
+std::vector<TicketRecord> ParkingLot::getActiveTickets(uint64_t durableThrough) const {
+    std::vector<TicketRecord> records;
+    records.reserve(getOccupiedSpaces());
+    for (const TicketShard& shard : activeTickets) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& entry : shard.tickets) {
+            const ActiveTicket& active = entry.second;
+            if (active.parkSequence > durableThrough ||
+                (active.exitSequence != 0 && active.exitSequence <= durableThrough)) {
+                continue;
+            }
+            const ParkingTicket& ticket = *active.ticket;
+            records.push_back(TicketRecord{ticket.getTicketId(), ticket.getSlotNumber(), ticket.getVehicleType(),
+                                           ticket.getVehicleLicenseNumber(), ticket.getEntryTime()});
+        }
+    }
+    return records;
+}
+
+const TariffEngine& ParkingLot::getTariff() const {
+    return tariff;
+}
+
+int ParkingLot::getTotalSpaces() const {
+    return slots.size();
+}
+
+int ParkingLot::getOccupiedSpaces() const {
+    return occupiedSlots.load(std::memory_order_relaxed);
+}
+
+std::string ParkingLot::getParkedLicenseNumber(int slotNumber) const {
+    if (slotNumber <= 0 || slotNumber > slots.size()) return "";
+    return vehicles.getLicenseNumber(slots.occupant(slotNumber - 1).load(std::memory_order_acquire));
+}
+
+bool ParkingLot::isFull() const {
+    return getOccupiedSpaces() == getTotalSpaces();
+}
+
+bool ParkingLot::isFull(VehicleType type) const {
+    return getAvailableSpaces(type) == 0;
+}
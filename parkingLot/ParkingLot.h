@@ -1,36 +1,137 @@
-#ifndef PARKING_LOT_H
-#define PARKING_LOT_H
-
-#include "ParkingSlot.h"
-#include "ParkingTicket.h"
-#include <vector>
-#include <unordered_map>
-#include <memory>
-
-class ParkingLot {
-private:
-    std::vector<std::shared_ptr<ParkingSlot>> parkingSlots;
-    std::unordered_map<std::string, std::shared_ptr<ParkingTicket>> activeTickets;
-    double hourlyRate;
-    int nextTicketNumber;
-    
-    std::string generateTicketNumber();
-    
-public:
-    ParkingLot(int carSpaces, int truckSpaces, int motorcycleSpaces, double rate);
-    
-    // Core operations
-    std::shared_ptr<ParkingTicket> parkVehicle(std::shared_ptr<Vehicle> vehicle);
-    double exitParking(const std::string& ticketNumber);
-    
-    // Getters
-    int getAvailableSpaces(VehicleType type) const;
-    int getTotalSpaces() const;
-    int getOccupiedSpaces() const;
-    
-    // Utility
-    bool isFull() const;
-    bool isFull(VehicleType type) const;
-};
-
-#endif // PARKING_LOT_H
+#ifndef PARKING_LOT_H
+#define PARKING_LOT_H
+
+#include "ParkingJournal.h"
+#include "ParkingSlot.h"
+#include "ParkingTicket.h"
+#include "Tariff.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+
+// Thread-safe: gates may park and exit concurrently. Free slots and active
+// tickets are split across shards with one small lock each, a gate starts
+// from its own shard, and the occupancy counters are atomic, so gates only
+// contend when they touch the same shard. Tickets are issued by the gate's
+// ticket shard, whose index is the id prefix, so a lookup needs no hashing
+// to find its shard.
+// Slots live in one contiguous SlotStore and refer to their vehicle by index
+// into a VehiclePool, so parking allocates nothing per slot.
+class ParkingLot {
+public:
+    // Called with a slot type and its free count before and after each change
+    using AvailabilityListener = std::function<void(VehicleType slotType, int freeBefore, int freeAfter)>;
+    
+private:
+    static const int SHARD_COUNT = 16;
+    
+    struct FreeList {
+        std::mutex mutex;
+        std::vector<int> slots; // used as a stack
+    };
+    
+    // A ticket with the journal sequences of its park and, while the vehicle
+    // is leaving, its exit (0: no journal, or not leaving). Both are set
+    // under the shard lock as the event is appended, so a checkpoint can tell
+    // which tickets its journal position covers.
+    struct ActiveTicket {
+        std::shared_ptr<ParkingTicket> ticket;
+        uint64_t parkSequence;
+        uint64_t exitSequence;
+    };
+    
+    struct TicketShard {
+        mutable std::mutex mutex;
+        std::unordered_map<ParkingId, ActiveTicket, ParkingIdHash> tickets;
+        std::atomic<uint64_t> nextSequence{1};
+    };
+    
+    SlotStore slots; // fixed layout after construction
+    VehiclePool vehicles;
+    std::array<TicketShard, SHARD_COUNT> activeTickets;
+    TariffEngine tariff;
+    
+    // Free slot indices per slot type, spread round-robin over shards and
+    // filled so each shard hands out its lowest slot number first
+    std::array<std::array<FreeList, SHARD_COUNT>, VEHICLE_TYPE_COUNT> freeSlots;
+    std::array<std::atomic<int>, VEHICLE_TYPE_COUNT> freeCounts;
+    std::atomic<int> occupiedSlots;
+    AvailabilityListener availabilityListener;
+    ParkingJournal* journal;
+    
+    // Index of a free slot that accepts `type`, removed from its free list; -1 if none
+    int claimSlot(VehicleType type);
+    int claimSlotOfType(int typeIndex);
+    void releaseSlot(int slotIndex);
+    void notifyAvailability(int typeIndex, int freeBefore, int freeAfter);
+    TicketShard& ticketShard(ParkingId ticketId);
+    
+public:
+    struct TicketFee {
+        ParkingId ticketId;
+        double fee;
+    };
+    
+    // Flat hourly rate for every vehicle type
+    ParkingLot(int carSpaces, int truckSpaces, int motorcycleSpaces, double rate);
+    ParkingLot(int carSpaces, int truckSpaces, int motorcycleSpaces, const TariffPlan& tariffPlan);
+    ParkingLot(const ParkingLot&) = delete;
+    ParkingLot& operator=(const ParkingLot&) = delete;
+    
+    // Core operations. With a journal attached, a park or exit whose event
+    // cannot be made durable is undone: parkVehicle returns nullptr and
+    // exitParking -1 with the ticket still active.
+    std::shared_ptr<ParkingTicket> parkVehicle(const Vehicle& vehicle);
+    std::shared_ptr<ParkingTicket> parkVehicle(std::shared_ptr<Vehicle> vehicle);
+    double exitParking(ParkingId ticketId);
+    double exitParking(const std::string& ticketNumber);
+    // Fee if the vehicle left now, recorded on the ticket for payment; -1 for
+    // an unknown ticket
+    double quoteFee(ParkingId ticketId);
+    // What every active ticket owes at one instant, e.g. for end-of-day billing
+    std::vector<TicketFee> calculateActiveFees() const;
+    
+    // Getters
+    int getAvailableSpaces(VehicleType type) const;
+    int getTotalSpaces() const;
+    int getOccupiedSpaces() const;
+    const TariffEngine& getTariff() const;
+    // Free slots of exactly `slotType`, without the car-to-truck fallback
+    int getFreeSlots(VehicleType slotType) const;
+    VehicleType getSlotType(int slotNumber) const;
+    // Tickets whose park event is journaled at or below `durableThrough` and
+    // whose exit, if one is under way, is not; by default every ticket issued
+    // and not leaving
+    std::vector<TicketRecord> getActiveTickets(uint64_t durableThrough = UINT64_MAX) const;
+    // Empty string if the slot is free or out of range
+    std::string getParkedLicenseNumber(int slotNumber) const;
+    
+    // Utility
+    bool isFull() const;
+    bool isFull(VehicleType type) const;
+    
+    // Install before the lot takes traffic; called from the parking gate's
+    // thread, so it must be cheap and thread-safe
+    void setAvailabilityListener(AvailabilityListener listener);
+    
+    // Persistence, see ParkingStore. With a journal attached, park and exit
+    // return only once their event is durable.
+    void attachJournal(ParkingJournal* journal);
+    // Reissues recovered tickets into an empty lot that is not yet taking
+    // traffic; tickets whose slot is out of range, of the wrong type or
+    // already taken are skipped. Returns the number restored.
+    int restoreTickets(const std::vector<TicketRecord>& tickets);
+    // Last sequence each ticket shard has issued, as ids (shards that issued
+    // nothing are left out). resumeTicketSequences continues every shard
+    // after the highest of `issued`, so tickets that have since exited are
+    // never numbered again.
+    std::vector<ParkingId> getLastIssuedTicketIds() const;
+    void resumeTicketSequences(const std::vector<ParkingId>& issued);
+};
+
+#endif // PARKING_LOT_H
@@ -0,0 +1,186 @@
+#include "../include/ParkingNetwork.h"
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+namespace {
+
+const int BITS_PER_WORD = 64;
+// Queries per thread below which a batch is not worth splitting
+const size_t MIN_QUERIES_PER_THREAD = 256;
+const int MAX_PARK_ATTEMPTS = 4;
+
+int wordCount(int maxLots) {
+    return (maxLots + BITS_PER_WORD - 1) / BITS_PER_WORD;
+}
+
+} // namespace
+
+ParkingNetwork::ParkingNetwork(int maxLots)
+    : maxLots(std::max(maxLots, 0)), lotCount(0), lots(this->maxLots), locations(this->maxLots) {
+    int words = wordCount(this->maxLots);
+    for (int type = 0; type < VEHICLE_TYPE_COUNT; ++type) {
+        availableLots[type].reset(new std::atomic<uint64_t>[words]);
+        for (int i = 0; i < words; ++i) {
+            availableLots[type][i].store(0, std::memory_order_relaxed);
+        }
+        freeTotals[type].store(0, std::memory_order_relaxed);
+    }
+}
+
+int ParkingNetwork::addLot(std::unique_ptr<ParkingLot> lot, LotLocation location) {
+    if (!lot) return -1;
+    
+    std::lock_guard<std::mutex> lock(addMutex);
+    int lotId = lotCount.load(std::memory_order_relaxed);
+    if (lotId >= maxLots) {
+        return -1;
+    }
+    
+    lots[lotId].reset(new LotEntry());
+    lots[lotId]->lot = std::move(lot);
+    locations[lotId] = location;
+    ParkingLot& added = *lots[lotId]->lot;
+    added.setAvailabilityListener([this, lotId](VehicleType slotType, int freeBefore, int freeAfter) {
+        onAvailabilityChange(lotId, slotType, freeBefore, freeAfter);
+    });
+    for (int type = 0; type < VEHICLE_TYPE_COUNT; ++type) {
+        freeTotals[type].fetch_add(added.getFreeSlots(static_cast<VehicleType>(type)), std::memory_order_relaxed);
+        refreshIndex(lotId, static_cast<VehicleType>(type));
+    }
+    
+    // Publishes the entry and location to lock-free readers
+    lotCount.store(lotId + 1, std::memory_order_release);
+    return lotId;
+}
+
+void ParkingNetwork::onAvailabilityChange(int lotId, VehicleType slotType, int freeBefore, int freeAfter) {
+    freeTotals[static_cast<int>(slotType)].fetch_add(freeAfter - freeBefore, std::memory_order_relaxed);
+    if ((freeBefore > 0) != (freeAfter > 0)) {
+        refreshIndex(lotId, slotType);
+    }
+}
+
+void ParkingNetwork::refreshIndex(int lotId, VehicleType slotType) {
+    // Racing transitions may report out of order, so set the bit from the
+    // lot's current count; the lock makes the last refresh see the last change
+    LotEntry& entry = *lots[lotId];
+    std::lock_guard<std::mutex> lock(entry.indexMutex);
+    std::atomic<uint64_t>& word = availableLots[static_cast<int>(slotType)][lotId / BITS_PER_WORD];
+    uint64_t bit = uint64_t(1) << (lotId % BITS_PER_WORD);
+    if (entry.lot->getFreeSlots(slotType) > 0) {
+        word.fetch_or(bit, std::memory_order_release);
+    } else {
+        word.fetch_and(~bit, std::memory_order_release);
+    }
+}
+
+int ParkingNetwork::findNearest(VehicleType vehicleType, LotLocation from, const std::vector<int>& excluded) const {
+    int count = lotCount.load(std::memory_order_acquire);
+    const std::atomic<uint64_t>* typeBits = availableLots[static_cast<int>(vehicleType)].get();
+    // Cars may also take truck slots
+    const std::atomic<uint64_t>* fallbackBits = vehicleType == VehicleType::CAR
+        ? availableLots[static_cast<int>(VehicleType::TRUCK)].get() : nullptr;
+    
+    int nearest = -1;
+    double nearestDistance = std::numeric_limits<double>::infinity();
+    for (int w = 0; w < wordCount(count); ++w) {
+        uint64_t bits = typeBits[w].load(std::memory_order_acquire);
+        if (fallbackBits) {
+            bits |= fallbackBits[w].load(std::memory_order_acquire);
+        }
+        while (bits) {
+            int lotId = w * BITS_PER_WORD + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (lotId >= count || std::find(excluded.begin(), excluded.end(), lotId) != excluded.end()) {
+                continue;
+            }
+            double dx = locations[lotId].x - from.x;
+            double dy = locations[lotId].y - from.y;
+            double distance = dx * dx + dy * dy;
+            if (distance < nearestDistance) {
+                nearestDistance = distance;
+                nearest = lotId;
+            }
+        }
+    }
+    return nearest;
+}
+
+int ParkingNetwork::findNearestLot(VehicleType vehicleType, LotLocation from) const {
+    return findNearest(vehicleType, from, std::vector<int>());
+}
+
+std::vector<int> ParkingNetwork::findNearestLots(const std::vector<AvailabilityQuery>& queries, int threads) const {
+    std::vector<int> results(queries.size(), -1);
+    auto answer = [&](size_t begin, size_t end) {
+        std::vector<int> none;
+        for (size_t i = begin; i < end; ++i) {
+            results[i] = findNearest(queries[i].vehicleType, queries[i].from, none);
+        }
+    };
+    
+    size_t workers = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min(workers, queries.size() / MIN_QUERIES_PER_THREAD);
+    if (workers <= 1) {
+        answer(0, queries.size());
+        return results;
+    }
+    
+    // The calling thread takes the last chunk
+    size_t chunk = (queries.size() + workers - 1) / workers;
+    std::vector<std::thread> pool;
+    for (size_t begin = 0; begin + chunk < queries.size(); begin += chunk) {
+        pool.emplace_back(answer, begin, begin + chunk);
+    }
+    answer(pool.size() * chunk, queries.size());
+    for (auto& worker : pool) {
+        worker.join();
+    }
+    return results;
+}
+
+NetworkTicket ParkingNetwork::parkNearest(const Vehicle& vehicle, LotLocation from) {
+    std::vector<int> tried;
+    for (int attempt = 0; attempt < MAX_PARK_ATTEMPTS; ++attempt) {
+        int lotId = findNearest(vehicle.getType(), from, tried);
+        if (lotId < 0) {
+            break;
+        }
+        auto ticket = lots[lotId]->lot->parkVehicle(vehicle);
+        if (ticket) {
+            return NetworkTicket{lotId, ticket};
+        }
+        tried.push_back(lotId); // filled up since the index was read
+    }
+    return NetworkTicket{-1, nullptr};
+}
+
+double ParkingNetwork::exitParking(int lotId, ParkingId ticketId) {
+    if (lotId < 0 || lotId >= getLotCount()) return -1.0;
+    return lots[lotId]->lot->exitParking(ticketId);
+}
+
+int ParkingNetwork::getLotCount() const {
+    return lotCount.load(std::memory_order_acquire);
+}
+
+ParkingLot& ParkingNetwork::getLot(int lotId) {
+    return *lots[lotId]->lot;
+}
+
+const ParkingLot& ParkingNetwork::getLot(int lotId) const {
+    return *lots[lotId]->lot;
+}
+
+LotLocation ParkingNetwork::getLocation(int lotId) const {
+    return locations[lotId];
+}
+
+int ParkingNetwork::getAvailableSpaces(VehicleType type) const {
+    int available = freeTotals[static_cast<int>(type)].load(std::memory_order_relaxed);
+    if (type == VehicleType::CAR) {
+        available += freeTotals[static_cast<int>(VehicleType::TRUCK)].load(std::memory_order_relaxed);
+    }
+    return available;
+}
@@ -0,0 +1,88 @@
+#ifndef PARKING_NETWORK_H
+#define PARKING_NETWORK_H
+
+#include "ParkingLot.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Position on the city's planar grid, in kilometres
+struct LotLocation {
+    double x;
+    double y;
+};
+
+struct AvailabilityQuery {
+    VehicleType vehicleType;
+    LotLocation from;
+};
+
+struct NetworkTicket {
+    int lotId; // -1 if no lot could take the vehicle
+    std::shared_ptr<ParkingTicket> ticket;
+};
+
+// Federation of parking lots with a live availability index. Every lot
+// reports free-count changes through its availability listener; the network
+// keeps per slot type a running total and a bitmap of lots with a free slot
+// of that type, flipping a lot's bit only when its count crosses zero.
+// Nearest-lot queries scan the bitmap words and the contiguous lot
+// coordinates, never the lots themselves, so they are lock-free and take
+// microseconds for thousands of lots.
+//
+// Thread-safe for queries, parking and exits from any thread. Lots are added
+// up front, up to the capacity given at construction.
+class ParkingNetwork {
+private:
+    struct LotEntry {
+        std::unique_ptr<ParkingLot> lot;
+        std::mutex indexMutex; // orders this lot's bitmap updates
+    };
+    
+    int maxLots;
+    std::atomic<int> lotCount;
+    std::vector<std::unique_ptr<LotEntry>> lots;
+    std::vector<LotLocation> locations;
+    // Bit `lotId` of word lotId / 64 is set while the lot has a free slot of the type
+    std::array<std::unique_ptr<std::atomic<uint64_t>[]>, VEHICLE_TYPE_COUNT> availableLots;
+    std::array<std::atomic<int>, VEHICLE_TYPE_COUNT> freeTotals;
+    std::mutex addMutex;
+    
+    void onAvailabilityChange(int lotId, VehicleType slotType, int freeBefore, int freeAfter);
+    void refreshIndex(int lotId, VehicleType slotType);
+    // Nearest lot with a slot accepting `vehicleType`, skipping lots in `excluded`
+    int findNearest(VehicleType vehicleType, LotLocation from, const std::vector<int>& excluded) const;
+    
+public:
+    explicit ParkingNetwork(int maxLots);
+    ParkingNetwork(const ParkingNetwork&) = delete;
+    ParkingNetwork& operator=(const ParkingNetwork&) = delete;
+    
+    // Takes ownership of a lot that is not yet taking traffic; returns its id,
+    // or -1 once the network is at capacity
+    int addLot(std::unique_ptr<ParkingLot> lot, LotLocation location);
+    
+    // Nearest lot with a slot for `vehicleType`, or -1 if every lot is full
+    int findNearestLot(VehicleType vehicleType, LotLocation from) const;
+    // Answers queries in order, split across up to `threads` threads
+    // (0 = one per core); small batches run on the calling thread
+    std::vector<int> findNearestLots(const std::vector<AvailabilityQuery>& queries, int threads = 0) const;
+    
+    // Parks at the nearest lot with room, moving on to the next nearest if
+    // that lot fills up in the meantime
+    NetworkTicket parkNearest(const Vehicle& vehicle, LotLocation from);
+    double exitParking(int lotId, ParkingId ticketId);
+    
+    // Getters
+    int getLotCount() const;
+    ParkingLot& getLot(int lotId);
+    const ParkingLot& getLot(int lotId) const;
+    LotLocation getLocation(int lotId) const;
+    // Network-wide free slots for `type`, including the car-to-truck fallback
+    int getAvailableSpaces(VehicleType type) const;
+};
+
+#endif // PARKING_NETWORK_H
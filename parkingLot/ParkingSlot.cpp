@@ -1,40 +1,63 @@
-#include "../include/ParkingSlot.h"
-
-ParkingSlot::ParkingSlot(int number, VehicleType type)
-    : slotNumber(number), isOccupied(false), slotType(type) {}
-
-bool ParkingSlot::isAvailable() const {
-    return !isOccupied;
-}
-
-bool ParkingSlot::canPark(VehicleType vehicleType) const {
-    return !isOccupied && (slotType == vehicleType || 
-                          (slotType == VehicleType::TRUCK && vehicleType == VehicleType::CAR));
-}
-
-bool ParkingSlot::parkVehicle(std::shared_ptr<Vehicle> vehicle) {
-    if (!isOccupied && (slotType == vehicle->getType() || 
-                       (slotType == VehicleType::TRUCK && vehicle->getType() == VehicleType::CAR))) {
-        parkedVehicle = vehicle;
-        isOccupied = true;
-        return true;
-    }
-    return false;
-}
-
-void ParkingSlot::vacateSlot() {
-    parkedVehicle = nullptr;
-    isOccupied = false;
-}
-
-int ParkingSlot::getSlotNumber() const {
-    return slotNumber;
-}
-
-VehicleType ParkingSlot::getSlotType() const {
-    return slotType;
-}
-
-std::shared_ptr<Vehicle> ParkingSlot::getParkedVehicle() const {
-    return parkedVehicle;
-}
+#include "../include/ParkingSlot.h"
+
+SlotStore::SlotStore(const std::vector<VehicleType>& slotTypes)
+    : types(slotTypes), occupants(new std::atomic<uint32_t>[slotTypes.size()]) {
+    for (size_t i = 0; i < slotTypes.size(); ++i) {
+        occupants[i].store(VehiclePool::NO_VEHICLE, std::memory_order_relaxed);
+    }
+}
+
+int SlotStore::size() const {
+    return static_cast<int>(types.size());
+}
+
+VehicleType SlotStore::getType(int index) const {
+    return types[index];
+}
+
+std::atomic<uint32_t>& SlotStore::occupant(int index) {
+    return occupants[index];
+}
+
+const std::atomic<uint32_t>& SlotStore::occupant(int index) const {
+    return occupants[index];
+}
+
+ParkingSlot::ParkingSlot(SlotStore& store, int index)
+    : store(&store), index(index) {}
+
+bool ParkingSlot::accepts(VehicleType slotType, VehicleType vehicleType) {
+    return slotType == vehicleType || (slotType == VehicleType::TRUCK && vehicleType == VehicleType::CAR);
+}
+
+bool ParkingSlot::isAvailable() const {
+    return store->occupant(index).load(std::memory_order_acquire) == VehiclePool::NO_VEHICLE;
+}
+
+bool ParkingSlot::canPark(VehicleType vehicleType) const {
+    return isAvailable() && accepts(getSlotType(), vehicleType);
+}
+
+bool ParkingSlot::parkVehicle(uint32_t vehicleIndex, VehicleType vehicleType) {
+    if (vehicleIndex == VehiclePool::NO_VEHICLE || !accepts(getSlotType(), vehicleType)) {
+        return false;
+    }
+    uint32_t expected = VehiclePool::NO_VEHICLE;
+    return store->occupant(index).compare_exchange_strong(expected, vehicleIndex, std::memory_order_acq_rel);
+}
+
+uint32_t ParkingSlot::vacateSlot() {
+    return store->occupant(index).exchange(VehiclePool::NO_VEHICLE, std::memory_order_acq_rel);
+}
+
+int ParkingSlot::getSlotNumber() const {
+    return index + 1;
+}
+
+VehicleType ParkingSlot::getSlotType() const {
+    return store->getType(index);
+}
+
+uint32_t ParkingSlot::getParkedVehicleIndex() const {
+    return store->occupant(index).load(std::memory_order_acquire);
+}
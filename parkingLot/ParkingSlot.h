@@ -1,29 +1,56 @@
-#ifndef PARKING_SLOT_H
-#define PARKING_SLOT_H
-
-#include "Vehicle.h"
-#include <memory>
-
-class ParkingSlot {
-private:
-    int slotNumber;
-    bool isOccupied;
-    std::shared_ptr<Vehicle> parkedVehicle;
-    VehicleType slotType;
-    
-public:
-    ParkingSlot(int number, VehicleType type);
-    
-    // Core functionality
-    bool isAvailable() const;
-    bool canPark(VehicleType vehicleType) const;
-    bool parkVehicle(std::shared_ptr<Vehicle> vehicle);
-    void vacateSlot();
-    
-    // Getters
-    int getSlotNumber() const;
-    VehicleType getSlotType() const;
-    std::shared_ptr<Vehicle> getParkedVehicle() const;
-};
-
-#endif // PARKING_SLOT_H
+#ifndef PARKING_SLOT_H
+#define PARKING_SLOT_H
+
+#include "Vehicle.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Struct-of-arrays storage for every slot of a lot: one byte of slot type and
+// one atomic word naming the parked vehicle (its VehiclePool index), so a
+// slot costs five bytes and scans walk contiguous memory.
+class SlotStore {
+private:
+    std::vector<VehicleType> types;
+    std::unique_ptr<std::atomic<uint32_t>[]> occupants; // VehiclePool::NO_VEHICLE when free
+    
+public:
+    explicit SlotStore(const std::vector<VehicleType>& slotTypes);
+    SlotStore(const SlotStore&) = delete;
+    SlotStore& operator=(const SlotStore&) = delete;
+    
+    int size() const;
+    VehicleType getType(int index) const;
+    std::atomic<uint32_t>& occupant(int index);
+    const std::atomic<uint32_t>& occupant(int index) const;
+};
+
+// Lightweight handle to one slot of a SlotStore; copy it freely. Safe to use
+// from several gates: parkVehicle claims the slot with a CAS on its occupant
+// word, so exactly one of several racing callers succeeds.
+class ParkingSlot {
+private:
+    SlotStore* store;
+    int index;
+    
+public:
+    ParkingSlot(SlotStore& store, int index);
+    
+    // Whether a slot of `slotType` accepts a vehicle of `vehicleType`
+    static bool accepts(VehicleType slotType, VehicleType vehicleType);
+    
+    // Core functionality
+    bool isAvailable() const;
+    bool canPark(VehicleType vehicleType) const;
+    bool parkVehicle(uint32_t vehicleIndex, VehicleType vehicleType);
+    // Returns the index of the vehicle that was parked, or NO_VEHICLE
+    uint32_t vacateSlot();
+    
+    // Getters
+    int getSlotNumber() const;
+    VehicleType getSlotType() const;
+    uint32_t getParkedVehicleIndex() const;
+};
+
+#endif // PARKING_SLOT_H
@@ -0,0 +1,188 @@
+#include "../include/ParkingSnapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char MAGIC[8] = {'P', 'L', 'S', 'N', 'A', 'P', '0', '2'};
+
+// Host byte order; the body (everything after the header) is checksummed
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t slotCount;
+    uint32_t checksum;
+    uint64_t coveredSequence;
+    uint64_t ticketCount;
+    uint64_t licenseBytes;
+    uint64_t reservedPaymentSequence;
+    uint32_t issuedCount; // last issued ticket ids, 8 bytes each
+    uint32_t reserved;
+};
+
+struct SnapshotTicket {
+    uint64_t ticketId;
+    int64_t entryTime; // ns since epoch
+    int32_t slotNumber;
+    uint32_t licenseOffset;
+    uint16_t licenseLength;
+    uint8_t vehicleType;
+    uint8_t reserved[5];
+};
+
+static_assert(sizeof(SnapshotHeader) == 56, "snapshot header layout");
+static_assert(sizeof(SnapshotTicket) == 32, "snapshot ticket layout");
+
+size_t alignUp(size_t value) {
+    return (value + 7) & ~size_t(7);
+}
+
+} // namespace
+
+bool ParkingSnapshot::write(const std::string& path, const SnapshotContents& contents) {
+    uint64_t licenseBytes = 0;
+    for (const TicketRecord& ticket : contents.tickets) {
+        licenseBytes += std::min<size_t>(ticket.licenseNumber.size(), 0xFFFF);
+    }
+    size_t slotsOffset = sizeof(SnapshotHeader);
+    size_t issuedOffset = alignUp(slotsOffset + contents.slotTypes.size());
+    size_t ticketsOffset = issuedOffset + contents.lastIssuedTicketIds.size() * sizeof(uint64_t);
+    size_t licensesOffset = ticketsOffset + contents.tickets.size() * sizeof(SnapshotTicket);
+    size_t fileSize = licensesOffset + licenseBytes;
+    
+    std::string tempPath = path + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(fileSize)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    void* mapping = ::mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+    char* base = static_cast<char*>(mapping);
+    
+    for (size_t i = 0; i < contents.slotTypes.size(); ++i) {
+        base[slotsOffset + i] = static_cast<char>(contents.slotTypes[i]);
+    }
+    for (size_t i = 0; i < contents.lastIssuedTicketIds.size(); ++i) {
+        uint64_t id = contents.lastIssuedTicketIds[i].getValue();
+        std::memcpy(base + issuedOffset + i * sizeof(uint64_t), &id, sizeof(id));
+    }
+    SnapshotTicket* entries = reinterpret_cast<SnapshotTicket*>(base + ticketsOffset);
+    uint32_t licenseOffset = 0;
+    for (size_t i = 0; i < contents.tickets.size(); ++i) {
+        const TicketRecord& ticket = contents.tickets[i];
+        SnapshotTicket& entry = entries[i];
+        entry = SnapshotTicket();
+        entry.ticketId = ticket.ticketId.getValue();
+        entry.entryTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            ticket.entryTime.time_since_epoch()).count();
+        entry.slotNumber = ticket.slotNumber;
+        entry.licenseOffset = licenseOffset;
+        entry.licenseLength = static_cast<uint16_t>(std::min<size_t>(ticket.licenseNumber.size(), 0xFFFF));
+        entry.vehicleType = static_cast<uint8_t>(ticket.vehicleType);
+        std::memcpy(base + licensesOffset + licenseOffset, ticket.licenseNumber.data(), entry.licenseLength);
+        licenseOffset += entry.licenseLength;
+    }
+    
+    SnapshotHeader header = SnapshotHeader();
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.slotCount = static_cast<uint32_t>(contents.slotTypes.size());
+    header.coveredSequence = contents.coveredSequence;
+    header.ticketCount = contents.tickets.size();
+    header.licenseBytes = licenseBytes;
+    header.reservedPaymentSequence = contents.reservedPaymentSequence;
+    header.issuedCount = static_cast<uint32_t>(contents.lastIssuedTicketIds.size());
+    header.checksum = ParkingJournal::checksum(base + slotsOffset, fileSize - slotsOffset);
+    std::memcpy(base, &header, sizeof(header));
+    
+    bool synced = ::msync(mapping, fileSize, MS_SYNC) == 0;
+    ::munmap(mapping, fileSize);
+    synced = ::fsync(fd) == 0 && synced;
+    ::close(fd);
+    if (!synced || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        return false;
+    }
+    
+    // Make the rename itself durable
+    std::string directory = path.substr(0, path.find_last_of('/') + 1);
+    int dirFd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+    return true;
+}
+
+bool ParkingSnapshot::load(const std::string& path, SnapshotContents& contents) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SnapshotHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size_t fileSize = static_cast<size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    ::madvise(mapping, fileSize, MADV_SEQUENTIAL);
+    const char* base = static_cast<const char*>(mapping);
+    
+    SnapshotHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    size_t slotsOffset = sizeof(SnapshotHeader);
+    size_t issuedOffset = alignUp(slotsOffset + header.slotCount);
+    size_t ticketsOffset = issuedOffset + size_t(header.issuedCount) * sizeof(uint64_t);
+    size_t licensesOffset = ticketsOffset + header.ticketCount * sizeof(SnapshotTicket);
+    bool valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                 header.ticketCount <= fileSize / sizeof(SnapshotTicket) &&
+                 licensesOffset + header.licenseBytes == fileSize &&
+                 ParkingJournal::checksum(base + slotsOffset, fileSize - slotsOffset) == header.checksum;
+    
+    if (valid) {
+        contents.coveredSequence = header.coveredSequence;
+        contents.reservedPaymentSequence = header.reservedPaymentSequence;
+        contents.lastIssuedTicketIds.clear();
+        for (uint32_t i = 0; i < header.issuedCount; ++i) {
+            uint64_t id;
+            std::memcpy(&id, base + issuedOffset + i * sizeof(uint64_t), sizeof(id));
+            contents.lastIssuedTicketIds.push_back(ParkingId(id));
+        }
+        contents.slotTypes.assign(reinterpret_cast<const VehicleType*>(base + slotsOffset),
+                                  reinterpret_cast<const VehicleType*>(base + slotsOffset) + header.slotCount);
+        contents.tickets.clear();
+        contents.tickets.reserve(header.ticketCount);
+        const SnapshotTicket* entries = reinterpret_cast<const SnapshotTicket*>(base + ticketsOffset);
+        for (uint64_t i = 0; i < header.ticketCount && valid; ++i) {
+            const SnapshotTicket& entry = entries[i];
+            if (uint64_t(entry.licenseOffset) + entry.licenseLength > header.licenseBytes) {
+                valid = false;
+                break;
+            }
+            TicketRecord ticket;
+            ticket.ticketId = ParkingId(entry.ticketId);
+            ticket.slotNumber = entry.slotNumber;
+            ticket.vehicleType = static_cast<VehicleType>(entry.vehicleType);
+            ticket.licenseNumber.assign(base + licensesOffset + entry.licenseOffset, entry.licenseLength);
+            ticket.entryTime = std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(entry.entryTime)));
+            contents.tickets.push_back(std::move(ticket));
+        }
+    }
+    ::munmap(mapping, fileSize);
+    return valid;
+}
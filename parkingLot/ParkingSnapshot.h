@@ -0,0 +1,32 @@
+#ifndef PARKING_SNAPSHOT_H
+#define PARKING_SNAPSHOT_H
+
+#include "ParkingJournal.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct SnapshotContents {
+    uint64_t coveredSequence; // journal events up to here are reflected
+    std::vector<VehicleType> slotTypes;
+    std::vector<TicketRecord> tickets;
+    // High-water marks, so ids of tickets and payments that are gone are
+    // never issued again: the last id of each ticket shard, and the highest
+    // payment sequence reserved
+    std::vector<ParkingId> lastIssuedTicketIds;
+    uint64_t reservedPaymentSequence = 0;
+};
+
+// Point-in-time image of a lot's slot table and active tickets, written and
+// read through a memory mapping. The file is a fixed header, one byte per
+// slot type, the last issued id of each ticket shard, one 32-byte entry per
+// ticket and a trailing block of license numbers, guarded by a checksum. It is written to a temporary name and
+// renamed into place, so a crash mid-write leaves the previous snapshot.
+class ParkingSnapshot {
+public:
+    static bool write(const std::string& path, const SnapshotContents& contents);
+    // False if the file is missing, truncated or corrupt
+    static bool load(const std::string& path, SnapshotContents& contents);
+};
+
+#endif // PARKING_SNAPSHOT_H
@@ -0,0 +1,171 @@
+#include "../include/ParkingStore.h"
+#include "../include/ParkingSnapshot.h"
+#include "../include/Payment.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <unordered_map>
+#include <unistd.h>
+
+namespace {
+
+// Set while some store journals the process's payment reservations
+std::atomic<bool> paymentSequenceClaimed(false);
+
+} // namespace
+
+ParkingStore::ParkingStore(const std::string& dir)
+    : directory(dir), lot(nullptr), stopping(false), ownsPaymentSequence(false), recoveredPaymentSequence(0) {}
+
+ParkingStore::~ParkingStore() {
+    stopCheckpoints();
+    if (ownsPaymentSequence) {
+        Payment::setSequenceReserver(nullptr, 0);
+        paymentSequenceClaimed.store(false);
+    }
+    if (lot) {
+        lot->attachJournal(nullptr);
+    }
+    journal.close();
+}
+
+std::string ParkingStore::snapshotPath() const {
+    return directory + "/snapshot.bin";
+}
+
+int ParkingStore::recover(ParkingLot& parkingLot) {
+    SnapshotContents snapshot{0, {}, {}, {}, 0};
+    if (::access(snapshotPath().c_str(), F_OK) == 0) {
+        if (!ParkingSnapshot::load(snapshotPath(), snapshot)) {
+            return -1;
+        }
+        if (static_cast<int>(snapshot.slotTypes.size()) != parkingLot.getTotalSpaces()) {
+            return -1;
+        }
+        for (size_t i = 0; i < snapshot.slotTypes.size(); ++i) {
+            if (snapshot.slotTypes[i] != parkingLot.getSlotType(static_cast<int>(i) + 1)) {
+                return -1;
+            }
+        }
+    }
+    
+    // Replay journal events the snapshot does not cover. Events of one ticket
+    // are in order; a park or exit already reflected in the snapshot is
+    // harmless to apply again.
+    std::unordered_map<ParkingId, TicketRecord, ParkingIdHash> active;
+    active.reserve(snapshot.tickets.size());
+    for (TicketRecord& ticket : snapshot.tickets) {
+        ParkingId id = ticket.ticketId;
+        active.emplace(id, std::move(ticket));
+    }
+    uint64_t lastSequence = snapshot.coveredSequence;
+    // Every ticket ever issued, not only the active ones, holds its number
+    std::vector<ParkingId> issued = snapshot.lastIssuedTicketIds;
+    uint64_t reservedPayments = snapshot.reservedPaymentSequence;
+    std::vector<JournalEvent> events;
+    for (uint64_t segment : ParkingJournal::listSegments(directory)) {
+        events.clear();
+        if (!ParkingJournal::readSegment(ParkingJournal::segmentPath(directory, segment), events)) {
+            return -1;
+        }
+        for (JournalEvent& event : events) {
+            if (event.sequence <= snapshot.coveredSequence) {
+                continue;
+            }
+            lastSequence = std::max(lastSequence, event.sequence);
+            if (event.kind == JournalEventKind::PARK) {
+                issued.push_back(event.ticket.ticketId);
+                active[event.ticket.ticketId] = std::move(event.ticket);
+            } else if (event.kind == JournalEventKind::EXIT) {
+                active.erase(event.ticket.ticketId);
+            } else if (event.kind == JournalEventKind::RESERVE_PAYMENTS) {
+                reservedPayments = std::max(reservedPayments, event.ticket.ticketId.getValue());
+            }
+        }
+    }
+    
+    std::vector<TicketRecord> tickets;
+    tickets.reserve(active.size());
+    for (auto& entry : active) {
+        tickets.push_back(std::move(entry.second));
+    }
+    int restored = parkingLot.restoreTickets(tickets);
+    parkingLot.resumeTicketSequences(issued);
+    
+    if (!journal.open(directory, lastSequence)) {
+        return -1;
+    }
+    lot = &parkingLot;
+    lot->attachJournal(&journal);
+    
+    recoveredPaymentSequence = reservedPayments;
+    bool unclaimed = false;
+    if (!ownsPaymentSequence && paymentSequenceClaimed.compare_exchange_strong(unclaimed, true)) {
+        ownsPaymentSequence = true;
+        Payment::setSequenceReserver([this](uint64_t limit) {
+            return journal.waitDurable(journal.appendPaymentReservation(limit));
+        }, reservedPayments);
+    } else {
+        Payment::resumeSequenceAfter(reservedPayments);
+    }
+    return restored;
+}
+
+bool ParkingStore::checkpoint() {
+    std::lock_guard<std::mutex> lock(checkpointMutex);
+    if (!lot) {
+        return false;
+    }
+    
+    // Every event up to `covered` is durable and was recorded on its ticket
+    // as it was journaled. The snapshot takes the lot exactly as of `covered`:
+    // later parks (which may yet be undone) are left out and later exits kept,
+    // and replaying the live segments applies whichever of them became durable.
+    uint64_t covered = 0;
+    uint64_t firstLiveSegment = 0;
+    if (!journal.rotate(covered, firstLiveSegment)) {
+        return false;
+    }
+    // Read after the rotation too: at least as high as anything covered
+    SnapshotContents snapshot{covered, {}, lot->getActiveTickets(covered), lot->getLastIssuedTicketIds(),
+                              std::max(Payment::getReservedSequence(), recoveredPaymentSequence)};
+    snapshot.slotTypes.reserve(lot->getTotalSpaces());
+    for (int slotNumber = 1; slotNumber <= lot->getTotalSpaces(); ++slotNumber) {
+        snapshot.slotTypes.push_back(lot->getSlotType(slotNumber));
+    }
+    if (!ParkingSnapshot::write(snapshotPath(), snapshot)) {
+        return false;
+    }
+    
+    for (uint64_t segment : ParkingJournal::listSegments(directory)) {
+        if (segment < firstLiveSegment) {
+            std::remove(ParkingJournal::segmentPath(directory, segment).c_str());
+        }
+    }
+    return true;
+}
+
+void ParkingStore::startCheckpoints(std::chrono::seconds interval) {
+    stopCheckpoints();
+    stopping = false;
+    checkpointer = std::thread([this, interval] {
+        std::unique_lock<std::mutex> lock(stopMutex);
+        while (!stopWake.wait_for(lock, interval, [this] { return stopping; })) {
+            lock.unlock();
+            checkpoint();
+            lock.lock();
+        }
+    });
+}
+
+void ParkingStore::stopCheckpoints() {
+    if (!checkpointer.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = true;
+    }
+    stopWake.notify_all();
+    checkpointer.join();
+}
@@ -0,0 +1,57 @@
+#ifndef PARKING_STORE_H
+#define PARKING_STORE_H
+
+#include "ParkingJournal.h"
+#include "ParkingLot.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Durable state for one ParkingLot in its own directory: journal segments
+// plus "snapshot.bin". recover() loads the snapshot, replays the journal
+// events after it and attaches a fresh journal segment to the lot.
+// checkpoint() rotates the journal, snapshots the lot and deletes the
+// segments the snapshot now covers, so restart cost is bounded by the
+// snapshot size plus the events since the last checkpoint.
+// The first store to recover in a process also journals the payment
+// sequence reservations (see Payment::setSequenceReserver) until it is
+// destroyed; every store's snapshots keep the highest reservation it has
+// seen, so payment ids survive a restart as ticket ids do as long as all
+// stores recover before payments are taken.
+class ParkingStore {
+private:
+    std::string directory;
+    ParkingJournal journal;
+    ParkingLot* lot;
+    
+    std::mutex checkpointMutex;
+    std::mutex stopMutex;
+    std::condition_variable stopWake;
+    bool stopping;
+    std::thread checkpointer;
+    bool ownsPaymentSequence;
+    uint64_t recoveredPaymentSequence;
+    
+    std::string snapshotPath() const;
+    
+public:
+    explicit ParkingStore(const std::string& directory);
+    ~ParkingStore();
+    ParkingStore(const ParkingStore&) = delete;
+    ParkingStore& operator=(const ParkingStore&) = delete;
+    
+    // Rebuilds `lot`, which must be new and not yet taking traffic, and
+    // journals its changes from then on. Returns the number of tickets
+    // restored, or -1 if the stored state is unreadable, belongs to a lot
+    // with a different slot layout, or the journal cannot be opened.
+    int recover(ParkingLot& lot);
+    
+    // Safe while gates are parking; false if the snapshot was not written
+    bool checkpoint();
+    void startCheckpoints(std::chrono::seconds interval);
+    void stopCheckpoints();
+};
+
+#endif // PARKING_STORE_H
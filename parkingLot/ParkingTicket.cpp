@@ -1,44 +1,73 @@
-#include "../include/ParkingTicket.h"
-
-ParkingTicket::ParkingTicket(const std::string& number, std::shared_ptr<Vehicle> vehicle, int slotNum)
-    : ticketNumber(number), vehicle(vehicle), slotNumber(slotNum), 
-      entryTime(std::chrono::system_clock::now()), isPaid(false) {}
-
-void ParkingTicket::markExit() {
-    exitTime = std::chrono::system_clock::now();
-}
-
-double ParkingTicket::calculateFee(double hourlyRate) {
-    auto duration = std::chrono::duration_cast<std::chrono::hours>(
-        std::chrono::system_clock::now() - entryTime);
-    double hours = duration.count() + 1; // Round up to the next hour
-    amountCharged = hours * hourlyRate;
-    return amountCharged;
-}
-
-void ParkingTicket::processPayment(double amount) {
-    if (amount >= amountCharged) {
-        isPaid = true;
-        markExit();
-    }
-}
-
-std::string ParkingTicket::getTicketNumber() const {
-    return ticketNumber;
-}
-
-bool ParkingTicket::isTicketPaid() const {
-    return isPaid;
-}
-
-std::string ParkingTicket::getVehicleLicenseNumber() const {
-    return vehicle ? vehicle->getLicenseNumber() : "";
-}
-
-int ParkingTicket::getSlotNumber() const {
-    return slotNumber;
-}
-
-std::chrono::system_clock::duration ParkingTicket::getParkingDuration() const {
-    return exitTime - entryTime;
-}
+#include "../include/ParkingTicket.h"
+
+ParkingTicket::ParkingTicket(ParkingId id, const Vehicle& vehicle, int slotNum)
+    : ticketId(id), entryTime(std::chrono::system_clock::now()), entryTick(std::chrono::steady_clock::now()),
+      amountCharged(-1.0), isPaid(false), licenseNumber(vehicle.getLicenseNumber()),
+      vehicleType(vehicle.getType()), slotNumber(slotNum) {}
+
+ParkingTicket::ParkingTicket(ParkingId id, const Vehicle& vehicle, int slotNum,
+                             std::chrono::system_clock::time_point entry)
+    : ticketId(id), entryTime(entry),
+      // A recovered entry time predates this process's monotonic clock, so
+      // place the entry tick the same distance in the past
+      entryTick(std::chrono::steady_clock::now() - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::system_clock::now() - entry)),
+      amountCharged(-1.0), isPaid(false), licenseNumber(vehicle.getLicenseNumber()),
+      vehicleType(vehicle.getType()), slotNumber(slotNum) {}
+
+void ParkingTicket::markExit() {
+    exitTime = std::chrono::system_clock::now();
+}
+
+double ParkingTicket::calculateFee(const TariffEngine& tariff, std::chrono::steady_clock::time_point now) {
+    amountCharged = tariff.calculateFee(vehicleType, tariff.hourOfDay(entryTime),
+                                        TariffEngine::billableHours(getStayDuration(now)));
+    return amountCharged;
+}
+
+void ParkingTicket::processPayment(double amount) {
+    if (amountCharged >= 0 && amount >= amountCharged) {
+        isPaid = true;
+        markExit();
+    }
+}
+
+ParkingId ParkingTicket::getTicketId() const {
+    return ticketId;
+}
+
+std::string ParkingTicket::getTicketNumber() const {
+    return ticketId.toString(ID_TAG);
+}
+
+bool ParkingTicket::isTicketPaid() const {
+    return isPaid;
+}
+
+std::string ParkingTicket::getVehicleLicenseNumber() const {
+    return licenseNumber;
+}
+
+VehicleType ParkingTicket::getVehicleType() const {
+    return vehicleType;
+}
+
+std::chrono::system_clock::time_point ParkingTicket::getEntryTime() const {
+    return entryTime;
+}
+
+double ParkingTicket::getAmountCharged() const {
+    return amountCharged;
+}
+
+int ParkingTicket::getSlotNumber() const {
+    return slotNumber;
+}
+
+std::chrono::system_clock::duration ParkingTicket::getParkingDuration() const {
+    return exitTime - entryTime;
+}
+
+std::chrono::steady_clock::duration ParkingTicket::getStayDuration(std::chrono::steady_clock::time_point now) const {
+    return now - entryTick;
+}
@@ -1,35 +1,50 @@
-#ifndef PARKING_TICKET_H
-#define PARKING_TICKET_H
-
-#include <string>
-#include <chrono>
-#include <memory>
-#include "Vehicle.h"
-
-class ParkingTicket {
-private:
-    std::string ticketNumber;
-    std::chrono::system_clock::time_point entryTime;
-    std::chrono::system_clock::time_point exitTime;
-    double amountCharged;
-    bool isPaid;
-    std::shared_ptr<Vehicle> vehicle;
-    int slotNumber;
-
-public:
-    ParkingTicket(const std::string& number, std::shared_ptr<Vehicle> vehicle, int slotNum);
-    
-    // Core functionality
-    void markExit();
-    double calculateFee(double hourlyRate);
-    void processPayment(double amount);
-    
-    // Getters
-    std::string getTicketNumber() const;
-    bool isTicketPaid() const;
-    std::string getVehicleLicenseNumber() const;
-    int getSlotNumber() const;
-    std::chrono::system_clock::duration getParkingDuration() const;
-};
-
-#endif // PARKING_TICKET_H
+#ifndef PARKING_TICKET_H
+#define PARKING_TICKET_H
+
+#include <string>
+#include <chrono>
+#include "ParkingId.h"
+#include "Tariff.h"
+#include "Vehicle.h"
+
+class ParkingTicket {
+public:
+    static constexpr const char* ID_TAG = "TKT";
+    
+private:
+    ParkingId ticketId;
+    std::chrono::system_clock::time_point entryTime; // wall clock, for bands and records
+    std::chrono::steady_clock::time_point entryTick; // monotonic, for the stay's length
+    std::chrono::system_clock::time_point exitTime;
+    double amountCharged; // -1 until a fee is calculated
+    bool isPaid;
+    std::string licenseNumber; // plates fit the small-string buffer, so no allocation
+    VehicleType vehicleType;
+    int slotNumber;
+
+public:
+    ParkingTicket(ParkingId id, const Vehicle& vehicle, int slotNum);
+    // Reissues a ticket recovered from the journal or a snapshot
+    ParkingTicket(ParkingId id, const Vehicle& vehicle, int slotNum, std::chrono::system_clock::time_point entry);
+    
+    // Core functionality
+    void markExit();
+    // Fee for the stay up to `now`, which the caller samples once; also
+    // stored as the amount charged
+    double calculateFee(const TariffEngine& tariff, std::chrono::steady_clock::time_point now);
+    void processPayment(double amount);
+    
+    // Getters
+    ParkingId getTicketId() const;
+    std::string getTicketNumber() const; // display form of the id
+    bool isTicketPaid() const;
+    double getAmountCharged() const;
+    std::string getVehicleLicenseNumber() const;
+    VehicleType getVehicleType() const;
+    std::chrono::system_clock::time_point getEntryTime() const;
+    int getSlotNumber() const;
+    std::chrono::system_clock::duration getParkingDuration() const;
+    std::chrono::steady_clock::duration getStayDuration(std::chrono::steady_clock::time_point now) const;
+};
+
+#endif // PARKING_TICKET_H
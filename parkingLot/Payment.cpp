@@ -1,42 +1,107 @@
-#include "../include/Payment.h"
-#include <sstream>
-#include <iomanip>
-
-Payment::Payment(std::shared_ptr<ParkingTicket> parkingTicket)
-    : ticket(parkingTicket), isCompleted(false) {
-    // Generate a simple payment ID (in a real system, this would be more sophisticated)
-    std::stringstream ss;
-    auto now = std::chrono::system_clock::now();
-    auto duration = now.time_since_epoch();
-    ss << "PAY" << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
-    paymentId = ss.str();
-}
-
-bool Payment::processPayment(double amount) {
-    if (!ticket) return false;
-    
-    if (amount >= ticket->calculateFee(10.0)) { // Assuming $10/hour rate for this example
-        this->amount = amount;
-        paymentTime = std::chrono::system_clock::now();
-        ticket->processPayment(amount);
-        isCompleted = true;
-        return true;
-    }
-    return false;
-}
-
-std::string Payment::getPaymentId() const {
-    return paymentId;
-}
-
-double Payment::getAmount() const {
-    return amount;
-}
-
-bool Payment::isPaymentCompleted() const {
-    return isCompleted;
-}
-
-std::string Payment::getAssociatedTicketNumber() const {
-    return ticket ? ticket->getTicketNumber() : "";
-}
+#include "../include/Payment.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+
+namespace {
+
+const uint64_t UNLIMITED = std::numeric_limits<uint64_t>::max();
+
+// Process-wide, so two payments can never share an id
+std::atomic<uint64_t> nextPaymentSequence(1);
+// Issuing past this takes reserveMutex and extends it through the reserver
+std::atomic<uint64_t> reservedThrough(UNLIMITED);
+std::mutex reserveMutex;
+Payment::SequenceReserver sequenceReserver;
+
+// 0 (an invalid id) if the sequence could not be reserved
+uint64_t issueSequence() {
+    uint64_t sequence = nextPaymentSequence.fetch_add(1, std::memory_order_relaxed);
+    if (sequence <= reservedThrough.load(std::memory_order_acquire)) {
+        return sequence;
+    }
+    std::lock_guard<std::mutex> lock(reserveMutex);
+    uint64_t limit = reservedThrough.load(std::memory_order_relaxed);
+    if (sequence > limit) {
+        // One durable write covers the next block of payments
+        uint64_t extended = sequence + Payment::RESERVATION_BLOCK - 1;
+        if (!sequenceReserver || !sequenceReserver(extended)) {
+            return 0;
+        }
+        reservedThrough.store(extended, std::memory_order_release);
+    }
+    return sequence;
+}
+
+} // namespace
+
+Payment::Payment(std::shared_ptr<ParkingTicket> parkingTicket)
+    : ticket(parkingTicket), isCompleted(false) {
+    uint64_t sequence = issueSequence();
+    if (sequence != 0) {
+        paymentId = ParkingId(parkingTicket ? parkingTicket->getTicketId().getPrefix() : 0, sequence);
+    }
+}
+
+void Payment::setSequenceReserver(SequenceReserver reserver, uint64_t lastReserved) {
+    std::lock_guard<std::mutex> lock(reserveMutex);
+    sequenceReserver = std::move(reserver);
+    if (!sequenceReserver) {
+        reservedThrough.store(UNLIMITED, std::memory_order_release);
+        return;
+    }
+    // Nothing past lastReserved is reserved yet; the next payment reserves it
+    uint64_t current = nextPaymentSequence.load(std::memory_order_relaxed);
+    while (current <= lastReserved &&
+           !nextPaymentSequence.compare_exchange_weak(current, lastReserved + 1, std::memory_order_relaxed)) {
+    }
+    reservedThrough.store(std::max(current, lastReserved + 1) - 1, std::memory_order_release);
+}
+
+void Payment::resumeSequenceAfter(uint64_t lastReserved) {
+    // Past the installed reservation, so the next payment extends it
+    uint64_t current = nextPaymentSequence.load(std::memory_order_relaxed);
+    while (current <= lastReserved &&
+           !nextPaymentSequence.compare_exchange_weak(current, lastReserved + 1, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t Payment::getReservedSequence() {
+    uint64_t limit = reservedThrough.load(std::memory_order_acquire);
+    return limit == UNLIMITED ? 0 : limit;
+}
+
+bool Payment::processPayment(double amount) {
+    // The lot calculates the fee on exit or quote; paying never recomputes it
+    if (!paymentId.isValid() || !ticket || ticket->getAmountCharged() < 0) return false;
+    
+    if (amount >= ticket->getAmountCharged()) {
+        this->amount = amount;
+        paymentTime = std::chrono::system_clock::now();
+        ticket->processPayment(amount);
+        isCompleted = true;
+        return true;
+    }
+    return false;
+}
+
+ParkingId Payment::getId() const {
+    return paymentId;
+}
+
+std::string Payment::getPaymentId() const {
+    return paymentId.toString(ID_TAG);
+}
+
+double Payment::getAmount() const {
+    return amount;
+}
+
+bool Payment::isPaymentCompleted() const {
+    return isCompleted;
+}
+
+std::string Payment::getAssociatedTicketNumber() const {
+    return ticket ? ticket->getTicketNumber() : "";
+}
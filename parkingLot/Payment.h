@@ -1,28 +1,49 @@
-#ifndef PAYMENT_H
-#define PAYMENT_H
-
-#include "ParkingTicket.h"
-#include <memory>
-
-class Payment {
-private:
-    std::string paymentId;
-    double amount;
-    std::chrono::system_clock::time_point paymentTime;
-    std::shared_ptr<ParkingTicket> ticket;
-    bool isCompleted;
-
-public:
-    Payment(std::shared_ptr<ParkingTicket> ticket);
-    
-    // Core functionality
-    bool processPayment(double amount);
-    
-    // Getters
-    std::string getPaymentId() const;
-    double getAmount() const;
-    bool isPaymentCompleted() const;
-    std::string getAssociatedTicketNumber() const;
-};
-
-#endif // PAYMENT_H
+#ifndef PAYMENT_H
+#define PAYMENT_H
+
+#include "ParkingTicket.h"
+#include <functional>
+#include <memory>
+
+class Payment {
+public:
+    static constexpr const char* ID_TAG = "PAY";
+    // Makes payment sequences up to `limit` durable; false if it could not
+    using SequenceReserver = std::function<bool(uint64_t limit)>;
+    static const uint64_t RESERVATION_BLOCK = 1024;
+    
+private:
+    ParkingId paymentId;
+    double amount;
+    std::chrono::system_clock::time_point paymentTime;
+    std::shared_ptr<ParkingTicket> ticket;
+    bool isCompleted;
+
+public:
+    Payment(std::shared_ptr<ParkingTicket> ticket);
+    
+    // Core functionality
+    bool processPayment(double amount);
+    
+    // Getters
+    ParkingId getId() const;
+    std::string getPaymentId() const; // display form of the id
+    double getAmount() const;
+    bool isPaymentCompleted() const;
+    std::string getAssociatedTicketNumber() const;
+    
+    // Restart safety. Payment sequences are process-wide; with a reserver
+    // installed they are issued only up to a limit it has made durable,
+    // RESERVATION_BLOCK at a time, and issuing resumes after
+    // `lastReserved`, the highest limit reserved before the restart. A
+    // payment created while no reservation can be made gets an invalid id and
+    // cannot be processed. Pass nullptr to issue without reservations again.
+    static void setSequenceReserver(SequenceReserver reserver, uint64_t lastReserved);
+    // Issue only after `lastReserved` from now on, e.g. a mark recovered by
+    // another store than the one reserving
+    static void resumeSequenceAfter(uint64_t lastReserved);
+    // Highest sequence the installed reserver has made durable
+    static uint64_t getReservedSequence();
+};
+
+#endif // PAYMENT_H
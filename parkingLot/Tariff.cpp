@@ -0,0 +1,107 @@
+#include "../include/Tariff.h"
+#include <algorithm>
+
+TariffPlan::TariffPlan(double hourlyRate)
+    : utcOffset(0) {
+    hourlyRates.fill(hourlyRate);
+    dailyCaps.fill(0.0);
+}
+
+TariffPlan& TariffPlan::setHourlyRate(VehicleType type, double rate) {
+    hourlyRates[static_cast<int>(type)] = rate;
+    return *this;
+}
+
+TariffPlan& TariffPlan::setDailyCap(VehicleType type, double cap) {
+    dailyCaps[static_cast<int>(type)] = cap;
+    return *this;
+}
+
+TariffPlan& TariffPlan::addBand(int startHour, int endHour, double multiplier) {
+    bands.push_back(TariffBand{startHour, endHour, multiplier});
+    return *this;
+}
+
+TariffPlan& TariffPlan::setUtcOffset(std::chrono::minutes offset) {
+    utcOffset = offset;
+    return *this;
+}
+
+double TariffPlan::getHourlyRate(VehicleType type) const {
+    return hourlyRates[static_cast<int>(type)];
+}
+
+double TariffPlan::getDailyCap(VehicleType type) const {
+    return dailyCaps[static_cast<int>(type)];
+}
+
+const std::vector<TariffBand>& TariffPlan::getBands() const {
+    return bands;
+}
+
+std::chrono::minutes TariffPlan::getUtcOffset() const {
+    return utcOffset;
+}
+
+TariffEngine::TariffEngine(const TariffPlan& plan)
+    : prefixCosts(VEHICLE_TYPE_COUNT * PREFIX_LENGTH, 0.0),
+      utcOffsetSeconds(std::chrono::duration_cast<std::chrono::seconds>(plan.getUtcOffset()).count()) {
+    std::array<double, HOURS_PER_DAY> multipliers;
+    multipliers.fill(1.0);
+    for (const TariffBand& band : plan.getBands()) {
+        int start = ((band.startHour % HOURS_PER_DAY) + HOURS_PER_DAY) % HOURS_PER_DAY;
+        int end = ((band.endHour % HOURS_PER_DAY) + HOURS_PER_DAY) % HOURS_PER_DAY;
+        int length = end > start ? end - start : end + HOURS_PER_DAY - start;
+        for (int i = 0; i < length; ++i) {
+            multipliers[(start + i) % HOURS_PER_DAY] = band.multiplier;
+        }
+    }
+    
+    for (int type = 0; type < VEHICLE_TYPE_COUNT; ++type) {
+        double rate = plan.getHourlyRate(static_cast<VehicleType>(type));
+        double* prefix = &prefixCosts[type * PREFIX_LENGTH];
+        for (int h = 0; h < 2 * HOURS_PER_DAY; ++h) {
+            prefix[h + 1] = prefix[h] + rate * multipliers[h % HOURS_PER_DAY];
+        }
+        double cap = plan.getDailyCap(static_cast<VehicleType>(type));
+        dailyCaps[type] = cap > 0 ? cap : prefix[HOURS_PER_DAY];
+        fullDayCosts[type] = std::min(dailyCaps[type], prefix[HOURS_PER_DAY]);
+    }
+}
+
+int TariffEngine::hourOfDay(std::chrono::system_clock::time_point time) const {
+    int64_t seconds = std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count() +
+                      utcOffsetSeconds;
+    int64_t hour = (seconds / 3600) % HOURS_PER_DAY;
+    return static_cast<int>(hour < 0 ? hour + HOURS_PER_DAY : hour);
+}
+
+int64_t TariffEngine::billableHours(std::chrono::steady_clock::duration stay) {
+    // Round up to the next hour, as a started hour is billed in full
+    return std::chrono::duration_cast<std::chrono::hours>(stay).count() + 1;
+}
+
+double TariffEngine::calculateFee(VehicleType type, int entryHour, int64_t hours) const {
+    int typeIndex = static_cast<int>(type);
+    const double* prefix = &prefixCosts[typeIndex * PREFIX_LENGTH];
+    int64_t days = hours / HOURS_PER_DAY;
+    int remainder = static_cast<int>(hours % HOURS_PER_DAY);
+    double partial = prefix[entryHour + remainder] - prefix[entryHour];
+    return days * fullDayCosts[typeIndex] + std::min(dailyCaps[typeIndex], partial);
+}
+
+void TariffEngine::calculateFees(const VehicleType* types, const uint8_t* entryHours, const int64_t* hours,
+                                 double* fees, size_t count) const {
+    const double* prefix = prefixCosts.data();
+    const double* caps = dailyCaps.data();
+    const double* fullDays = fullDayCosts.data();
+    for (size_t i = 0; i < count; ++i) {
+        int typeIndex = static_cast<int>(types[i]);
+        int64_t days = hours[i] / HOURS_PER_DAY;
+        int64_t remainder = hours[i] - days * HOURS_PER_DAY;
+        const double* row = prefix + typeIndex * PREFIX_LENGTH + entryHours[i];
+        double partial = row[remainder] - row[0];
+        double cap = caps[typeIndex];
+        fees[i] = days * fullDays[typeIndex] + (partial < cap ? partial : cap);
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef TARIFF_H
+#define TARIFF_H
+
+#include "Vehicle.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Time-of-day surcharge or discount: hours [startHour, endHour) of the local
+// day are billed at `multiplier` times the base rate. A band with endHour <=
+// startHour wraps past midnight. Later bands override earlier ones.
+struct TariffBand {
+    int startHour;
+    int endHour;
+    double multiplier;
+};
+
+// Pricing rules for a lot: an hourly base rate per vehicle type, time-of-day
+// bands, and a cap on what any 24 hours of a stay can cost.
+class TariffPlan {
+private:
+    std::array<double, VEHICLE_TYPE_COUNT> hourlyRates;
+    std::array<double, VEHICLE_TYPE_COUNT> dailyCaps; // <= 0 means uncapped
+    std::vector<TariffBand> bands;
+    std::chrono::minutes utcOffset;
+    
+public:
+    // Flat rate for every vehicle type, no bands, no caps, UTC
+    explicit TariffPlan(double hourlyRate);
+    
+    TariffPlan& setHourlyRate(VehicleType type, double rate);
+    TariffPlan& setDailyCap(VehicleType type, double cap);
+    TariffPlan& addBand(int startHour, int endHour, double multiplier);
+    // Offset of the lot's local time from UTC, for placing bands
+    TariffPlan& setUtcOffset(std::chrono::minutes offset);
+    
+    // Getters
+    double getHourlyRate(VehicleType type) const;
+    double getDailyCap(VehicleType type) const;
+    const std::vector<TariffBand>& getBands() const;
+    std::chrono::minutes getUtcOffset() const;
+};
+
+// A TariffPlan compiled into lookup tables at lot construction. Every started
+// hour of a stay is billed at the rate of the local hour it falls in; each
+// full 24 hours and the remainder are capped separately. Per vehicle type the
+// engine keeps prefix sums of the hourly rates over two days, so a fee is
+// two table reads and a few multiplies whatever the length of the stay.
+class TariffEngine {
+public:
+    static const int HOURS_PER_DAY = 24;
+    
+private:
+    static const int PREFIX_LENGTH = 2 * HOURS_PER_DAY + 1;
+    
+    // prefixCosts[type * PREFIX_LENGTH + h]: cost of local hours [0, h) over two days
+    std::vector<double> prefixCosts;
+    std::array<double, VEHICLE_TYPE_COUNT> dailyCaps;
+    std::array<double, VEHICLE_TYPE_COUNT> fullDayCosts;
+    int64_t utcOffsetSeconds;
+    
+public:
+    explicit TariffEngine(const TariffPlan& plan);
+    
+    // Local hour of day in [0, 24) of a wall-clock instant
+    int hourOfDay(std::chrono::system_clock::time_point time) const;
+    // Started hours of a stay; every stay bills at least one hour
+    static int64_t billableHours(std::chrono::steady_clock::duration stay);
+    
+    double calculateFee(VehicleType type, int entryHour, int64_t billableHours) const;
+    // Fees for `count` stays given as parallel arrays; one branch-free pass
+    void calculateFees(const VehicleType* types, const uint8_t* entryHours, const int64_t* hours,
+                       double* fees, size_t count) const;
+};
+
+#endif // TARIFF_H
@@ -1,12 +1,47 @@
-#include "../include/Vehicle.h"
-
-Vehicle::Vehicle(const std::string& licenseNum, VehicleType vehicleType)
-    : licenseNumber(licenseNum), type(vehicleType) {}
-
-std::string Vehicle::getLicenseNumber() const {
-    return licenseNumber;
-}
-
-VehicleType Vehicle::getType() const {
-    return type;
-}
+#include "../include/Vehicle.h"
+#include <functional>
+#include <thread>
+
+Vehicle::Vehicle(const std::string& licenseNum, VehicleType vehicleType)
+    : licenseNumber(licenseNum), type(vehicleType) {}
+
+std::string Vehicle::getLicenseNumber() const {
+    return licenseNumber;
+}
+
+VehicleType Vehicle::getType() const {
+    return type;
+}
+
+// An index is entry * SHARD_COUNT + shard, so it names its shard directly
+uint32_t VehiclePool::add(const Vehicle& vehicle) {
+    static thread_local const uint32_t homeShard =
+        static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()) % SHARD_COUNT);
+    Shard& shard = shards[homeShard];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    uint32_t entry;
+    if (!shard.freeEntries.empty()) {
+        entry = shard.freeEntries.back();
+        shard.freeEntries.pop_back();
+        shard.vehicles[entry] = vehicle;
+    } else {
+        entry = static_cast<uint32_t>(shard.vehicles.size());
+        shard.vehicles.push_back(vehicle);
+    }
+    return entry * SHARD_COUNT + homeShard;
+}
+
+void VehiclePool::remove(uint32_t index) {
+    if (index == NO_VEHICLE) return;
+    Shard& shard = shards[index % SHARD_COUNT];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.freeEntries.push_back(index / SHARD_COUNT);
+}
+
+std::string VehiclePool::getLicenseNumber(uint32_t index) const {
+    if (index == NO_VEHICLE) return "";
+    const Shard& shard = shards[index % SHARD_COUNT];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    uint32_t entry = index / SHARD_COUNT;
+    return entry < shard.vehicles.size() ? shard.vehicles[entry].getLicenseNumber() : "";
+}
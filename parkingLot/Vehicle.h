@@ -1,26 +1,65 @@
-#ifndef VEHICLE_H
-#define VEHICLE_H
-
-#include <string>
-
-enum class VehicleType {
-    CAR,
-    TRUCK,
-    MOTORCYCLE,
-    ELECTRIC
-};
-
-class Vehicle {
-private:
-    std::string licenseNumber;
-    VehicleType type;
-
-public:
-    Vehicle(const std::string& licenseNum, VehicleType vehicleType);
-    
-    // Getters
-    std::string getLicenseNumber() const;
-    VehicleType getType() const;
-};
-
-#endif // VEHICLE_H
+#ifndef VEHICLE_H
+#define VEHICLE_H
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// One byte so per-slot type arrays stay compact
+enum class VehicleType : uint8_t {
+    CAR,
+    TRUCK,
+    MOTORCYCLE,
+    ELECTRIC
+};
+
+// Number of VehicleType values, for per-type tables
+constexpr int VEHICLE_TYPE_COUNT = 4;
+
+class Vehicle {
+private:
+    std::string licenseNumber;
+    VehicleType type;
+
+public:
+    Vehicle(const std::string& licenseNum, VehicleType vehicleType);
+    
+    // Getters
+    std::string getLicenseNumber() const;
+    VehicleType getType() const;
+};
+
+// Table of parked vehicles addressed by a 32-bit index, so slots refer to
+// their vehicle by index instead of holding a pointer each. Entries are
+// stored by value and freed indices are reused. Thread-safe: the table is
+// split into shards with one lock each, and a gate adds to its own shard.
+class VehiclePool {
+public:
+    static const uint32_t NO_VEHICLE = UINT32_MAX;
+    
+private:
+    static const int SHARD_COUNT = 16;
+    
+    struct Shard {
+        mutable std::mutex mutex;
+        std::vector<Vehicle> vehicles;
+        std::vector<uint32_t> freeEntries; // used as a stack
+    };
+    
+    std::array<Shard, SHARD_COUNT> shards;
+    
+public:
+    VehiclePool() = default;
+    VehiclePool(const VehiclePool&) = delete;
+    VehiclePool& operator=(const VehiclePool&) = delete;
+    
+    uint32_t add(const Vehicle& vehicle);
+    void remove(uint32_t index);
+    
+    // Empty string for NO_VEHICLE
+    std::string getLicenseNumber(uint32_t index) const;
+};
+
+#endif // VEHICLE_H
@@ -0,0 +1,143 @@
+// BinaryLogFormatter output read back through BinaryLogReader: plain and
+// deferred entries, string tables across blocks, and damaged files.
+
+#include "Test.h"
+
+#include "../movieTicketBooking/include/utils/BinaryLog.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+using namespace MovieBooking::Utils;
+
+namespace {
+
+LogEntry makeEntry(LogLevel level, const char* message, const char* category, const char* file, int line,
+                   const char* function) {
+    LogEntry entry(level, message, category, file, line, function);
+    // Microsecond resolution is what the format keeps
+    entry.timestamp = std::chrono::system_clock::time_point(std::chrono::microseconds(1760000000123456));
+    return entry;
+}
+
+// kFileMagic then one block with every entry, as FileAppender writes them
+template<typename... Entries>
+std::string writeFile(BinaryLogFormatter& formatter, const Entries&... entries) {
+    std::string out(formatter.fileHeader());
+    formatter.beginBlock(out);
+    (formatter.formatTo(entries, out), ...);
+    return out;
+}
+
+} // namespace
+
+TEST(BinaryLog, PlainEntriesRoundTrip) {
+    BinaryLogFormatter formatter;
+    const LogEntry first = makeEntry(LogLevel::WARN, "seat 12 taken", "booking", "Show.h", 42, "lockSeats");
+    const LogEntry second = makeEntry(LogLevel::ERROR, "gateway down", "", "PaymentService.cpp", 7, "charge");
+    const std::string file = writeFile(formatter, first, second);
+
+    BinaryLogReader reader(file.data(), file.size());
+    ASSERT_TRUE(reader.isValid());
+    DecodedLogRecord record;
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_TRUE(record.level == LogLevel::WARN);
+    EXPECT_EQ(record.message, "seat 12 taken");
+    EXPECT_EQ(record.category, "booking");
+    EXPECT_EQ(record.file, "Show.h");
+    EXPECT_EQ(record.line, 42);
+    EXPECT_EQ(record.function, "lockSeats");
+    EXPECT_TRUE(record.timestamp == first.timestamp);
+    EXPECT_EQ(record.threadHash, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_TRUE(record.level == LogLevel::ERROR);
+    EXPECT_EQ(record.message, "gateway down");
+    EXPECT_EQ(record.category, "");
+    EXPECT_EQ(record.file, "PaymentService.cpp");
+    EXPECT_FALSE(reader.next(record));
+    EXPECT_EQ(reader.remaining(), 0u);
+}
+
+TEST(BinaryLog, LongMessagesRoundTrip) {
+    BinaryLogFormatter formatter;
+    const std::string message(LogEntry::kInlineMessageSize * 3, 'x');
+    const LogEntry entry = makeEntry(LogLevel::INFO, message.c_str(), "", "a.cpp", 1, "f");
+    const std::string file = writeFile(formatter, entry);
+
+    BinaryLogReader reader(file.data(), file.size());
+    DecodedLogRecord record;
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.message, message);
+}
+
+TEST(BinaryLog, DeferredEntriesAreRenderedOnRead) {
+    BinaryLogFormatter formatter;
+    LogEntry entry = makeEntry(LogLevel::INFO, "", "payment", "PaymentService.cpp", 88, "settle");
+    ASSERT_TRUE(entry.setDeferred("booking {} charged {} via {} ({})", 1234, 19.5, "mock", true));
+    const std::string file = writeFile(formatter, entry);
+
+    BinaryLogReader reader(file.data(), file.size());
+    DecodedLogRecord record;
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.message, "booking 1234 charged 19.5 via mock (true)");
+    EXPECT_EQ(record.category, "payment");
+}
+
+// String ids restart with every block, so a reader must drop its table at
+// each BLOCK_START rather than reuse ids from the block before
+TEST(BinaryLog, StringTablesResetPerBlock) {
+    BinaryLogFormatter formatter;
+    std::string file(formatter.fileHeader());
+    formatter.beginBlock(file);
+    formatter.formatTo(makeEntry(LogLevel::INFO, "one", "", "First.cpp", 1, "first"), file);
+    formatter.formatTo(makeEntry(LogLevel::INFO, "two", "", "First.cpp", 2, "first"), file);
+    formatter.beginBlock(file);
+    formatter.formatTo(makeEntry(LogLevel::INFO, "three", "", "Second.cpp", 3, "second"), file);
+    // format() is a self-contained block of its own
+    file += formatter.format(makeEntry(LogLevel::DEBUG, "four", "", "Third.cpp", 4, "third"));
+
+    BinaryLogReader reader(file.data(), file.size());
+    DecodedLogRecord record;
+    const char* expectedFiles[] = {"First.cpp", "First.cpp", "Second.cpp", "Third.cpp"};
+    const char* expectedFunctions[] = {"first", "first", "second", "third"};
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(reader.next(record));
+        EXPECT_EQ(record.file, expectedFiles[i]);
+        EXPECT_EQ(record.function, expectedFunctions[i]);
+        EXPECT_EQ(record.line, i + 1);
+    }
+    EXPECT_FALSE(reader.next(record));
+}
+
+TEST(BinaryLog, TruncatedTailStopsAtTheLastWholeEntry) {
+    BinaryLogFormatter formatter;
+    const LogEntry entry = makeEntry(LogLevel::INFO, "kept", "", "a.cpp", 1, "f");
+    const LogEntry torn = makeEntry(LogLevel::INFO, "torn", "", "a.cpp", 2, "f");
+    const std::string whole = writeFile(formatter, entry, torn);
+    const std::string file = whole.substr(0, whole.size() - 3);
+
+    BinaryLogReader reader(file.data(), file.size());
+    DecodedLogRecord record;
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.message, "kept");
+    EXPECT_FALSE(reader.next(record));
+    EXPECT_FALSE(reader.isValid());
+    EXPECT_TRUE(reader.remaining() > 0u);
+}
+
+TEST(BinaryLog, RejectsFilesWithoutTheMagic) {
+    const std::string text = "2025-01-01 00:00:00 [INFO] not a binary log";
+    BinaryLogReader reader(text.data(), text.size());
+    EXPECT_FALSE(reader.isValid());
+    DecodedLogRecord record;
+    EXPECT_FALSE(reader.next(record));
+
+    std::string corrupt(BinaryLog::kFileMagic);
+    corrupt += '\x7f';
+    BinaryLogReader corruptReader(corrupt.data(), corrupt.size());
+    EXPECT_TRUE(corruptReader.isValid());
+    EXPECT_FALSE(corruptReader.next(record));
+    EXPECT_EQ(corruptReader.remaining(), 1u);
+}
@@ -0,0 +1,143 @@
+// Expected and BookingError: value and error access, and each error code's
+// status, message, JSON body and matching exception.
+
+#include "Test.h"
+
+#include "../movieTicketBooking/include/utils/BookingError.h"
+#include "../movieTicketBooking/include/utils/Exceptions.h"
+#include "../movieTicketBooking/include/utils/Expected.h"
+#include "../movieTicketBooking/include/utils/JsonWriter.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace MovieBooking::Utils;
+
+namespace {
+
+BookingError errorOf(BookingErrorCode code) {
+    BookingError error = BookingError::seats(code, 7, {3, 4});
+    error.bookingId = 55;
+    error.requested = 4;
+    error.available = 1;
+    return error;
+}
+
+// The status and code raise() reports, or 0 and "" if it threw something else
+std::pair<int, std::string> raisedStatus(const BookingError& error) {
+    try {
+        error.raise();
+    } catch (const MovieBookingException& e) {
+        return {e.getHttpStatusCode(), e.getErrorCode()};
+    } catch (...) {
+    }
+    return {0, ""};
+}
+
+} // namespace
+
+TEST(Expected, HoldsAValueOrAnError) {
+    Expected<int, BookingError> value = 42;
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(*value, 42);
+    EXPECT_EQ(value.value(), 42);
+
+    Expected<int, BookingError> error = makeUnexpected(BookingError::seats(BookingErrorCode::NO_SEATS, 7, {}));
+    EXPECT_FALSE(error.has_value());
+    EXPECT_FALSE(static_cast<bool>(error));
+    EXPECT_EQ(error.error().code, BookingErrorCode::NO_SEATS);
+}
+
+TEST(Expected, ValueOnAnErrorThrowsCarryingIt) {
+    Expected<int, BookingError> error =
+        makeUnexpected(BookingError::seats(BookingErrorCode::SEATS_UNAVAILABLE, 7, {9}));
+    bool threw = false;
+    try {
+        error.value();
+    } catch (const BadExpectedAccess<BookingError>& e) {
+        threw = true;
+        EXPECT_TRUE(e.error().seatIds == (std::vector<int>{9}));
+    }
+    EXPECT_TRUE(threw);
+
+    Expected<void, BookingError> failed = makeUnexpected(errorOf(BookingErrorCode::LOCK_TIMEOUT));
+    threw = false;
+    try {
+        failed.value();
+    } catch (const BadExpectedAccess<BookingError>&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+    Expected<void, BookingError> succeeded;
+    EXPECT_TRUE(succeeded.has_value());
+}
+
+TEST(Expected, MovesOutMoveOnlyValues) {
+    Expected<std::unique_ptr<int>, BookingError> value = std::make_unique<int>(5);
+    std::unique_ptr<int> taken = std::move(value).value();
+    ASSERT_TRUE(taken != nullptr);
+    EXPECT_EQ(*taken, 5);
+}
+
+TEST(BookingError, StatusesMatchTheExceptionsTheyReplace) {
+    const BookingErrorCode codes[] = {
+        BookingErrorCode::SEATS_UNAVAILABLE, BookingErrorCode::UNKNOWN_SEATS, BookingErrorCode::NO_SEATS,
+        BookingErrorCode::INSUFFICIENT_SEATS, BookingErrorCode::NOT_LOCK_HOLDER, BookingErrorCode::LOCK_TIMEOUT,
+        BookingErrorCode::BOOKING_EXPIRED};
+    for (BookingErrorCode code : codes) {
+        const BookingError error = errorOf(code);
+        EXPECT_EQ(raisedStatus(error).first, error.getHttpStatusCode());
+    }
+    EXPECT_EQ(errorOf(BookingErrorCode::SEATS_UNAVAILABLE).getHttpStatusCode(), 409);
+    EXPECT_EQ(errorOf(BookingErrorCode::UNKNOWN_SEATS).getHttpStatusCode(), 400);
+    EXPECT_EQ(errorOf(BookingErrorCode::INSUFFICIENT_SEATS).getHttpStatusCode(), 422);
+}
+
+TEST(BookingError, RaiseThrowsTheMatchingException) {
+    EXPECT_EQ(raisedStatus(errorOf(BookingErrorCode::SEATS_UNAVAILABLE)).second, "CONFLICT_ERROR");
+    EXPECT_EQ(raisedStatus(errorOf(BookingErrorCode::UNKNOWN_SEATS)).second, "VALIDATION_ERROR");
+    EXPECT_EQ(raisedStatus(errorOf(BookingErrorCode::LOCK_TIMEOUT)).second, "CONCURRENCY_ERROR");
+    EXPECT_EQ(raisedStatus(errorOf(BookingErrorCode::BOOKING_EXPIRED)).second, "BUSINESS_RULE_VIOLATION");
+
+    bool seatTaken = false;
+    try {
+        errorOf(BookingErrorCode::SEATS_UNAVAILABLE).raise();
+    } catch (const SeatAlreadyBookedException& e) {
+        seatTaken = true;
+        EXPECT_EQ(e.getConflictType(), "SEAT_ALREADY_BOOKED");
+    } catch (...) {
+    }
+    EXPECT_TRUE(seatTaken);
+
+    bool insufficient = false;
+    try {
+        errorOf(BookingErrorCode::INSUFFICIENT_SEATS).raise();
+    } catch (const InsufficientSeatsException& e) {
+        insufficient = true;
+        EXPECT_EQ(std::string(e.what()), errorOf(BookingErrorCode::INSUFFICIENT_SEATS).getMessage());
+    } catch (...) {
+    }
+    EXPECT_TRUE(insufficient);
+}
+
+TEST(BookingError, MessagesNameTheSeatsAtFault) {
+    EXPECT_EQ(errorOf(BookingErrorCode::SEATS_UNAVAILABLE).getMessage(), "Seats already taken for show 7: 3, 4");
+    EXPECT_EQ(errorOf(BookingErrorCode::NOT_LOCK_HOLDER).getMessage(), "Seats are not locked by booking 55: 3, 4");
+    EXPECT_EQ(errorOf(BookingErrorCode::BOOKING_EXPIRED).getMessage(), "Booking 55 has expired");
+    EXPECT_EQ(std::string(errorOf(BookingErrorCode::UNKNOWN_SEATS).getErrorCode()), "UNKNOWN_SEATS");
+}
+
+TEST(BookingError, WritesItsResponseBody) {
+    std::string out;
+    JsonWriter writer(out);
+    errorOf(BookingErrorCode::SEATS_UNAVAILABLE).writeJson(writer);
+    EXPECT_EQ(out, "{\"error\":\"Seats already taken for show 7: 3, 4\",\"code\":\"SEATS_UNAVAILABLE\","
+                   "\"seatIds\":[3,4]}");
+
+    out.clear();
+    JsonWriter bare(out);
+    BookingError::seats(BookingErrorCode::NO_SEATS, 7, {}).writeJson(bare);
+    EXPECT_EQ(out, "{\"error\":\"No seats selected for show 7\",\"code\":\"NO_SEATS\"}");
+}
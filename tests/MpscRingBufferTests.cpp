@@ -0,0 +1,122 @@
+// MpscRingBuffer: FIFO order and full/empty detection across many laps of
+// the ring, and no lost or repeated element under concurrent producers.
+
+#include "Test.h"
+
+#include "../movieTicketBooking/include/utils/MpscRingBuffer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using MovieBooking::Utils::MpscRingBuffer;
+
+namespace {
+
+bool push(MpscRingBuffer<uint64_t>& ring, uint64_t value) {
+    return ring.tryPush([value](uint64_t& slot) { slot = value; });
+}
+
+bool pop(MpscRingBuffer<uint64_t>& ring, uint64_t& value) {
+    return ring.tryConsume([&value](uint64_t& slot) { value = slot; });
+}
+
+} // namespace
+
+TEST(MpscRingBuffer, RoundsCapacityUpToAPowerOfTwo) {
+    EXPECT_EQ(MpscRingBuffer<int>(0).capacity(), 2u);
+    EXPECT_EQ(MpscRingBuffer<int>(5).capacity(), 8u);
+    EXPECT_EQ(MpscRingBuffer<int>(64).capacity(), 64u);
+}
+
+TEST(MpscRingBuffer, RejectsPushWhenFullAndConsumeWhenEmpty) {
+    MpscRingBuffer<uint64_t> ring(4);
+    uint64_t value = 0;
+    EXPECT_FALSE(pop(ring, value));
+    for (uint64_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(push(ring, i));
+    }
+    EXPECT_FALSE(push(ring, 99));
+    EXPECT_EQ(ring.size(), 4u);
+
+    ASSERT_TRUE(pop(ring, value));
+    EXPECT_EQ(value, 0u);
+    // The freed slot is reused on the next lap
+    EXPECT_TRUE(push(ring, 4));
+    EXPECT_FALSE(push(ring, 5));
+}
+
+// Partial fills and drains move head and tail through every slot offset for
+// many laps; every element must come out once, in order
+TEST(MpscRingBuffer, KeepsOrderAcrossWrapAround) {
+    MpscRingBuffer<uint64_t> ring(8);
+    uint64_t next = 0;
+    uint64_t expected = 0;
+    for (int round = 0; round < 1000; ++round) {
+        const int pushes = 1 + round % 8;
+        for (int i = 0; i < pushes && push(ring, next); ++i) {
+            ++next;
+        }
+        const int pops = 1 + (round * 5) % 7;
+        uint64_t value = 0;
+        for (int i = 0; i < pops && pop(ring, value); ++i) {
+            EXPECT_EQ(value, expected);
+            ++expected;
+        }
+        EXPECT_EQ(ring.size(), next - expected);
+    }
+    uint64_t value = 0;
+    while (pop(ring, value)) {
+        EXPECT_EQ(value, expected++);
+    }
+    EXPECT_EQ(expected, next);
+    EXPECT_TRUE(next > 100 * ring.capacity());
+}
+
+TEST(MpscRingBuffer, ConcurrentProducersLoseNothing) {
+    const int kProducers = 4;
+    const uint64_t kPerProducer = 20000;
+    MpscRingBuffer<uint64_t> ring(64);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&ring, p] {
+            for (uint64_t i = 0; i < kPerProducer; ++i) {
+                // Producer id in the high bits, sequence in the low
+                const uint64_t value = (static_cast<uint64_t>(p) << 32) | i;
+                while (!push(ring, value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint64_t> nextOf(kProducers, 0);
+    uint64_t received = 0;
+    while (received < kProducers * kPerProducer) {
+        uint64_t value = 0;
+        if (!pop(ring, value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const size_t producer = static_cast<size_t>(value >> 32);
+        ++received;
+        // Not ASSERT: the producers are still running
+        EXPECT_TRUE(producer < nextOf.size());
+        if (producer >= nextOf.size()) {
+            continue;
+        }
+        // Each producer's elements arrive in the order it pushed them
+        EXPECT_EQ(value & 0xffffffffu, nextOf[producer]);
+        nextOf[producer] = (value & 0xffffffffu) + 1;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    for (uint64_t next : nextOf) {
+        EXPECT_EQ(next, kPerProducer);
+    }
+    uint64_t value = 0;
+    EXPECT_FALSE(pop(ring, value));
+}
@@ -0,0 +1,233 @@
+// ParkingJournal replay, including torn and corrupt tails, and ParkingStore
+// recover and checkpoint across simulated restarts.
+
+#include "Test.h"
+
+#include "../parkingLot/ParkingJournal.h"
+#include "../parkingLot/ParkingLot.h"
+#include "../parkingLot/ParkingStore.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+// A fresh directory, removed with everything in it when the test ends
+class TempDirectory {
+private:
+    std::string path;
+
+public:
+    TempDirectory() {
+        char pattern[] = "/tmp/parking-test-XXXXXX";
+        const char* created = mkdtemp(pattern);
+        path = created ? created : "";
+    }
+    ~TempDirectory() {
+        std::error_code ignored;
+        std::filesystem::remove_all(path, ignored);
+    }
+    const std::string& get() const { return path; }
+};
+
+TicketRecord makeRecord(uint64_t id, int slot, const std::string& license) {
+    return TicketRecord{ParkingId(id), slot, VehicleType::CAR, license,
+                        std::chrono::system_clock::time_point(std::chrono::seconds(1700000000 + id))};
+}
+
+// Park records for ids 1..count in a new journal, each durable before returning
+void writeJournal(const std::string& directory, int count) {
+    ParkingJournal journal;
+    ASSERT_TRUE(journal.open(directory, 0));
+    for (int i = 1; i <= count; ++i) {
+        ASSERT_TRUE(journal.waitDurable(journal.appendPark(makeRecord(i, i, "CAR-" + std::to_string(i)))));
+    }
+    journal.close();
+}
+
+std::vector<JournalEvent> readOnlySegment(const std::string& directory) {
+    std::vector<JournalEvent> events;
+    const auto segments = ParkingJournal::listSegments(directory);
+    if (segments.size() == 1) {
+        ParkingJournal::readSegment(ParkingJournal::segmentPath(directory, segments[0]), events);
+    }
+    return events;
+}
+
+std::unique_ptr<ParkingLot> makeLot() {
+    return std::unique_ptr<ParkingLot>(new ParkingLot(8, 2, 2, 10.0));
+}
+
+std::set<std::string> activeLicenses(const ParkingLot& lot) {
+    std::set<std::string> licenses;
+    for (const TicketRecord& ticket : lot.getActiveTickets()) {
+        licenses.insert(ticket.licenseNumber);
+    }
+    return licenses;
+}
+
+} // namespace
+
+TEST(ParkingJournal, ReplaysEventsInOrder) {
+    TempDirectory directory;
+    {
+        ParkingJournal journal;
+        ASSERT_TRUE(journal.open(directory.get(), 41));
+        const uint64_t park = journal.appendPark(makeRecord(7, 3, "ABC-123"));
+        const uint64_t exit = journal.appendExit(ParkingId(7));
+        EXPECT_EQ(park, 42u);
+        EXPECT_EQ(exit, 43u);
+        ASSERT_TRUE(journal.waitDurable(exit));
+        journal.close();
+    }
+
+    const auto events = readOnlySegment(directory.get());
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].sequence, 42u);
+    EXPECT_TRUE(events[0].kind == JournalEventKind::PARK);
+    EXPECT_TRUE(events[0].ticket.ticketId == ParkingId(7));
+    EXPECT_EQ(events[0].ticket.slotNumber, 3);
+    EXPECT_EQ(events[0].ticket.licenseNumber, "ABC-123");
+    EXPECT_TRUE(events[0].ticket.entryTime == makeRecord(7, 3, "").entryTime);
+    EXPECT_TRUE(events[1].kind == JournalEventKind::EXIT);
+    EXPECT_TRUE(events[1].ticket.ticketId == ParkingId(7));
+}
+
+// A crash mid-write leaves part of the last record; replay keeps every whole
+// record before it
+TEST(ParkingJournal, DropsATornTail) {
+    TempDirectory directory;
+    writeJournal(directory.get(), 5);
+    const std::string path = ParkingJournal::segmentPath(directory.get(), ParkingJournal::listSegments(directory.get())[0]);
+    const auto size = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, size - 5);
+
+    const auto events = readOnlySegment(directory.get());
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events.back().ticket.licenseNumber, "CAR-4");
+}
+
+TEST(ParkingJournal, StopsAtACorruptRecord) {
+    TempDirectory directory;
+    writeJournal(directory.get(), 4);
+    const std::string path = ParkingJournal::segmentPath(directory.get(), ParkingJournal::listSegments(directory.get())[0]);
+    const auto recordSize = std::filesystem::file_size(path) / 4;
+    {
+        // Flip the last byte of the second record's license
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(static_cast<std::streamoff>(2 * recordSize - 1));
+        char byte = 0;
+        file.read(&byte, 1);
+        byte ^= 0x55;
+        file.seekp(static_cast<std::streamoff>(2 * recordSize - 1));
+        file.write(&byte, 1);
+    }
+
+    const auto events = readOnlySegment(directory.get());
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].ticket.licenseNumber, "CAR-1");
+}
+
+TEST(ParkingStore, RecoverRestoresActiveTicketsAfterRestart) {
+    TempDirectory directory;
+    std::string kept;
+    {
+        auto lot = makeLot();
+        ParkingStore store(directory.get());
+        ASSERT_EQ(store.recover(*lot), 0);
+        auto leaving = lot->parkVehicle(Vehicle("LEAVES", VehicleType::CAR));
+        auto staying = lot->parkVehicle(Vehicle("STAYS", VehicleType::CAR));
+        auto truck = lot->parkVehicle(Vehicle("TRUCK", VehicleType::TRUCK));
+        ASSERT_TRUE(leaving && staying && truck);
+        EXPECT_TRUE(lot->exitParking(leaving->getTicketId()) >= 0.0);
+        kept = staying->getTicketNumber();
+    }
+
+    auto lot = makeLot();
+    ParkingStore store(directory.get());
+    ASSERT_EQ(store.recover(*lot), 2);
+    EXPECT_TRUE(activeLicenses(*lot) == (std::set<std::string>{"STAYS", "TRUCK"}));
+    EXPECT_EQ(lot->getOccupiedSpaces(), 2);
+    EXPECT_EQ(lot->getAvailableSpaces(VehicleType::TRUCK), 1);
+
+    // Restored tickets exit as usual, and new ones never reuse their ids
+    EXPECT_TRUE(lot->exitParking(kept) >= 0.0);
+    auto fresh = lot->parkVehicle(Vehicle("NEW", VehicleType::CAR));
+    ASSERT_TRUE(fresh != nullptr);
+    EXPECT_NE(fresh->getTicketNumber(), kept);
+}
+
+// A checkpoint snapshots the lot and drops the segments it covers; events
+// after it are still replayed on top of the snapshot
+TEST(ParkingStore, CheckpointCompactsTheJournal) {
+    TempDirectory directory;
+    {
+        auto lot = makeLot();
+        ParkingStore store(directory.get());
+        ASSERT_EQ(store.recover(*lot), 0);
+        std::vector<std::shared_ptr<ParkingTicket>> tickets;
+        for (int i = 0; i < 6; ++i) {
+            tickets.push_back(lot->parkVehicle(Vehicle("BEFORE-" + std::to_string(i), VehicleType::CAR)));
+            ASSERT_TRUE(tickets.back() != nullptr);
+        }
+        for (int i = 0; i < 3; ++i) {
+            lot->exitParking(tickets[i]->getTicketId());
+        }
+        ASSERT_TRUE(store.checkpoint());
+        EXPECT_TRUE(std::filesystem::exists(directory.get() + "/snapshot.bin"));
+        EXPECT_EQ(ParkingJournal::listSegments(directory.get()).size(), 1u);
+
+        lot->exitParking(tickets[3]->getTicketId());
+        ASSERT_TRUE(lot->parkVehicle(Vehicle("AFTER", VehicleType::MOTORCYCLE)) != nullptr);
+    }
+
+    auto lot = makeLot();
+    ParkingStore store(directory.get());
+    ASSERT_EQ(store.recover(*lot), 3);
+    EXPECT_TRUE(activeLicenses(*lot) == (std::set<std::string>{"BEFORE-4", "BEFORE-5", "AFTER"}));
+}
+
+TEST(ParkingStore, RecoverSurvivesATornJournalTail) {
+    TempDirectory directory;
+    {
+        auto lot = makeLot();
+        ParkingStore store(directory.get());
+        ASSERT_EQ(store.recover(*lot), 0);
+        ASSERT_TRUE(lot->parkVehicle(Vehicle("WHOLE", VehicleType::CAR)) != nullptr);
+    }
+    {
+        // Half a record, as a crash mid-append would leave
+        const auto segments = ParkingJournal::listSegments(directory.get());
+        std::ofstream file(ParkingJournal::segmentPath(directory.get(), segments.back()),
+                           std::ios::binary | std::ios::app);
+        file.write("\x30\x00\x00\x00\x12\x34", 6);
+    }
+
+    auto lot = makeLot();
+    ParkingStore store(directory.get());
+    ASSERT_EQ(store.recover(*lot), 1);
+    EXPECT_TRUE(activeLicenses(*lot) == (std::set<std::string>{"WHOLE"}));
+    // The next run starts a segment of its own, so the torn one stays behind
+    ASSERT_TRUE(lot->parkVehicle(Vehicle("LATER", VehicleType::CAR)) != nullptr);
+}
+
+TEST(ParkingStore, RejectsStateOfADifferentLayout) {
+    TempDirectory directory;
+    {
+        auto lot = makeLot();
+        ParkingStore store(directory.get());
+        ASSERT_EQ(store.recover(*lot), 0);
+        ASSERT_TRUE(lot->parkVehicle(Vehicle("CAR", VehicleType::CAR)) != nullptr);
+        ASSERT_TRUE(store.checkpoint());
+    }
+
+    ParkingLot smaller(4, 2, 2, 10.0);
+    ParkingStore store(directory.get());
+    EXPECT_EQ(store.recover(smaller), -1);
+}
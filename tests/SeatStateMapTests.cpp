@@ -0,0 +1,125 @@
+// SeatStateMap: packed status words, single-seat CAS and the all-or-nothing
+// multi-seat transition with its rollback.
+
+#include "Test.h"
+
+#include "../movieTicketBooking/include/models/SeatStateMap.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using MovieBooking::Models::SeatStateMap;
+using MovieBooking::Models::ShowSeatStatus;
+
+namespace {
+
+const ShowSeatStatus AVAILABLE = ShowSeatStatus::AVAILABLE;
+const ShowSeatStatus LOCKED = ShowSeatStatus::LOCKED;
+const ShowSeatStatus BOOKED = ShowSeatStatus::BOOKED;
+
+} // namespace
+
+TEST(SeatStateMap, PacksSeatsAcrossWords) {
+    SeatStateMap seats(70, ShowSeatStatus::MAINTENANCE);
+    EXPECT_EQ(seats.wordCount(), 3u);
+    EXPECT_EQ(seats.count(ShowSeatStatus::MAINTENANCE), 70u);
+    // Padding past size() never counts, whatever its bits hold
+    EXPECT_EQ(seats.count(AVAILABLE), 0u);
+
+    seats.set(0, AVAILABLE);
+    seats.set(31, BOOKED);
+    seats.set(32, LOCKED);
+    seats.set(69, AVAILABLE);
+    EXPECT_EQ(seats.get(0), AVAILABLE);
+    EXPECT_EQ(seats.get(31), BOOKED);
+    EXPECT_EQ(seats.get(32), LOCKED);
+    EXPECT_EQ(seats.get(33), ShowSeatStatus::MAINTENANCE);
+    EXPECT_TRUE(seats.ordinalsWithStatus(AVAILABLE) == (std::vector<size_t>{0, 69}));
+    EXPECT_TRUE(seats.findAvailable(1) == (std::vector<size_t>{0}));
+}
+
+TEST(SeatStateMap, CompareExchangeFailsOnlyOnItsOwnSeat) {
+    SeatStateMap seats(32);
+    ASSERT_TRUE(seats.compareExchange(5, AVAILABLE, LOCKED));
+    EXPECT_FALSE(seats.compareExchange(5, AVAILABLE, LOCKED));
+    EXPECT_EQ(seats.get(5), LOCKED);
+    // A neighbour in the same word is unaffected
+    EXPECT_TRUE(seats.compareExchange(6, AVAILABLE, BOOKED));
+    EXPECT_TRUE(seats.compareExchange(5, LOCKED, BOOKED));
+    EXPECT_EQ(seats.count(BOOKED), 2u);
+}
+
+TEST(SeatStateMap, TransitionAllClaimsEverySeat) {
+    SeatStateMap seats(100);
+    std::vector<size_t> conflicts;
+    ASSERT_TRUE(seats.tryTransitionAll({1, 2, 40, 99}, AVAILABLE, LOCKED, conflicts));
+    EXPECT_TRUE(conflicts.empty());
+    EXPECT_EQ(seats.count(LOCKED), 4u);
+    EXPECT_EQ(seats.get(99), LOCKED);
+}
+
+TEST(SeatStateMap, TransitionAllRollsBackClaimedWords) {
+    SeatStateMap seats(100);
+    seats.set(70, BOOKED);
+    seats.set(75, LOCKED);
+
+    // Words 0 and 1 are claimed before word 2 conflicts, and must be restored
+    std::vector<size_t> conflicts;
+    EXPECT_FALSE(seats.tryTransitionAll({1, 2, 40, 70, 71, 75, 90}, AVAILABLE, LOCKED, conflicts));
+    EXPECT_TRUE(conflicts == (std::vector<size_t>{70, 75}));
+    EXPECT_EQ(seats.count(AVAILABLE), 98u);
+    EXPECT_EQ(seats.get(70), BOOKED);
+    EXPECT_EQ(seats.get(75), LOCKED);
+}
+
+TEST(SeatStateMap, TransitionAllReportsConflictsInLaterWords) {
+    SeatStateMap seats(128);
+    seats.set(3, BOOKED);
+    seats.set(100, BOOKED);
+    std::vector<size_t> conflicts;
+    EXPECT_FALSE(seats.tryTransitionAll({3, 4, 100, 101}, AVAILABLE, LOCKED, conflicts));
+    EXPECT_TRUE(conflicts == (std::vector<size_t>{3, 100}));
+    EXPECT_EQ(seats.count(LOCKED), 0u);
+}
+
+// Overlapping all-or-nothing claims: every seat ends up with exactly one
+// winner, and a loser leaves nothing behind once it rolls back
+TEST(SeatStateMap, ConcurrentTransitionsNeverShareASeat) {
+    const size_t kSeats = 256;
+    const int kThreads = 4;
+    SeatStateMap seats(kSeats);
+    std::vector<std::atomic<int>> owners(kSeats);
+    std::atomic<int> doubleClaims{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t first = static_cast<size_t>(t); first + 40 < kSeats; first += 3) {
+                // Spans a word boundary, so a partial claim has to be undone
+                const std::vector<size_t> ordinals{first, first + 20, first + 40};
+                std::vector<size_t> conflicts;
+                if (!seats.tryTransitionAll(ordinals, AVAILABLE, LOCKED, conflicts)) {
+                    continue;
+                }
+                for (size_t ordinal : ordinals) {
+                    if (owners[ordinal].exchange(t + 1) != 0) {
+                        doubleClaims.fetch_add(1);
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(doubleClaims.load(), 0);
+    size_t owned = 0;
+    for (size_t ordinal = 0; ordinal < kSeats; ++ordinal) {
+        const bool locked = seats.get(ordinal) == LOCKED;
+        EXPECT_EQ(locked, owners[ordinal].load() != 0);
+        owned += locked ? 1 : 0;
+    }
+    EXPECT_EQ(seats.count(LOCKED), owned);
+}
@@ -0,0 +1,156 @@
+// ShardedLruCache: LRU eviction per shard, TTL expiry and the atomic
+// putIfAbsent and update paths.
+
+#include "Test.h"
+
+#include "../movieTicketBooking/include/utils/ShardedLruCache.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Cache = MovieBooking::Utils::ShardedLruCache<int, std::string>;
+
+namespace {
+
+const auto kLongTtl = std::chrono::hours(1);
+
+Cache::ValuePtr value(const char* text) {
+    return std::make_shared<const std::string>(text);
+}
+
+uint64_t totalOf(const Cache& cache, uint64_t Cache::ShardStats::*field) {
+    uint64_t total = 0;
+    for (const auto& stats : cache.getShardStats()) {
+        total += stats.*field;
+    }
+    return total;
+}
+
+} // namespace
+
+TEST(ShardedLruCache, EvictsTheLeastRecentlyUsedEntry) {
+    Cache cache(3, kLongTtl, 1);
+    cache.put(1, value("one"));
+    cache.put(2, value("two"));
+    cache.put(3, value("three"));
+    // A hit makes 1 the most recent, leaving 2 the oldest
+    ASSERT_TRUE(cache.get(1) != nullptr);
+    cache.put(4, value("four"));
+
+    EXPECT_TRUE(cache.get(2) == nullptr);
+    EXPECT_EQ(*cache.get(1), "one");
+    EXPECT_EQ(*cache.get(4), "four");
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT_EQ(totalOf(cache, &Cache::ShardStats::evictions), 1u);
+}
+
+TEST(ShardedLruCache, ReplacingAKeyDoesNotEvict) {
+    Cache cache(2, kLongTtl, 1);
+    cache.put(1, value("one"));
+    cache.put(2, value("two"));
+    cache.put(1, value("uno"));
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(*cache.get(1), "uno");
+    EXPECT_EQ(totalOf(cache, &Cache::ShardStats::evictions), 0u);
+}
+
+TEST(ShardedLruCache, CapacityIsSplitAcrossShards) {
+    Cache cache(64, kLongTtl, 4);
+    for (int key = 0; key < 1000; ++key) {
+        cache.put(key, value("v"));
+    }
+    EXPECT_EQ(cache.size(), 64u);
+    for (const auto& stats : cache.getShardStats()) {
+        EXPECT_EQ(stats.size, 16u);
+    }
+
+    cache.setCapacity(8);
+    EXPECT_EQ(cache.size(), 8u);
+}
+
+TEST(ShardedLruCache, ExpiredEntriesMissAndArePurged) {
+    Cache cache(10, kLongTtl, 2);
+    cache.put(1, value("stale"), Cache::Clock::duration::zero());
+    cache.put(2, value("fresh"));
+    cache.put(3, value("soon"), std::chrono::milliseconds(20));
+
+    EXPECT_TRUE(cache.get(1) == nullptr);
+    EXPECT_EQ(totalOf(cache, &Cache::ShardStats::expirations), 1u);
+    ASSERT_TRUE(cache.get(3) != nullptr);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_EQ(cache.purgeExpired(), 1u);
+    EXPECT_TRUE(cache.get(3) == nullptr);
+    EXPECT_EQ(*cache.get(2), "fresh");
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST(ShardedLruCache, SetTtlAppliesToLaterPuts) {
+    Cache cache(10, kLongTtl, 1);
+    cache.put(1, value("kept"));
+    cache.setTtl(Cache::Clock::duration::zero());
+    cache.put(2, value("expired"));
+    EXPECT_TRUE(cache.get(1) != nullptr);
+    EXPECT_TRUE(cache.get(2) == nullptr);
+}
+
+TEST(ShardedLruCache, PutIfAbsentKeepsTheLiveEntry) {
+    Cache cache(10, kLongTtl, 1);
+    EXPECT_EQ(*cache.putIfAbsent(1, value("first")), "first");
+    EXPECT_EQ(*cache.putIfAbsent(1, value("second")), "first");
+
+    // An expired entry counts as absent
+    cache.put(2, value("old"), Cache::Clock::duration::zero());
+    EXPECT_EQ(*cache.putIfAbsent(2, value("new")), "new");
+    EXPECT_EQ(*cache.get(2), "new");
+}
+
+TEST(ShardedLruCache, UpdateSwapsTheValueAndKeepsItsTtl) {
+    Cache cache(10, kLongTtl, 1);
+    const auto original = value("one");
+    cache.put(1, original, std::chrono::milliseconds(20));
+
+    EXPECT_TRUE(cache.update(1, [](const std::string& current) {
+        return std::make_shared<const std::string>(current + "!");
+    }));
+    EXPECT_EQ(*cache.get(1), "one!");
+    // Readers holding the old snapshot keep it unchanged
+    EXPECT_EQ(*original, "one");
+    // A null result leaves the entry alone
+    EXPECT_TRUE(cache.update(1, [](const std::string&) { return Cache::ValuePtr(); }));
+    EXPECT_EQ(*cache.get(1), "one!");
+    EXPECT_FALSE(cache.update(2, [](const std::string&) { return value("never"); }));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_FALSE(cache.update(1, [](const std::string&) { return value("late"); }));
+    EXPECT_TRUE(cache.get(1) == nullptr);
+}
+
+TEST(ShardedLruCache, ConcurrentUseStaysWithinCapacity) {
+    const int kThreads = 4;
+    Cache cache(100, kLongTtl, 8);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&cache, t] {
+            for (int i = 0; i < 5000; ++i) {
+                const int key = (i * 31 + t) % 400;
+                if (i % 3 == 0) {
+                    cache.put(key, value("v"));
+                } else if (auto hit = cache.get(key)) {
+                    EXPECT_EQ(*hit, "v");
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // 100 over 8 shards rounds up to 13 each
+    EXPECT_LE(cache.size(), 104u);
+    for (const auto& stats : cache.getShardStats()) {
+        EXPECT_LE(stats.size, 13u);
+    }
+}
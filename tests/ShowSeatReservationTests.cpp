@@ -0,0 +1,174 @@
+// Show seat reservation: all-or-nothing locks, booking by the lock holder
+// and release, alone and racing each other.
+
+#include "Test.h"
+
+#include "../movieTicketBooking/include/models/Show.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace MovieBooking;
+using Models::ShowSeatStatus;
+
+namespace {
+
+const int kShowId = 7;
+
+// Seats 1..seatCount, all available
+std::unique_ptr<Models::Show> makeShow(int seatCount) {
+    auto start = std::chrono::system_clock::now() + std::chrono::hours(24);
+    auto show = std::make_unique<Models::Show>(kShowId, 1, 1, start, start + std::chrono::hours(3), 12.5);
+    std::vector<Models::ShowSeatRecord> seats;
+    seats.reserve(seatCount);
+    for (int seat = 1; seat <= seatCount; ++seat) {
+        seats.emplace_back(kShowId * 1000 + seat, kShowId, seat, ShowSeatStatus::AVAILABLE, 12.5);
+    }
+    show->loadShowSeats(seats);
+    return show;
+}
+
+ShowSeatStatus statusOf(const Models::Show& show, int seatId) {
+    return show.getShowSeatById(seatId)->getStatus();
+}
+
+} // namespace
+
+TEST(ShowSeatReservation, LockIsAllOrNothing) {
+    auto show = makeShow(40);
+    ASSERT_TRUE(show->lockSeats({1, 2}, 100));
+
+    auto locked = show->tryLockSeats({2, 3, 35}, 200);
+    ASSERT_FALSE(locked.has_value());
+    EXPECT_EQ(locked.error().code, Utils::BookingErrorCode::SEATS_UNAVAILABLE);
+    EXPECT_TRUE(locked.error().seatIds == (std::vector<int>{2}));
+    EXPECT_EQ(statusOf(*show, 3), ShowSeatStatus::AVAILABLE);
+    EXPECT_EQ(statusOf(*show, 35), ShowSeatStatus::AVAILABLE);
+    EXPECT_EQ(show->getLockedSeatCount(), 2);
+    EXPECT_EQ(show->getShowSeatById(2)->getBookingId(), 100);
+}
+
+TEST(ShowSeatReservation, LockRejectsUnknownAndEmptySelections) {
+    auto show = makeShow(10);
+    auto unknown = show->tryLockSeats({1, 11, 12}, 100);
+    ASSERT_FALSE(unknown.has_value());
+    EXPECT_EQ(unknown.error().code, Utils::BookingErrorCode::UNKNOWN_SEATS);
+    EXPECT_TRUE(unknown.error().seatIds == (std::vector<int>{11, 12}));
+
+    auto empty = show->tryLockSeats({}, 100);
+    ASSERT_FALSE(empty.has_value());
+    EXPECT_EQ(empty.error().code, Utils::BookingErrorCode::NO_SEATS);
+    EXPECT_EQ(show->getAvailableSeatCount(), 10);
+}
+
+TEST(ShowSeatReservation, OnlyTheHolderBooksItsSeats) {
+    auto show = makeShow(10);
+    ASSERT_TRUE(show->lockSeats({4, 5}, 100));
+    EXPECT_FALSE(show->bookSeats({4, 5}, 200));
+    // One seat of the selection is not the holder's: nothing is booked
+    ASSERT_TRUE(show->lockSeats({6}, 200));
+    EXPECT_FALSE(show->bookSeats({5, 6}, 100));
+    EXPECT_EQ(show->getBookedSeatCount(), 0);
+
+    ASSERT_TRUE(show->bookSeats({4, 5}, 100));
+    EXPECT_EQ(statusOf(*show, 4), ShowSeatStatus::BOOKED);
+    EXPECT_EQ(show->getShowSeatById(5)->getBookingId(), 100);
+    // Booked seats are no longer released with the booking's locks
+    EXPECT_FALSE(show->releaseLockedSeats(100));
+    EXPECT_EQ(show->getBookedSeatCount(), 2);
+}
+
+TEST(ShowSeatReservation, ReleaseFreesOnlyTheHoldersLocks) {
+    auto show = makeShow(10);
+    ASSERT_TRUE(show->lockSeats({1, 2}, 100));
+    ASSERT_TRUE(show->lockSeats({3}, 200));
+    EXPECT_TRUE(show->releaseLockedSeats(100));
+    EXPECT_EQ(statusOf(*show, 1), ShowSeatStatus::AVAILABLE);
+    EXPECT_EQ(show->getShowSeatById(1)->getBookingId(), -1);
+    EXPECT_EQ(statusOf(*show, 3), ShowSeatStatus::LOCKED);
+    EXPECT_FALSE(show->releaseLockedSeats(100));
+    // Released seats can be locked again straight away
+    EXPECT_TRUE(show->lockSeats({1, 2}, 300));
+}
+
+// Bookings fight over overlapping seat pairs, then book or release what they
+// won. Every booked seat must belong to a booking whose bookSeats succeeded,
+// and nothing may stay locked once every booking is settled.
+TEST(ShowSeatReservation, ConcurrentLockBookAndRelease) {
+    const int kSeats = 64;
+    const int kThreads = 4;
+    const int kRounds = 400;
+    auto show = makeShow(kSeats);
+    std::vector<std::atomic<int>> bookedBy(kSeats + 1);
+    std::atomic<int> bookedSeats{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int round = 0; round < kRounds; ++round) {
+                const int bookingId = (t + 1) * 100000 + round;
+                const int first = 1 + (round * 7 + t * 3) % (kSeats - 1);
+                const std::vector<int> seats{first, first + 1};
+                if (!show->lockSeats(seats, bookingId)) {
+                    continue;
+                }
+                if (round % 4 == 0 && show->bookSeats(seats, bookingId)) {
+                    for (int seat : seats) {
+                        bookedBy[seat].store(bookingId);
+                    }
+                    bookedSeats.fetch_add(2);
+                } else {
+                    EXPECT_TRUE(show->releaseLockedSeats(bookingId));
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(show->getLockedSeatCount(), 0);
+    EXPECT_EQ(show->getBookedSeatCount(), bookedSeats.load());
+    for (int seat = 1; seat <= kSeats; ++seat) {
+        const auto view = show->getShowSeatById(seat);
+        if (view->getStatus() == ShowSeatStatus::BOOKED) {
+            EXPECT_EQ(view->getBookingId(), bookedBy[seat].load());
+        } else {
+            EXPECT_EQ(bookedBy[seat].load(), 0);
+        }
+    }
+}
+
+// A booking's own book and release racing: the book either takes every seat
+// or none, and a seat is never left claimed by either
+TEST(ShowSeatReservation, BookRacingReleaseOfTheSameBooking) {
+    for (int round = 0; round < 200; ++round) {
+        auto show = makeShow(8);
+        const std::vector<int> seats{1, 2, 3, 4};
+        ASSERT_TRUE(show->lockSeats(seats, 100));
+
+        std::atomic<bool> booked{false};
+        std::thread booker([&] { booked.store(show->bookSeats(seats, 100)); });
+        std::thread releaser([&] { show->releaseLockedSeats(100); });
+        booker.join();
+        releaser.join();
+
+        const int bookedCount = show->getBookedSeatCount();
+        EXPECT_EQ(bookedCount, booked.load() ? 4 : 0);
+        for (int seat : seats) {
+            const auto view = show->getShowSeatById(seat);
+            const int holder = view->getBookingId();
+            if (view->getStatus() == ShowSeatStatus::AVAILABLE) {
+                EXPECT_EQ(holder, -1);
+            } else {
+                EXPECT_EQ(holder, 100);
+            }
+        }
+        // Whatever release missed is still the booking's to release
+        show->releaseLockedSeats(100);
+        EXPECT_EQ(show->getLockedSeatCount(), 0);
+    }
+}
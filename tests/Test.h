@@ -0,0 +1,106 @@
+#pragma once
+
+// Minimal unit test harness with the shape of GoogleTest, so the tests build
+// without third-party code and port over by swapping this header:
+//
+//   TEST(SeatStateMap, RollsBackOnConflict) {
+//       Models::SeatStateMap seats(64);
+//       ASSERT_TRUE(seats.compareExchange(3, AVAILABLE, LOCKED));
+//       EXPECT_EQ(seats.count(LOCKED), 1u);
+//   }
+//
+// EXPECT_* records a failure and carries on; ASSERT_* also ends the test.
+// Threads a test starts may use EXPECT_*, but ASSERT_* belongs on the test's
+// own thread while no other thread it started is still running.
+// Tests run one after another in registration order, each file's in the
+// order they appear. Flags: --filter=SUBSTRING (matched on Suite.Name)
+
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace Test {
+
+using Function = void (*)();
+
+class Registration {
+private:
+    std::string suite_;
+    std::string name_;
+    Function function_;
+
+public:
+    Registration(std::string suite, std::string name, Function function)
+        : suite_(std::move(suite)), name_(std::move(name)), function_(function) {}
+
+    const std::string& getSuite() const { return suite_; }
+    const std::string& getName() const { return name_; }
+    Function getFunction() const { return function_; }
+};
+
+// Thrown by a failed ASSERT_* to leave the test; caught by the runner
+struct FatalFailure {};
+
+Registration* registerTest(const char* suite, const char* name, Function function);
+void reportFailure(const char* file, int line, const std::string& message);
+int runAll(int argc, char** argv);
+
+// Printable form of a compared value; "?" for types without operator<<
+template <typename T>
+std::string describe(const T& value) {
+    if constexpr (requires(std::ostream& out) { out << value; }) {
+        std::ostringstream out;
+        out << value;
+        return out.str();
+    } else if constexpr (std::is_enum_v<T>) {
+        return std::to_string(static_cast<long long>(value));
+    } else {
+        return "?";
+    }
+}
+
+template <typename A, typename B>
+std::string describeComparison(const char* expression, const A& actual, const B& expected) {
+    return std::string(expression) + " (" + describe(actual) + " vs " + describe(expected) + ")";
+}
+
+} // namespace Test
+
+#define TEST_CONCAT_INNER(a, b) a##b
+#define TEST_CONCAT(a, b) TEST_CONCAT_INNER(a, b)
+#define TEST(suite, name)                                                                   \
+    static void TEST_CONCAT(suite, TEST_CONCAT(_, name))();                                 \
+    static ::Test::Registration* TEST_CONCAT(testRegistration_, __LINE__) =                 \
+        ::Test::registerTest(#suite, #name, TEST_CONCAT(suite, TEST_CONCAT(_, name)));      \
+    static void TEST_CONCAT(suite, TEST_CONCAT(_, name))()
+
+#define TEST_CHECK(condition, message, onFailure)                        \
+    do {                                                                 \
+        if (!(condition)) {                                              \
+            ::Test::reportFailure(__FILE__, __LINE__, (message));        \
+            onFailure;                                                   \
+        }                                                                \
+    } while (false)
+
+#define TEST_CHECK_OP(actual, op, expected, onFailure)                                       \
+    do {                                                                                     \
+        const auto& testActual = (actual);                                                   \
+        const auto& testExpected = (expected);                                               \
+        if (!(testActual op testExpected)) {                                                 \
+            ::Test::reportFailure(__FILE__, __LINE__,                                        \
+                                  ::Test::describeComparison(#actual " " #op " " #expected,  \
+                                                             testActual, testExpected));     \
+            onFailure;                                                                       \
+        }                                                                                    \
+    } while (false)
+
+#define EXPECT_TRUE(condition) TEST_CHECK(condition, #condition, (void)0)
+#define EXPECT_FALSE(condition) TEST_CHECK(!(condition), "!(" #condition ")", (void)0)
+#define EXPECT_EQ(actual, expected) TEST_CHECK_OP(actual, ==, expected, (void)0)
+#define EXPECT_NE(actual, expected) TEST_CHECK_OP(actual, !=, expected, (void)0)
+#define EXPECT_LE(actual, expected) TEST_CHECK_OP(actual, <=, expected, (void)0)
+
+#define ASSERT_TRUE(condition) TEST_CHECK(condition, #condition, throw ::Test::FatalFailure())
+#define ASSERT_FALSE(condition) TEST_CHECK(!(condition), "!(" #condition ")", throw ::Test::FatalFailure())
+#define ASSERT_EQ(actual, expected) TEST_CHECK_OP(actual, ==, expected, throw ::Test::FatalFailure())
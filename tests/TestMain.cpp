@@ -0,0 +1,112 @@
+// Runner for the unit tests, see Test.h.
+//
+// The concurrent tests are most useful built with -fsanitize=thread. As with
+// the benchmarks, each suite links only its own project, so either can be
+// built alone. tests/Parking*Tests.cpp are the parking suite and every other
+// tests/*Tests.cpp the booking suite:
+//   g++ -std=c++20 -g -pthread tests/TestMain.cpp <parking tests>
+//       <parkingLot sources> -o run_parking_tests
+//   g++ -std=c++20 -g -pthread tests/TestMain.cpp <booking tests>
+//       <movieTicketBooking sources> -lmysqlclient -o run_booking_tests
+// The booking suite needs the complete movieTicketBooking build, including
+// the model, exception and logger sources and the MySQL client library.
+// A failing test prints its file and line; the exit status is the number of
+// failed tests, capped at 255.
+
+#include "Test.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace Test {
+
+namespace {
+
+std::vector<std::unique_ptr<Registration>>& registry() {
+    static std::vector<std::unique_ptr<Registration>> registrations;
+    return registrations;
+}
+
+// Failures reported by the running test, from any of its threads
+std::atomic<int> currentFailures{0};
+
+struct Options {
+    std::string filter;
+};
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string flag = argv[i];
+        auto value = [&](const char* prefix) -> const char* {
+            size_t length = std::strlen(prefix);
+            return flag.compare(0, length, prefix) == 0 ? argv[i] + length : nullptr;
+        };
+        if (const char* v = value("--filter=")) {
+            options.filter = v;
+        } else {
+            std::cerr << "unknown flag " << flag << "\nusage: " << argv[0] << " [--filter=SUBSTRING]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+Registration* registerTest(const char* suite, const char* name, Function function) {
+    registry().push_back(std::make_unique<Registration>(suite, name, function));
+    return registry().back().get();
+}
+
+void reportFailure(const char* file, int line, const std::string& message) {
+    currentFailures.fetch_add(1);
+    std::printf("%s:%d: failed: %s\n", file, line, message.c_str());
+}
+
+int runAll(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 2;
+    }
+
+    int passed = 0;
+    int failed = 0;
+    for (const auto& registration : registry()) {
+        const std::string testName = registration->getSuite() + "." + registration->getName();
+        if (testName.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        std::printf("[ RUN      ] %s\n", testName.c_str());
+        std::fflush(stdout);
+        currentFailures.store(0);
+        try {
+            registration->getFunction()();
+        } catch (const FatalFailure&) {
+            // Already reported
+        } catch (const std::exception& e) {
+            reportFailure(__FILE__, __LINE__, std::string("uncaught exception: ") + e.what());
+        } catch (...) {
+            reportFailure(__FILE__, __LINE__, "uncaught exception");
+        }
+        if (currentFailures == 0) {
+            ++passed;
+            std::printf("[       OK ] %s\n", testName.c_str());
+        } else {
+            ++failed;
+            std::printf("[  FAILED  ] %s\n", testName.c_str());
+        }
+    }
+    std::printf("%d passed, %d failed\n", passed, failed);
+    return failed > 255 ? 255 : failed;
+}
+
+} // namespace Test
+
+int main(int argc, char** argv) {
+    return Test::runAll(argc, argv);
+}
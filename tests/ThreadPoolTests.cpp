@@ -0,0 +1,155 @@
+// ThreadPool: each back-pressure policy once the queue is full, workers
+// submitting to their own full pool, and shutdown.
+
+#include "Test.h"
+
+#include "../movieTicketBooking/include/utils/ThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace MovieBooking::Utils;
+
+namespace {
+
+// Holds a pool's workers busy until opened
+class Gate {
+private:
+    std::promise<void> opened_;
+    std::shared_future<void> waiter_ = opened_.get_future().share();
+
+public:
+    void wait() const { waiter_.wait(); }
+    void open() { opened_.set_value(); }
+};
+
+// Occupy the single worker of `pool` and wait until it has taken the task,
+// so the whole queue is free for the test
+std::future<void> occupyWorker(ThreadPool& pool, Gate& gate) {
+    std::atomic<bool> started{false};
+    auto busy = pool.submit([&gate, &started] {
+        started.store(true);
+        gate.wait();
+    });
+    while (!started.load()) {
+        std::this_thread::yield();
+    }
+    return busy;
+}
+
+} // namespace
+
+TEST(ThreadPool, RunsTasksAndPropagatesExceptions) {
+    ThreadPool pool("test", 2);
+    auto value = pool.submit([] { return 42; });
+    auto failure = pool.submit([]() -> int { throw std::runtime_error("boom"); });
+    EXPECT_EQ(value.get(), 42);
+    bool threw = false;
+    try {
+        failure.get();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+TEST(ThreadPool, RejectThrowsOnceTheQueueIsFull) {
+    ThreadPool pool("reject", 1, 2, BackPressurePolicy::REJECT);
+    Gate gate;
+    auto busy = occupyWorker(pool, gate);
+    auto first = pool.submit([] { return 1; });
+    auto second = pool.submit([] { return 2; });
+    EXPECT_EQ(pool.getQueueDepth(), 2u);
+
+    bool rejected = false;
+    try {
+        pool.submit([] { return 3; });
+    } catch (const RateLimitException&) {
+        rejected = true;
+    }
+    EXPECT_TRUE(rejected);
+    EXPECT_EQ(pool.getStats().rejected, 1u);
+
+    gate.open();
+    busy.get();
+    EXPECT_EQ(first.get() + second.get(), 3);
+}
+
+TEST(ThreadPool, CallerRunsOnTheSubmittingThread) {
+    ThreadPool pool("caller-runs", 1, 1, BackPressurePolicy::CALLER_RUNS);
+    Gate gate;
+    auto busy = occupyWorker(pool, gate);
+    auto queued = pool.submit([] { return std::this_thread::get_id(); });
+    auto overflow = pool.submit([] { return std::this_thread::get_id(); });
+
+    // Ran before submit returned, on this thread. Not ASSERT: the pool could
+    // not shut down while its worker waits on the gate.
+    EXPECT_TRUE(overflow.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    gate.open();
+    EXPECT_TRUE(overflow.get() == std::this_thread::get_id());
+    EXPECT_EQ(pool.getStats().rejected, 0u);
+    busy.get();
+    EXPECT_TRUE(queued.get() != std::this_thread::get_id());
+}
+
+TEST(ThreadPool, BlockWaitsForRoom) {
+    ThreadPool pool("block", 1, 1, BackPressurePolicy::BLOCK);
+    Gate gate;
+    auto busy = occupyWorker(pool, gate);
+    auto queued = pool.submit([] { return 1; });
+
+    std::atomic<bool> submitted{false};
+    std::future<int> blocked;
+    std::thread submitter([&] {
+        blocked = pool.submit([] { return 2; });
+        submitted.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(submitted.load());
+
+    gate.open();
+    submitter.join();
+    EXPECT_TRUE(submitted.load());
+    EXPECT_EQ(queued.get() + blocked.get(), 3);
+    busy.get();
+}
+
+// A worker that would block on its own full queue runs the task inline
+TEST(ThreadPool, WorkersNeverBlockOnTheirOwnQueue) {
+    ThreadPool pool("nested", 1, 1, BackPressurePolicy::BLOCK);
+    auto outer = pool.submit([&pool] {
+        auto first = pool.submit([] { return 1; });
+        auto second = pool.submit([] { return 2; });
+        // second had no room and ran here; first waits for this task to end
+        return second.get();
+    });
+    ASSERT_TRUE(outer.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    EXPECT_EQ(outer.get(), 2);
+}
+
+TEST(ThreadPool, ShutdownFinishesQueuedWorkAndRejectsNew) {
+    auto pool = std::make_unique<ThreadPool>("shutdown", 2, 100);
+    std::atomic<int> ran{0};
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 50; ++i) {
+        futures.push_back(pool->submit([&ran] {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            ran.fetch_add(1);
+        }));
+    }
+    pool->shutdown();
+    EXPECT_EQ(ran.load(), 50);
+    EXPECT_EQ(pool->getStats().completed, 50u);
+
+    bool rejected = false;
+    try {
+        pool->submit([] {});
+    } catch (const RateLimitException&) {
+        rejected = true;
+    }
+    EXPECT_TRUE(rejected);
+}
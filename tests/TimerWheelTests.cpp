@@ -0,0 +1,107 @@
+// TimerWheel: timers fire at their tick whichever level they start on, after
+// cascading down through the levels below.
+
+#include "Test.h"
+
+#include "../movieTicketBooking/include/utils/TimerWheel.h"
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+using Wheel = MovieBooking::Utils::TimerWheel<int>;
+
+namespace {
+
+const Wheel::Clock::time_point kOrigin = Wheel::Clock::time_point(std::chrono::hours(1000));
+
+Wheel::Clock::time_point at(uint64_t seconds) {
+    return kOrigin + std::chrono::seconds(seconds);
+}
+
+// Advance one tick at a time to `lastTick`, recording the tick each payload fired at
+std::vector<std::pair<int, uint64_t>> runUntil(Wheel& wheel, uint64_t firstTick, uint64_t lastTick) {
+    std::vector<std::pair<int, uint64_t>> fired;
+    for (uint64_t tick = firstTick; tick <= lastTick; ++tick) {
+        for (int payload : wheel.advance(at(tick))) {
+            fired.emplace_back(payload, tick);
+        }
+    }
+    return fired;
+}
+
+} // namespace
+
+TEST(TimerWheel, FiresAtTheFirstTickAtOrAfterTheDeadline) {
+    Wheel wheel(std::chrono::seconds(1), kOrigin);
+    wheel.schedule(at(5), 1);
+    wheel.schedule(at(5) - std::chrono::milliseconds(500), 2);
+    EXPECT_TRUE(wheel.advance(at(4)).empty());
+    EXPECT_TRUE(wheel.advance(at(5)) == (std::vector<int>{1, 2}));
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimerWheel, PastDeadlinesFireOnTheNextAdvance) {
+    Wheel wheel(std::chrono::seconds(1), kOrigin);
+    wheel.advance(at(10));
+    wheel.schedule(at(3), 1);
+    wheel.schedule(kOrigin - std::chrono::hours(1), 2);
+    EXPECT_TRUE(wheel.advance(at(11)) == (std::vector<int>{1, 2}));
+}
+
+// Deltas straddling each level boundary start on levels 0 to 3 and must
+// cascade down without firing early or late
+TEST(TimerWheel, CascadesEachLevelToTheExactTick) {
+    Wheel wheel(std::chrono::seconds(1), kOrigin);
+    const std::vector<uint64_t> ticks{1, 63, 64, 65, 127, 128, 4095, 4096, 4097, 4160, 262143, 262144, 262209};
+    for (size_t i = 0; i < ticks.size(); ++i) {
+        wheel.schedule(at(ticks[i]), static_cast<int>(i));
+    }
+
+    const auto fired = runUntil(wheel, 0, ticks.back() + 1);
+    ASSERT_EQ(fired.size(), ticks.size());
+    for (size_t i = 0; i < fired.size(); ++i) {
+        EXPECT_EQ(fired[i].first, static_cast<int>(i));
+        EXPECT_EQ(fired[i].second, ticks[fired[i].first]);
+    }
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+// Timers placed mid-rotation land in slots relative to the current tick,
+// not to the origin
+TEST(TimerWheel, CascadesTimersScheduledMidRotation) {
+    Wheel wheel(std::chrono::seconds(1), kOrigin);
+    wheel.advance(at(100));
+    const std::vector<uint64_t> ticks{150, 163, 164, 191, 192, 4196, 5000};
+    for (size_t i = 0; i < ticks.size(); ++i) {
+        wheel.schedule(at(ticks[i]), static_cast<int>(i));
+    }
+
+    const auto fired = runUntil(wheel, 101, 5001);
+    ASSERT_EQ(fired.size(), ticks.size());
+    for (const auto& [payload, tick] : fired) {
+        EXPECT_EQ(tick, ticks[payload]);
+    }
+}
+
+TEST(TimerWheel, JumpsFireEverythingDueOldestFirst) {
+    Wheel wheel(std::chrono::seconds(1), kOrigin);
+    wheel.schedule(at(5000), 3);
+    wheel.schedule(at(70), 2);
+    wheel.schedule(at(3), 1);
+    wheel.schedule(at(9000), 4);
+    EXPECT_TRUE(wheel.advance(at(6000)) == (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(wheel.size(), 1u);
+}
+
+TEST(TimerWheel, CancelledTimersNeverFire) {
+    Wheel wheel(std::chrono::seconds(1), kOrigin);
+    const auto near = wheel.schedule(at(2), 1);
+    const auto far = wheel.schedule(at(5000), 2);
+    wheel.schedule(at(5000), 3);
+    EXPECT_TRUE(wheel.cancel(near));
+    EXPECT_TRUE(wheel.cancel(far));
+    EXPECT_FALSE(wheel.cancel(far));
+    EXPECT_EQ(wheel.size(), 1u);
+    EXPECT_TRUE(wheel.advance(at(6000)) == (std::vector<int>{3}));
+}